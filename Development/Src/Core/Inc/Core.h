@@ -1200,6 +1200,10 @@ extern UBOOL					GIsCriticalError;
 extern UBOOL					GIsStarted;
 extern UBOOL					GIsRunning;
 extern UBOOL					GIsGarbageCollecting;
+/** Whether the realtime GC mark phase is spread across GThreadPool workers, disabled via -SERIALGCMARK */
+extern UBOOL					GUseParallelGCMark;
+/** Whether each parallel GC mark phase is validated against a serial one, enabled via -VERIFYGCMARK */
+extern UBOOL					GVerifyParallelGCMark;
 extern UBOOL					GIsReplacingObject;
 
 /**
@@ -1308,6 +1312,10 @@ extern QWORD					GNumTimingCodeCalls;
 #else
 extern UBOOL					GUseSeekFreeLoading;
 #endif
+/** Whether uncompressed seekfree packages are memory mapped rather than read, enabled via -MAPPEDPACKAGES.	*/
+extern UBOOL					GUseMappedPackageLoading;
+/** Number of compressed chunks decompressed in parallel, 0 to base it on the number of hardware threads, set via -DECOMPRESSIONWINDOW=.	*/
+extern INT						GDecompressionWindowSize;
 
 #if ENABLE_SCRIPT_TRACING
 /** Whether we are tracing script to a log file */
@@ -1334,6 +1342,7 @@ extern "C" TCHAR GPackage[];
 #include "UnName.h"						// Global name subsystem.
 #include "UnStack.h"					// Script stack definition.
 #include "UnScriptMacros.h"				// Script macro definitions
+#include "UnObjHash.h"					// Object hash tables.
 #include "UnObjBas.h"					// Object base class.
 #include "HashSet.h"					// Hash set definitions.
 #include "UnMath.h"						// Vector math functions.
@@ -1355,9 +1364,11 @@ extern "C" TCHAR GPackage[];
 #include "FCallbackDevice.h"			// Base class for callback devices.
 #include "UnThreadingBase.h"			// Non-platform specific multi-threaded support.
 #include "UnAsyncWork.h"				
+#include "UnTaskGraph.h"				// Work stealing thread pool and dependent queued work.
 #include "UnOutputDevices.h"			// Output devices
 #include "UnObjectRedirector.h"			// Cross-package object redirector
 #include "UnArchive.h"					// Utility archive classes
+#include "UnMappedFile.h"				// Memory mapped files
 #include "UnBulkData.h"					// Bulk data classes
 #include "PerfCounter.h"				// Serialization performance tracking classes
 #include "UnLinker.h"					// Linker.
@@ -1557,6 +1568,8 @@ enum EMemoryStats
 	STAT_FaceFXPeakAllocSize,
 	STAT_FaceFXCurrentAllocSize,
 	STAT_TextureMemory,
+	STAT_FrameArenaMemory,
+	STAT_FrameArenaPeakMemory,
 
 	STAT_GameToRendererMallocPSSP,
 	STAT_GameToRendererMallocSkMSP,
@@ -1615,6 +1628,10 @@ enum EObjectStats
 	STAT_InitProperties,
 	STAT_NameTableEntries,
 	STAT_NameTableMemorySize,
+	STAT_GCMarkTime,
+	STAT_GCLastMarkTime,
+	STAT_GCMarkThreads,
+	STAT_GCReachableObjects,
 };
 
 /** Threading stats */
@@ -1626,6 +1643,8 @@ enum EThreadingStats
 	STAT_GameTickWaitTime,
 	STAT_GameTickWantedWaitTime,
 	STAT_GameTickAdditionalWaitTime,
+	STAT_ServerTickJitter,
+	STAT_ServerTickCpuTime,
 };
 
 /**
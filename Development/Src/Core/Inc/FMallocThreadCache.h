@@ -0,0 +1,209 @@
+/*=============================================================================
+	FMallocThreadCache.h: Size class allocator with per thread caches.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#ifndef _FMALLOCTHREADCACHE_H
+#define _FMALLOCTHREADCACHE_H
+
+#if __LINUX__
+
+/**
+ * Allocator serving small requests from per thread caches of size class blocks, only taking a lock
+ * when a cache runs empty or overflows and whole batches of blocks are moved between it and the
+ * central free lists of a size class. Blocks are carved out of spans mapped from the OS, allocations
+ * larger than the biggest size class are mapped individually.
+ *
+ * Spans and large allocations are aligned to SPAN_SIZE and start with a header so the size class of
+ * any pointer can be found without a lookup. Spans are never returned to the OS.
+ *
+ * Enabled via -THREADCACHEMALLOC, which is checked before the engine has parsed the command line.
+ */
+class FMallocThreadCache : public FMalloc
+{
+public:
+	enum { ALLOCATION_ALIGNMENT	= 16			};
+	enum { SPAN_SIZE			= 256 * 1024	};
+	enum { MAX_SMALL_SIZE		= 32768			};
+	enum { NUM_SIZE_CLASSES		= 40			};
+
+	/** Block on a free list, overlaid on the freed memory. */
+	struct FFreeBlock
+	{
+		/** Next block in the same list. */
+		FFreeBlock*	Next;
+		/** Next batch, only used by the first block of a batch in a central free list. */
+		FFreeBlock*	NextBatch;
+	};
+
+	/** Per thread cache of free blocks. */
+	struct FThreadCache
+	{
+		/** Free blocks per size class. */
+		FFreeBlock*		FreeLists[NUM_SIZE_CLASSES];
+		/** Number of blocks in each free list. */
+		INT				FreeCounts[NUM_SIZE_CLASSES];
+		/** Bytes allocated minus bytes freed by this thread, summed up for stats. */
+		SIZE_T			UsedBytes;
+		/** Allocations minus frees by this thread, summed up for stats. */
+		INT				CurrentAllocs;
+		/** Allocations made by this thread. */
+		INT				TotalAllocs;
+		/** Next cache in the list of all thread caches. */
+		FThreadCache*	Next;
+	};
+
+	/** Shared state of a size class. */
+	struct FSizeClass
+	{
+		/** Guards everything below. */
+		pthread_mutex_t		Mutex;
+		/** Size of blocks in bytes. */
+		INT					BlockSize;
+		/** Number of blocks moved between a thread cache and the central lists at once. */
+		INT					BatchSize;
+		/** Stack of batches of exactly BatchSize blocks, linked via NextBatch. */
+		FFreeBlock*			FullBatches;
+		/** Blocks handed back in smaller numbers, e.g. by exiting threads. */
+		FFreeBlock*			LooseBlocks;
+		/** Number of blocks in LooseBlocks. */
+		INT					NumLooseBlocks;
+		/** Number of blocks in FullBatches. */
+		INT					NumBatchedBlocks;
+		/** Number of spans carved up for this size class. */
+		INT					NumSpans;
+	};
+
+	/** Header at the start of each span and large allocation. */
+	struct FSpanHeader
+	{
+		/** Size class of the blocks in this span, INDEX_NONE for a large allocation. */
+		INT		SizeClass;
+		/** Size of the mapping in bytes. */
+		SIZE_T	MappedSize;
+		/** Requested size of a large allocation. */
+		SIZE_T	LargeSize;
+	};
+	enum { SPAN_HEADER_SIZE = 64 };
+
+	FMallocThreadCache();
+
+	/**
+	 * Returns whether -THREADCACHEMALLOC was passed. Reads the process command line directly as
+	 * GMalloc is created on the first allocation, way before appCmdLine is set up.
+	 */
+	static UBOOL IsRequestedOnCommandLine();
+
+	// FMalloc interface.
+	virtual void* Malloc( DWORD Size, DWORD Alignment );
+	virtual void* Realloc( void* Ptr, DWORD NewSize, DWORD Alignment );
+	virtual void Free( void* Ptr );
+	virtual UBOOL IsInternallyThreadSafe()
+	{
+		return TRUE;
+	}
+
+	/**
+	 * Gathers memory allocations for both virtual and physical allocations.
+	 *
+	 * @param Virtual	[out] size of virtual allocations
+	 * @param Physical	[out] size of physical allocations
+	 */
+	virtual void GetAllocationInfo( SIZE_T& Virtual, SIZE_T& Physical );
+
+	virtual UBOOL Exec( const TCHAR* Cmd, FOutputDevice& Ar );
+
+	/**
+	 * Logs memory usage, optionally broken down by size class.
+	 *
+	 * @param bSummaryOnly	whether to skip the per size class stats
+	 * @param Ar			device to log to
+	 */
+	void DumpAllocs( UBOOL bSummaryOnly, FOutputDevice& Ar );
+
+private:
+	/**
+	 * Locks a pthread mutex for the lifetime of the object. Plain mutexes are used as none of the
+	 * locks are ever taken recursively.
+	 */
+	class FScopeMutexLock
+	{
+	public:
+		FScopeMutexLock( pthread_mutex_t* InMutex )
+		:	Mutex( InMutex )
+		{
+			pthread_mutex_lock( Mutex );
+		}
+		~FScopeMutexLock()
+		{
+			pthread_mutex_unlock( Mutex );
+		}
+	private:
+		pthread_mutex_t* Mutex;
+	};
+
+	/** @return the calling thread's cache, creating it on first use */
+	FThreadCache* GetThreadCache();
+
+	/**
+	 * Moves a batch of blocks of the passed in size class into the thread cache.
+	 */
+	void FetchFromCentral( FThreadCache* Cache, INT SizeClass );
+
+	/**
+	 * Moves a batch of blocks of the passed in size class from the thread cache to the central lists.
+	 */
+	void ReleaseToCentral( FThreadCache* Cache, INT SizeClass );
+
+	/**
+	 * Maps a new span for the passed in size class and pushes its blocks on the loose list. Called
+	 * with the size class locked.
+	 */
+	void AllocateSpan( FSizeClass& Class, INT SizeClass );
+
+	/**
+	 * Maps SPAN_SIZE aligned memory from the OS.
+	 *
+	 * @param	Size	size in bytes, multiple of the page size
+	 * @return	mapping, never NULL
+	 */
+	void* MapAligned( SIZE_T Size );
+
+	/** Unmaps memory returned by MapAligned. */
+	void Unmap( void* Ptr, SIZE_T Size );
+
+	/** @return header of the span or large allocation Ptr belongs to */
+	static FSpanHeader* GetSpanHeader( void* Ptr )
+	{
+		return (FSpanHeader*)( (PTRINT) Ptr & ~(PTRINT)(SPAN_SIZE - 1) );
+	}
+
+	/** Called when a thread exits, handing its cached blocks back to the central lists. */
+	static void DestroyThreadCache( void* InCache );
+
+	/** Size classes. */
+	FSizeClass		SizeClasses[NUM_SIZE_CLASSES];
+	/** Size class index for each 16 byte step up to MAX_SMALL_SIZE. */
+	BYTE			SizeToClass[MAX_SMALL_SIZE / ALLOCATION_ALIGNMENT + 1];
+	/** Key used to get notified about exiting threads. */
+	pthread_key_t	ThreadCacheKey;
+	/** Guards the list of thread caches and the retired stats. */
+	pthread_mutex_t	ThreadCachesMutex;
+	/** All live thread caches. */
+	FThreadCache*	ThreadCaches;
+	/** Stats of exited threads. */
+	SIZE_T			RetiredUsedBytes;
+	INT				RetiredCurrentAllocs;
+	INT				RetiredTotalAllocs;
+	/** Bytes currently mapped from the OS and their peak. */
+	volatile INT	OsCurrentKB;
+	INT				OsPeakKB;
+};
+
+#endif	// __LINUX__
+
+#endif	// _FMALLOCTHREADCACHE_H
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -23,6 +23,12 @@ public:
 		Alignment = InAlignment;
 	}
 
+	/** Destructor, freeing the data buffer. */
+	~FRingBuffer()
+	{
+		delete [] Data;
+	}
+
 	/**
 	 * A reference to an allocated chunk of the ring buffer.
 	 * Upon destruction of the context, the chunk is committed as written.
@@ -82,6 +82,12 @@ public:
 	 */
 	virtual class ULinker* GetLinker() { return NULL; }
 
+	/**
+	 * Returns the memory mapped file this archive reads from, if any. Data of such archives can be
+	 * referenced in place instead of being copied, see FUntypedBulkData::Serialize.
+	 */
+	virtual class FMappedFile* GetMappedFile() { return NULL; }
+
 	virtual INT Tell()
 	{
 		return INDEX_NONE;
@@ -155,6 +155,86 @@ public:
 	virtual void DoWork();
 };
 
+/**
+ * Decompresses a stream of independent chunks in parallel with FAsyncUncompress, keeping a window of them in
+ * flight on the thread pool while the caller reads the next ones. Each slot of the window has its own buffer
+ * for compressed data which is handed out by GetCompressedBuffer once the chunk using it is done. A window
+ * size of 1 decompresses synchronously on the calling thread.
+ */
+class FAsyncUncompressPipeline
+{
+public:
+	/**
+	 * Constructor, allocating a compressed data buffer per slot.
+	 *
+	 * @param	InFlags				Flags to control what method to use for decompression
+	 * @param	InMaxCompressedSize	Size of largest compressed chunk in bytes
+	 * @param	InWindowSize		Number of chunks decompressed at once, INDEX_NONE to use GetDefaultWindowSize
+	 */
+	FAsyncUncompressPipeline( ECompressionFlags InFlags, INT InMaxCompressedSize, INT InWindowSize = INDEX_NONE );
+
+	/**
+	 * Destructor, waiting for all chunks and freeing the buffers.
+	 */
+	~FAsyncUncompressPipeline();
+
+	/**
+	 * Returns the buffer the next chunk's compressed data should be read into, blocking till the chunk that
+	 * last used it has been decompressed.
+	 *
+	 * @return buffer of at least InMaxCompressedSize bytes
+	 */
+	void* GetCompressedBuffer();
+
+	/**
+	 * Kicks off decompression of the chunk read into the buffer last returned by GetCompressedBuffer.
+	 *
+	 * @param	UncompressedBuffer	Buffer to decompress into, needs to stay valid till Flush
+	 * @param	UncompressedSize	Size of uncompressed data in bytes
+	 * @param	CompressedSize		Size of compressed data in bytes
+	 */
+	void Uncompress( void* UncompressedBuffer, INT UncompressedSize, INT CompressedSize );
+
+	/**
+	 * Blocks till all chunks have been decompressed.
+	 */
+	void Flush();
+
+	/**
+	 * @return time in seconds spent waiting for decompression
+	 */
+	DOUBLE GetWaitTime() const
+	{
+		return WaitTime;
+	}
+
+	/**
+	 * @return number of chunks decompressed at once, based on GDecompressionWindowSize
+	 */
+	static INT GetDefaultWindowSize();
+
+private:
+	/**
+	 * Blocks till the chunk using the passed in slot has been decompressed.
+	 */
+	void WaitForSlot( INT SlotIndex );
+
+	/** Flags to control decompression. */
+	ECompressionFlags	Flags;
+	/** Size of a slot's compressed data buffer in bytes. */
+	INT					MaxCompressedSize;
+	/** Number of slots. */
+	INT					WindowSize;
+	/** Slot handed out by the last GetCompressedBuffer call. */
+	INT					CurrentSlot;
+	/** Compressed data buffers of all slots, back to back. */
+	BYTE*				CompressedBuffers;
+	/** Per slot counter, non-zero while the slot's chunk is being decompressed. */
+	FThreadSafeCounter*	PendingChunks;
+	/** Time in seconds spent waiting for decompression. */
+	DOUBLE				WaitTime;
+};
+
 /**
  * Asynchronous SHA verification
  */
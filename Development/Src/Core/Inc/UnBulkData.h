@@ -24,6 +24,8 @@ enum EBulkDataFlags
 	BULKDATA_SerializeCompressedLZO				= 1<<4,
 	/** Bulk data won't be used and doesn't need to be loaded						*/
 	BULKDATA_Unused								= 1<<5,
+	/** Payload points into a memory mapped package. Runtime only, never saved.	*/
+	BULKDATA_Mapped								= 1<<6,
 
 	/** Flag to check if either compression mode is specified						*/
 	BULKDATA_SerializeCompressed				= (BULKDATA_SerializeCompressedZLIB | BULKDATA_SerializeCompressedLZO),
@@ -349,6 +351,36 @@ private:
 	 */
 	void MakeSureBulkDataIsLoaded();
 
+	/**
+	 * Copies the bulk data into owned memory if it references a memory mapped package.
+	 */
+	void MakeSureBulkDataIsOwned();
+
+	/**
+	 * (Re)allocates owned memory for GetBulkDataSize bytes, dropping a reference to a mapped package.
+	 * Existing contents are only preserved if they were already owned.
+	 */
+	void AllocateBulkData();
+
+	/**
+	 * Frees the bulk data, releasing the mapping instead if it references a memory mapped package.
+	 */
+	void FreeBulkData();
+
+	/**
+	 * Drops the reference to the memory mapped package the bulk data points into and clears BULKDATA_Mapped.
+	 */
+	void ReleaseMappedBulkData();
+
+	/**
+	 * Points the bulk data directly at the passed in archive's memory mapped file if the data is stored
+	 * in a way allowing it to be used in place and skips over it.
+	 *
+	 * @param	Ar	Archive to serialize with
+	 * @return	TRUE if the bulk data now references the mapping, FALSE if it needs to be serialized
+	 */
+	UBOOL SerializeBulkDataMapped( FArchive& Ar );
+
 	/**
 	 * Loads the data from disk into the specified memory block. This requires us still being attached to an
 	 * archive we can use for serialization.
@@ -162,6 +162,29 @@ enum EComponentInstanceFlags
 	CIF_ReinstanceComponents		= CIF_ForceInstance|CIF_ModifiedComponentsOnly,
 };
 
+/**
+ * Inline cache of a virtual or global script function call site, remembering the function the call
+ * resolved to for the class and state of the object it was last made on.
+ */
+struct FScriptCallCache
+{
+	/** Class of the object the function was looked up for */
+	UClass*		Class;
+	/** State the object was in, NULL for global calls */
+	UState*		State;
+	/** Function the call resolved to */
+	UFunction*	Function;
+	/** GScriptCallCacheEpoch at the time the function was looked up */
+	DWORD		Epoch;
+};
+
+/** Bumped whenever function maps change or structs go away, invalidating all FScriptCallCache entries. */
+extern DWORD GScriptCallCacheEpoch;
+/** Whether virtual and global script calls go through their call site's cache. */
+extern UBOOL GUseScriptCallCaches;
+/** Whether script code is translated into superinstructions when it is loaded. */
+extern UBOOL GUseScriptSuperinstructions;
+
 /**
  * Base class for all UObject types that contain fields.
  */
@@ -193,6 +216,11 @@ class UStruct : public UField
 	/** Array of object references embedded in script code. Mirrored for easy access by realtime garbage collection code */
 	TArray<UObject*>	ScriptObjectReferences;
 
+	/** Offsets of the function names of virtual and global calls in Script, ascending. Gathered when loading script code */
+	TArray<INT>					CallSiteOffsets;
+	/** Inline cache of each call site in CallSiteOffsets */
+	TArray<FScriptCallCache>	CallCaches;
+
 	// Constructors.
 	UStruct( ENativeConstructor, INT InSize, const TCHAR* InName, const TCHAR* InPackageName, EObjectFlags InFlags, UStruct* InSuperStruct );
 	UStruct( EStaticConstructor, INT InSize, const TCHAR* InName, const TCHAR* InPackageName, EObjectFlags InFlags );
@@ -266,6 +294,15 @@ class UStruct : public UField
 	void SerializeTaggedProperties( FArchive& Ar, BYTE* Data, UStruct* DefaultsStruct, BYTE* Defaults, INT DefaultsCount=0 ) const;
 	virtual EExprToken SerializeExpr( INT& iCode, FArchive& Ar );
 
+	/**
+	 * Translates common expression patterns in Script into superinstructions, or back into their original
+	 * form. Only the leading token of an expression is rewritten so code offsets remain valid.
+	 *
+	 * @param	bFuse	TRUE to fuse expressions into superinstructions, FALSE to restore the original tokens
+	 * @return	number of expressions that were rewritten
+	 */
+	INT TranslateSuperinstructions( UBOOL bFuse );
+
 	virtual void PropagateStructDefaults();
 
 	/**
@@ -304,6 +341,36 @@ class UStruct : public UField
 		return (UStruct*)SuperField;
 	}
 	UBOOL StructCompare( const void* A, const void* B, DWORD PortFlags=0 );
+
+	/**
+	 * Finds the inline cache of a virtual or global function call in Script.
+	 *
+	 * @param	CodeOffset	offset of the function name following the call's token
+	 * @return	cache of the call site, NULL if the call site is unknown
+	 */
+	FORCEINLINE FScriptCallCache* FindCallCache( INT CodeOffset )
+	{
+		INT Min = 0;
+		INT Max = CallSiteOffsets.Num() - 1;
+		while( Min <= Max )
+		{
+			const INT Mid = (Min + Max) >> 1;
+			const INT MidOffset = CallSiteOffsets(Mid);
+			if( MidOffset == CodeOffset )
+			{
+				return &CallCaches(Mid);
+			}
+			else if( MidOffset < CodeOffset )
+			{
+				Min = Mid + 1;
+			}
+			else
+			{
+				Max = Mid - 1;
+			}
+		}
+		return NULL;
+	}
 };
 
 /**
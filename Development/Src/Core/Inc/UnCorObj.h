@@ -75,6 +75,8 @@ private:
 	TArray<INT> GenerationNetObjectCount;
 	/** for packages that were a forced export in another package (seekfree loading), the name of that base package, otherwise NAME_None */
 	FName ForcedExportBasePackageName;
+	/** name clients know this package by if it was loaded from a file of another name, otherwise NAME_None */
+	FName NetPackageName;
 	
 	/** array of UPackages that currently have NetObjects that are relevant to netplay */
 	static TArray<UPackage*> NetPackages;
@@ -291,6 +293,16 @@ public:
 	{
 		return CurrentNumNetObjects;
 	}
+	/** returns the name clients know this package by */
+	FORCEINLINE FName GetNetPackageName()
+	{
+		return NetPackageName != NAME_None ? NetPackageName : GetFName();
+	}
+	/** sets the name clients know this package by, for packages loaded from a file of another name */
+	FORCEINLINE void SetNetPackageName(FName InNetPackageName)
+	{
+		NetPackageName = InNetPackageName;
+	}
 
 	///////////////////////////////////////////////////////////////////////////
 	// SCC functions
@@ -19,6 +19,139 @@ public:
 	{}
 };
 
+/**
+ * Replication condition translated from its bytecode into a short postfix program that is evaluated
+ * natively instead of by the script VM. Only side effect free conditions are translated, i.e. instance
+ * bool, byte and int variables, constants, !, &&, || and ==/!= on ints and bools, which covers the
+ * common cases like "bNetDirty && Role==ROLE_Authority" or "bNetOwner". Anything else is left to script.
+ */
+class FRepConditionProgram
+{
+public:
+	enum { MAX_OPS		= 16 };
+	enum { MAX_STACK	= 8 };
+
+	/** Operations, operands are popped off and results pushed onto the evaluation stack. */
+	enum EOpcode
+	{
+		REPOP_Bool,			// Push bool variable at Offset masked by Value.
+		REPOP_Byte,			// Push byte variable at Offset.
+		REPOP_Int,			// Push int variable at Offset.
+		REPOP_Const,		// Push Value.
+		REPOP_Not,			// Logical not of top of stack.
+		REPOP_And,			// Logical and of top two entries.
+		REPOP_Or,			// Logical or of top two entries.
+		REPOP_Equal,		// Compare top two entries for equality.
+		REPOP_NotEqual,		// Compare top two entries for inequality.
+	};
+
+	/** Single operation. */
+	struct FOp
+	{
+		/** EOpcode of operation. */
+		BYTE	Opcode;
+		/** Offset of variable in object. */
+		INT		Offset;
+		/** Bitmask for bool variables, value for constants. */
+		DWORD	Value;
+	};
+
+	/** Constructor, initializing the program as not translated. */
+	FRepConditionProgram()
+	:	NumOps( 0 )
+	{}
+
+	/**
+	 * Translates the replication condition of the passed in property.
+	 *
+	 * @param	RepOwner	property owning the replication condition
+	 * @return	TRUE if the condition could be translated, FALSE if it has to be run by the script VM
+	 */
+	UBOOL Compile( UProperty* RepOwner );
+
+	/** @return TRUE if the condition was translated and can be evaluated with Evaluate */
+	UBOOL IsCompiled() const
+	{
+		return NumOps > 0;
+	}
+
+	/**
+	 * Evaluates the translated condition.
+	 *
+	 * @param	Object	object to evaluate condition for
+	 * @return	result of the condition
+	 */
+	UBOOL Evaluate( const BYTE* Object ) const
+	{
+		checkSlow(IsCompiled());
+		INT Stack[MAX_STACK];
+		INT Top = 0;
+		for( INT OpIndex=0; OpIndex<NumOps; OpIndex++ )
+		{
+			const FOp& Op = Ops[OpIndex];
+			switch( Op.Opcode )
+			{
+			case REPOP_Bool:
+				Stack[Top++] = (*(BITFIELD*)(Object + Op.Offset) & Op.Value) ? 1 : 0;
+				break;
+			case REPOP_Byte:
+				Stack[Top++] = Object[Op.Offset];
+				break;
+			case REPOP_Int:
+				Stack[Top++] = *(INT*)(Object + Op.Offset);
+				break;
+			case REPOP_Const:
+				Stack[Top++] = (INT)Op.Value;
+				break;
+			case REPOP_Not:
+				Stack[Top-1] = !Stack[Top-1];
+				break;
+			case REPOP_And:
+				Top--;
+				Stack[Top-1] = Stack[Top-1] && Stack[Top];
+				break;
+			case REPOP_Or:
+				Top--;
+				Stack[Top-1] = Stack[Top-1] || Stack[Top];
+				break;
+			case REPOP_Equal:
+				Top--;
+				Stack[Top-1] = Stack[Top-1] == Stack[Top];
+				break;
+			case REPOP_NotEqual:
+				Top--;
+				Stack[Top-1] = Stack[Top-1] != Stack[Top];
+				break;
+			}
+		}
+		checkSlow(Top==1);
+		return Stack[0] != 0;
+	}
+
+private:
+	/**
+	 * Translates a single expression and its operands, appending the operations to the program.
+	 *
+	 * @param	Script		bytecode of the class owning the condition
+	 * @param	iCode		[in/out] position of expression in bytecode, advanced past it
+	 * @param	StackSize	[in/out] current size of the evaluation stack
+	 * @return	TRUE if the expression could be translated
+	 */
+	UBOOL CompileExpr( const TArray<BYTE>& Script, INT& iCode, INT& StackSize );
+
+	/**
+	 * Appends an operation to the program.
+	 *
+	 * @return	TRUE if there was room for the operation
+	 */
+	UBOOL AddOp( BYTE Opcode, INT Offset=0, DWORD Value=0 );
+
+	/** Operations of the program. */
+	FOp		Ops[MAX_OPS];
+	/** Number of operations in use, 0 if the condition isn't translated. */
+	INT		NumOps;
+};
+
 //
 // Information about a class, cached for network coordination.
 //
@@ -51,6 +184,16 @@ public:
 				return &C->Fields(Index-C->FieldsBase);
 		return NULL;
 	}
+	/**
+	 * Returns the replication condition translated for native evaluation.
+	 *
+	 * @param	ConditionIndex	index of condition, as in FFieldNetCache
+	 * @return	translated condition, needs to be checked with IsCompiled before evaluating it
+	 */
+	const FRepConditionProgram& GetRepCondition( INT ConditionIndex )
+	{
+		return RepConditions(ConditionIndex);
+	}
 	TArray<FFieldNetCache*> RepProperties;
 private:
 	INT FieldsBase;
@@ -59,6 +202,8 @@ private:
 	UClass* Class;
 	TArray<FFieldNetCache> Fields;
 	TMap<UObject*,FFieldNetCache*> FieldMap;
+	/** Translated replication conditions, indexed by condition index. */
+	TArray<FRepConditionProgram> RepConditions;
 };
 
 //
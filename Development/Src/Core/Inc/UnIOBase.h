@@ -434,12 +434,19 @@ protected:
 	virtual INT PlatformGetNextRequestIndex() = 0;
 
 	/**
-	 * Fulfills a compressed read request in a blocking fashion by falling back to using
-	 * PlatformSeek and various PlatformReads in combination with FAsyncUncompress to allow
-	 * decompression while we are waiting for file I/O.
+	 * Fulfills a compressed read request in a blocking fashion by reading compressed chunks one
+	 * after another and decompressing a window of them in parallel with FAsyncUncompressPipeline.
 	 */
 	void FulfillCompressedRead( const FAsyncIORequest& IORequest );
 
+	/**
+	 * Picks the next outstanding request, if there is one, and fulfills it in a blocking fashion.
+	 * Safe to be called from several threads at once as long as PlatformRead is.
+	 *
+	 * @return	TRUE if a request was fulfilled, FALSE if there was nothing to do
+	 */
+	UBOOL FulfillNextRequest();
+
 	/**
 	 * Retrieves cached file handle or caches it if it hasn't been already
 	 *
@@ -567,6 +574,93 @@ struct FAsyncIOSystemWindows : public FAsyncIOSystemBase
 };
 #endif	
 
+/*-----------------------------------------------------------------------------
+	FAsyncIOSystemLinux
+-----------------------------------------------------------------------------*/
+
+#if __LINUX__
+/**
+ * Linux specific implementation of async IO system. Uses pread so that a pool of reader threads
+ * can share file handles and keep several reads in flight, with requests ordered by file offset.
+ */
+struct FAsyncIOSystemLinux : public FAsyncIOSystemBase
+{
+	/** Constructor, initializing member variables. */
+	FAsyncIOSystemLinux();
+
+	/**
+	 * Initializes the base and spawns the additional reader threads.
+	 *
+	 * @return True if initialization was successful, false otherwise
+	 */
+	virtual UBOOL Init();
+
+	/**
+	 * Stops and destroys the reader threads before cleaning up the base.
+	 */
+	virtual void Exit();
+
+	/** 
+	 * Reads passed in number of bytes from passed in file handle.
+	 *
+	 * @param	FileHandle	Handle of file to read from.
+	 * @param	Offset		Offset in bytes from start, INDEX_NONE if file pointer shouldn't be changed
+	 * @param	Size		Size in bytes to read at current position from passed in file handle
+	 * @param	Dest		Pointer to data to read into
+	 *
+	 * @return	TRUE if read was successful, FALSE otherwise
+	 */
+	virtual UBOOL PlatformRead( FAsyncIOHandle FileHandle, INT Offset, INT Size, void* Dest );
+
+	/** 
+	 * Creates a file handle for the passed in file name
+	 *
+	 * @param	FileName	Pathname to file
+	 *
+	 * @return	INVALID_HANDLE if failure, handle on success
+	 */
+	virtual FAsyncIOHandle PlatformCreateHandle( const TCHAR* FileName );
+
+	/**
+	 * Closes passed in file handle.
+	 */
+	virtual void PlatformDestroyHandle( FAsyncIOHandle FileHandle );
+
+	/**
+	 * Returns whether the passed in handle is valid or not.
+	 *
+	 * @param	FileHandle	File hande to check validity
+	 *
+	 * @return	TRUE if file handle is valid, FALSE otherwise
+	 */
+	virtual UBOOL PlatformIsHandleValid( FAsyncIOHandle FileHandle );
+
+	/**
+	 * Determines the next request index to be fulfilled. Of the highest priority requests, the one
+	 * closest after the end of the last read in the same file is picked to avoid seeking, falling
+	 * back to the oldest one.
+	 *
+	 * This function is being called while there is a scope lock on the critical section so it
+	 * needs to be fast in order to not block QueueIORequest and the likes.
+	 *
+	 * @return	index of next to be fulfilled request or INDEX_NONE if there is none
+	 */
+	virtual INT PlatformGetNextRequestIndex();
+
+private:
+	friend class FAsyncIOReaderLinux;
+
+	/** Runnables of the additional reader threads, the IO system thread itself being the first reader.	*/
+	TArray<class FAsyncIOReaderLinux*>	Readers;
+	/** Additional reader threads.																			*/
+	TArray<FRunnableThread*>			ReaderThreads;
+	/** File the last picked request reads from.															*/
+	FString								LastFileName;
+	/** Offset the last picked request ends at.																*/
+	INT									LastReadEnd;
+};
+#endif
+
 /*-----------------------------------------------------------------------------
 	FAsyncIOSystemXenon
 -----------------------------------------------------------------------------*/
@@ -728,6 +728,11 @@ public:
 	 */
 	virtual ULinker* GetLinker() { return this; }
 
+	/**
+	 * Returns the memory mapped file the loader reads from, if any.
+	 */
+	virtual FMappedFile* GetMappedFile();
+
 	/**
 	 * Creates and returns a ULinkerLoad object.
 	 *
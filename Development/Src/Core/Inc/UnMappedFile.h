@@ -0,0 +1,151 @@
+/*=============================================================================
+	UnMappedFile.h: Memory mapped files and the archive reading from them.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#ifndef _UNMAPPEDFILE_H
+#define _UNMAPPEDFILE_H
+
+/*-----------------------------------------------------------------------------
+	FMappedFile.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Read-only, reference counted mapping of a whole file. Pages are shared with every other process
+ * mapping the same file so several servers loading the same packages only pay for them once.
+ *
+ * Data pointing into a mapping keeps it alive by holding a reference. The owner of such a pointer
+ * can find the mapping again via FindContaining. That takes a lock, so owners should remember
+ * whether their pointer is mapped (e.g. BULKDATA_Mapped) and only look it up if it is.
+ */
+class FMappedFile
+{
+public:
+	/**
+	 * Maps the passed in file.
+	 *
+	 * @param	Filename	file to map
+	 * @return	mapping holding a single reference, NULL if the file could not be mapped
+	 */
+	static FMappedFile* Open( const TCHAR* Filename );
+
+	/**
+	 * Returns the mapping the passed in pointer points into.
+	 *
+	 * @param	Ptr		pointer to look up
+	 * @return	mapping containing Ptr, NULL if Ptr doesn't point into any mapping
+	 */
+	static FMappedFile* FindContaining( const void* Ptr );
+
+	/** Adds a reference to the mapping. */
+	void AddRef()
+	{
+		RefCount.Increment();
+	}
+
+	/** Removes a reference and unmaps the file once the last one is gone. */
+	void Release();
+
+	/** @return pointer to the first byte of the file */
+	const BYTE* GetData() const
+	{
+		return Data;
+	}
+
+	/** @return size of the file in bytes */
+	INT GetSize() const
+	{
+		return Size;
+	}
+
+	/** @return name of the mapped file */
+	const FString& GetFilename() const
+	{
+		return Filename;
+	}
+
+private:
+	/** Constructor, only called by Open. */
+	FMappedFile( const TCHAR* InFilename, BYTE* InData, INT InSize, void* InPlatformHandle );
+	/** Destructor, unmapping the file. Only called by Release. */
+	~FMappedFile();
+
+	/**
+	 * Platform specific mapping of a file.
+	 *
+	 * @param	Filename		absolute path of file to map
+	 * @param	OutData			receives the start of the mapping
+	 * @param	OutSize			receives the size of the mapping
+	 * @param	OutPlatformHandle	receives the handle needed to unmap the file
+	 * @return	TRUE if successful, FALSE otherwise
+	 */
+	static UBOOL PlatformMap( const TCHAR* Filename, BYTE*& OutData, INT& OutSize, void*& OutPlatformHandle );
+
+	/** Platform specific unmapping of a file mapped by PlatformMap. */
+	static void PlatformUnmap( BYTE* Data, INT Size, void* PlatformHandle );
+
+	/** Number of references, the mapping is destroyed when this reaches zero. */
+	FThreadSafeCounter	RefCount;
+	/** Start of the mapping. */
+	BYTE*				Data;
+	/** Size of the mapping in bytes. */
+	INT					Size;
+	/** Platform specific handle needed to unmap the file. */
+	void*				PlatformHandle;
+	/** Name of the mapped file, for debugging. */
+	FString				Filename;
+};
+
+/*-----------------------------------------------------------------------------
+	FArchiveMapped.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Loading archive reading from a memory mapped file. Reads are plain copies out of the mapping and
+ * bulk data can reference the mapping directly. Compressed packages are not supported and fall back
+ * to FArchiveAsync as SetCompressionMap returns FALSE.
+ */
+class FArchiveMapped : public FArchive
+{
+public:
+	/**
+	 * Constructor, mapping the passed in file. Sets the error state if mapping failed.
+	 *
+	 * @param	InFilename	file to map
+	 */
+	FArchiveMapped( const TCHAR* InFilename );
+
+	/** Destructor, releasing the mapping. */
+	virtual ~FArchiveMapped();
+
+	// FArchive interface.
+	virtual UBOOL Close();
+	virtual void Serialize( void* Data, INT Num );
+	virtual INT Tell()
+	{
+		return CurrentPos;
+	}
+	virtual INT TotalSize()
+	{
+		return MappedFile ? MappedFile->GetSize() : 0;
+	}
+	virtual void Seek( INT InPos )
+	{
+		checkf( InPos >= 0 && InPos <= TotalSize(), TEXT("Seek to %i outside of %s"), InPos, *Filename );
+		CurrentPos = InPos;
+	}
+	virtual FMappedFile* GetMappedFile()
+	{
+		return MappedFile;
+	}
+
+private:
+	/** Mapping we read from, NULL if mapping failed or after Close. */
+	FMappedFile*	MappedFile;
+	/** Current position of archive. */
+	INT				CurrentPos;
+	/** Name of the file, for debugging. */
+	FString			Filename;
+};
+
+#endif	// _UNMAPPEDFILE_H
@@ -196,6 +196,10 @@ struct FIntPoint
 	{
 		return INT( appSqrt( FLOAT(X*X + Y*Y) ) );
 	}
+	friend DWORD GetTypeHash( const FIntPoint& Point )
+	{
+		return (DWORD)Point.X * 73856093 ^ (DWORD)Point.Y * 19349663;
+	}
 };
 
 /*-----------------------------------------------------------------------------
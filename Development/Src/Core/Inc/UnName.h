@@ -13,6 +13,19 @@ enum {NAME_SIZE	= 128};
 /** Name index. */
 typedef INT NAME_INDEX;
 
+/** Number of name entry pointers per chunk of the name table. Chunks are never reallocated so entries can be looked up without locking. */
+enum {NAME_TABLE_CHUNK_SIZE	= 16384};
+
+/** Maximum number of chunks of the name table, allowing for 4M names. */
+enum {MAX_NAME_TABLE_CHUNKS	= 256};
+
+/** Number of bins of the name hash. Has to be a power of two. */
+#if CONSOLE
+enum {NAME_HASH_SIZE		= 16384};
+#else
+enum {NAME_HASH_SIZE		= 65536};
+#endif
+
 /** Externally, the instance number to represent no instance number is NAME_NO_NUMBER, 
     but internally, we add 1 to indices, so we use this #define internally for 
 	zero'd memory initialization will still make NAME_None as expected */
@@ -54,10 +67,13 @@ struct FNameEntry
 	/** Index of name in hash. */
 	NAME_INDEX		Index;
 
+	/** Case insensitive hash of Name, computed once when the entry is allocated and compared before the string is. */
+	DWORD			Hash;
+
 	/** RF_TagImp, RF_TagExp */
 	EObjectFlags	Flags;
 
-	/** Pointer to the next entry in this hash bin's linked list. */
+	/** Pointer to the next entry in this hash bin's linked list. Never changes once the entry is published. */
 	FNameEntry*		HashNext;
 
 	/** Name, variable-sized - note that AllocateNameEntry only allocates memory as needed. */
@@ -98,7 +114,7 @@ struct FNameEntry
 
 	// Functions.
 	friend FArchive& operator<<( FArchive& Ar, FNameEntry& E );
-	friend FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, EObjectFlags Flags, FNameEntry* HashNext );
+	friend FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Hash, DWORD Index, EObjectFlags Flags, FNameEntry* HashNext );
 };
 
 /*----------------------------------------------------------------------------
@@ -122,14 +138,17 @@ public:
 	//@{
 	NAME_INDEX GetIndex() const
 	{
-		checkName(Index < Names.Num());
-		checkName(Names(Index));
+		checkName(Index < NumNames);
+		checkName(GetEntry(Index));
 		return Index;
 	}
-	INT GetNumber() const;
+	INT GetNumber() const
+	{
+		return Number;
+	}
 	const TCHAR* GetName() const
 	{
-		return Names(Index)->Name;
+		return GetEntry(Index)->Name;
 	}
 	//@}
 
@@ -160,25 +179,25 @@ public:
 	 */
 	UBOOL HasAnyFlags( EObjectFlags FlagToCheck ) const
 	{
-		return Names(Index)->HasAnyFlags( FlagToCheck );
+		return GetEntry(Index)->HasAnyFlags( FlagToCheck );
 	}
 	EObjectFlags GetFlags() const
 	{
-		checkName(Index < Names.Num());
-		checkName(Names(Index));
-		return Names(Index)->Flags;
+		checkName(Index < NumNames);
+		checkName(GetEntry(Index));
+		return GetEntry(Index)->Flags;
 	}
 	void SetFlags( EObjectFlags Set ) const
 	{
-		checkName(Index < Names.Num());
-		checkName(Names(Index));
-		Names(Index)->SetFlags( Set );
+		checkName(Index < NumNames);
+		checkName(GetEntry(Index));
+		GetEntry(Index)->SetFlags( Set );
 	}
 	void ClearFlags( EObjectFlags Clear ) const
 	{
-		checkName(Index < Names.Num());
-		checkName(Names(Index));
-		Names(Index)->ClearFlags( Clear );
+		checkName(Index < NumNames);
+		checkName(GetEntry(Index));
+		GetEntry(Index)->ClearFlags( Clear );
 	}
 	//@}
 
@@ -192,7 +211,7 @@ public:
 	}
 	UBOOL IsValid() const
 	{
-		return Index>=0 && Index<Names.Num() && Names(Index)!=NULL;
+		return Index>=0 && Index<NumNames && GetEntry(Index)!=NULL;
 	}
 
 	/**
@@ -269,7 +288,7 @@ public:
 	static FString SafeString( EName Index, INT InstanceNumber=NAME_NO_NUMBER_INTERNAL )
 	{
 		return GetIsInitialized()
-			? (Names.IsValidIndex(Index) && Names(Index))
+			? (Index >= 0 && Index < NumNames && GetEntry(Index))
 				? FName(Index, InstanceNumber).ToString()
 				: FString(TEXT("Invalid"))
 			: FString(TEXT("Uninitialized"));
@@ -281,12 +300,15 @@ public:
 #else
 #define RF_Suppress				DECLARE_UINT64(0x0000100000000000)		// @warning: Mirrored in UnObjBas.h. Suppressed log name.
 #endif
-		return GetIsInitialized() && (Names(Index)->Flags & RF_Suppress);
+		return GetIsInitialized() && (GetEntry(Index)->Flags & RF_Suppress);
 #undef RF_Suppress
 	}
+	/**
+	 * @return Number of name indices handed out so far. Entries of indices below this are only NULL for unused hardcoded indices.
+	 */
 	static INT GetMaxNames()
 	{
-		return Names.Num();
+		return NumNames;
 	}
 	/**
 	 * @return Size of all name entries.
@@ -295,9 +317,16 @@ public:
 	{
 		return NameEntryMemorySize;
 	}
+	/**
+	 * Looks up a name entry by index. Safe to call from any thread while names are being added.
+	 *
+	 * @param	i	name index
+	 * @return	the entry or NULL if the index has not been populated yet
+	 */
 	static FNameEntry* GetEntry( int i )
 	{
-		return Names(i);
+		FNameEntry** Chunk = NameChunks[i / NAME_TABLE_CHUNK_SIZE];
+		return Chunk ? Chunk[i % NAME_TABLE_CHUNK_SIZE] : NULL;
 	}
 	static UBOOL GetInitialized()
 	{
@@ -336,10 +365,12 @@ private:
 	/** Number portion of the string/number pair (stored internally as 1 more than actual, so zero'd memory will be the default, no-instance case) */
 	INT			Number;
 
-	// Static subsystem variables.
-	/** Table of all names. This is a NoInit because we may need to use it before the constructor is called due to random static variable initialization order */
-	static TArrayNoInit<FNameEntry*>	Names;					// Table of all names.
-	static FNameEntry*					NameHash[4096];			// Hashed names.
+	// Static subsystem variables. These are plain arrays rather than TArrays so they are zero initialized before any
+	// constructor runs, and so that no reallocation can ever move them underneath a thread reading them.
+	/** Table of all names, indexed by name index and split into chunks which are allocated on demand */
+	static FNameEntry**					NameChunks[MAX_NAME_TABLE_CHUNKS];
+	static INT							NumNames;				// Number of name indices handed out.
+	static FNameEntry*					NameHash[NAME_HASH_SIZE];	// Hashed names.
 	static INT							NameEntryMemorySize;	// Size of all name entries.
 
 	/**
@@ -356,7 +387,7 @@ private:
 	friend const TCHAR* DebugFName(INT, INT);
 	friend const TCHAR* DebugFName(FName&);
 	friend const TCHAR* DebugFName(UObject*);
-	friend FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, EObjectFlags Flags, FNameEntry* HashNext );
+	friend FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Hash, DWORD Index, EObjectFlags Flags, FNameEntry* HashNext );
 
 	/**
 	 * Shared initialization code (between two constructors)
@@ -368,13 +399,22 @@ private:
 	 */
 	void Init(const TCHAR* InName, INT InNumber, EFindName FindType, UBOOL bSplitName=TRUE);
 
+	/**
+	 * Stores an entry in the name table, allocating the chunk holding its index if needed.
+	 *
+	 * @param	Index	name index to store the entry at
+	 * @param	Entry	entry to store
+	 */
+	static void SetEntry( NAME_INDEX Index, FNameEntry* Entry );
+
 public:
 	/**
-	 * This function is only for use by the debugger FName add-in; it should never be called from code
+	 * This function is only for use by the debugger FName add-in; it should never be called from code.
+	 * Entry i is GetPureNamesTable()[i / NAME_TABLE_CHUNK_SIZE][i % NAME_TABLE_CHUNK_SIZE].
 	 */
-	static TArray<FNameEntry*>&	GetPureNamesTable(void)
+	static FNameEntry** const* GetPureNamesTable(void)
 	{
-		return FName::Names;
+		return FName::NameChunks;
 	}
 };
 inline DWORD GetTypeHash( const FName N )
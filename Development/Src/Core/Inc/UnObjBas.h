@@ -739,37 +739,6 @@ namespace UE3
 	};
 }
 
-/**
- * The object hash size to use
- *
- * NOTE: This must be power of 2 so that (size - 1) turns on all bits!
- */
-#define OBJECT_HASH_BINS 8192
-
-/**
- * Calculates the object's hash just using the object's name index
- *
- * @param ObjName the object's name to use the index of
- */
-FORCEINLINE INT GetObjectHash(FName ObjName)
-{
-	return (ObjName.GetIndex() ^ ObjName.GetNumber()) & (OBJECT_HASH_BINS - 1);
-}
-
-/**
- * Calculates the object's hash just using the object's name index
- * XORed with the outer. Yields much better spread in the hash
- * buckets, but requires knowledge of the outer, which isn't available
- * in all cases.
- *
- * @param ObjName the object's name to use the index of
- * @param Outer the object's outer pointer treated as an INT
- */
-FORCEINLINE INT GetObjectOuterHash(FName ObjName,INT Outer)
-{
-	return ((ObjName.GetIndex() ^ ObjName.GetNumber()) ^ Outer) & (OBJECT_HASH_BINS - 1);
-}
-
 //
 // The base class of all objects.
 //
@@ -787,6 +756,7 @@ class UObject
 	friend class ULinkerSave;
 	friend class UPackageMap;
 	friend class FArchiveRealtimeGC;
+	friend class FObjectHash;
 	friend struct FObjectImport;
 	friend struct FObjectExport;
 	friend class UWorld;
@@ -807,10 +777,10 @@ private:
 	/** Flags used to track and report various object states. This needs to be 8 byte aligned! */
 	EObjectFlags					ObjectFlags;
 
-	/** Next object in this hash bin. */
+	/** Next object with the same name, see FObjectHash. */
 	UObject*						HashNext;
 
-	/** Next object in the hash bin that includes outers */
+	/** Next object with the same outer, see FObjectHash. */
 	UObject*						HashOuterNext;
 
 	/** Main script execution stack. */
@@ -865,10 +835,8 @@ private:
 	static INT						GImportCount;
 	/** Forced exports for EndLoad optimization.							*/
 	static INT						GForcedExportCount;
-	/** Object hash.														*/
-	static UObject*					GObjHash[OBJECT_HASH_BINS];
-	/** Object hash that also uses the outer								*/
-	static UObject*					GObjHashOuter[OBJECT_HASH_BINS];
+	/** Object hash, finding objects by name and outer.					*/
+	static FObjectHash				GObjHash;
 	/** Objects to automatically register.									*/
 	static UObject*					GAutoRegister;
 	/** Objects that might need preloading.									*/
@@ -1238,6 +1206,14 @@ public:
 	static UObject* StaticFindObjectFast( UClass* Class, UObject* InOuter, FName InName, UBOOL ExactClass=0, UBOOL AnyPackage=0, EObjectFlags ExclusiveFlags=0 );
 	static UObject* StaticFindObject( UClass* Class, UObject* InOuter, const TCHAR* Name, UBOOL ExactClass=0 );
 	static UObject* StaticFindObjectChecked( UClass* Class, UObject* InOuter, const TCHAR* Name, UBOOL ExactClass=0 );
+	/**
+	 * Gathers the objects inside an outer using the object hash instead of iterating over all objects.
+	 *
+	 * @param	Outer					Outer to find the objects of
+	 * @param	Results					Receives the objects, appended to any existing entries
+	 * @param	bIncludeNestedObjects	If TRUE, objects inside the found objects are gathered as well
+	 */
+	static void GetObjectsWithOuter( const UObject* Outer, TArray<UObject*>& Results, UBOOL bIncludeNestedObjects=TRUE );
 	/**
 	 * Find or load an object by string name with optional outer and filename specifications.
 	 * These are optional because the InName can contain all of the necessary information.
@@ -1852,6 +1828,13 @@ public:
 		ObjectFlags &= ~NewFlags;
 		checkSlow(Name!=NAME_None || !(ObjectFlags&RF_Public));
 	}
+	/**
+	 * Atomically clears RF_Unreachable. Used by the parallel GC mark phase where several threads can
+	 * reach the same object at once and exactly one of them has to take ownership of it.
+	 *
+	 * @return TRUE if this call cleared the flag, FALSE if it was already clear
+	 */
+	UBOOL ThisThreadAtomicallyClearedRFUnreachable();
 	/**
 	 * Used to safely check whether any of the passed in flags are set. This is required
 	 * as EObjectFlags currently is a 64 bit data type and UBOOL is a 32 bit data type so
@@ -2181,6 +2164,22 @@ public:
 	DECLARE_FUNCTION(execStructCmpEq);
 	DECLARE_FUNCTION(execStructCmpNe);
 	DECLARE_FUNCTION(execStructMember);
+	DECLARE_FUNCTION(execFusedStructMember);
+	DECLARE_FUNCTION(execFusedJumpIfNotIntCmp);
+	DECLARE_FUNCTION(execFusedIntAdd);
+	DECLARE_FUNCTION(execFusedIntSubtract);
+	DECLARE_FUNCTION(execFusedIntMultiply);
+	DECLARE_FUNCTION(execFusedIntDivide);
+	DECLARE_FUNCTION(execFusedIntPreIncrement);
+	DECLARE_FUNCTION(execFusedIntPreDecrement);
+	DECLARE_FUNCTION(execFusedIntPostIncrement);
+	DECLARE_FUNCTION(execFusedIntPostDecrement);
+	DECLARE_FUNCTION(execFusedFloatAdd);
+	DECLARE_FUNCTION(execFusedFloatSubtract);
+	DECLARE_FUNCTION(execFusedFloatMultiply);
+	DECLARE_FUNCTION(execFusedFloatDivide);
+	DECLARE_FUNCTION(execProfiledNative);
+	DECLARE_FUNCTION(execProfiledHighNative);
 	DECLARE_FUNCTION(execIntConst);
 	DECLARE_FUNCTION(execFloatConst);
 	DECLARE_FUNCTION(execStringConst);
@@ -0,0 +1,445 @@
+/*=============================================================================
+	UnObjHash.h: Open addressed object hash tables.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#ifndef _UNOBJHASH_H
+#define _UNOBJHASH_H
+
+/**
+ * Hashes an object name and outer pointer into a well distributed 32 bit value.
+ *
+ * @param ObjName	the object's name
+ * @param Outer		the object's outer pointer, not dereferenced
+ * @return hash value, not yet masked to a table size
+ */
+FORCEINLINE DWORD GetObjectHash( FName ObjName, const UObject* Outer )
+{
+	DWORD Hash = (DWORD)ObjName.GetIndex() * 0x9E3779B1;
+	Hash ^= (DWORD)ObjName.GetNumber() * 0x85EBCA77;
+	// Objects are at least 8 byte aligned so the low bits of the outer carry no information.
+	Hash ^= (DWORD)(((PTRINT)Outer) >> 3) * 0xC2B2AE3D;
+	return Hash ^ (Hash >> 16);
+}
+
+/**
+ * Hash table using open addressing with linear probing. Entries live inline in a single
+ * power of two sized allocation so probing never leaves the table. Removal shifts
+ * following entries back into the hole instead of leaving tombstones, and the table
+ * doubles in size once it is half full.
+ *
+ * EntryType needs to be a plain struct providing
+ *		UBOOL IsFree() const				- whether the slot is unused, zeroed memory has to be free
+ *		DWORD GetHash() const				- hash of the entry's key
+ *		UBOOL Matches( const KeyType& )		- whether the entry's key matches
+ * Several entries can share a key, iterate them with FindFirst/FindNext.
+ */
+template<typename EntryType>
+class TLinearProbingHash
+{
+public:
+	/** Constructor, initializing the table to empty without allocating */
+	TLinearProbingHash()
+	:	Entries( NULL )
+	,	HashSize( 0 )
+	,	NumEntries( 0 )
+	{}
+
+	/** Destructor, freeing the entries */
+	~TLinearProbingHash()
+	{
+		appFree( Entries );
+	}
+
+	/**
+	 * Removes all entries and resizes the table.
+	 *
+	 * @param InHashSize	new number of slots, needs to be a power of two or 0 to free all memory
+	 */
+	void Empty( INT InHashSize )
+	{
+		checkSlow( (InHashSize & (InHashSize - 1)) == 0 );
+		appFree( Entries );
+		HashSize	= InHashSize;
+		NumEntries	= 0;
+		Entries		= NULL;
+		if( HashSize > 0 )
+		{
+			Entries = (EntryType*) appMalloc( HashSize * sizeof(EntryType) );
+			appMemzero( Entries, HashSize * sizeof(EntryType) );
+		}
+	}
+
+	/**
+	 * Finds the first entry matching a key.
+	 *
+	 * @param Key		key to look for
+	 * @param KeyHash	hash of the key, as returned by EntryType::GetHash for a matching entry
+	 * @return slot index of the entry or INDEX_NONE if there is none
+	 */
+	template<typename KeyType>
+	FORCEINLINE INT FindFirst( const KeyType& Key, DWORD KeyHash ) const
+	{
+		return Probe( Key, KeyHash & (HashSize - 1) );
+	}
+
+	/**
+	 * Finds the next entry matching a key.
+	 *
+	 * @param Key		key to look for
+	 * @param SlotIndex	slot of the previous match as returned by FindFirst or FindNext
+	 * @return slot index of the entry or INDEX_NONE if there are no more
+	 */
+	template<typename KeyType>
+	FORCEINLINE INT FindNext( const KeyType& Key, INT SlotIndex ) const
+	{
+		return Probe( Key, (SlotIndex + 1) & (HashSize - 1) );
+	}
+
+	/**
+	 * Adds an entry without checking for existing entries with the same key.
+	 *
+	 * @param Entry	entry to add
+	 * @return slot index the entry was added at, only valid until the table changes
+	 */
+	INT Add( const EntryType& Entry )
+	{
+		// Keep the load factor at or below 1/2 which keeps probe sequences short and guarantees free slots.
+		if( (NumEntries + 1) * 2 > HashSize )
+		{
+			Resize( Max( HashSize * 2, 1024 ) );
+		}
+		INT SlotIndex = Entry.GetHash() & (HashSize - 1);
+		while( !Entries[SlotIndex].IsFree() )
+		{
+			SlotIndex = (SlotIndex + 1) & (HashSize - 1);
+		}
+		Entries[SlotIndex] = Entry;
+		NumEntries++;
+		return SlotIndex;
+	}
+
+	/**
+	 * Removes the entry at a slot, moving back entries of the same probe sequence.
+	 *
+	 * @param SlotIndex	slot to free as returned by FindFirst/FindNext
+	 */
+	void RemoveAt( INT SlotIndex )
+	{
+		checkSlow( !Entries[SlotIndex].IsFree() );
+		const INT HashMask = HashSize - 1;
+		INT HoleIndex = SlotIndex;
+		for( INT NextIndex = (HoleIndex + 1) & HashMask; !Entries[NextIndex].IsFree(); NextIndex = (NextIndex + 1) & HashMask )
+		{
+			// The entry can fill the hole if the hole lies between its home slot and its current slot.
+			const INT HomeIndex = Entries[NextIndex].GetHash() & HashMask;
+			if( ((NextIndex - HomeIndex) & HashMask) >= ((NextIndex - HoleIndex) & HashMask) )
+			{
+				Entries[HoleIndex] = Entries[NextIndex];
+				HoleIndex = NextIndex;
+			}
+		}
+		appMemzero( &Entries[HoleIndex], sizeof(EntryType) );
+		NumEntries--;
+	}
+
+	/**
+	 * @return entry at a slot index returned by FindFirst/FindNext/Add
+	 */
+	FORCEINLINE EntryType& GetEntry( INT SlotIndex )
+	{
+		checkSlow( SlotIndex >= 0 && SlotIndex < HashSize );
+		return Entries[SlotIndex];
+	}
+	FORCEINLINE const EntryType& GetEntry( INT SlotIndex ) const
+	{
+		checkSlow( SlotIndex >= 0 && SlotIndex < HashSize );
+		return Entries[SlotIndex];
+	}
+
+	/** @return number of entries in the table */
+	INT Num() const
+	{
+		return NumEntries;
+	}
+
+	/** @return number of slots in the table */
+	INT GetHashSize() const
+	{
+		return HashSize;
+	}
+
+	/** @return allocated size in bytes */
+	DWORD GetAllocatedSize() const
+	{
+		return HashSize * sizeof(EntryType);
+	}
+
+	/**
+	 * Gathers probe length statistics, walking the whole table.
+	 *
+	 * @param OutAverageProbeLength	average number of slots visited to find an existing entry
+	 * @param OutMaxProbeLength		worst case number of slots visited to find an existing entry
+	 */
+	void GetProbeStats( FLOAT& OutAverageProbeLength, INT& OutMaxProbeLength ) const
+	{
+		QWORD TotalProbeLength = 0;
+		OutMaxProbeLength = 0;
+		for( INT SlotIndex = 0; SlotIndex < HashSize; SlotIndex++ )
+		{
+			if( !Entries[SlotIndex].IsFree() )
+			{
+				const INT ProbeLength = ((SlotIndex - (INT)Entries[SlotIndex].GetHash()) & (HashSize - 1)) + 1;
+				TotalProbeLength += ProbeLength;
+				OutMaxProbeLength = Max( OutMaxProbeLength, ProbeLength );
+			}
+		}
+		OutAverageProbeLength = NumEntries ? (FLOAT)((DOUBLE)TotalProbeLength / NumEntries) : 0.f;
+	}
+
+private:
+	/**
+	 * Walks the probe sequence starting at a slot until a matching entry or a free slot is found.
+	 *
+	 * @param Key			key to look for
+	 * @param SlotIndex		slot to start at
+	 * @return slot index of the matching entry or INDEX_NONE
+	 */
+	template<typename KeyType>
+	FORCEINLINE INT Probe( const KeyType& Key, INT SlotIndex ) const
+	{
+		if( NumEntries > 0 )
+		{
+			// The load factor guarantees a free slot so this terminates.
+			while( !Entries[SlotIndex].IsFree() )
+			{
+				if( Entries[SlotIndex].Matches( Key ) )
+				{
+					return SlotIndex;
+				}
+				SlotIndex = (SlotIndex + 1) & (HashSize - 1);
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	/**
+	 * Reallocates the table and reinserts all entries.
+	 *
+	 * @param NewHashSize	new number of slots, needs to be a power of two
+	 */
+	void Resize( INT NewHashSize )
+	{
+		EntryType* OldEntries	= Entries;
+		const INT OldHashSize	= HashSize;
+		// Detach the old entries so Empty doesn't free them.
+		Entries = NULL;
+		Empty( NewHashSize );
+		for( INT SlotIndex = 0; SlotIndex < OldHashSize; SlotIndex++ )
+		{
+			if( !OldEntries[SlotIndex].IsFree() )
+			{
+				Add( OldEntries[SlotIndex] );
+			}
+		}
+		appFree( OldEntries );
+	}
+
+	/** Slot storage */
+	EntryType*	Entries;
+	/** Number of slots, always a power of two */
+	INT			HashSize;
+	/** Number of slots in use */
+	INT			NumEntries;
+};
+
+/**
+ * Global object hash. Objects are found by name and outer through an open addressed table that
+ * holds the lookup keys inline, so a lookup only touches the object it returns. Two further
+ * tables map a name and an outer to the first object of a doubly linked list of all objects
+ * with that name or outer, used by ANY_PACKAGE lookups and to iterate the children of an object.
+ * The forward links of those lists live in UObject::HashNext and UObject::HashOuterNext, the
+ * backward links in a side array indexed by UObject::Index.
+ */
+class FObjectHash
+{
+public:
+	/** Entry of the name/outer table */
+	struct FNameOuterEntry
+	{
+		FName		Name;
+		UObject*	Outer;
+		/** NULL if the slot is free */
+		UObject*	Object;
+
+		UBOOL IsFree() const
+		{
+			return Object == NULL;
+		}
+		DWORD GetHash() const
+		{
+			return GetObjectHash( Name, Outer );
+		}
+		UBOOL Matches( const FNameOuterEntry& Key ) const
+		{
+			return Name == Key.Name && Outer == Key.Outer;
+		}
+	};
+
+	/** Entry of the name and outer tables, pointing at the first object of a list */
+	struct FListHeadEntry
+	{
+		/** Name of the objects in the list, NAME_None for the outer table */
+		FName		Name;
+		/** Outer of the objects in the list, NULL for the name table */
+		UObject*	Outer;
+		/** First object in the list, NULL if the slot is free */
+		UObject*	First;
+		/** Number of objects in the list */
+		INT			Count;
+
+		UBOOL IsFree() const
+		{
+			return First == NULL;
+		}
+		DWORD GetHash() const
+		{
+			return GetObjectHash( Name, Outer );
+		}
+		UBOOL Matches( const FListHeadEntry& Key ) const
+		{
+			return Name == Key.Name && Outer == Key.Outer;
+		}
+	};
+
+	/** Backward links of the name and outer lists */
+	struct FPrevLinks
+	{
+		UObject*	PrevWithName;
+		UObject*	PrevWithOuter;
+	};
+
+	/** Initializes all tables to empty. */
+	void Init();
+
+	/** Frees all memory. */
+	void Exit();
+
+	/**
+	 * Adds an object to all tables.
+	 *
+	 * @param Object	object to add, using its current name, outer and index
+	 */
+	void Add( UObject* Object );
+
+	/**
+	 * Removes an object from all tables. The outer is never dereferenced as it might have been
+	 * destroyed already during garbage collection.
+	 *
+	 * @param Object	object to remove, with the name, outer and index it was added with
+	 */
+	void Remove( UObject* Object );
+
+	/**
+	 * Finds the first object with a given name and outer.
+	 *
+	 * @param Name		object name
+	 * @param Outer		object outer, may be NULL for top level packages
+	 * @return slot of the object in the name/outer table or INDEX_NONE, pass to FindNextNameOuter and GetNameOuterObject
+	 */
+	FORCEINLINE INT FindFirstNameOuter( FName Name, UObject* Outer ) const
+	{
+		FNameOuterEntry Key;
+		Key.Name	= Name;
+		Key.Outer	= Outer;
+		return NameOuterHash.FindFirst( Key, GetObjectHash( Name, Outer ) );
+	}
+
+	/**
+	 * Finds the next object with a given name and outer.
+	 *
+	 * @param Name		object name
+	 * @param Outer		object outer
+	 * @param SlotIndex	slot returned by the previous call to FindFirstNameOuter or FindNextNameOuter
+	 * @return slot of the object in the name/outer table or INDEX_NONE
+	 */
+	FORCEINLINE INT FindNextNameOuter( FName Name, UObject* Outer, INT SlotIndex ) const
+	{
+		FNameOuterEntry Key;
+		Key.Name	= Name;
+		Key.Outer	= Outer;
+		return NameOuterHash.FindNext( Key, SlotIndex );
+	}
+
+	/**
+	 * @return object at a slot returned by FindFirstNameOuter or FindNextNameOuter
+	 */
+	FORCEINLINE UObject* GetNameOuterObject( INT SlotIndex ) const
+	{
+		return NameOuterHash.GetEntry( SlotIndex ).Object;
+	}
+
+	/**
+	 * @return first object with the passed in name, iterate the rest with GetNextWithName
+	 */
+	UObject* GetFirstWithName( FName Name ) const;
+
+	/**
+	 * @return next object with the same name as the passed in one or NULL
+	 */
+	UObject* GetNextWithName( const UObject* Object ) const;
+
+	/**
+	 * @return first object directly inside Outer, iterate the rest with GetNextWithOuter
+	 */
+	UObject* GetFirstWithOuter( const UObject* Outer ) const;
+
+	/**
+	 * @return next object with the same outer as the passed in one or NULL
+	 */
+	UObject* GetNextWithOuter( const UObject* Object ) const;
+
+	/**
+	 * @return number of objects directly inside Outer
+	 */
+	INT GetNumWithOuter( const UObject* Outer ) const;
+
+	/**
+	 * Logs table sizes, load and probe statistics.
+	 *
+	 * @param Ar	device to log to
+	 */
+	void DumpStats( FOutputDevice& Ar ) const;
+
+private:
+	/**
+	 * Links an object into the list at a head entry, adding the head if there is none.
+	 *
+	 * @param Table		name or outer table
+	 * @param Key		key of the list
+	 * @param Object	object to link in
+	 * @param bOuter	whether this is the outer list
+	 */
+	void LinkObject( TLinearProbingHash<FListHeadEntry>& Table, const FListHeadEntry& Key, UObject* Object, UBOOL bOuter );
+
+	/**
+	 * Unlinks an object from the list at a head entry, removing the head if the list is now empty.
+	 *
+	 * @param Table		name or outer table
+	 * @param Key		key of the list
+	 * @param Object	object to unlink
+	 * @param bOuter	whether this is the outer list
+	 */
+	void UnlinkObject( TLinearProbingHash<FListHeadEntry>& Table, const FListHeadEntry& Key, UObject* Object, UBOOL bOuter );
+
+	/** Name and outer to object */
+	TLinearProbingHash<FNameOuterEntry>	NameOuterHash;
+	/** Name to list of objects with that name */
+	TLinearProbingHash<FListHeadEntry>	NameHash;
+	/** Outer to list of objects inside it */
+	TLinearProbingHash<FListHeadEntry>	OuterHash;
+	/** Backward list links indexed by UObject::Index */
+	TArray<FPrevLinks>					PrevLinks;
+};
+
+#endif
@@ -156,6 +156,198 @@ inline FString FStateFrame::Describe()
 	return Node ? Node->GetFullName() : TEXT("None");
 }
 
+/*-----------------------------------------------------------------------------
+	Script profiler.
+-----------------------------------------------------------------------------*/
+
+struct FScopedScriptProfile;
+
+/**
+ * Collects call counts and inclusive/exclusive cycles for every script function, broken down by
+ * the state it was called in. Calls are measured in ProcessEvent and CallFunction, and in the
+ * native dispatch thunks that are swapped into GNatives while profiling. With a sample rate above
+ * one only every Nth top level call tree is measured and the results are scaled up accordingly.
+ */
+class CORE_API FScriptProfiler
+{
+public:
+	/** Whether calls are being recorded. Checked inline by every instrumented call. */
+	UBOOL bIsProfiling;
+
+	/** Constructor, initializing the profiler to be idle. */
+	FScriptProfiler();
+
+	/**
+	 * Discards previously collected data and starts recording.
+	 *
+	 * @param	InSampleRate	only every InSampleRate'th top level call tree is measured
+	 */
+	void Start( INT InSampleRate=1 );
+
+	/** Stops recording, keeping the collected data around for Dump. */
+	void Stop();
+
+	/** Discards all collected data without changing whether we are recording. */
+	void Reset();
+
+	/** Advances the frame count used to average the results. Called once per engine tick. */
+	void Tick()
+	{
+		if( bIsProfiling )
+		{
+			NumFrames++;
+		}
+	}
+
+	/**
+	 * Writes the collected data to a file readable by the stats viewer and logs the most
+	 * expensive functions.
+	 *
+	 * @param	Ar	output device to log the summary to
+	 * @return	TRUE if the file was written, FALSE otherwise
+	 */
+	UBOOL Dump( FOutputDevice& Ar );
+
+	/**
+	 * Starts measuring a call. Only called while profiling.
+	 *
+	 * @param	Scope		scope to track the call with
+	 * @param	Object		object the function is called on
+	 * @param	Function	function being called
+	 */
+	void BeginCall( FScopedScriptProfile& Scope, UObject* Object, UFunction* Function );
+
+	/**
+	 * Finishes measuring a call started by BeginCall.
+	 *
+	 * @param	Scope	scope the call was tracked with
+	 */
+	void EndCall( FScopedScriptProfile& Scope );
+
+	/**
+	 * @param	iNative		native function index
+	 * @return	the function measured by the thunk installed for iNative, NULL if there is none
+	 */
+	UFunction* GetProfiledNative( INT iNative ) const
+	{
+		return NativeFunctions.Num() ? NativeFunctions(iNative) : NULL;
+	}
+
+	/**
+	 * @param	iNative		native function index
+	 * @return	the native handler for iNative, bypassing any installed thunk
+	 */
+	Native GetUnprofiledNative( INT iNative ) const
+	{
+		return OriginalNatives.Num() ? OriginalNatives(iNative) : GNatives[iNative];
+	}
+
+private:
+	/** Data collected for a function called in a given state. */
+	struct FFunctionStats
+	{
+		UFunction*	Function;
+		/** State the function was called in, NULL if the object was not in a state. */
+		UState*		State;
+		INT			NumCalls;
+		QWORD		InclusiveCycles;
+		QWORD		ExclusiveCycles;
+		/** Number of calls currently on the stack, used to avoid counting recursion twice. */
+		INT			NumActive;
+	};
+
+	/** Key used to look up FFunctionStats. */
+	struct FFunctionStatsKey
+	{
+		UFunction*	Function;
+		UState*		State;
+
+		FFunctionStatsKey( UFunction* InFunction, UState* InState )
+		:	Function( InFunction )
+		,	State( InState )
+		{}
+		UBOOL operator==( const FFunctionStatsKey& Other ) const
+		{
+			return Function == Other.Function && State == Other.State;
+		}
+		friend DWORD GetTypeHash( const FFunctionStatsKey& Key )
+		{
+			return PointerHash( Key.Function, PointerHash( Key.State ) );
+		}
+	};
+
+	/** Direct mapped cache in front of StatsMap, as the same few functions make up most calls. */
+	struct FCacheEntry
+	{
+		UFunction*	Function;
+		UState*		State;
+		INT			StatsIndex;
+	};
+	enum { CACHE_SIZE = 1024 };
+
+	/**
+	 * Finds or creates the stats for a function called in a state.
+	 *
+	 * @return	index into Stats
+	 */
+	INT FindStats( UFunction* Function, UState* State );
+
+	/** Swaps the native dispatch thunks into GNatives. */
+	void InstallNativeThunks();
+	/** Restores GNatives to the handlers present before InstallNativeThunks. */
+	void RemoveNativeThunks();
+
+	TArray<FFunctionStats>			Stats;
+	TMap<FFunctionStatsKey,INT>		StatsMap;
+	FCacheEntry						Cache[CACHE_SIZE];
+	/** Innermost call being measured, NULL outside of measured call trees. */
+	FScopedScriptProfile*			CurrentScope;
+	/** Bumped on Start and Stop so that scopes begun in another session are ignored. */
+	DWORD							Session;
+	INT								SampleRate;
+	INT								SampleCounter;
+	/** Whether we are inside a top level call tree that was skipped by sampling. */
+	UBOOL							bInSkippedTree;
+	INT								NumFrames;
+	/** Profiled function for every native index that has a thunk installed, indexed by iNative. */
+	TArray<UFunction*>				NativeFunctions;
+	/** Contents of GNatives before the thunks were installed. */
+	TArray<Native>					OriginalNatives;
+};
+
+extern CORE_API FScriptProfiler GScriptProfiler;
+
+/**
+ * Measures a script call for the duration of its scope if the script profiler is running.
+ */
+struct FScopedScriptProfile
+{
+	/** Profiler session the call was begun in, 0 if it is not being measured. */
+	DWORD					Session;
+	/** Stats the call is accumulated into, INDEX_NONE for the root of a skipped call tree. */
+	INT						StatsIndex;
+	DWORD					StartCycles;
+	/** Cycles spent in measured calls made from this one. */
+	DWORD					ChildCycles;
+	FScopedScriptProfile*	Parent;
+
+	FScopedScriptProfile( UObject* Object, UFunction* Function )
+	:	Session( 0 )
+	{
+		if( GScriptProfiler.bIsProfiling )
+		{
+			GScriptProfiler.BeginCall( *this, Object, Function );
+		}
+	}
+	~FScopedScriptProfile()
+	{
+		if( Session )
+		{
+			GScriptProfiler.EndCall( *this );
+		}
+	}
+};
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
@@ -146,6 +146,10 @@ enum EExprToken
 	EX_PrimitiveCast		= 0x38,	// A casting operator for primitives which reads the type as the subsequent byte
 	EX_DynArrayInsert		= 0x39,	// Inserts into a dynamic array
 	EX_ReturnNothing		= 0x3A, // failsafe for functions that return a value - returns the zero value for a property and logs that control reached the end of a non-void function
+	EX_FusedFloatAdd		= 0x3B, // Superinstruction: float + on simple operands.
+	EX_FusedFloatSubtract	= 0x3C, // Superinstruction: float - on simple operands.
+	EX_FusedFloatMultiply	= 0x3D, // Superinstruction: float * on simple operands.
+	EX_FusedFloatDivide		= 0x3E, // Superinstruction: float / on simple operands.
 	EX_DynArrayRemove		= 0x40,	// Removes from a dynamic array
 	EX_DebugInfo			= 0x41,	//DEBUGGER Debug information
 	EX_DelegateFunction		= 0x42, // Call to a delegate function
@@ -156,6 +160,12 @@ enum EExprToken
 	EX_DynArrayFindStruct	= 0x47, // dynarray<struct> search for item index
 	EX_LocalOutVariable		= 0x48, // local out (pass by reference) function parameter
 	EX_DefaultParmValue		= 0x49,	// default value of optional function parameter
+	EX_FusedJumpIfNotIntCmp	= 0x4A, // Superinstruction: goto if not int comparison of simple operands.
+	EX_FusedStructMember	= 0x4B, // Superinstruction: struct member chain of a local or object variable.
+	EX_FusedIntAdd			= 0x4C, // Superinstruction: int + on simple operands.
+	EX_FusedIntSubtract		= 0x4D, // Superinstruction: int - on simple operands.
+	EX_FusedIntMultiply		= 0x4E, // Superinstruction: int * on simple operands.
+	EX_FusedIntDivide		= 0x4F, // Superinstruction: int / on simple operands.
 	EX_EmptyParmValue		= 0x50,	// unspecified value for optional function parameter
 	EX_InterfaceContext		= 0x51,	// Call a function through a native interface variable
 	EX_InterfaceCast		= 0x52,	// Converting an object reference to native interface variable
@@ -165,6 +175,10 @@ enum EExprToken
 	EX_DynArrayRemoveItem	= 0x56, // Remove an item from a dynamic array
 	EX_DynArrayInsertItem	= 0x57, // Insert an item into a dynamic array
 	EX_DynArrayIterator		= 0x58, // Iterate through a dynamic array
+	EX_FusedIntPreIncrement	= 0x59, // Superinstruction: ++ of an int variable.
+	EX_FusedIntPreDecrement	= 0x5A, // Superinstruction: -- of an int variable.
+	EX_FusedIntPostIncrement= 0x5B, // Superinstruction: int variable ++.
+	EX_FusedIntPostDecrement= 0x5C, // Superinstruction: int variable --.
 
 	// Natives.
 	EX_ExtendedNative		= 0x60,
@@ -172,6 +186,29 @@ enum EExprToken
 	EX_Max					= 0x1000,
 };
 
+/** Native function indices of the operators superinstructions are fused from, see Object.uc. */
+enum EFusedNative
+{
+	NATIVE_Multiply_IntInt		= 144,
+	NATIVE_Divide_IntInt		= 145,
+	NATIVE_Add_IntInt			= 146,
+	NATIVE_Subtract_IntInt		= 147,
+	NATIVE_Less_IntInt			= 150,
+	NATIVE_Greater_IntInt		= 151,
+	NATIVE_LessEqual_IntInt		= 152,
+	NATIVE_GreaterEqual_IntInt	= 153,
+	NATIVE_EqualEqual_IntInt	= 154,
+	NATIVE_NotEqual_IntInt		= 155,
+	NATIVE_AddAdd_PreInt		= 163,
+	NATIVE_SubtractSubtract_PreInt= 164,
+	NATIVE_AddAdd_Int			= 165,
+	NATIVE_SubtractSubtract_Int	= 166,
+	NATIVE_Multiply_FloatFloat	= 171,
+	NATIVE_Divide_FloatFloat	= 172,
+	NATIVE_Add_FloatFloat		= 174,
+	NATIVE_Subtract_FloatFloat	= 175,
+};
+
 
 enum ECastToken
 {
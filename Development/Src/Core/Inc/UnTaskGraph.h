@@ -0,0 +1,299 @@
+/*=============================================================================
+	UnTaskGraph.h: Work stealing thread pool and dependent queued work.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#ifndef _UNTASKGRAPH_H
+#define _UNTASKGRAPH_H
+
+/**
+ * Fixed capacity Chase-Lev work stealing deque. The owning worker pushes and
+ * pops at the bottom (LIFO, cache friendly) while any other worker may steal
+ * from the top (FIFO, oldest work first). Only the owning thread may call
+ * Push and Pop, Steal is safe from any thread.
+ */
+class FWorkStealingQueue
+{
+public:
+	/** Number of slots in the deque. Must be a power of two. */
+	enum { Capacity = 1024 };
+
+	/** Constructor, initializing the deque to empty */
+	FWorkStealingQueue()
+	:	Top(0)
+	,	Bottom(0)
+	{
+		appMemzero( (void*) Items, sizeof(Items) );
+	}
+
+	/**
+	 * Pushes work onto the bottom of the deque. Owning thread only.
+	 *
+	 * @param Work	work to push
+	 * @return TRUE if the work was pushed, FALSE if the deque is full
+	 */
+	UBOOL Push( FQueuedWork* Work )
+	{
+		const INT LocalBottom	= Bottom;
+		const INT LocalTop		= Top;
+		if( LocalBottom - LocalTop >= Capacity )
+		{
+			return FALSE;
+		}
+		Items[LocalBottom & (Capacity - 1)] = Work;
+		// Publish the item before making it visible to thieves.
+		appInterlockedExchange( &Bottom, LocalBottom + 1 );
+		return TRUE;
+	}
+
+	/**
+	 * Pops the most recently pushed work from the bottom of the deque. Owning thread only.
+	 *
+	 * @return the work or NULL if the deque is empty or the last item was stolen
+	 */
+	FQueuedWork* Pop()
+	{
+		const INT LocalBottom = Bottom - 1;
+		// Full barrier so the reservation is visible before Top is read.
+		appInterlockedExchange( &Bottom, LocalBottom );
+		const INT LocalTop = Top;
+		if( LocalTop > LocalBottom )
+		{
+			// Deque was empty, restore canonical empty state.
+			Bottom = LocalTop;
+			return NULL;
+		}
+		FQueuedWork* Work = Items[LocalBottom & (Capacity - 1)];
+		if( LocalTop == LocalBottom )
+		{
+			// Last item, race against thieves for it.
+			if( appInterlockedCompareExchange( (INT*) &Top, LocalTop + 1, LocalTop ) != LocalTop )
+			{
+				Work = NULL;
+			}
+			Bottom = LocalTop + 1;
+		}
+		return Work;
+	}
+
+	/**
+	 * Steals the oldest work from the top of the deque. Safe from any thread.
+	 *
+	 * @return the work or NULL if the deque is empty or another thread won the race
+	 */
+	FQueuedWork* Steal()
+	{
+		const INT LocalTop = Top;
+		appMemoryBarrier();
+		const INT LocalBottom = Bottom;
+		if( LocalTop >= LocalBottom )
+		{
+			return NULL;
+		}
+		FQueuedWork* Work = Items[LocalTop & (Capacity - 1)];
+		if( appInterlockedCompareExchange( (INT*) &Top, LocalTop + 1, LocalTop ) != LocalTop )
+		{
+			return NULL;
+		}
+		return Work;
+	}
+
+	/**
+	 * @return approximate number of items in the deque, only exact when called from the owning thread
+	 */
+	INT Num() const
+	{
+		return Max<INT>( 0, Bottom - Top );
+	}
+
+private:
+	/** Index thieves steal from */
+	volatile INT Top;
+	/** Index the owner pushes to and pops from */
+	volatile INT Bottom;
+	/** Circular item storage */
+	FQueuedWork* volatile Items[Capacity];
+};
+
+/**
+ * Queued work that can depend on other queued work. The work is only handed to
+ * its pool once every prerequisite has completed and Dispatch has been called,
+ * which makes it possible to express continuations and fork/join graphs on top
+ * of any FQueuedThreadPool.
+ *
+ * Prerequisites must be added before Dispatch and while the prerequisite is
+ * guaranteed to still be alive, which in practice means building the graph before
+ * dispatching its roots.
+ */
+class FQueuedGraphWork : public FAsyncWorkBase
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param InWorkCompletionCounter	Counter to decrement on completion of task if non- NULL, see FAsyncWorkBase
+	 */
+	FQueuedGraphWork( FThreadSafeCounter* InWorkCompletionCounter = NULL );
+
+	/**
+	 * Makes this work wait for Prerequisite to complete before being queued.
+	 *
+	 * @param Prerequisite	work that needs to complete first
+	 */
+	void AddPrerequisite( FQueuedGraphWork* Prerequisite );
+
+	/**
+	 * Releases the work to the pool. It is queued immediately if all prerequisites
+	 * have already completed, otherwise the last prerequisite to finish queues it.
+	 *
+	 * @param InPool	pool to queue the work on
+	 */
+	void Dispatch( FQueuedThreadPool* InPool = GThreadPool );
+
+	/**
+	 * Performs the task and queues any subsequents whose prerequisites are now met.
+	 */
+	virtual void DoWork();
+
+protected:
+	/**
+	 * This is where the derived class does its work.
+	 */
+	virtual void DoTask() = 0;
+
+private:
+	/**
+	 * Called by a prerequisite upon completion, queues this work once nothing is pending.
+	 */
+	void PrerequisiteCompleted();
+
+	/** Acquires the spin lock guarding Subsequents and bHasCompleted */
+	void LockSubsequents();
+
+	/** Releases the spin lock guarding Subsequents and bHasCompleted */
+	void UnlockSubsequents();
+
+	/** Number of unfinished prerequisites plus one that is held until Dispatch is called */
+	FThreadSafeCounter NumPendingPrerequisites;
+	/** Work waiting on this one to complete */
+	TArray<FQueuedGraphWork*> Subsequents;
+	/** Spin lock guarding Subsequents and bHasCompleted */
+	volatile INT SubsequentsLock;
+	/** Whether DoTask has finished and subsequents have been released */
+	UBOOL bHasCompleted;
+	/** Pool the work is queued on, set by Dispatch */
+	FQueuedThreadPool* Pool;
+};
+
+/**
+ * Queued thread pool that schedules work with per worker work stealing deques.
+ * Work queued from one of the pool's own workers goes onto that worker's deque
+ * without taking a lock, work queued from any other thread goes into a shared
+ * injection queue. Idle workers steal from each other before going to sleep.
+ */
+class FQueuedThreadPoolTaskGraph : public FQueuedThreadPool
+{
+public:
+	/** Constructor, zeroing members */
+	FQueuedThreadPoolTaskGraph();
+
+	/** Cleans up any threads that were allocated in the pool */
+	virtual ~FQueuedThreadPoolTaskGraph();
+
+	/**
+	 * Creates the thread pool with the specified number of threads
+	 *
+	 * @param InNumQueuedThreads Specifies the number of threads to use in the pool, 0 to use one per hardware thread minus one
+	 * @param ProcessorMask Specifies which processors should be used by the pool
+	 * @param StackSize The size of stack the threads in the pool need (32K default)
+	 *
+	 * @return Whether the pool creation was successful or not
+	 */
+	virtual UBOOL Create(DWORD InNumQueuedThreads,DWORD ProcessorMask = 0,
+		DWORD StackSize = (32 * 1024));
+
+	/**
+	 * Tells the pool to clean up all background threads, abandoning work that hasn't started
+	 */
+	virtual void Destroy(void);
+
+	/**
+	 * Queues work on the calling worker's deque if called from a worker, otherwise
+	 * on the shared queue, and wakes an idle worker if there is one.
+	 *
+	 * @param InQueuedWork The work that needs to be done asynchronously
+	 */
+	virtual void AddQueuedWork(FQueuedWork* InQueuedWork);
+
+	/**
+	 * Workers never return to the pool, they look for work themselves.
+	 *
+	 * @param InQueuedThread ignored
+	 */
+	virtual void ReturnToPool(FQueuedThread* InQueuedThread);
+
+	/** @return number of worker threads in the pool */
+	virtual INT GetNumThreads(void) const
+	{
+		return Workers.Num();
+	}
+
+	/** @return number of work items that were executed by a worker other than the one they were queued on */
+	INT GetNumStolen() const
+	{
+		return NumStolen.GetValue();
+	}
+
+	/** @return number of work items executed since the pool was created */
+	INT GetNumExecuted() const
+	{
+		return NumExecuted.GetValue();
+	}
+
+private:
+	friend class FTaskGraphWorker;
+
+	/**
+	 * Finds work for a worker, checking its own deque first, then the shared
+	 * queue and finally stealing from other workers.
+	 *
+	 * @param Worker	worker looking for work
+	 * @return work to execute or NULL if none was found
+	 */
+	FQueuedWork* FindWork(class FTaskGraphWorker* Worker);
+
+	/** Adds a worker to the idle list */
+	void MarkIdle(class FTaskGraphWorker* Worker);
+
+	/** Removes a worker from the idle list if it is still on it */
+	void MarkBusy(class FTaskGraphWorker* Worker);
+
+	/** Wakes up one idle worker if there is any */
+	void WakeIdleWorker();
+
+	/** Worker threads and their deques */
+	TArray<class FTaskGraphWorker*> Workers;
+	/** Runnable threads executing the workers */
+	TArray<FRunnableThread*> WorkerThreads;
+	/** Work queued from outside the pool, consumed starting at QueuedWorkHead */
+	TArray<FQueuedWork*> QueuedWork;
+	/** Index of the oldest unconsumed entry in QueuedWork */
+	INT QueuedWorkHead;
+	/** Number of entries in QueuedWork that have not been consumed, read without the lock */
+	volatile INT NumQueuedWork;
+	/** Guards QueuedWork */
+	FCriticalSection* SynchQueue;
+	/** Workers waiting on their event */
+	TArray<class FTaskGraphWorker*> IdleWorkers;
+	/** Number of entries in IdleWorkers, read without the lock */
+	volatile INT NumIdleWorkers;
+	/** Guards IdleWorkers */
+	FCriticalSection* SynchIdle;
+	/** TLS slot holding the FTaskGraphWorker running on the current thread */
+	DWORD WorkerTlsSlot;
+	/** Stats */
+	FThreadSafeCounter NumStolen;
+	FThreadSafeCounter NumExecuted;
+};
+
+#endif
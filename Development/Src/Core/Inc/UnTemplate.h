@@ -447,6 +447,17 @@ private:
 	IndexType				Index;
 };
 
+/**
+ * Inline storage of a TInlineArray, directly following its FArray so FArray can find it.
+ */
+struct FInlineArrayStorage
+{
+	/** Inline elements. */
+	void*	Data;
+	/** Number of elements fitting into the inline storage. */
+	INT		Max;
+};
+
 //
 // Base dynamic array.
 //
@@ -547,13 +558,14 @@ public:
 	:	Data	( NULL )
 	,   ArrayNum( 0 )
 	,	ArrayMax( 0 )
+	,	bHasInlineStorage( 0 )
 
 	{}
 	FArray( ENoInit )
 	{}
 	~FArray()
 	{
-		if( Data )
+		if( Data && !IsUsingInlineStorage() )
 		{
 			appFree( Data );
 		}
@@ -572,28 +584,59 @@ public:
 		return ArrayMax - ArrayNum;
 	}
 	void Remove( INT Index, INT Count, INT ElementSize, DWORD Alignment );
+	/**
+	 * Returns whether this is a TInlineArray.
+	 */
+	UBOOL HasInlineStorage() const
+	{
+		return bHasInlineStorage;
+	}
+	/**
+	 * Returns whether the elements are stored in the inline storage of a TInlineArray.
+	 */
+	UBOOL IsUsingInlineStorage() const
+	{
+		return bHasInlineStorage && Data == GetInlineStorage().Data;
+	}
 protected:
 	void Realloc( INT ElementSize, DWORD Alignment )
 	{
+		if( bHasInlineStorage )
+		{
+			ReallocInline( ElementSize, Alignment );
+		}
 		// Avoid calling appRealloc( NULL, 0 ) as ANSI C mandates returning a valid pointer which is not what we want.
-		if( Data || ArrayMax )
+		else if( Data || ArrayMax )
 		{
 			Data = appRealloc( Data, ArrayMax*ElementSize, Alignment );
 		}
 	}
+	/**
+	 * Realloc for arrays with inline storage, only touching the heap if ArrayMax doesn't fit inline.
+	 */
+	void ReallocInline( INT ElementSize, DWORD Alignment );
 	INT CalculateSlack( INT ElementSize ) const;
 
+	/** @return inline storage of a TInlineArray, only valid if bHasInlineStorage is set */
+	const FInlineArrayStorage& GetInlineStorage() const
+	{
+		return *(const FInlineArrayStorage*)(this + 1);
+	}
+
 	FArray( INT InNum, INT ElementSize, DWORD Alignment )
 	:   Data    ( NULL  )
 	,   ArrayNum( InNum )
 	,	ArrayMax( InNum )
+	,	bHasInlineStorage( 0 )
 
 	{
 		Realloc( ElementSize, Alignment );
 	}
 	void* Data;
 	INT	  ArrayNum;
-	INT	  ArrayMax;
+	// The top bit of ArrayMax flags arrays with inline storage, keeping FArray the same size.
+	INT	  ArrayMax : 31;
+	DWORD bHasInlineStorage : 1;
 };
 
 //
@@ -1211,6 +1254,60 @@ public:
 	}
 };
 
+/**
+ * TArray with room for NumInlineElements elements inside the array itself, only allocating from the
+ * heap once more elements are needed. Meant for scratch arrays on the stack that are usually small.
+ *
+ * It can be passed to anything taking a TArray and serializes the same way. The elements move back
+ * into the inline storage when the array shrinks enough. ExchangeArray is not supported.
+ */
+template<class T, INT NumInlineElements> class TInlineArray : public TArray<T>
+{
+public:
+	TInlineArray()
+	{
+		InitInlineStorage();
+	}
+	TInlineArray( const TInlineArray& Other )
+	{
+		InitInlineStorage();
+		this->Copy( Other );
+	}
+	TInlineArray( const TArray<T>& Other )
+	{
+		InitInlineStorage();
+		this->Copy( Other );
+	}
+	TInlineArray& operator=( const TInlineArray& Other )
+	{
+		this->Copy( Other );
+		return *this;
+	}
+	TInlineArray& operator=( const TArray<T>& Other )
+	{
+		this->Copy( Other );
+		return *this;
+	}
+
+private:
+	/** Points the array at its inline storage. */
+	void InitInlineStorage()
+	{
+		// FArray expects the inline storage right behind it.
+		checkSlow( (BYTE*)&InlineStorage == (BYTE*)(FArray*)this + sizeof(FArray) );
+		InlineStorage.Data			= InlineElements;
+		InlineStorage.Max			= NumInlineElements;
+		this->Data					= InlineElements;
+		this->ArrayMax				= NumInlineElements;
+		this->bHasInlineStorage		= 1;
+	}
+
+	/** Location and size of InlineElements, read by FArray. */
+	FInlineArrayStorage	InlineStorage;
+	/** Inline elements, QWORDs to satisfy DEFAULT_ALIGNMENT. */
+	QWORD				InlineElements[(NumInlineElements * sizeof(T) + sizeof(QWORD) - 1) / sizeof(QWORD)];
+};
+
 //
 // Array operator news.
 //
@@ -1232,6 +1329,8 @@ template <class T, DWORD Alignment> void* operator new( size_t Size, TArray<T, A
 //
 template <class T> inline void ExchangeArray( TArray<T>& A, TArray<T>& B )
 {
+	// Inline storage can't change owners.
+	check( !A.HasInlineStorage() && !B.HasInlineStorage() );
 	appMemswap( &A, &B, sizeof(FArray) );
 }
 
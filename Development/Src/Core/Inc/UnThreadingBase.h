@@ -443,6 +443,12 @@ public:
 	 * @param InQueuedThread The thread that is ready to be pooled
 	 */
 	virtual void ReturnToPool(FQueuedThread* InQueuedThread) = 0;
+
+	/**
+	 * @return the number of threads the pool was created with, i.e. how many
+	 * pieces of work it can run at the same time
+	 */
+	virtual INT GetNumThreads(void) const = 0;
 };
 
 /*
@@ -472,12 +478,19 @@ protected:
 	 */
 	FCriticalSection* SynchQueue;
 
+	/**
+	 * The number of threads created by Create. QueuedThreads only holds the
+	 * idle ones
+	 */
+	INT NumThreads;
+
 	/**
 	 * Constructor that creates the zeroes the critical sections
 	 */
 	FQueuedThreadPoolBase(void)
 	{
 		SynchQueue = NULL;
+		NumThreads = 0;
 	}
 
 public:
@@ -514,6 +527,14 @@ public:
 	 * @param InQueuedThread The thread that is ready to be pooled
 	 */
 	void ReturnToPool(FQueuedThread* InQueuedThread);
+
+	/**
+	 * @return the number of threads the pool was created with
+	 */
+	virtual INT GetNumThreads(void) const
+	{
+		return NumThreads;
+	}
 };
 
 // Include the platform specific versions
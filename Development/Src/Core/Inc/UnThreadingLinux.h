@@ -9,6 +9,10 @@
 #ifndef _UNTHREADING_LINUX_H
 #define _UNTHREADING_LINUX_H
 
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
 /**
  * Interlocked style functions for threadsafe atomic operations
  */
@@ -16,53 +20,42 @@
 /**
  * Atomically increments the value pointed to and returns that to the caller
  */
-FORCEINLINE INT appInterlockedIncrement(INT* Value)
+FORCEINLINE INT appInterlockedIncrement(volatile INT* Value)
 {
-	//@todo implement properly
-	return ++(*Value);
+	return __sync_add_and_fetch(Value,1);
 }
 /**
  * Atomically decrements the value pointed to and returns that to the caller
  */
-FORCEINLINE INT appInterlockedDecrement(INT* Value)
+FORCEINLINE INT appInterlockedDecrement(volatile INT* Value)
 {
-	//@todo implement properly
-	return --(*Value);
+	return __sync_sub_and_fetch(Value,1);
 }
 /**
  * Atomically adds the amount to the value pointed to and returns the old
  * value to the caller
  */
-FORCEINLINE INT appInterlockedAdd(INT* Value,INT Amount)
+FORCEINLINE INT appInterlockedAdd(volatile INT* Value,INT Amount)
 {
-	//@todo implement properly
-	INT Temp = *Value;
-	(*Value) += Amount;
-	return Temp;
+	return __sync_fetch_and_add(Value,Amount);
 }
 /**
  * Atomically swaps two values returning the original value to the caller
  */
-FORCEINLINE INT appInterlockedExchange(INT* Value,INT Exchange)
+FORCEINLINE INT appInterlockedExchange(volatile INT* Value,INT Exchange)
 {
-	//@todo implement properly
-	INT Temp = *Value;
-	(*Value) = Exchange;
+	// __sync_lock_test_and_set is only an acquire barrier, so follow it with a full one
+	INT Temp = __sync_lock_test_and_set(Value,Exchange);
+	__sync_synchronize();
 	return Temp;
 }
 /**
  * Atomically compares the value to comperand and replaces with the exchange
  * value if they are equal and returns the original value
  */
-FORCEINLINE INT appInterlockedCompareExchange(INT* Dest,INT Exchange,INT Comperand)
+FORCEINLINE INT appInterlockedCompareExchange(volatile INT* Dest,INT Exchange,INT Comperand)
 {
-	//@todo implement properly
-	INT Temp = *Dest;
-	if (Temp == Comperand)
-	{
-		(*Dest) = Exchange;
-	}
-	return Temp;
+	return __sync_val_compare_and_swap(Dest,Comperand,Exchange);
 }
 /**
  * Atomically compares the pointer to comperand and replaces with the exchange
@@ -70,59 +63,155 @@ FORCEINLINE INT appInterlockedCompareExchange(INT* Dest,INT Exchange,INT Compera
  */
 FORCEINLINE void* appInterlockedCompareExchangePointer(void** Dest,void* Exchange,void* Comperand)
 {
-	//@todo implement properly
-	void* Temp = *Dest;
-	if (Temp == Comperand)
+	return __sync_val_compare_and_swap(Dest,Comperand,Exchange);
+}
+
+/**
+ * Returns the currently executing thread's id. pthread_t is an opaque pointer sized value, so
+ * the kernel thread id is used instead as it fits a DWORD on 64-bit as well.
+ */
+FORCEINLINE DWORD appGetCurrentThreadId(void)
+{
+	return (DWORD)syscall(SYS_gettid);
+}
+
+/**
+ * Allocates a thread local store slot
+ */
+FORCEINLINE DWORD appAllocTlsSlot(void)
+{
+	pthread_key_t Key = 0;
+	if (pthread_key_create(&Key,NULL) != 0)
 	{
-		(*Dest) = Exchange;
+		return (DWORD)INDEX_NONE;
 	}
-	return Temp;
+	return (DWORD)Key;
 }
 
 /**
- * Returns the currently executing thread's id
+ * Sets a value in the specified TLS slot
+ *
+ * @param SlotIndex the TLS index to store it in
+ * @param Value the value to store in the slot
  */
-FORCEINLINE DWORD appGetCurrentThreadId(void)
+FORCEINLINE void appSetTlsValue(DWORD SlotIndex,void* Value)
 {
-	//@todo -- implement properly
-	return 0;
+	pthread_setspecific((pthread_key_t)SlotIndex,Value);
 }
 
+/**
+ * Reads the value stored at the specified TLS slot
+ *
+ * @return the value stored in the slot
+ */
+FORCEINLINE void* appGetTlsValue(DWORD SlotIndex)
+{
+	return pthread_getspecific((pthread_key_t)SlotIndex);
+}
 
 /**
- * This is the Linux version of a critical section.
+ * Frees a previously allocated TLS slot
+ *
+ * @param SlotIndex the TLS index to store it in
+ */
+FORCEINLINE void appFreeTlsSlot(DWORD SlotIndex)
+{
+	pthread_key_delete((pthread_key_t)SlotIndex);
+}
+
+
+/**
+ * This is the Linux version of a critical section. Like its Windows
+ * counterpart it may be locked recursively by the owning thread.
  */
 class FCriticalSection :
 	public FSynchronize
 {
+	/**
+	 * The pthread mutex, created recursive
+	 */
+	pthread_mutex_t Mutex;
 
 public:
 	/**
 	 * Constructor that initializes the aggregated critical section
 	 */
-	FCriticalSection(void);
+	FORCEINLINE FCriticalSection(void)
+	{
+		pthread_mutexattr_t MutexAttributes;
+		pthread_mutexattr_init(&MutexAttributes);
+		pthread_mutexattr_settype(&MutexAttributes,PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&Mutex,&MutexAttributes);
+		pthread_mutexattr_destroy(&MutexAttributes);
+	}
 
 	/**
 	 * Destructor cleaning up the critical section
 	 */
-	virtual ~FCriticalSection(void);
+	FORCEINLINE ~FCriticalSection(void)
+	{
+		pthread_mutex_destroy(&Mutex);
+	}
 
 	/**
 	 * Locks the critical section
 	 */
-	virtual void Lock(void);
+	FORCEINLINE void Lock(void)
+	{
+		pthread_mutex_lock(&Mutex);
+	}
 
 	/**
 	 * Releases the lock on the critical seciton
 	 */
-	virtual void Unlock(void);
+	FORCEINLINE void Unlock(void)
+	{
+		pthread_mutex_unlock(&Mutex);
+	}
 };
 
 /**
- * This is the Linux version of an event
+ * This is the Linux version of an event, a condition variable guarding
+ * a triggered flag.
  */
 class FEventLinux : public FEvent
 {
+	/**
+	 * Guards the state below
+	 */
+	pthread_mutex_t Mutex;
+
+	/**
+	 * Signaled whenever the event is triggered or pulsed
+	 */
+	pthread_cond_t Condition;
+
+	/**
+	 * Whether Create succeeded, i.e. Mutex and Condition need cleaning up
+	 */
+	UBOOL bInitialized;
+
+	/**
+	 * Whether the event stays triggered until Reset is called
+	 */
+	UBOOL bIsManualReset;
+
+	/**
+	 * Whether the event is triggered
+	 */
+	UBOOL bTriggered;
+
+	/**
+	 * Number of threads blocked in Wait
+	 */
+	INT NumWaitingThreads;
+
+	/**
+	 * Incremented by Pulse on manual reset events, releasing everybody
+	 * waiting at the time without leaving the event triggered
+	 */
+	DWORD PulseCount;
+
 public:
 	/**
 	 * Constructor that zeroes the handle
@@ -146,7 +235,7 @@ public:
 
 	/**
 	 * Creates the event. Manually reset events stay triggered until reset.
-	 * Named events share the same underlying event.
+	 * Events are process local, so names are ignored.
 	 *
 	 * @param bIsManualReset Whether the event requires manual reseting or not
 	 * @param InName Whether to use a commonly shared event or not. If so this
@@ -232,19 +321,19 @@ class FQueuedThreadLinux : public FQueuedThread
 	FEvent* DoWorkEvent;
 
 	/**
-	 * The thread handle to clean up. Must be closed or this will leak resources
+	 * The thread to join when killing it
 	 */
-	HANDLE ThreadHandle;
+	pthread_t Thread;
 
 	/**
-	 * The thread ID for this thread
+	 * Whether Thread has been created and not been joined yet
 	 */
-	DWORD ThreadID;
+	UBOOL bIsJoinable;
 
 	/**
 	 * If true, the thread should exit
 	 */
-	UBOOL TimeToDie;
+	volatile INT TimeToDie;
 
 	/**
 	 * The work this thread is doing
@@ -261,6 +350,12 @@ class FQueuedThreadLinux : public FQueuedThread
 	 */
 	FQueuedThreadPool* OwningThreadPool;
 
+	/**
+	 * The thread entry point. Simply forwards the call on to the right
+	 * thread main function
+	 */
+	static void* _ThreadProc(void* pThis);
+
 	/**
 	 * The real thread entry point. It waits for work events to be queued. Once
 	 * an event is queued, it executes it and goes back to waiting.
@@ -284,12 +379,13 @@ public:
 	 *
 	 * @param InPool The thread pool interface used to place this thread
 	 * back into the pool of available threads when its work is done
+	 * @param ProcessorMask Specifies which processors should be used by the pool
 	 * @param InStackSize The size of the stack to create. 0 means use the
 	 * current thread's stack size
 	 *
 	 * @return True if the thread and all of its initialization was successful, false otherwise
 	 */
-	virtual UBOOL Create(FQueuedThreadPool* InPool,DWORD InStackSize = 0);
+	virtual UBOOL Create(FQueuedThreadPool* InPool,DWORD ProcessorMask,DWORD InStackSize = 0);
 	
 	/**
 	 * Tells the thread to exit. If the caller needs to know when the thread
@@ -334,11 +430,12 @@ public:
 	 * Creates the thread pool with the specified number of threads
 	 *
 	 * @param InNumQueuedThreads Specifies the number of threads to use in the pool
+	 * @param ProcessorMask Specifies which processors should be used by the pool
 	 * @param StackSize The size of stack the threads in the pool need (32K default)
 	 *
 	 * @return Whether the pool creation was successful or not
 	 */
-	virtual UBOOL Create(DWORD InNumQueuedThreads,DWORD StackSize = (32 * 1024));
+	virtual UBOOL Create(DWORD InNumQueuedThreads,DWORD ProcessorMask = 0,DWORD StackSize = (32 * 1024));
 };
 
 /**
@@ -350,7 +447,23 @@ class FRunnableThreadLinux : public FRunnableThread
 	/**
 	 * The thread handle for the thread
 	 */
-	HANDLE Thread;
+	pthread_t Thread;
+
+	/**
+	 * Whether Thread has been created and has neither been joined nor detached yet
+	 */
+	UBOOL bIsJoinable;
+
+	/**
+	 * Kernel thread id, set by the thread itself when it starts
+	 */
+	volatile DWORD ThreadID;
+
+	/**
+	 * Set by Create once it is done with the thread, which holds off
+	 * running the runnable till then as it might delete itself
+	 */
+	volatile INT bCreateFinished;
 
 	/**
 	 * The runnable object to execute on this thread
@@ -372,6 +485,12 @@ class FRunnableThreadLinux : public FRunnableThread
 	 */
 	EThreadPriority ThreadPriority;
 
+	/**
+	 * The thread entry point. Simply forwards the call on to the right
+	 * thread main function
+	 */
+	static void* _ThreadProc(void* pThis);
+
 	/**
 	 * The real thread entry point. It calls the Init/Run/Exit methods on
 	 * the runnable object
@@ -393,6 +512,7 @@ public:
 	 * Creates the thread with the specified stack size and thread priority.
 	 *
 	 * @param InRunnable The runnable object to execute
+	 * @param ThreadName Name of the thread
 	 * @param bAutoDeleteSelf Whether to delete this object on exit
 	 * @param bAutoDeleteRunnable Whether to delete the runnable object on exit
 	 * @param InStackSize The size of the stack to create. 0 means use the
@@ -402,9 +522,9 @@ public:
 	 *
 	 * @return True if the thread and all of its initialization was successful, false otherwise
 	 */
-	UBOOL Create(FRunnable* InRunnable,UBOOL bAutoDeleteSelf = 0,
-		UBOOL bAutoDeleteRunnable = 0,DWORD InStackSize = 0,
-		EThreadPriority InThreadPri = TPri_Normal);
+	UBOOL Create(FRunnable* InRunnable,const TCHAR* ThreadName,
+		UBOOL bAutoDeleteSelf = 0,UBOOL bAutoDeleteRunnable = 0,
+		DWORD InStackSize = 0,EThreadPriority InThreadPri = TPri_Normal);
 	
 	/**
 	 * Changes the thread priority of the currently running thread
@@ -425,7 +545,7 @@ public:
 
 	/**
 	 * Tells the thread to either pause execution or resume depending on the
-	 * passed in value.
+	 * passed in value. Not supported by pthreads.
 	 *
 	 * @param bShouldPause Whether to pause the thread (true) or resume (false)
 	 */
@@ -443,12 +563,19 @@ public:
 	 *
 	 * @return True if the thread exited gracefull, false otherwise
 	 */
-	virtual UBOOL Kill(UBOOL bShouldWait = 0,DWORD MaxWaitTime = 0);
+	virtual UBOOL Kill(UBOOL bShouldWait = 0,DWORD MaxWaitTime = INFINITE);
 
 	/**
 	 * Halts the caller until this thread is has completed its work.
 	 */
 	virtual void WaitForCompletion(void);
+
+	/**
+	 * Thread ID for this thread 
+	 *
+	 * @return ID that was set by CreateThread
+	 */
+	virtual DWORD GetThreadID(void);
 };
 
 /**
@@ -461,6 +588,7 @@ public:
 	 * Creates the thread with the specified stack size and thread priority.
 	 *
 	 * @param InRunnable The runnable object to execute
+	 * @param ThreadName Name of the thread
 	 * @param bAutoDeleteSelf Whether to delete this object on exit
 	 * @param bAutoDeleteRunnable Whether to delete the runnable object on exit
 	 * @param InStackSize The size of the stack to create. 0 means use the
@@ -470,7 +598,7 @@ public:
 	 *
 	 * @return The newly created thread or NULL if it failed
 	 */
-	virtual FRunnableThread* CreateThread(FRunnable* InRunnable,
+	virtual FRunnableThread* CreateThread(FRunnable* InRunnable, const TCHAR* ThreadName,
 		UBOOL bAutoDeleteSelf = 0,UBOOL bAutoDeleteRunnable = 0,
 		DWORD InStackSize = 0,EThreadPriority InThreadPri = TPri_Normal);
 
@@ -310,6 +310,8 @@ UBOOL					GIsStarted						= FALSE;					/* Whether execution is happening from wi
 UBOOL					GIsGuarded						= FALSE;					/* Whether execution is happening within main()/WinMain()'s try/catch handler */
 UBOOL					GIsRunning						= FALSE;					/* Whether execution is happening within MainLoop() */
 UBOOL					GIsGarbageCollecting			= FALSE;					/* Whether we are inside garbage collection */
+UBOOL					GUseParallelGCMark				= TRUE;						/* Whether the realtime GC mark phase runs on multiple threads */
+UBOOL					GVerifyParallelGCMark			= FALSE;					/* Whether the parallel GC mark phase is checked against the serial one */
 UBOOL					GIsReplacingObject				= FALSE;					/* Whether we are currently in-place replacing an object */
 /** This determines if we should pop up any dialogs.  If Yes then no popping up dialogs.					*/
 UBOOL					GIsUnattended					= FALSE;
@@ -416,6 +418,10 @@ QWORD					GNumTimingCodeCalls				= 0;
 /** Whether we are using the seekfree/ cooked loading codepath.												*/
 UBOOL					GUseSeekFreeLoading				= FALSE;
 #endif
+/** Whether uncompressed seekfree packages are memory mapped rather than read.								*/
+UBOOL					GUseMappedPackageLoading		= FALSE;
+/** Number of compressed chunks decompressed in parallel, 0 to base it on the number of hardware threads.	*/
+INT						GDecompressionWindowSize		= 0;
 
 #if ENABLE_SCRIPT_TRACING
 /** Whether we are tracing script to a log file */
@@ -473,6 +479,8 @@ DECLARE_CYCLE_STAT(TEXT("Game thread idle time"),STAT_GameIdleTime,STATGROUP_Thr
 DECLARE_CYCLE_STAT(TEXT("Game thread tick wait time"),STAT_GameTickWaitTime,STATGROUP_Threading);
 DECLARE_FLOAT_COUNTER_STAT(TEXT("Game thread requested wait time"),STAT_GameTickWantedWaitTime,STATGROUP_Threading);
 DECLARE_FLOAT_COUNTER_STAT(TEXT("Game thread additional wait time"),STAT_GameTickAdditionalWaitTime,STATGROUP_Threading);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Server tick jitter"),STAT_ServerTickJitter,STATGROUP_Threading);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Server tick CPU time"),STAT_ServerTickCpuTime,STATGROUP_Threading);
 
 
 #if !PS3
@@ -0,0 +1,508 @@
+/*=============================================================================
+	FMallocThreadCache.cpp: Size class allocator with per thread caches.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+#include "FMallocThreadCache.h"
+
+#if __LINUX__
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <strings.h>
+
+/** The allocator, needed by the thread exit callback. */
+static FMallocThreadCache*						GMallocThreadCache = NULL;
+/** Cache of the current thread, NULL till it allocates for the first time. */
+static __thread FMallocThreadCache::FThreadCache*	GCurrentThreadCache = NULL;
+
+/*-----------------------------------------------------------------------------
+	FMallocThreadCache.
+-----------------------------------------------------------------------------*/
+
+FMallocThreadCache::FMallocThreadCache()
+:	ThreadCaches			( NULL )
+,	RetiredUsedBytes		( 0 )
+,	RetiredCurrentAllocs	( 0 )
+,	RetiredTotalAllocs		( 0 )
+,	OsCurrentKB				( 0 )
+,	OsPeakKB				( 0 )
+{
+	check( GMallocThreadCache == NULL );
+	GMallocThreadCache = this;
+	check( sizeof(FSpanHeader) <= SPAN_HEADER_SIZE );
+	check( sizeof(FFreeBlock) <= ALLOCATION_ALIGNMENT );
+
+	// Size classes step by 16 bytes up to 128 and by a quarter of the power of two above that,
+	// limiting the waste of rounding up to 25%.
+	INT BlockSize = 0;
+	for( INT SizeClass=0; SizeClass<NUM_SIZE_CLASSES; SizeClass++ )
+	{
+		if( BlockSize < 128 )
+		{
+			BlockSize += ALLOCATION_ALIGNMENT;
+		}
+		else
+		{
+			INT PowerOfTwo = 128;
+			while( PowerOfTwo * 2 <= BlockSize )
+			{
+				PowerOfTwo *= 2;
+			}
+			BlockSize += PowerOfTwo / 4;
+		}
+
+		FSizeClass& Class		= SizeClasses[SizeClass];
+		pthread_mutex_init( &Class.Mutex, NULL );
+		Class.BlockSize			= BlockSize;
+		// Move around 64 KByte at once, limited to keep caches of small blocks short.
+		Class.BatchSize			= Clamp<INT>( 65536 / BlockSize, 2, 64 );
+		Class.FullBatches		= NULL;
+		Class.LooseBlocks		= NULL;
+		Class.NumLooseBlocks	= 0;
+		Class.NumBatchedBlocks	= 0;
+		Class.NumSpans			= 0;
+	}
+	check( BlockSize == MAX_SMALL_SIZE );
+
+	// Map each 16 byte step to the smallest size class fitting it.
+	INT SizeClass = 0;
+	for( INT Step=0; Step<ARRAY_COUNT(SizeToClass); Step++ )
+	{
+		while( SizeClasses[SizeClass].BlockSize < Step * ALLOCATION_ALIGNMENT )
+		{
+			SizeClass++;
+		}
+		SizeToClass[Step] = SizeClass;
+	}
+
+	pthread_mutex_init( &ThreadCachesMutex, NULL );
+	verify( pthread_key_create( &ThreadCacheKey, DestroyThreadCache ) == 0 );
+}
+
+/**
+ * Returns whether -THREADCACHEMALLOC was passed. Reads the process command line directly as
+ * GMalloc is created on the first allocation, way before appCmdLine is set up.
+ */
+UBOOL FMallocThreadCache::IsRequestedOnCommandLine()
+{
+	// Arguments are separated by zero bytes.
+	static ANSICHAR CommandLine[8192];
+	const INT FileDescriptor = open( "/proc/self/cmdline", O_RDONLY );
+	if( FileDescriptor < 0 )
+	{
+		return FALSE;
+	}
+	const INT Length = Max<INT>( read( FileDescriptor, CommandLine, sizeof(CommandLine) - 1 ), 0 );
+	close( FileDescriptor );
+	CommandLine[Length] = 0;
+
+	for( INT Position=0; Position<Length; Position+=strlen(CommandLine + Position) + 1 )
+	{
+		if( strcasecmp( CommandLine + Position, "-THREADCACHEMALLOC" ) == 0 )
+		{
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * Maps SPAN_SIZE aligned memory from the OS.
+ *
+ * @param	Size	size in bytes, multiple of the page size
+ * @return	mapping, never NULL
+ */
+void* FMallocThreadCache::MapAligned( SIZE_T Size )
+{
+	// Over-allocate and trim the unaligned head and tail.
+	const SIZE_T MappedSize = Size + SPAN_SIZE;
+	BYTE* Mapping = (BYTE*) mmap( NULL, MappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+	if( Mapping == MAP_FAILED )
+	{
+		appErrorf( *LocalizeError("OutOfMemory",TEXT("Core")) );
+	}
+	BYTE* Aligned = Align( Mapping, SPAN_SIZE );
+	if( Aligned > Mapping )
+	{
+		munmap( Mapping, Aligned - Mapping );
+	}
+	const SIZE_T TailSize = (Mapping + MappedSize) - (Aligned + Size);
+	if( TailSize > 0 )
+	{
+		munmap( Aligned + Size, TailSize );
+	}
+
+	const INT NewOsCurrentKB = appInterlockedAdd( &OsCurrentKB, (INT)(Size / 1024) ) + (INT)(Size / 1024);
+	// Racy but only used for stats.
+	OsPeakKB = Max( OsPeakKB, NewOsCurrentKB );
+	return Aligned;
+}
+
+/** Unmaps memory returned by MapAligned. */
+void FMallocThreadCache::Unmap( void* Ptr, SIZE_T Size )
+{
+	munmap( Ptr, Size );
+	appInterlockedAdd( &OsCurrentKB, -(INT)(Size / 1024) );
+}
+
+/**
+ * Maps a new span for the passed in size class and pushes its blocks on the loose list. Called
+ * with the size class locked.
+ */
+void FMallocThreadCache::AllocateSpan( FSizeClass& Class, INT SizeClass )
+{
+	FSpanHeader* Header	= (FSpanHeader*) MapAligned( SPAN_SIZE );
+	Header->SizeClass	= SizeClass;
+	Header->MappedSize	= SPAN_SIZE;
+	Header->LargeSize	= 0;
+	Class.NumSpans++;
+
+	// Push in reverse so blocks are handed out in address order.
+	const INT NumBlocks = (SPAN_SIZE - SPAN_HEADER_SIZE) / Class.BlockSize;
+	BYTE* FirstBlock = (BYTE*) Header + SPAN_HEADER_SIZE;
+	for( INT BlockIndex=NumBlocks-1; BlockIndex>=0; BlockIndex-- )
+	{
+		FFreeBlock* Block	= (FFreeBlock*)( FirstBlock + BlockIndex * Class.BlockSize );
+		Block->Next			= Class.LooseBlocks;
+		Class.LooseBlocks	= Block;
+	}
+	Class.NumLooseBlocks += NumBlocks;
+}
+
+/**
+ * Moves a batch of blocks of the passed in size class into the thread cache.
+ */
+void FMallocThreadCache::FetchFromCentral( FThreadCache* Cache, INT SizeClass )
+{
+	FSizeClass& Class = SizeClasses[SizeClass];
+	FScopeMutexLock ScopeLock( &Class.Mutex );
+
+	// Full batches are handed over as a whole.
+	if( Class.FullBatches )
+	{
+		FFreeBlock* Batch				= Class.FullBatches;
+		Class.FullBatches				= Batch->NextBatch;
+		Class.NumBatchedBlocks			-= Class.BatchSize;
+		Cache->FreeLists[SizeClass]		= Batch;
+		Cache->FreeCounts[SizeClass]	= Class.BatchSize;
+		return;
+	}
+
+	if( !Class.LooseBlocks )
+	{
+		AllocateSpan( Class, SizeClass );
+	}
+
+	// Detach up to a batch worth of loose blocks.
+	FFreeBlock* First	= Class.LooseBlocks;
+	FFreeBlock* Last	= First;
+	INT Count			= 1;
+	while( Count < Class.BatchSize && Last->Next )
+	{
+		Last = Last->Next;
+		Count++;
+	}
+	Class.LooseBlocks				= Last->Next;
+	Class.NumLooseBlocks			-= Count;
+	Last->Next						= NULL;
+	Cache->FreeLists[SizeClass]		= First;
+	Cache->FreeCounts[SizeClass]	= Count;
+}
+
+/**
+ * Moves a batch of blocks of the passed in size class from the thread cache to the central lists.
+ */
+void FMallocThreadCache::ReleaseToCentral( FThreadCache* Cache, INT SizeClass )
+{
+	FSizeClass& Class = SizeClasses[SizeClass];
+
+	// Split off the batch before taking the lock.
+	FFreeBlock* First	= Cache->FreeLists[SizeClass];
+	FFreeBlock* Last	= First;
+	for( INT Count=1; Count<Class.BatchSize; Count++ )
+	{
+		Last = Last->Next;
+	}
+	Cache->FreeLists[SizeClass]		= Last->Next;
+	Cache->FreeCounts[SizeClass]	-= Class.BatchSize;
+	Last->Next						= NULL;
+
+	FScopeMutexLock ScopeLock( &Class.Mutex );
+	First->NextBatch		= Class.FullBatches;
+	Class.FullBatches		= First;
+	Class.NumBatchedBlocks	+= Class.BatchSize;
+}
+
+/** @return the calling thread's cache, creating it on first use */
+FMallocThreadCache::FThreadCache* FMallocThreadCache::GetThreadCache()
+{
+	FThreadCache* Cache = GCurrentThreadCache;
+	if( !Cache )
+	{
+		// Caches are mapped directly as we can't allocate from ourselves yet.
+		Cache = (FThreadCache*) mmap( NULL, sizeof(FThreadCache), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+		if( Cache == MAP_FAILED )
+		{
+			appErrorf( *LocalizeError("OutOfMemory",TEXT("Core")) );
+		}
+		// Anonymous mappings are zeroed.
+		{
+			FScopeMutexLock ScopeLock( &ThreadCachesMutex );
+			Cache->Next		= ThreadCaches;
+			ThreadCaches	= Cache;
+		}
+		GCurrentThreadCache = Cache;
+		// Only used to get notified when the thread exits.
+		pthread_setspecific( ThreadCacheKey, Cache );
+	}
+	return Cache;
+}
+
+/** Called when a thread exits, handing its cached blocks back to the central lists. */
+void FMallocThreadCache::DestroyThreadCache( void* InCache )
+{
+	FMallocThreadCache* Malloc	= GMallocThreadCache;
+	FThreadCache* Cache			= (FThreadCache*) InCache;
+
+	for( INT SizeClass=0; SizeClass<NUM_SIZE_CLASSES; SizeClass++ )
+	{
+		FFreeBlock* Block = Cache->FreeLists[SizeClass];
+		if( Block )
+		{
+			FFreeBlock* Last = Block;
+			while( Last->Next )
+			{
+				Last = Last->Next;
+			}
+			FSizeClass& Class = Malloc->SizeClasses[SizeClass];
+			FScopeMutexLock ScopeLock( &Class.Mutex );
+			Last->Next				= Class.LooseBlocks;
+			Class.LooseBlocks		= Block;
+			Class.NumLooseBlocks	+= Cache->FreeCounts[SizeClass];
+		}
+	}
+
+	{
+		FScopeMutexLock ScopeLock( &Malloc->ThreadCachesMutex );
+		FThreadCache** Link = &Malloc->ThreadCaches;
+		while( *Link != Cache )
+		{
+			Link = &(*Link)->Next;
+		}
+		*Link = Cache->Next;
+		Malloc->RetiredUsedBytes		+= Cache->UsedBytes;
+		Malloc->RetiredCurrentAllocs	+= Cache->CurrentAllocs;
+		Malloc->RetiredTotalAllocs		+= Cache->TotalAllocs;
+	}
+
+	// Allocations made by later thread exit callbacks create a new cache.
+	GCurrentThreadCache = NULL;
+	munmap( Cache, sizeof(FThreadCache) );
+}
+
+void* FMallocThreadCache::Malloc( DWORD Size, DWORD Alignment )
+{
+	check( (Alignment == DEFAULT_ALIGNMENT || Alignment <= ALLOCATION_ALIGNMENT) && "Alignment currently unsupported in thread cache Malloc" );
+	FThreadCache* Cache = GetThreadCache();
+	Cache->CurrentAllocs++;
+	Cache->TotalAllocs++;
+
+	if( Size <= MAX_SMALL_SIZE )
+	{
+		const INT SizeClass = SizeToClass[(Size + ALLOCATION_ALIGNMENT - 1) / ALLOCATION_ALIGNMENT];
+		if( !Cache->FreeLists[SizeClass] )
+		{
+			FetchFromCentral( Cache, SizeClass );
+		}
+		FFreeBlock* Block				= Cache->FreeLists[SizeClass];
+		Cache->FreeLists[SizeClass]		= Block->Next;
+		Cache->FreeCounts[SizeClass]--;
+		Cache->UsedBytes				+= SizeClasses[SizeClass].BlockSize;
+		return Block;
+	}
+
+	// Large allocations get their own mapping.
+	const SIZE_T MappedSize	= Align<SIZE_T>( SPAN_HEADER_SIZE + Size, getpagesize() );
+	FSpanHeader* Header		= (FSpanHeader*) MapAligned( MappedSize );
+	Header->SizeClass		= INDEX_NONE;
+	Header->MappedSize		= MappedSize;
+	Header->LargeSize		= Size;
+	Cache->UsedBytes		+= Size;
+	return (BYTE*) Header + SPAN_HEADER_SIZE;
+}
+
+void* FMallocThreadCache::Realloc( void* Ptr, DWORD NewSize, DWORD Alignment )
+{
+	if( !Ptr )
+	{
+		return NewSize ? Malloc( NewSize, Alignment ) : NULL;
+	}
+	if( !NewSize )
+	{
+		Free( Ptr );
+		return NULL;
+	}
+
+	// Keep the block if the new size still fits its size class snugly.
+	FSpanHeader* Header = GetSpanHeader( Ptr );
+	SIZE_T OldSize;
+	if( Header->SizeClass != INDEX_NONE )
+	{
+		OldSize = SizeClasses[Header->SizeClass].BlockSize;
+		if( NewSize <= MAX_SMALL_SIZE && SizeToClass[(NewSize + ALLOCATION_ALIGNMENT - 1) / ALLOCATION_ALIGNMENT] == Header->SizeClass )
+		{
+			return Ptr;
+		}
+	}
+	else
+	{
+		OldSize = Header->LargeSize;
+		if( NewSize > MAX_SMALL_SIZE && SPAN_HEADER_SIZE + NewSize <= Header->MappedSize && NewSize >= OldSize / 2 )
+		{
+			GetThreadCache()->UsedBytes += (SIZE_T) NewSize - OldSize;
+			Header->LargeSize = NewSize;
+			return Ptr;
+		}
+	}
+
+	void* NewPtr = Malloc( NewSize, Alignment );
+	appMemcpy( NewPtr, Ptr, Min<SIZE_T>( OldSize, NewSize ) );
+	Free( Ptr );
+	return NewPtr;
+}
+
+void FMallocThreadCache::Free( void* Ptr )
+{
+	if( !Ptr )
+	{
+		return;
+	}
+	FThreadCache* Cache = GetThreadCache();
+	Cache->CurrentAllocs--;
+
+	FSpanHeader* Header = GetSpanHeader( Ptr );
+	const INT SizeClass = Header->SizeClass;
+	if( SizeClass != INDEX_NONE )
+	{
+		FFreeBlock* Block				= (FFreeBlock*) Ptr;
+		Block->Next						= Cache->FreeLists[SizeClass];
+		Cache->FreeLists[SizeClass]		= Block;
+		Cache->FreeCounts[SizeClass]++;
+		Cache->UsedBytes				-= SizeClasses[SizeClass].BlockSize;
+
+		// Keep up to two batches around so alternating allocations and frees don't hit the central lists.
+		if( Cache->FreeCounts[SizeClass] > 2 * SizeClasses[SizeClass].BatchSize )
+		{
+			ReleaseToCentral( Cache, SizeClass );
+		}
+	}
+	else
+	{
+		checkSlow( Ptr == (BYTE*) Header + SPAN_HEADER_SIZE );
+		Cache->UsedBytes -= Header->LargeSize;
+		Unmap( Header, Header->MappedSize );
+	}
+}
+
+/**
+ * Gathers memory allocations for both virtual and physical allocations.
+ *
+ * @param Virtual	[out] size of virtual allocations
+ * @param Physical	[out] size of physical allocations
+ */
+void FMallocThreadCache::GetAllocationInfo( SIZE_T& Virtual, SIZE_T& Physical )
+{
+	Virtual		= (SIZE_T) OsCurrentKB * 1024;
+	Physical	= 0;
+}
+
+UBOOL FMallocThreadCache::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
+{
+	if( ParseCommand(&Cmd,TEXT("DUMPALLOCS")) )
+	{
+		const FString	Token			= ParseToken( Cmd, 0 );
+		const UBOOL		bSummaryOnly	= Token == TEXT("SUMMARYONLY");
+		DumpAllocs( bSummaryOnly, Ar );
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/**
+ * Logs memory usage, optionally broken down by size class.
+ *
+ * @param bSummaryOnly	whether to skip the per size class stats
+ * @param Ar			device to log to
+ */
+void FMallocThreadCache::DumpAllocs( UBOOL bSummaryOnly, FOutputDevice& Ar )
+{
+	// Per thread counters are read without synchronization, which is fine for stats.
+	SIZE_T	UsedBytes		= 0;
+	INT		CurrentAllocs	= 0;
+	INT		TotalAllocs		= 0;
+	INT		NumThreads		= 0;
+	INT		CachedBlocks[NUM_SIZE_CLASSES];
+	appMemzero( CachedBlocks, sizeof(CachedBlocks) );
+	{
+		FScopeMutexLock ScopeLock( &ThreadCachesMutex );
+		UsedBytes		= RetiredUsedBytes;
+		CurrentAllocs	= RetiredCurrentAllocs;
+		TotalAllocs		= RetiredTotalAllocs;
+		for( FThreadCache* Cache=ThreadCaches; Cache; Cache=Cache->Next )
+		{
+			UsedBytes		+= Cache->UsedBytes;
+			CurrentAllocs	+= Cache->CurrentAllocs;
+			TotalAllocs		+= Cache->TotalAllocs;
+			NumThreads++;
+			for( INT SizeClass=0; SizeClass<NUM_SIZE_CLASSES; SizeClass++ )
+			{
+				CachedBlocks[SizeClass] += Cache->FreeCounts[SizeClass];
+			}
+		}
+	}
+
+	Ar.Logf( TEXT("Memory Allocation Status") );
+	Ar.Logf( TEXT("Curr Memory % 5.3fM / % 5.3fM"), UsedBytes/1024.0/1024.0, OsCurrentKB/1024.0 );
+	Ar.Logf( TEXT("Peak Memory          / % 5.3fM"), OsPeakKB/1024.0 );
+	Ar.Logf( TEXT("Allocs      % 6i Current / % 6i Total"), CurrentAllocs, TotalAllocs );
+	Ar.Logf( TEXT("Threads     % 6i"), NumThreads );
+
+	if( !bSummaryOnly )
+	{
+		Ar.Logf( TEXT("Block Size Batch Num Spans Thread Cached Central Free Mem Used") );
+		Ar.Logf( TEXT("---------- ----- --------- ------------- ------------ --------") );
+		INT TotalSpans = 0;
+		for( INT SizeClass=0; SizeClass<NUM_SIZE_CLASSES; SizeClass++ )
+		{
+			FSizeClass& Class = SizeClasses[SizeClass];
+			INT NumSpans;
+			INT CentralFree;
+			{
+				FScopeMutexLock ScopeLock( &Class.Mutex );
+				NumSpans	= Class.NumSpans;
+				CentralFree	= Class.NumLooseBlocks + Class.NumBatchedBlocks;
+			}
+			Ar.Logf
+			(
+				TEXT("% 10i % 5i % 9i % 13i % 12i % 7iK"),
+				Class.BlockSize,
+				Class.BatchSize,
+				NumSpans,
+				CachedBlocks[SizeClass],
+				CentralFree,
+				NumSpans * (SPAN_SIZE / 1024)
+			);
+			TotalSpans += NumSpans;
+		}
+		Ar.Logf( TEXT("Small allocations use %iK in %i spans"), TotalSpans * (SPAN_SIZE / 1024), TotalSpans );
+	}
+}
+
+#endif	// __LINUX__
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -100,24 +100,29 @@ void FArchive::SerializeCompressed( void* V, INT Length, ECompressionFlags Flags
 			MaxCompressedSize = Max( CompressionChunks[ChunkIndex].CompressedSize, MaxCompressedSize );
 		}
 
-		// Set up destination pointer and allocate memory for compressed chunk[s] (one at a time).
-		BYTE*	Dest				= (BYTE*) V;
-		void*	CompressedBuffer	= appMalloc( MaxCompressedSize );
+		// Set up destination pointer and the pipeline decompressing a window of chunks in parallel. A single chunk has
+		// nothing to overlap with so it is decompressed synchronously on this thread, and the window is never larger
+		// than the number of chunks.
+		BYTE*	Dest	= (BYTE*) V;
+		const INT WindowSize = TotalChunkCount > 1 ? Min( FAsyncUncompressPipeline::GetDefaultWindowSize(), TotalChunkCount ) : 1;
+		FAsyncUncompressPipeline Pipeline( Flags, MaxCompressedSize, WindowSize );
 
 		// Iteratre over all chunks, serialize them into memory and decompress them directly into the destination pointer
+		// while the next ones are being serialized.
 		for( INT ChunkIndex=0; ChunkIndex<TotalChunkCount; ChunkIndex++ )
 		{
 			const FCompressedChunkInfo& Chunk = CompressionChunks[ChunkIndex];
 			// Read compressed data.
+			void* CompressedBuffer = Pipeline.GetCompressedBuffer();
 			Serialize( CompressedBuffer, Chunk.CompressedSize );
 			// Decompress into dest pointer directly.
-			verify( appUncompressMemory( Flags, Dest, Chunk.UncompressedSize, CompressedBuffer, Chunk.CompressedSize ) );
+			Pipeline.Uncompress( Dest, Chunk.UncompressedSize, Chunk.CompressedSize );
 			// And advance it by read amount.
 			Dest += Chunk.UncompressedSize;
 		}
 
-		// Free up allocated memory.
-		appFree( CompressedBuffer );
+		// Wait for the last chunks before the data is used.
+		Pipeline.Flush();
 		delete [] CompressionChunks;
 	}
 	else if( IsSaving() )
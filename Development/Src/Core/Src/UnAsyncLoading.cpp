@@ -644,21 +644,15 @@ QWORD FAsyncIOSystemBase::QueueIORequest(
 }
 
 /**
- * Fulfills a compressed read request in a blocking fashion by falling back to using
- * PlatformSeek and various PlatformReads in combination with FAsyncUncompress to allow
- * decompression while we are waiting for file I/O.
+ * Fulfills a compressed read request in a blocking fashion by reading compressed chunks one
+ * after another and decompressing a window of them in parallel with FAsyncUncompressPipeline.
  *
  * @note: the way this code works needs to be in line with FArchive::SerializeCompressed
  */
 void FAsyncIOSystemBase::FulfillCompressedRead( const FAsyncIORequest& IORequest )
 {
 	// Initialize variables.
-	FAsyncUncompress*		Uncompressor			= NULL;
 	BYTE*					UncompressedBuffer		= (BYTE*) IORequest.Dest;
-	// First compression chunk contains information about total size so we skip that one.
-	INT						CurrentChunkIndex		= 1;
-	INT						CurrentBufferIndex		= 0;
-	UBOOL					bHasProcessedAllData	= FALSE;
 
 	// read the first two ints, which will contain the magic bytes (to detect byteswapping)
 	// and the original size the chunks were compressed from
@@ -708,7 +702,6 @@ void FAsyncIOSystemBase::FulfillCompressedRead( const FAsyncIORequest& IORequest
 	// allocate chunk info data based on number of chunks
 	FCompressedChunkInfo*	CompressionChunks		= new FCompressedChunkInfo[TotalChunkCount];
 	INT						ChunkInfoSize			= (TotalChunkCount) * sizeof(FCompressedChunkInfo);
-	void*					CompressedBuffer[2];
 	
 	// Read table of compression chunks after seeking to offset (after the initial header data)
 	PlatformRead( IORequest.FileHandle, IORequest.Offset + sizeof(HeaderData), ChunkInfoSize, CompressionChunks );
@@ -743,65 +736,33 @@ void FAsyncIOSystemBase::FulfillCompressedRead( const FAsyncIORequest& IORequest
 		check( CompressionChunks[ChunkIndex].UncompressedSize <= CompressionChunkSize );
 	}
 
-	// Allocate memory for compressed data.
-	CompressedBuffer[0]	= appMalloc( MaxCompressedSize );
-	CompressedBuffer[1] = appMalloc( MaxCompressedSize );
+	// Chunks are decompressed in parallel by the pipeline while the following ones are being read. The first chunk
+	// info is the summary, so a single data chunk is decompressed synchronously on this thread.
+	const INT NumDataChunks = TotalChunkCount - 1;
+	const INT WindowSize = NumDataChunks > 1 ? Min( FAsyncUncompressPipeline::GetDefaultWindowSize(), NumDataChunks ) : 1;
+	FAsyncUncompressPipeline Pipeline( IORequest.CompressionFlags, MaxCompressedSize, WindowSize );
 
-	// Initial read request.
-	PlatformRead( IORequest.FileHandle, INDEX_NONE, CompressionChunks[CurrentChunkIndex].CompressedSize, CompressedBuffer[CurrentBufferIndex] );
+	// Compressed chunks are stored back to back following the chunk table. Reads always pass an explicit offset
+	// so platforms can fulfill several requests from the same handle at once.
+	INT ReadOffset = IORequest.Offset + HeaderSize + ChunkInfoSize;
 
-	// Loop till we're done decompressing all data.
-	while( !bHasProcessedAllData )
+	// First compression chunk contains information about total size so we skip that one.
+	for( INT ChunkIndex=1; ChunkIndex<TotalChunkCount; ChunkIndex++ )
 	{
-		// Create uncompressor object performing async decompression.
-		Uncompressor = new FAsyncUncompress	(
-								IORequest.CompressionFlags,
-								UncompressedBuffer,
-								CompressionChunks[CurrentChunkIndex].UncompressedSize,
-								CompressedBuffer[CurrentBufferIndex],
-								CompressionChunks[CurrentChunkIndex].CompressedSize
-											);
-		// Add to queued work pool for processing.
-		GThreadPool->AddQueuedWork( Uncompressor );
-
-		// Advance destination pointer.
-		UncompressedBuffer += CompressionChunks[CurrentChunkIndex].UncompressedSize;
-	
-		// Check whether we are already done reading.
-		if( CurrentChunkIndex < TotalChunkCount-1 )
-		{
-			// Can't postincrement in if statement as we need it to remain at valid value for one more loop iteration to finish
-			// the decompression.
-			CurrentChunkIndex++;
-			// Swap compression buffers to read into.
-			CurrentBufferIndex = 1 - CurrentBufferIndex;
-			// Read more data.
-			PlatformRead( IORequest.FileHandle, INDEX_NONE, CompressionChunks[CurrentChunkIndex].CompressedSize, CompressedBuffer[CurrentBufferIndex] );
-		}
-		// We were already done reading the last time around so we are done processing now.
-		else
-		{
-			bHasProcessedAllData = TRUE;
-		}
-		
-		//@todo async loading: should use event for this
-		STAT(DOUBLE UncompressorWaitTime = 0);
-		{
-			SCOPE_SECONDS_COUNTER(UncompressorWaitTime);
-			// Sync with decompressor.
-			while( !Uncompressor->IsDone() )
-			{
-				appSleep( 0 );
-			}
-		}
-		INC_FLOAT_STAT_BY(STAT_AsyncIO_UncompressorWaitTime,(FLOAT)UncompressorWaitTime);
-		delete Uncompressor;
-		Uncompressor = NULL;
+		const FCompressedChunkInfo& Chunk = CompressionChunks[ChunkIndex];
+		// Read the chunk into the next free buffer...
+		PlatformRead( IORequest.FileHandle, ReadOffset, Chunk.CompressedSize, Pipeline.GetCompressedBuffer() );
+		ReadOffset += Chunk.CompressedSize;
+		// ... and kick off its decompression, which continues while the next ones are being read.
+		Pipeline.Uncompress( UncompressedBuffer, Chunk.UncompressedSize, Chunk.CompressedSize );
+		UncompressedBuffer += Chunk.UncompressedSize;
 	}
 
+	// Sync with decompressor.
+	Pipeline.Flush();
+	INC_FLOAT_STAT_BY(STAT_AsyncIO_UncompressorWaitTime,(FLOAT)Pipeline.GetWaitTime());
+
 	delete [] CompressionChunks;
-	appFree( CompressedBuffer[0] );
-	appFree( CompressedBuffer[1] );
 }
 
 /**
@@ -1059,69 +1020,81 @@ DWORD FAsyncIOSystemBase::Run()
 	// IsRunning gets decremented by Stop.
 	while( IsRunning.GetValue() > 0 )
 	{
-		// Copy of read request.
-		FAsyncIORequest IORequest				= {0};
-		UBOOL			bIsReadRequestPending	= FALSE;
+		if( !FulfillNextRequest() )
 		{
-			FScopeLock ScopeLock( CriticalSection );
-			if( OutstandingRequests.Num() )
-			{
-				// Gets next request index based on platform specific criteria like layout on disc.
-				INT TheRequestIndex = PlatformGetNextRequestIndex();
-				if( TheRequestIndex != INDEX_NONE )
-				{					
-					// We need to copy as we're going to remove it...
-					IORequest = OutstandingRequests( TheRequestIndex );
-					// ...right here.
-					OutstandingRequests.Remove( TheRequestIndex );		
-					// We're busy reading. Updated inside scoped lock to ensure BlockTillAllRequestsFinished works correctly.
-					BusyReading.Increment();
-					bIsReadRequestPending = TRUE;
-				}
+			// Wait till the calling thread signals further work.
+			OutstandingRequestsEvent->Wait();
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Picks the next outstanding request, if there is one, and fulfills it in a blocking fashion.
+ * Safe to be called from several threads at once as long as PlatformRead is.
+ *
+ * @return	TRUE if a request was fulfilled, FALSE if there was nothing to do
+ */
+UBOOL FAsyncIOSystemBase::FulfillNextRequest()
+{
+	// Copy of read request.
+	FAsyncIORequest IORequest				= {0};
+	UBOOL			bIsReadRequestPending	= FALSE;
+	{
+		FScopeLock ScopeLock( CriticalSection );
+		if( OutstandingRequests.Num() )
+		{
+			// Gets next request index based on platform specific criteria like layout on disc.
+			INT TheRequestIndex = PlatformGetNextRequestIndex();
+			if( TheRequestIndex != INDEX_NONE )
+			{					
+				// We need to copy as we're going to remove it...
+				IORequest = OutstandingRequests( TheRequestIndex );
+				// ...right here.
+				OutstandingRequests.Remove( TheRequestIndex );		
+				// We're busy reading. Updated inside scoped lock to ensure BlockTillAllRequestsFinished works correctly.
+				BusyReading.Increment();
+				bIsReadRequestPending = TRUE;
+				// Retrieve cached handle or create it if it wasn't cached. The handle map is shared with other readers.
+				IORequest.FileHandle = GetCachedFileHandle( IORequest.FileName );
 			}
 		}
+	}
 
-		// We only have work to do if there's a v
-		if( bIsReadRequestPending )
+	// We only have work to do if there's a v
+	if( bIsReadRequestPending )
+	{
+		if( PlatformIsHandleValid(IORequest.FileHandle) )
 		{
-			// Retrieve cached handle or create it if it wasn't cached.
-			IORequest.FileHandle = GetCachedFileHandle( IORequest.FileName );
-			if( PlatformIsHandleValid(IORequest.FileHandle) )
+			if( IORequest.UncompressedSize )
 			{
-				if( IORequest.UncompressedSize )
-				{
-					// Data is compressed on disc so we need to also decompress.
-					FulfillCompressedRead( IORequest );
-				}
-				else
-				{
-					// Read data after seeking.
-					PlatformRead( IORequest.FileHandle, IORequest.Offset, IORequest.Size, IORequest.Dest );
-				}
-				INC_DWORD_STAT( STAT_AsyncIO_FulfilledReadCount );
-				INC_DWORD_STAT_BY( STAT_AsyncIO_FulfilledReadSize, IORequest.Size );
+				// Data is compressed on disc so we need to also decompress.
+				FulfillCompressedRead( IORequest );
 			}
 			else
 			{
-				//@todo streaming: add warning once we have thread safe logging.
+				// Read data after seeking.
+				PlatformRead( IORequest.FileHandle, IORequest.Offset, IORequest.Size, IORequest.Dest );
 			}
-
-			DEC_DWORD_STAT( STAT_AsyncIO_OutstandingReadCount );
-			DEC_DWORD_STAT_BY( STAT_AsyncIO_OutstandingReadSize, IORequest.Size );
-
-			// Request fulfilled.
-			IORequest.Counter->Decrement(); 
-			// We're done reading for now.
-			BusyReading.Decrement();	
+			INC_DWORD_STAT( STAT_AsyncIO_FulfilledReadCount );
+			INC_DWORD_STAT_BY( STAT_AsyncIO_FulfilledReadSize, IORequest.Size );
 		}
 		else
 		{
-			// Wait till the calling thread signals further work.
-			OutstandingRequestsEvent->Wait();
+			//@todo streaming: add warning once we have thread safe logging.
 		}
+
+		DEC_DWORD_STAT( STAT_AsyncIO_OutstandingReadCount );
+		DEC_DWORD_STAT_BY( STAT_AsyncIO_OutstandingReadSize, IORequest.Size );
+
+		// Request fulfilled.
+		IORequest.Counter->Decrement(); 
+		// We're done reading for now.
+		BusyReading.Decrement();	
 	}
 
-	return 0;
+	return bIsReadRequestPending;
 }
 
 /**
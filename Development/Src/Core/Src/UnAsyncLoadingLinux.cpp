@@ -0,0 +1,281 @@
+/*=============================================================================
+	UnAsyncLoadingLinux.cpp: Unreal async loading code, Linux implementation.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+
+#if __LINUX__
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+/** Default number of reads kept in flight, including the one of the IO system thread itself. */
+#define DEFAULT_ASYNCIO_READERS		4
+/** Time in milliseconds an idle reader waits before checking whether it should exit. */
+#define ASYNCIO_READER_WAIT_TIME	100
+
+/*-----------------------------------------------------------------------------
+	Async loading stats.
+-----------------------------------------------------------------------------*/
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Platform read time"),STAT_AsyncIO_PlatformReadTime,STATGROUP_AsyncIO);
+
+
+/*-----------------------------------------------------------------------------
+	FAsyncIOReaderLinux.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Additional reader thread of FAsyncIOSystemLinux, fulfilling requests from the same queue as
+ * the IO system thread.
+ */
+class FAsyncIOReaderLinux : public FRunnable
+{
+public:
+	/**
+	 * Constructor, initializing member variables.
+	 *
+	 * @param	InIOSystem	IO system to fulfill requests of
+	 */
+	FAsyncIOReaderLinux( FAsyncIOSystemLinux* InIOSystem )
+	:	IOSystem( InIOSystem )
+	{}
+
+	// FRunnable interface.
+	virtual UBOOL Init()
+	{
+		return TRUE;
+	}
+	virtual DWORD Run()
+	{
+		// The IO system's running state is shared by all readers and cleared by its Stop.
+		while( IOSystem->IsRunning.GetValue() > 0 )
+		{
+			if( !IOSystem->FulfillNextRequest() )
+			{
+				// Every queued request triggers the event once, waking up a single reader. The timeout
+				// makes sure we notice the IO system stopping as the event is only triggered once then.
+				IOSystem->OutstandingRequestsEvent->Wait( ASYNCIO_READER_WAIT_TIME );
+			}
+		}
+		return 0;
+	}
+	virtual void Stop()
+	{}
+	virtual void Exit()
+	{}
+
+private:
+	/** IO system to fulfill requests of. */
+	FAsyncIOSystemLinux* IOSystem;
+};
+
+
+/*-----------------------------------------------------------------------------
+	FAsyncIOSystemLinux implementation.
+-----------------------------------------------------------------------------*/
+
+/** Constructor, initializing member variables. */
+FAsyncIOSystemLinux::FAsyncIOSystemLinux()
+:	LastReadEnd( 0 )
+{}
+
+/**
+ * Initializes the base and spawns the additional reader threads. If the platform can't create them
+ * the IO system thread fulfills all requests on its own.
+ *
+ * @return True if initialization was successful, false otherwise
+ */
+UBOOL FAsyncIOSystemLinux::Init()
+{
+	if( !FAsyncIOSystemBase::Init() )
+	{
+		return FALSE;
+	}
+
+	// The IO system thread is a reader itself.
+	INT NumReaders = DEFAULT_ASYNCIO_READERS;
+	Parse( appCmdLine(), TEXT("ASYNCIOREADERS="), NumReaders );
+	for( INT ReaderIndex=1; ReaderIndex<NumReaders; ReaderIndex++ )
+	{
+		FAsyncIOReaderLinux* Reader = new FAsyncIOReaderLinux( this );
+		FRunnableThread* ReaderThread = GThreadFactory->CreateThread( Reader, *FString::Printf(TEXT("AsyncIOReader%i"),ReaderIndex), 0, 0, 0, TPri_BelowNormal );
+		if( ReaderThread == NULL )
+		{
+			debugf( NAME_Warning, TEXT("Failed to create async IO reader thread, continuing with %i reader(s)."), ReaderIndex );
+			delete Reader;
+			break;
+		}
+		Readers.AddItem( Reader );
+		ReaderThreads.AddItem( ReaderThread );
+	}
+	return TRUE;
+}
+
+/**
+ * Stops and destroys the reader threads before cleaning up the base.
+ */
+void FAsyncIOSystemLinux::Exit()
+{
+	// Stop has already been called at this point so the readers are on their way out.
+	for( INT ReaderIndex=0; ReaderIndex<ReaderThreads.Num(); ReaderIndex++ )
+	{
+		ReaderThreads(ReaderIndex)->Kill( TRUE );
+		GThreadFactory->Destroy( ReaderThreads(ReaderIndex) );
+		delete Readers(ReaderIndex);
+	}
+	ReaderThreads.Empty();
+	Readers.Empty();
+
+	FAsyncIOSystemBase::Exit();
+}
+
+/**
+ * Reads passed in number of bytes from passed in file handle.
+ *
+ * @param	FileHandle	Handle of file to read from.
+ * @param	Offset		Offset in bytes from start, INDEX_NONE if file pointer shouldn't be changed
+ * @param	Size		Size in bytes to read at current position from passed in file handle
+ * @param	Dest		Pointer to data to read into
+ *
+ * @return	TRUE if read was successful, FALSE otherwise
+ */
+UBOOL FAsyncIOSystemLinux::PlatformRead( FAsyncIOHandle FileHandle, INT Offset, INT Size, void* Dest )
+{
+	const INT	FileDescriptor	= (INT)(PTRINT) FileHandle.Handle;
+	INT			BytesRead		= 0;
+	STAT(DOUBLE ReadTime = 0);
+	{
+		SCOPE_SECONDS_COUNTER(ReadTime);
+		SCOPED_FILE_IO_ASYNC_READ_STATS(FileHandle.StatsHandle,Size,Offset);
+
+		while( BytesRead < Size )
+		{
+			// pread leaves the file pointer alone so readers can share the handle. Reads without an
+			// offset are only safe from a single reader and are not issued by the base code.
+			const ssize_t Result = Offset != INDEX_NONE
+				? pread( FileDescriptor, (BYTE*)Dest + BytesRead, Size - BytesRead, Offset + BytesRead )
+				: read( FileDescriptor, (BYTE*)Dest + BytesRead, Size - BytesRead );
+			if( Result > 0 )
+			{
+				BytesRead += Result;
+			}
+			else if( Result < 0 && errno == EINTR )
+			{
+				continue;
+			}
+			else
+			{
+				// End of file or error.
+				break;
+			}
+		}
+	}
+	INC_FLOAT_STAT_BY(STAT_AsyncIO_PlatformReadTime,(FLOAT)ReadTime);
+	// Constrain bandwidth if wanted.
+	STAT(ConstrainBandwidth(Size, ReadTime));
+	return BytesRead == Size;
+}
+
+/**
+ * Creates a file handle for the passed in file name
+ *
+ * @param	Filename	Pathname to file
+ *
+ * @return	INVALID_HANDLE if failure, handle on success
+ */
+FAsyncIOHandle FAsyncIOSystemLinux::PlatformCreateHandle( const TCHAR* Filename )
+{
+	FAsyncIOHandle FileHandle;
+
+	// Convert to an absolute path in order to be able to handle current working directory changing on us.
+	FString AbsPath			= appConvertRelativePathToFull( Filename );
+	FileHandle.Handle		= (void*)(PTRINT) open( TCHAR_TO_ANSI(*AbsPath), O_RDONLY );
+	if( PlatformIsHandleValid( FileHandle ) )
+	{
+		// Requests are ordered by offset so let the kernel read ahead aggressively.
+		posix_fadvise( (INT)(PTRINT) FileHandle.Handle, 0, 0, POSIX_FADV_SEQUENTIAL );
+	}
+
+	FileHandle.StatsHandle	= FILE_IO_STATS_GET_HANDLE( Filename );
+	return FileHandle;
+}
+
+/**
+ * Closes passed in file handle.
+ */
+void FAsyncIOSystemLinux::PlatformDestroyHandle( FAsyncIOHandle FileHandle )
+{
+	close( (INT)(PTRINT) FileHandle.Handle );
+}
+
+/**
+ * Returns whether the passed in handle is valid or not.
+ *
+ * @param	FileHandle	File hande to check validity
+ *
+ * @return	TRUE if file handle is valid, FALSE otherwise
+ */
+UBOOL FAsyncIOSystemLinux::PlatformIsHandleValid( FAsyncIOHandle FileHandle )
+{
+	return (INT)(PTRINT) FileHandle.Handle >= 0;
+}
+
+/**
+ * Determines the next request index to be fulfilled. Of the highest priority requests, the one
+ * closest after the end of the last read in the same file is picked to avoid seeking, falling
+ * back to the oldest one.
+ *
+ * This function is being called while there is a scope lock on the critical section so it
+ * needs to be fast in order to not block QueueIORequest and the likes.
+ *
+ * @return	index of next to be fulfilled request or INDEX_NONE if there is none
+ */
+INT FAsyncIOSystemLinux::PlatformGetNextRequestIndex()
+{
+	// Find the highest priority of outstanding requests.
+	EAsyncIOPriority HighestPriority = AIOP_MIN;
+	for( INT CurrentRequestIndex=0; CurrentRequestIndex<OutstandingRequests.Num(); CurrentRequestIndex++ )
+	{
+		HighestPriority = Max( HighestPriority, OutstandingRequests(CurrentRequestIndex).Priority );
+	}
+	if( HighestPriority < MinPriority )
+	{
+		return INDEX_NONE;
+	}
+
+	INT OldestIndex		= INDEX_NONE;
+	INT ClosestIndex	= INDEX_NONE;
+	for( INT CurrentRequestIndex=0; CurrentRequestIndex<OutstandingRequests.Num(); CurrentRequestIndex++ )
+	{
+		const FAsyncIORequest& Request = OutstandingRequests(CurrentRequestIndex);
+		if( Request.Priority == HighestPriority )
+		{
+			// Requests are added to the end so the first one found is the oldest.
+			if( OldestIndex == INDEX_NONE )
+			{
+				OldestIndex = CurrentRequestIndex;
+			}
+			// Keep on reading forward in the same file.
+			if( Request.Offset >= LastReadEnd
+			&&	(ClosestIndex == INDEX_NONE || Request.Offset < OutstandingRequests(ClosestIndex).Offset)
+			&&	Request.FileName == LastFileName )
+			{
+				ClosestIndex = CurrentRequestIndex;
+			}
+		}
+	}
+
+	const INT NextIndex = ClosestIndex != INDEX_NONE ? ClosestIndex : OldestIndex;
+	LastFileName		= OutstandingRequests(NextIndex).FileName;
+	LastReadEnd			= OutstandingRequests(NextIndex).Offset + OutstandingRequests(NextIndex).Size;
+	return NextIndex;
+}
+
+#endif
+
+/*----------------------------------------------------------------------------
+	End.
+----------------------------------------------------------------------------*/
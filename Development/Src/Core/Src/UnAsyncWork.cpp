@@ -169,6 +169,125 @@ void FAsyncUncompress::DoWork(void)
 	// Set internal state to notify that we are done.
 }
 
+/*-----------------------------------------------------------------------------
+	FAsyncUncompressPipeline.
+-----------------------------------------------------------------------------*/
+
+/** Upper bound of the automatically chosen decompression window size. */
+#define MAX_DEFAULT_DECOMPRESSION_WINDOW	8
+
+/**
+ * Constructor, allocating a compressed data buffer per slot.
+ *
+ * @param	InFlags				Flags to control what method to use for decompression
+ * @param	InMaxCompressedSize	Size of largest compressed chunk in bytes
+ * @param	InWindowSize		Number of chunks decompressed at once, INDEX_NONE to use GetDefaultWindowSize
+ */
+FAsyncUncompressPipeline::FAsyncUncompressPipeline( ECompressionFlags InFlags, INT InMaxCompressedSize, INT InWindowSize )
+:	Flags( InFlags )
+,	MaxCompressedSize( Align( Max( InMaxCompressedSize, 1 ), 16 ) )
+,	WindowSize( InWindowSize == INDEX_NONE ? GetDefaultWindowSize() : Max( InWindowSize, 1 ) )
+,	CurrentSlot( INDEX_NONE )
+,	WaitTime( 0 )
+{
+	// Without a thread pool there is nothing to overlap with.
+	if( !GThreadPool )
+	{
+		WindowSize = 1;
+	}
+	CompressedBuffers	= (BYTE*) appMalloc( MaxCompressedSize * WindowSize );
+	PendingChunks		= new FThreadSafeCounter[WindowSize];
+}
+
+/**
+ * Destructor, waiting for all chunks and freeing the buffers.
+ */
+FAsyncUncompressPipeline::~FAsyncUncompressPipeline()
+{
+	Flush();
+	delete [] PendingChunks;
+	appFree( CompressedBuffers );
+}
+
+/**
+ * @return number of chunks decompressed at once, based on GDecompressionWindowSize
+ */
+INT FAsyncUncompressPipeline::GetDefaultWindowSize()
+{
+	if( GDecompressionWindowSize > 0 )
+	{
+		return GDecompressionWindowSize;
+	}
+	// Enough chunks to keep every core busy while the next one is being read.
+	return Clamp<INT>( GNumHardwareThreads, 2, MAX_DEFAULT_DECOMPRESSION_WINDOW );
+}
+
+/**
+ * Blocks till the chunk using the passed in slot has been decompressed.
+ */
+void FAsyncUncompressPipeline::WaitForSlot( INT SlotIndex )
+{
+	if( PendingChunks[SlotIndex].GetValue() > 0 )
+	{
+		//@todo async loading: should use event for this
+		const DOUBLE StartTime = appSeconds();
+		while( PendingChunks[SlotIndex].GetValue() > 0 )
+		{
+			appSleep( 0 );
+		}
+		WaitTime += appSeconds() - StartTime;
+	}
+}
+
+/**
+ * Returns the buffer the next chunk's compressed data should be read into, blocking till the chunk that
+ * last used it has been decompressed.
+ *
+ * @return buffer of at least InMaxCompressedSize bytes
+ */
+void* FAsyncUncompressPipeline::GetCompressedBuffer()
+{
+	CurrentSlot = (CurrentSlot + 1) % WindowSize;
+	WaitForSlot( CurrentSlot );
+	return CompressedBuffers + CurrentSlot * MaxCompressedSize;
+}
+
+/**
+ * Kicks off decompression of the chunk read into the buffer last returned by GetCompressedBuffer.
+ *
+ * @param	UncompressedBuffer	Buffer to decompress into, needs to stay valid till Flush
+ * @param	UncompressedSize	Size of uncompressed data in bytes
+ * @param	CompressedSize		Size of compressed data in bytes
+ */
+void FAsyncUncompressPipeline::Uncompress( void* UncompressedBuffer, INT UncompressedSize, INT CompressedSize )
+{
+	check( CurrentSlot != INDEX_NONE );
+	check( CompressedSize <= MaxCompressedSize );
+	BYTE* CompressedBuffer = CompressedBuffers + CurrentSlot * MaxCompressedSize;
+
+	if( WindowSize == 1 )
+	{
+		verify( appUncompressMemory( Flags, UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize ) );
+	}
+	else
+	{
+		PendingChunks[CurrentSlot].Increment();
+		// Deletes itself once done.
+		GThreadPool->AddQueuedWork( new FAsyncUncompress( Flags, UncompressedBuffer, UncompressedSize, CompressedBuffer, CompressedSize, &PendingChunks[CurrentSlot] ) );
+	}
+}
+
+/**
+ * Blocks till all chunks have been decompressed.
+ */
+void FAsyncUncompressPipeline::Flush()
+{
+	for( INT SlotIndex=0; SlotIndex<WindowSize; SlotIndex++ )
+	{
+		WaitForSlot( SlotIndex );
+	}
+}
+
 
 
 /*-----------------------------------------------------------------------------
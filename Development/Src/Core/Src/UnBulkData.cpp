@@ -82,8 +82,7 @@ FUntypedBulkData::~FUntypedBulkData()
 {
 	check( LockStatus == LOCKSTATUS_Unlocked );
 	// Free memory.
-	appFree( BulkData );
-	BulkData = NULL;
+	FreeBulkData();
 	// Detach from archive.
 	if( AttachedAr )
 	{
@@ -356,8 +355,7 @@ void FUntypedBulkData::GetCopy( void** Dest, UBOOL bDiscardInternalCopy )
 			// single use bulk data.
 			if( bDiscardInternalCopy && (AttachedAr || (BulkDataFlags & BULKDATA_SingleUse)) )
 			{
-				appFree( BulkData );
-				BulkData = NULL;
+				FreeBulkData();
 			}
 		}
 		// Data isn't currently loaded so we need to load it from disk.
@@ -374,9 +372,11 @@ void FUntypedBulkData::GetCopy( void** Dest, UBOOL bDiscardInternalCopy )
 		{
 			// If the internal copy should be discarded and we are still attached to an archive we can
 			// simply "return" the already existing copy and NULL out the internal reference. We can
-			// also do this if the data is single use like e.g. when uploading texture data.
+			// also do this if the data is single use like e.g. when uploading texture data. Data
+			// referencing a mapped package is copied as the caller is going to appFree it.
 			if( bDiscardInternalCopy && (AttachedAr || (BulkDataFlags & BULKDATA_SingleUse)) )
 			{
+				MakeSureBulkDataIsOwned();
 				*Dest = BulkData;
 				BulkData = NULL;
 			}
@@ -418,6 +418,9 @@ void* FUntypedBulkData::Lock( DWORD LockFlags )
 	{
 		LockStatus = LOCKSTATUS_ReadWriteLock;
 
+		// Mapped packages are read-only.
+		MakeSureBulkDataIsOwned();
+
 		// We need to detach from the archive to not be able to clobber changes by serializing
 		// over them.
 		if( AttachedAr )
@@ -466,8 +469,7 @@ void FUntypedBulkData::Unlock()
 	// if required later on. Also free if we're guaranteed to only to access the data once.
 	if( AttachedAr || (BulkDataFlags & BULKDATA_SingleUse) )
 	{
-		appFree( BulkData );
-		BulkData = NULL;
+		FreeBulkData();
 	}
 }
 
@@ -485,8 +487,7 @@ void FUntypedBulkData::RemoveBulkData()
 	}
 	// Resize to 0 elements.
 	ElementCount	= 0;
-	appFree( BulkData );
-	BulkData		= NULL;
+	FreeBulkData();
 }
 
 
@@ -507,8 +508,8 @@ void FUntypedBulkData::SerializeLikeLazyArray( FArchive &Ar, UObject* Owner )
 	check( Ar.IsLoading() );
 	check( Ar.IsPersistent() );
 
-	// Initialize variables filled in by regular serialization code.
-	BulkDataFlags			= BULKDATA_ForceSingleElementSerialization;
+	// Initialize variables filled in by regular serialization code, keeping track of whether the data we hold is mapped.
+	BulkDataFlags			= BULKDATA_ForceSingleElementSerialization | (BulkDataFlags & BULKDATA_Mapped);
 	ElementCount			= INDEX_NONE;
 	BulkDataSizeOnDisk		= INDEX_NONE;
 	BulkDataOffsetInFile	= INDEX_NONE;
@@ -575,7 +576,7 @@ void FUntypedBulkData::SerializeLikeLazyArray( FArchive &Ar, UObject* Owner )
 	else
 	{
 		// Allocate memory and serialize data into.
-		BulkData = appRealloc( BulkData, GetBulkDataSize() );
+		AllocateBulkData();
 		SerializeBulkData( Ar, BulkData );
 		check( Ar.Tell() == EndPosition );
 	}
@@ -595,15 +596,18 @@ void FUntypedBulkData::Serialize( FArchive& Ar, UObject* Owner )
 	{
 		// Special case for transacting bulk data arrays.
 
-		// Flags for bulk data.
+		// Flags for bulk data. Whether the data is mapped describes the memory currently held and isn't serialized.
+		const DWORD MappedFlag = BulkDataFlags & BULKDATA_Mapped;
+		BulkDataFlags &= ~BULKDATA_Mapped;
 		Ar << BulkDataFlags;
+		BulkDataFlags |= MappedFlag;
 		// Number of elements in array.
 		Ar << ElementCount;
 
 		if(Ar.IsLoading())
 		{
 			// Allocate bulk data.
-			BulkData = appRealloc( BulkData, GetBulkDataSize() );
+			AllocateBulkData();
 
 			// Deserialize bulk data.
 			SerializeBulkData( Ar, BulkData );
@@ -625,8 +629,11 @@ void FUntypedBulkData::Serialize( FArchive& Ar, UObject* Owner )
 		// Keep track of first serialized item to be able to overwrite it.
 		INT BulkDataFlagsPos = Ar.Tell();
 
-		// Flags for bulk data.
+		// Flags for bulk data. Whether the data is mapped describes the memory currently held and isn't serialized.
+		const DWORD MappedFlag = BulkDataFlags & BULKDATA_Mapped;
+		BulkDataFlags &= ~BULKDATA_Mapped;
 		Ar << BulkDataFlags;
+		BulkDataFlags |= MappedFlag;
 
 		// Number of elements in array.
 		Ar << ElementCount;
@@ -660,10 +667,10 @@ void FUntypedBulkData::Serialize( FArchive& Ar, UObject* Owner )
 					// Seek over the bulk data we skipped serializing.
 					Ar.Seek( Ar.Tell() + BulkDataSizeOnDisk );
 				}
-				// Serialize the bulk data right away.
-				else
+				// Serialize the bulk data right away unless it can be referenced in place in a memory mapped package.
+				else if( !SerializeBulkDataMapped( Ar ) )
 				{
-					BulkData = appRealloc( BulkData, GetBulkDataSize() );
+					AllocateBulkData();
 					SerializeBulkData( Ar, BulkData );
 				}
 			}
@@ -692,7 +699,7 @@ void FUntypedBulkData::Serialize( FArchive& Ar, UObject* Owner )
 				MakeSureBulkDataIsLoaded();
 
 				// Keep track of last saved values.
-				SavedBulkDataFlags	= BulkDataFlags;
+				SavedBulkDataFlags	= BulkDataFlags & ~BULKDATA_Mapped;
 				SavedElementCount	= ElementCount;
 	
 				// Keep track of position we are going to serialize placeholder BulkDataSizeOnDisk.
@@ -1007,6 +1014,100 @@ void FUntypedBulkData::MakeSureBulkDataIsLoaded()
 	}
 }
 
+/**
+ * Copies the bulk data into owned memory if it references a memory mapped package.
+ */
+void FUntypedBulkData::MakeSureBulkDataIsOwned()
+{
+	if( BulkDataFlags & BULKDATA_Mapped )
+	{
+		void* OwnedData = appMalloc( GetBulkDataSize() );
+		appMemcpy( OwnedData, BulkData, GetBulkDataSize() );
+		ReleaseMappedBulkData();
+		BulkData = OwnedData;
+	}
+}
+
+/**
+ * (Re)allocates owned memory for GetBulkDataSize bytes, dropping a reference to a mapped package.
+ * Existing contents are only preserved if they were already owned.
+ */
+void FUntypedBulkData::AllocateBulkData()
+{
+	if( BulkDataFlags & BULKDATA_Mapped )
+	{
+		ReleaseMappedBulkData();
+		BulkData = NULL;
+	}
+	BulkData = appRealloc( BulkData, GetBulkDataSize() );
+}
+
+/**
+ * Frees the bulk data, releasing the mapping instead if it references a memory mapped package.
+ */
+void FUntypedBulkData::FreeBulkData()
+{
+	if( BulkDataFlags & BULKDATA_Mapped )
+	{
+		ReleaseMappedBulkData();
+	}
+	else
+	{
+		appFree( BulkData );
+	}
+	BulkData = NULL;
+}
+
+/**
+ * Drops the reference to the memory mapped package the bulk data points into and clears BULKDATA_Mapped.
+ * Only looks up the mapping, which requires a lock, for bulk data tagged as mapped.
+ */
+void FUntypedBulkData::ReleaseMappedBulkData()
+{
+	check( BulkDataFlags & BULKDATA_Mapped );
+	FMappedFile* MappedFile = FMappedFile::FindContaining( BulkData );
+	check( MappedFile );
+	MappedFile->Release();
+	BulkDataFlags &= ~BULKDATA_Mapped;
+}
+
+/**
+ * Points the bulk data directly at the passed in archive's memory mapped file if the data is stored
+ * in a way allowing it to be used in place and skips over it.
+ *
+ * @param	Ar	Archive to serialize with
+ * @return	TRUE if the bulk data now references the mapping, FALSE if it needs to be serialized
+ */
+UBOOL FUntypedBulkData::SerializeBulkDataMapped( FArchive& Ar )
+{
+	FMappedFile* MappedFile = Ar.GetMappedFile();
+	// Only data SerializeBulkData would copy verbatim can be used in place.
+	if( !MappedFile 
+	||	(BulkDataFlags & (BULKDATA_Unused | BULKDATA_SerializeCompressed | BULKDATA_ForceSingleElementSerialization))
+	||	RequiresSingleElementSerialization( Ar )
+	||	GetBulkDataSize() == 0 )
+	{
+		return FALSE;
+	}
+
+	const INT Offset = Ar.Tell();
+	const BYTE* Data = MappedFile->GetData() + Offset;
+	// Bulk data users expect memory aligned like an allocation.
+	if( Offset + GetBulkDataSize() > MappedFile->GetSize() 
+	||	((PTRINT) Data & (DEFAULT_ALIGNMENT - 1)) )
+	{
+		return FALSE;
+	}
+
+	// Mapping is read-only, Lock makes a copy if the data is going to be written to.
+	FreeBulkData();
+	MappedFile->AddRef();
+	BulkData = (void*) Data;
+	BulkDataFlags |= BULKDATA_Mapped;
+	Ar.Seek( Offset + GetBulkDataSize() );
+	return TRUE;
+}
+
 /**
  * Loads the data from disk into the specified memory block. This requires us still being attached to an
  * archive we can use for serialization.
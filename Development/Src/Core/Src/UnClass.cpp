@@ -914,6 +914,10 @@ LoadPropertyValue:
 void UStruct::FinishDestroy()
 {
 	Script.Empty();
+	CallSiteOffsets.Empty();
+	CallCaches.Empty();
+	// Caches might refer to this struct, and new ones can end up at the same address.
+	GScriptCallCacheEpoch++;
 	Super::FinishDestroy();
 }
 void UStruct::Serialize( FArchive& Ar )
@@ -943,6 +947,7 @@ void UStruct::Serialize( FArchive& Ar )
 	{
 		Script.Empty( ScriptSize );
 		Script.Add( ScriptSize );
+		CallSiteOffsets.Empty();
 	}
 
 	INT iCode = 0;
@@ -957,6 +962,10 @@ void UStruct::Serialize( FArchive& Ar )
 
 	if( Ar.IsLoading() )
 	{
+		// SerializeExpr gathered the virtual and global call sites, give each an empty inline cache.
+		CallCaches.Empty( CallSiteOffsets.Num() );
+		CallCaches.AddZeroed( CallSiteOffsets.Num() );
+
 		// Collect references to objects embedded in script and store them in easily accessible array.
 		ScriptObjectReferences.Empty();
 		FArchiveObjectReferenceCollector ObjectReferenceCollector( &ScriptObjectReferences );
@@ -966,6 +975,13 @@ void UStruct::Serialize( FArchive& Ar )
 			SerializeExpr( iCode2, ObjectReferenceCollector );
 		}
 
+		// Fuse common expressions into superinstructions when running the game. The Editor and commandlets
+		// might save the code again and the script debugger relies on the original expressions.
+		if( GUseScriptSuperinstructions && !GIsEditor && !GIsUCC && !GDebugger )
+		{
+			TranslateSuperinstructions( TRUE );
+		}
+
 		// Link the properties.
 		Link( Ar, TRUE );
 	}
@@ -984,6 +1000,210 @@ void UStruct::StripData(UE3::EPlatformType TargetPlatform)
 	CppText		= NULL;
 }
 
+/*-----------------------------------------------------------------------------
+	Script superinstructions.
+-----------------------------------------------------------------------------*/
+
+/** Which way SerializeExpr translates expressions while TranslateSuperinstructions walks script code. */
+enum ESuperinstructionTranslation
+{
+	SIT_None,
+	SIT_Fuse,
+	SIT_Unfuse,
+};
+static ESuperinstructionTranslation GSuperinstructionTranslation = SIT_None;
+/** Number of expressions rewritten by the current TranslateSuperinstructions call. */
+static INT GNumTranslatedExprs = 0;
+
+/**
+ * Reads a script object pointer from unaligned bytecode.
+ */
+static inline UObject* ReadScriptObject( const TArray<BYTE>& Script, INT iCode )
+{
+	DWORD TempCode;
+	appMemcpy( &TempCode, &Script(iCode), sizeof(DWORD) );
+	return (UObject*)appDWORDToPointer(TempCode);
+}
+
+/**
+ * Returns the size of the operand expression at iCode if it is one superinstructions decode inline,
+ * which is a local or object variable of the passed in property class or a constant of matching type.
+ *
+ * @param	Script			bytecode containing the operand
+ * @param	iCode			position of operand in bytecode
+ * @param	PropertyClass	UIntProperty or UFloatProperty
+ * @param	bAllowConst		whether constants are accepted
+ * @return	size of operand in bytes, 0 if it can't be decoded inline
+ */
+static INT GetSimpleOperandSize( const TArray<BYTE>& Script, INT iCode, UClass* PropertyClass, UBOOL bAllowConst )
+{
+	const UBOOL bInt = PropertyClass == UIntProperty::StaticClass();
+	switch( Script(iCode) )
+	{
+		case EX_LocalVariable:
+		case EX_InstanceVariable:
+		{
+			UObject* Property = ReadScriptObject( Script, iCode + 1 );
+			return Property && Property->GetClass() == PropertyClass ? 1 + sizeof(DWORD) : 0;
+		}
+		case EX_IntConst:
+			return bAllowConst && bInt ? 1 + sizeof(INT) : 0;
+		case EX_IntConstByte:
+			return bAllowConst && bInt ? 2 : 0;
+		case EX_IntZero:
+		case EX_IntOne:
+			return bAllowConst && bInt ? 1 : 0;
+		case EX_FloatConst:
+			return bAllowConst && !bInt ? 1 + sizeof(FLOAT) : 0;
+	}
+	return 0;
+}
+
+/**
+ * Checks whether the native operator call spanning iStart to iEnd takes simple operands and nothing
+ * follows its parameters, in particular no debugger info.
+ *
+ * @param	Script			bytecode containing the call
+ * @param	iStart			position of the call in bytecode
+ * @param	iEnd			position following the call
+ * @param	NumOperands		number of operands the operator takes
+ * @param	PropertyClass	type of the operands
+ * @param	bAllowConst		whether constant operands are accepted
+ */
+static UBOOL IsSimpleOperatorCall( const TArray<BYTE>& Script, INT iStart, INT iEnd, INT NumOperands, UClass* PropertyClass, UBOOL bAllowConst )
+{
+	INT iCode = iStart + 1;
+	for( INT OperandIndex=0; OperandIndex<NumOperands; OperandIndex++ )
+	{
+		const INT OperandSize = GetSimpleOperandSize( Script, iCode, PropertyClass, bAllowConst );
+		if( OperandSize == 0 )
+		{
+			return FALSE;
+		}
+		iCode += OperandSize;
+	}
+	return iCode + 1 == iEnd && Script(iCode) == EX_EndFunctionParms;
+}
+
+/**
+ * Returns the superinstruction the expression spanning iStart to iEnd can be fused into.
+ *
+ * @param	Script	bytecode containing the expression, with its subexpressions already translated
+ * @param	iStart	position of expression in bytecode
+ * @param	iEnd	position following the expression
+ * @return	superinstruction token, 0 if the expression doesn't match any
+ */
+static BYTE GetSuperinstruction( const TArray<BYTE>& Script, INT iStart, INT iEnd )
+{
+	UClass* IntClass	= UIntProperty::StaticClass();
+	UClass* FloatClass	= UFloatProperty::StaticClass();
+	switch( Script(iStart) )
+	{
+		case EX_JumpIfNot:
+		{
+			// [EX_JumpIfNot][WORD offset][int compare native][operand][operand][EX_EndFunctionParms]
+			const INT iCompare = iStart + 1 + sizeof(WORD);
+			const BYTE Compare = Script(iCompare);
+			if( Compare >= NATIVE_Less_IntInt && Compare <= NATIVE_NotEqual_IntInt && IsSimpleOperatorCall( Script, iCompare, iEnd, 2, IntClass, TRUE ) )
+			{
+				return EX_FusedJumpIfNotIntCmp;
+			}
+			return 0;
+		}
+		case EX_StructMember:
+		{
+			// [EX_StructMember][member][struct][copy struct][modified][struct expression]
+			const INT iCopy		= iStart + 1 + 2 * sizeof(DWORD);
+			const BYTE Inner	= Script(iCopy + 2);
+			if( Script(iCopy) == 0 && (Inner == EX_FusedStructMember || Inner == EX_LocalVariable || Inner == EX_InstanceVariable) )
+			{
+				return EX_FusedStructMember;
+			}
+			return 0;
+		}
+		case NATIVE_Add_IntInt:				return IsSimpleOperatorCall( Script, iStart, iEnd, 2, IntClass, TRUE ) ? EX_FusedIntAdd : 0;
+		case NATIVE_Subtract_IntInt:		return IsSimpleOperatorCall( Script, iStart, iEnd, 2, IntClass, TRUE ) ? EX_FusedIntSubtract : 0;
+		case NATIVE_Multiply_IntInt:		return IsSimpleOperatorCall( Script, iStart, iEnd, 2, IntClass, TRUE ) ? EX_FusedIntMultiply : 0;
+		case NATIVE_Divide_IntInt:			return IsSimpleOperatorCall( Script, iStart, iEnd, 2, IntClass, TRUE ) ? EX_FusedIntDivide : 0;
+		case NATIVE_AddAdd_PreInt:			return IsSimpleOperatorCall( Script, iStart, iEnd, 1, IntClass, FALSE ) ? EX_FusedIntPreIncrement : 0;
+		case NATIVE_SubtractSubtract_PreInt:return IsSimpleOperatorCall( Script, iStart, iEnd, 1, IntClass, FALSE ) ? EX_FusedIntPreDecrement : 0;
+		case NATIVE_AddAdd_Int:				return IsSimpleOperatorCall( Script, iStart, iEnd, 1, IntClass, FALSE ) ? EX_FusedIntPostIncrement : 0;
+		case NATIVE_SubtractSubtract_Int:	return IsSimpleOperatorCall( Script, iStart, iEnd, 1, IntClass, FALSE ) ? EX_FusedIntPostDecrement : 0;
+		case NATIVE_Add_FloatFloat:			return IsSimpleOperatorCall( Script, iStart, iEnd, 2, FloatClass, TRUE ) ? EX_FusedFloatAdd : 0;
+		case NATIVE_Subtract_FloatFloat:	return IsSimpleOperatorCall( Script, iStart, iEnd, 2, FloatClass, TRUE ) ? EX_FusedFloatSubtract : 0;
+		case NATIVE_Multiply_FloatFloat:	return IsSimpleOperatorCall( Script, iStart, iEnd, 2, FloatClass, TRUE ) ? EX_FusedFloatMultiply : 0;
+		case NATIVE_Divide_FloatFloat:		return IsSimpleOperatorCall( Script, iStart, iEnd, 2, FloatClass, TRUE ) ? EX_FusedFloatDivide : 0;
+	}
+	return 0;
+}
+
+/**
+ * Returns the token the passed in superinstruction was fused from, 0 if it isn't a superinstruction.
+ */
+static BYTE GetUnfusedToken( BYTE Token )
+{
+	switch( Token )
+	{
+		case EX_FusedJumpIfNotIntCmp:	return EX_JumpIfNot;
+		case EX_FusedStructMember:		return EX_StructMember;
+		case EX_FusedIntAdd:			return NATIVE_Add_IntInt;
+		case EX_FusedIntSubtract:		return NATIVE_Subtract_IntInt;
+		case EX_FusedIntMultiply:		return NATIVE_Multiply_IntInt;
+		case EX_FusedIntDivide:			return NATIVE_Divide_IntInt;
+		case EX_FusedIntPreIncrement:	return NATIVE_AddAdd_PreInt;
+		case EX_FusedIntPreDecrement:	return NATIVE_SubtractSubtract_PreInt;
+		case EX_FusedIntPostIncrement:	return NATIVE_AddAdd_Int;
+		case EX_FusedIntPostDecrement:	return NATIVE_SubtractSubtract_Int;
+		case EX_FusedFloatAdd:			return NATIVE_Add_FloatFloat;
+		case EX_FusedFloatSubtract:		return NATIVE_Subtract_FloatFloat;
+		case EX_FusedFloatMultiply:		return NATIVE_Multiply_FloatFloat;
+		case EX_FusedFloatDivide:		return NATIVE_Divide_FloatFloat;
+	}
+	return 0;
+}
+
+/**
+ * Translates the expression spanning iStart to iEnd the way the current TranslateSuperinstructions call
+ * asks for. Called by SerializeExpr after the expression's subexpressions have been translated.
+ */
+static void TranslateExpr( TArray<BYTE>& Script, INT iStart, INT iEnd )
+{
+	const BYTE Token = Script(iStart);
+	const BYTE NewToken = GSuperinstructionTranslation == SIT_Fuse
+		? GetSuperinstruction( Script, iStart, iEnd )
+		: GetUnfusedToken( Token );
+	if( NewToken != 0 )
+	{
+		Script(iStart) = NewToken;
+		GNumTranslatedExprs++;
+	}
+}
+
+/**
+ * Translates common expression patterns in Script into superinstructions, or back into their original
+ * form. Only the leading token of an expression is rewritten so code offsets remain valid.
+ *
+ * @param	bFuse	TRUE to fuse expressions into superinstructions, FALSE to restore the original tokens
+ * @return	number of expressions that were rewritten
+ */
+INT UStruct::TranslateSuperinstructions( UBOOL bFuse )
+{
+	check(GSuperinstructionTranslation==SIT_None);
+	GSuperinstructionTranslation	= bFuse ? SIT_Fuse : SIT_Unfuse;
+	GNumTranslatedExprs				= 0;
+
+	// Neither loading nor saving, SerializeExpr just walks the code and calls TranslateExpr for each expression.
+	FArchive DummyAr;
+	INT iCode = 0;
+	while( iCode < Script.Num() )
+	{
+		SerializeExpr( iCode, DummyAr );
+	}
+
+	GSuperinstructionTranslation = SIT_None;
+	return GNumTranslatedExprs;
+}
+
 //
 // Serialize an expression to an archive.
 // Returns expression token.
@@ -991,6 +1211,7 @@ void UStruct::StripData(UE3::EPlatformType TargetPlatform)
 EExprToken UStruct::SerializeExpr( INT& iCode, FArchive& Ar )
 {
 	EExprToken Expr=(EExprToken)0;
+	const INT iStart = iCode;
 	
 	#define XFER(T) {Ar << *(T*)&Script(iCode); iCode += sizeof(T); }
 
@@ -1146,6 +1367,10 @@ EExprToken UStruct::SerializeExpr( INT& iCode, FArchive& Ar )
 		case EX_VirtualFunction:
 		case EX_GlobalFunction:
 		{
+			if( Ar.IsLoading() )
+			{
+				CallSiteOffsets.AddItem( iCode );
+			}
 			XFER(FName); // Virtual function name.
 			while( SerializeExpr( iCode, Ar ) != EX_EndFunctionParms ); // Parms.
 			HANDLE_OPTIONAL_DEBUG_INFO; //DEBUGGER
@@ -1312,6 +1537,7 @@ EExprToken UStruct::SerializeExpr( INT& iCode, FArchive& Ar )
 			break;
 		}
 		case EX_JumpIfNot:
+		case EX_FusedJumpIfNotIntCmp:
 		{
 			XFER(WORD); // Code offset.
 			SerializeExpr( iCode, Ar ); // Boolean expr.
@@ -1389,6 +1615,7 @@ EExprToken UStruct::SerializeExpr( INT& iCode, FArchive& Ar )
 			break;
 		}
 		case EX_StructMember:
+		case EX_FusedStructMember:
 		{
 			XFERPTR(UProperty*);		// the struct property we're accessing
 			XFERPTR(UStruct*);			// the struct which contains the property
@@ -1402,6 +1629,23 @@ EExprToken UStruct::SerializeExpr( INT& iCode, FArchive& Ar )
 			XFER(FName);	// Name of function we're assigning to the delegate.
 			break;
 		}
+		case EX_FusedIntAdd:
+		case EX_FusedIntSubtract:
+		case EX_FusedIntMultiply:
+		case EX_FusedIntDivide:
+		case EX_FusedIntPreIncrement:
+		case EX_FusedIntPreDecrement:
+		case EX_FusedIntPostIncrement:
+		case EX_FusedIntPostDecrement:
+		case EX_FusedFloatAdd:
+		case EX_FusedFloatSubtract:
+		case EX_FusedFloatMultiply:
+		case EX_FusedFloatDivide:
+		{
+			// Operator superinstructions keep the layout of the native call they were fused from.
+			while( SerializeExpr( iCode, Ar ) != EX_EndFunctionParms ); // Parms.
+			break;
+		}
 		default:
 		{
 			// This should never occur.
@@ -1409,6 +1653,10 @@ EExprToken UStruct::SerializeExpr( INT& iCode, FArchive& Ar )
 			break;
 		}
 	}
+	if( GSuperinstructionTranslation != SIT_None )
+	{
+		TranslateExpr( Script, iStart, iCode );
+	}
 	return Expr;
 	#undef XFER
 	#undef XFERPTR
@@ -1624,6 +1872,10 @@ void UState::Serialize( FArchive& Ar )
 	Ar << LabelTableOffset << StateFlags;
 	// serialize the function map
 	Ar << FuncMap;
+	if( Ar.IsLoading() )
+	{
+		GScriptCallCacheEpoch++;
+	}
 }
 IMPLEMENT_CLASS(UState);
 
@@ -2508,7 +2760,8 @@ void UFunction::Bind()
 		// Find hardcoded native.
 		check(iNative<EX_Max);
 		check(GNatives[iNative]!=0);
-		Func = GNatives[iNative];
+		// Bypass the script profiler's dispatch thunks, which only work when called from bytecode.
+		Func = GScriptProfiler.GetUnprofiledNative( iNative );
 	}
 	else
 	{
@@ -57,6 +57,13 @@ INT GNativeDuplicate=0;
 void (UObject::*GCasts[CST_Max])( FFrame &Stack, RESULT_DECL );
 INT GCastDuplicate=0;
 
+/** Bumped whenever function maps change or structs go away, invalidating all FScriptCallCache entries. */
+DWORD GScriptCallCacheEpoch = 1;
+/** Whether virtual and global script calls go through their call site's cache. */
+UBOOL GUseScriptCallCaches = TRUE;
+/** Whether script code is translated into superinstructions when it is loaded. */
+UBOOL GUseScriptSuperinstructions = FALSE;
+
 #define RUNAWAY_LIMIT 1000000
 #if PS3
 	#define RECURSE_LIMIT 100
@@ -1100,6 +1107,60 @@ void UObject::execStructMember( FFrame& Stack, RESULT_DECL )
 }
 IMPLEMENT_FUNCTION( UObject, EX_StructMember, execStructMember );
 
+/**
+ * Superinstruction for a chain of struct members ending in a local or object variable, fused from
+ * EX_StructMember expressions that don't require a copy of the struct. Adds up the member offsets
+ * without stepping through each level.
+ */
+void UObject::execFusedStructMember( FFrame& Stack, RESULT_DECL )
+{
+	// The outermost member is the one accessed.
+	UProperty* Property = (UProperty*)Stack.ReadObject();
+	INT Offset = Property->Offset;
+	Stack.Code += sizeof(DWORD) + 1; // Struct and copy flag, which is always 0.
+	BYTE bStructWillBeModified = *Stack.Code++;
+
+	// Inner members, marking replicated ones dirty just like execStructMember does.
+	BYTE Token;
+	while( (Token = *Stack.Code++) != EX_LocalVariable && Token != EX_InstanceVariable )
+	{
+		UProperty* Member = (UProperty*)Stack.ReadObject();
+		if( bStructWillBeModified && (Member->PropertyFlags & CPF_Net) )
+		{
+			NetDirty(Member);
+		}
+		Offset += Member->Offset;
+		Stack.Code += sizeof(DWORD) + 1;
+		bStructWillBeModified = *Stack.Code++;
+	}
+
+	// Variable holding the struct.
+	UProperty* Variable = (UProperty*)Stack.ReadObject();
+	BYTE* StructAddr;
+	if( Token == EX_LocalVariable )
+	{
+		StructAddr = Stack.Locals + Variable->Offset;
+	}
+	else
+	{
+		StructAddr = (BYTE*)this + Variable->Offset;
+		if( bStructWillBeModified && (Variable->PropertyFlags & CPF_Net) )
+		{
+			NetDirty(Variable);
+		}
+	}
+
+	// Set result.
+	GProperty	= Property;
+	GPropAddr	= StructAddr + Offset;
+	GPropObject	= this;
+	if( Result )
+	{
+		Property->CopyCompleteValue( Result, GPropAddr );
+	}
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedStructMember, execFusedStructMember );
+
 void UObject::execEndOfScript( FFrame& Stack, RESULT_DECL )
 {
 	appErrorf(TEXT("Execution beyond end of script in %s on %s"), *Stack.Node->GetFullName(), *Stack.Object->GetFullName());
@@ -1280,6 +1341,98 @@ void UObject::execJumpIfNot( FFrame& Stack, RESULT_DECL )
 }
 IMPLEMENT_FUNCTION( UObject, EX_JumpIfNot, execJumpIfNot );
 
+/**
+ * Reads an int operand of a superinstruction, which is a variable or a constant.
+ */
+static FORCEINLINE INT ReadFusedIntOperand( FFrame& Stack )
+{
+	switch( *Stack.Code++ )
+	{
+		case EX_LocalVariable:
+			return *(INT*)(Stack.Locals + ((UProperty*)Stack.ReadObject())->Offset);
+		case EX_InstanceVariable:
+			return *(INT*)((BYTE*)Stack.Object + ((UProperty*)Stack.ReadObject())->Offset);
+		case EX_IntConst:
+			return Stack.ReadInt();
+		case EX_IntConstByte:
+			return *Stack.Code++;
+		case EX_IntZero:
+			return 0;
+		default:
+			return 1; // EX_IntOne
+	}
+}
+
+/**
+ * Returns the address of the int variable operand of a superinstruction that modifies it, marking
+ * replicated member variables dirty just like P_GET_INT_REF does.
+ */
+static FORCEINLINE INT* ReadFusedIntVariable( FFrame& Stack )
+{
+	const BYTE Token = *Stack.Code++;
+	UProperty* Property = (UProperty*)Stack.ReadObject();
+	if( Token == EX_LocalVariable )
+	{
+		return (INT*)(Stack.Locals + Property->Offset);
+	}
+	if( Property->PropertyFlags & CPF_Net )
+	{
+		Stack.Object->NetDirty( Property );
+	}
+	return (INT*)((BYTE*)Stack.Object + Property->Offset);
+}
+
+/**
+ * Reads a float operand of a superinstruction, which is a variable or a constant.
+ */
+static FORCEINLINE FLOAT ReadFusedFloatOperand( FFrame& Stack )
+{
+	switch( *Stack.Code++ )
+	{
+		case EX_LocalVariable:
+			return *(FLOAT*)(Stack.Locals + ((UProperty*)Stack.ReadObject())->Offset);
+		case EX_InstanceVariable:
+			return *(FLOAT*)((BYTE*)Stack.Object + ((UProperty*)Stack.ReadObject())->Offset);
+		default:
+			return Stack.ReadFloat(); // EX_FloatConst
+	}
+}
+
+/**
+ * Superinstruction for a conditional jump on an int comparison of variables and constants, fused from
+ * EX_JumpIfNot and one of the int comparison natives.
+ */
+void UObject::execFusedJumpIfNotIntCmp( FFrame& Stack, RESULT_DECL )
+{
+	CHECK_RUNAWAY;
+
+	// Get code offset.
+	INT wOffset = Stack.ReadWord();
+
+	// Compare operands, skipping the native's EX_EndFunctionParms.
+	const BYTE Compare	= *Stack.Code++;
+	const INT A			= ReadFusedIntOperand( Stack );
+	const INT B			= ReadFusedIntOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	UBOOL Value;
+	switch( Compare )
+	{
+		case NATIVE_Less_IntInt:			Value = A < B;	break;
+		case NATIVE_Greater_IntInt:			Value = A > B;	break;
+		case NATIVE_LessEqual_IntInt:		Value = A <= B;	break;
+		case NATIVE_GreaterEqual_IntInt:	Value = A >= B;	break;
+		case NATIVE_EqualEqual_IntInt:		Value = A == B;	break;
+		default:							Value = A != B;	break;
+	}
+
+	// Jump if false.
+	if( !Value )
+		Stack.Code = &Stack.Node->Script( wOffset );
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedJumpIfNotIntCmp, execFusedJumpIfNotIntCmp );
+
 void UObject::execConditional( FFrame& Stack, RESULT_DECL )
 {
 	// Get test expression
@@ -1509,10 +1662,43 @@ IMPLEMENT_FUNCTION( UObject, EX_Context, execContext );
 // Function calls //
 ////////////////////
 
+/**
+ * Reads the function name of a virtual or global call and finds the function to call on the passed in
+ * object. Looking the name up through the state and class chains is skipped if the call site's inline
+ * cache was filled in for the same class and state.
+ *
+ * @param	Object	object the function is called on
+ * @param	Stack	frame positioned at the function name
+ * @param	bGlobal	whether to ignore the object's state
+ * @return	function to call
+ */
+static FORCEINLINE UFunction* FindCallSiteFunction( UObject* Object, FFrame& Stack, UBOOL bGlobal )
+{
+	FScriptCallCache* Cache = GUseScriptCallCaches ? Stack.Node->FindCallCache( Stack.Code - Stack.Node->Script.GetTypedData() ) : NULL;
+	const FName FunctionName = Stack.ReadName();
+	if( !Cache )
+	{
+		return Object->FindFunctionChecked( FunctionName, bGlobal );
+	}
+
+	// The state is part of the key, so state changes are picked up without flushing anything.
+	FStateFrame* StateFrame = Object->GetStateFrame();
+	UState* State = (!bGlobal && StateFrame) ? StateFrame->StateNode : NULL;
+	UClass* Class = Object->GetClass();
+	if( Cache->Class != Class || Cache->State != State || Cache->Epoch != GScriptCallCacheEpoch )
+	{
+		Cache->Function	= Object->FindFunctionChecked( FunctionName, bGlobal );
+		Cache->Class	= Class;
+		Cache->State	= State;
+		Cache->Epoch	= GScriptCallCacheEpoch;
+	}
+	return Cache->Function;
+}
+
 void UObject::execVirtualFunction( FFrame& Stack, RESULT_DECL )
 {
 	// Call the virtual function.
-	CallFunction( Stack, Result, FindFunctionChecked(Stack.ReadName(),0) );
+	CallFunction( Stack, Result, FindCallSiteFunction(this,Stack,0) );
 }
 IMPLEMENT_FUNCTION( UObject, EX_VirtualFunction, execVirtualFunction );
 
@@ -1526,7 +1712,7 @@ IMPLEMENT_FUNCTION( UObject, EX_FinalFunction, execFinalFunction );
 void UObject::execGlobalFunction( FFrame& Stack, RESULT_DECL )
 {
 	// Call global version of virtual function.
-	CallFunction( Stack, Result, FindFunctionChecked(Stack.ReadName(),1) );
+	CallFunction( Stack, Result, FindCallSiteFunction(this,Stack,1) );
 }
 IMPLEMENT_FUNCTION( UObject, EX_GlobalFunction, execGlobalFunction );
 
@@ -2518,6 +2704,100 @@ void UObject::execSubtractSubtract_Int( FFrame& Stack, RESULT_DECL )
 }
 IMPLEMENT_FUNCTION( UObject, 166, execSubtractSubtract_Int );
 
+//
+// Int operator superinstructions, fused from the natives above when their operands are variables or
+// constants. They read the operands directly and skip the native's EX_EndFunctionParms.
+//
+
+void UObject::execFusedIntAdd( FFrame& Stack, RESULT_DECL )
+{
+	const INT A = ReadFusedIntOperand( Stack );
+	const INT B = ReadFusedIntOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = A + B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntAdd, execFusedIntAdd );
+
+void UObject::execFusedIntSubtract( FFrame& Stack, RESULT_DECL )
+{
+	const INT A = ReadFusedIntOperand( Stack );
+	const INT B = ReadFusedIntOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = A - B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntSubtract, execFusedIntSubtract );
+
+void UObject::execFusedIntMultiply( FFrame& Stack, RESULT_DECL )
+{
+	const INT A = ReadFusedIntOperand( Stack );
+	const INT B = ReadFusedIntOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = A * B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntMultiply, execFusedIntMultiply );
+
+void UObject::execFusedIntDivide( FFrame& Stack, RESULT_DECL )
+{
+	const INT A = ReadFusedIntOperand( Stack );
+	const INT B = ReadFusedIntOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	if (B == 0)
+	{
+		Stack.Logf(NAME_ScriptWarning,TEXT("Divide by zero"));
+	}
+
+	*(INT*)Result = B ? A / B : 0;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntDivide, execFusedIntDivide );
+
+void UObject::execFusedIntPreIncrement( FFrame& Stack, RESULT_DECL )
+{
+	INT* A = ReadFusedIntVariable( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = ++(*A);
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntPreIncrement, execFusedIntPreIncrement );
+
+void UObject::execFusedIntPreDecrement( FFrame& Stack, RESULT_DECL )
+{
+	INT* A = ReadFusedIntVariable( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = --(*A);
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntPreDecrement, execFusedIntPreDecrement );
+
+void UObject::execFusedIntPostIncrement( FFrame& Stack, RESULT_DECL )
+{
+	INT* A = ReadFusedIntVariable( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = (*A)++;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntPostIncrement, execFusedIntPostIncrement );
+
+void UObject::execFusedIntPostDecrement( FFrame& Stack, RESULT_DECL )
+{
+	INT* A = ReadFusedIntVariable( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(INT*)Result = (*A)--;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedIntPostDecrement, execFusedIntPostDecrement );
+
 void UObject::execRand( FFrame& Stack, RESULT_DECL )
 {
 	P_GET_INT(A);
@@ -2649,6 +2929,60 @@ void UObject::execSubtract_FloatFloat( FFrame& Stack, RESULT_DECL )
 }	
 IMPLEMENT_FUNCTION( UObject, 175, execSubtract_FloatFloat );
 
+//
+// Float operator superinstructions, fused from the natives above when their operands are variables or
+// constants. They read the operands directly and skip the native's EX_EndFunctionParms.
+//
+
+void UObject::execFusedFloatAdd( FFrame& Stack, RESULT_DECL )
+{
+	const FLOAT A = ReadFusedFloatOperand( Stack );
+	const FLOAT B = ReadFusedFloatOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(FLOAT*)Result = A + B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedFloatAdd, execFusedFloatAdd );
+
+void UObject::execFusedFloatSubtract( FFrame& Stack, RESULT_DECL )
+{
+	const FLOAT A = ReadFusedFloatOperand( Stack );
+	const FLOAT B = ReadFusedFloatOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(FLOAT*)Result = A - B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedFloatSubtract, execFusedFloatSubtract );
+
+void UObject::execFusedFloatMultiply( FFrame& Stack, RESULT_DECL )
+{
+	const FLOAT A = ReadFusedFloatOperand( Stack );
+	const FLOAT B = ReadFusedFloatOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	*(FLOAT*)Result = A * B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedFloatMultiply, execFusedFloatMultiply );
+
+void UObject::execFusedFloatDivide( FFrame& Stack, RESULT_DECL )
+{
+	const FLOAT A = ReadFusedFloatOperand( Stack );
+	const FLOAT B = ReadFusedFloatOperand( Stack );
+	Stack.Code++;
+	GPropObject = NULL;
+
+	if (B == 0.f)
+	{
+		Stack.Logf(NAME_ScriptWarning,TEXT("Divide by zero"));
+	}
+
+	*(FLOAT*)Result = A / B;
+}
+IMPLEMENT_FUNCTION( UObject, EX_FusedFloatDivide, execFusedFloatDivide );
+
 void UObject::execLess_FloatFloat( FFrame& Stack, RESULT_DECL )
 {
 	P_GET_FLOAT(A);
@@ -5178,6 +5512,7 @@ void UObject::SkipFunction(FFrame& Stack, RESULT_DECL, UFunction* Function)
 void UObject::CallFunction( FFrame& Stack, RESULT_DECL, UFunction* Function )
 {
 	STAT(FScopedScriptStats ScriptStats( Function ));
+	FScopedScriptProfile ScriptProfile( this, Function );
 
 #if ENABLE_SCRIPT_TRACING
 	if ( GIsUTracing && !(Function->FunctionFlags&FUNC_Operator) )
@@ -5522,6 +5857,7 @@ void UObject::ProcessEvent( UFunction* Function, void* Parms, void* UnusedResult
 	// Scope required for scoped script stats.
 	{
 		STAT(FScopedScriptStats ScriptStats( Function ));
+		FScopedScriptProfile ScriptProfile( this, Function );
 		
 		// Create a new local execution stack.
 		FFrame NewStack( this, Function, 0, appAlloca(Function->PropertiesSize) );
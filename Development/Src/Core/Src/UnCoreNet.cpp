@@ -13,7 +13,7 @@
 // FPackageInfo constructor.
 //
 FPackageInfo::FPackageInfo(UPackage* Package)
-:	PackageName		(Package != NULL ? Package->GetFName() : NAME_None)
+:	PackageName		(Package != NULL ? Package->GetNetPackageName() : NAME_None)
 ,	Parent			(Package)
 ,	Guid			(Package != NULL ? Package->GetGuid() : FGuid(0,0,0,0))
 ,	ObjectBase		( INDEX_NONE )
@@ -27,7 +27,7 @@ FPackageInfo::FPackageInfo(UPackage* Package)
 	if (Package != NULL)
 	{
 		FFilename PackageFile;
-		if (GPackageFileCache->FindPackageFile(*Package->GetName(), NULL, PackageFile, NULL, FALSE))
+		if (GPackageFileCache->FindPackageFile(*PackageName.ToString(), NULL, PackageFile, NULL, FALSE))
 		{
 			Extension = PackageFile.GetExtension();
 		}
@@ -52,6 +52,227 @@ FClassNetCache::FClassNetCache( UClass* InClass )
 : Class( InClass )
 {}
 
+/*-----------------------------------------------------------------------------
+	FRepConditionProgram implementation.
+-----------------------------------------------------------------------------*/
+
+/** Native function indices of the operators replication conditions can be translated for, see Object.uc. */
+enum ERepConditionNative
+{
+	REPNATIVE_Not_PreBool			= 129,
+	REPNATIVE_AndAnd_BoolBool		= 130,
+	REPNATIVE_OrOr_BoolBool			= 132,
+	REPNATIVE_EqualEqual_IntInt		= 154,
+	REPNATIVE_NotEqual_IntInt		= 155,
+	REPNATIVE_EqualEqual_BoolBool	= 242,
+	REPNATIVE_NotEqual_BoolBool		= 243,
+};
+
+/**
+ * Reads a DWORD from unaligned bytecode.
+ */
+static DWORD ReadScriptDWORD( const TArray<BYTE>& Script, INT iCode )
+{
+	DWORD Result;
+	appMemcpy( &Result, &Script(iCode), sizeof(DWORD) );
+	return Result;
+}
+
+/**
+ * Translates the replication condition of the passed in property.
+ *
+ * @param	RepOwner	property owning the replication condition
+ * @return	TRUE if the condition could be translated, FALSE if it has to be run by the script VM
+ */
+UBOOL FRepConditionProgram::Compile( UProperty* RepOwner )
+{
+	NumOps = 0;
+	const TArray<BYTE>& Script = RepOwner->GetOwnerClass()->Script;
+	INT iCode = RepOwner->RepOffset;
+	INT StackSize = 0;
+	if( !CompileExpr( Script, iCode, StackSize ) || StackSize != 1 )
+	{
+		NumOps = 0;
+	}
+	return IsCompiled();
+}
+
+/**
+ * Appends an operation to the program.
+ *
+ * @return	TRUE if there was room for the operation
+ */
+UBOOL FRepConditionProgram::AddOp( BYTE Opcode, INT Offset, DWORD Value )
+{
+	if( NumOps >= MAX_OPS )
+	{
+		return FALSE;
+	}
+	FOp& Op		= Ops[NumOps++];
+	Op.Opcode	= Opcode;
+	Op.Offset	= Offset;
+	Op.Value	= Value;
+	return TRUE;
+}
+
+/**
+ * Translates a single expression and its operands, appending the operations to the program.
+ *
+ * @param	Script		bytecode of the class owning the condition
+ * @param	iCode		[in/out] position of expression in bytecode, advanced past it
+ * @param	StackSize	[in/out] current size of the evaluation stack
+ * @return	TRUE if the expression could be translated
+ */
+UBOOL FRepConditionProgram::CompileExpr( const TArray<BYTE>& Script, INT& iCode, INT& StackSize )
+{
+	if( iCode >= Script.Num() )
+	{
+		return FALSE;
+	}
+
+	const BYTE Expr = Script(iCode++);
+	switch( Expr )
+	{
+		case EX_BoolVariable:
+		{
+			if( iCode + 5 > Script.Num() || Script(iCode) != EX_InstanceVariable )
+			{
+				return FALSE;
+			}
+			UBoolProperty* Property = Cast<UBoolProperty>( (UObject*)appDWORDToPointer( ReadScriptDWORD( Script, iCode + 1 ) ) );
+			iCode += 5;
+			if( !Property || Property->ArrayDim != 1 || StackSize >= MAX_STACK )
+			{
+				return FALSE;
+			}
+			StackSize++;
+			return AddOp( REPOP_Bool, Property->Offset, Property->BitMask );
+		}
+		case EX_InstanceVariable:
+		{
+			if( iCode + 4 > Script.Num() )
+			{
+				return FALSE;
+			}
+			UProperty* Property = Cast<UProperty>( (UObject*)appDWORDToPointer( ReadScriptDWORD( Script, iCode ) ) );
+			iCode += 4;
+			if( !Property || Property->ArrayDim != 1 || StackSize >= MAX_STACK )
+			{
+				return FALSE;
+			}
+			StackSize++;
+			if( Property->IsA(UByteProperty::StaticClass()) )
+			{
+				return AddOp( REPOP_Byte, Property->Offset );
+			}
+			else if( Property->IsA(UIntProperty::StaticClass()) )
+			{
+				return AddOp( REPOP_Int, Property->Offset );
+			}
+			return FALSE;
+		}
+		case EX_PrimitiveCast:
+		{
+			// Bytes are pushed as ints already.
+			if( iCode >= Script.Num() || Script(iCode++) != CST_ByteToInt )
+			{
+				return FALSE;
+			}
+			return CompileExpr( Script, iCode, StackSize );
+		}
+		case EX_IntZero:
+		case EX_IntOne:
+		case EX_True:
+		case EX_False:
+		case EX_ByteConst:
+		case EX_IntConstByte:
+		case EX_IntConst:
+		{
+			DWORD Value = 0;
+			if( Expr == EX_IntOne || Expr == EX_True )
+			{
+				Value = 1;
+			}
+			else if( Expr == EX_ByteConst || Expr == EX_IntConstByte )
+			{
+				if( iCode >= Script.Num() )
+				{
+					return FALSE;
+				}
+				Value = Script(iCode++);
+			}
+			else if( Expr == EX_IntConst )
+			{
+				if( iCode + 4 > Script.Num() )
+				{
+					return FALSE;
+				}
+				Value = ReadScriptDWORD( Script, iCode );
+				iCode += 4;
+			}
+			if( StackSize >= MAX_STACK )
+			{
+				return FALSE;
+			}
+			StackSize++;
+			return AddOp( REPOP_Const, 0, Value );
+		}
+		case REPNATIVE_Not_PreBool:
+		case REPNATIVE_AndAnd_BoolBool:
+		case REPNATIVE_OrOr_BoolBool:
+		case REPNATIVE_EqualEqual_IntInt:
+		case REPNATIVE_NotEqual_IntInt:
+		case REPNATIVE_EqualEqual_BoolBool:
+		case REPNATIVE_NotEqual_BoolBool:
+		{
+			if( !CompileExpr( Script, iCode, StackSize ) )
+			{
+				return FALSE;
+			}
+			if( Expr != REPNATIVE_Not_PreBool )
+			{
+				// Short circuit operators store the size of their second operand, which we evaluate regardless.
+				if( Expr == REPNATIVE_AndAnd_BoolBool || Expr == REPNATIVE_OrOr_BoolBool )
+				{
+					if( iCode + 3 > Script.Num() || Script(iCode) != EX_Skip )
+					{
+						return FALSE;
+					}
+					iCode += 3;
+				}
+				if( !CompileExpr( Script, iCode, StackSize ) )
+				{
+					return FALSE;
+				}
+				StackSize--;
+			}
+			if( iCode >= Script.Num() || Script(iCode++) != EX_EndFunctionParms )
+			{
+				return FALSE;
+			}
+			// Skip debugger info following the call, see execDebugInfo.
+			if( iCode + 5 <= Script.Num() && Script(iCode) == EX_DebugInfo && ReadScriptDWORD( Script, iCode + 1 ) == 100 )
+			{
+				iCode += 14;
+			}
+
+			switch( Expr )
+			{
+				case REPNATIVE_Not_PreBool:			return AddOp( REPOP_Not );
+				case REPNATIVE_AndAnd_BoolBool:		return AddOp( REPOP_And );
+				case REPNATIVE_OrOr_BoolBool:		return AddOp( REPOP_Or );
+				case REPNATIVE_EqualEqual_IntInt:
+				case REPNATIVE_EqualEqual_BoolBool:	return AddOp( REPOP_Equal );
+				default:							return AddOp( REPOP_NotEqual );
+			}
+		}
+		default:
+		{
+			return FALSE;
+		}
+	}
+}
+
 /*-----------------------------------------------------------------------------
 	UPackageMap implementation.
 -----------------------------------------------------------------------------*/
@@ -120,6 +341,7 @@ FClassNetCache* UPackageMap::GetClassNetCache( UClass* Class )
 		{
 			Result->Super		         = GetClassNetCache(Class->GetSuperClass());
 			Result->RepProperties        = Result->Super->RepProperties;
+			Result->RepConditions        = Result->Super->RepConditions;
 			Result->RepConditionCount    = Result->Super->RepConditionCount;
 			Result->FieldsBase           = Result->Super->GetMaxIndex();
 		}
@@ -134,7 +356,12 @@ FClassNetCache* UPackageMap::GetClassNetCache( UClass* Class )
 				INT ThisIndex      = Result->GetMaxIndex();
                 UProperty* ItP     = Cast<UProperty>(Field,CLASS_IsAUProperty);
 				if( ItP && (ItP->RepOwner==ItP || !SupportsObject(ItP->RepOwner)) )
+				{
 					ConditionIndex = Result->RepConditionCount++;
+					// Translate the condition so it can be evaluated without the script VM.
+					FRepConditionProgram* Condition = new(Result->RepConditions)FRepConditionProgram;
+					Condition->Compile( ItP->RepOwner );
+				}
 				new(Result->Fields)FFieldNetCache( Field, ThisIndex, ConditionIndex );
 			}
 		}}
@@ -280,7 +507,7 @@ INT UPackageMap::AddPackage(UPackage* Package)
 			// do nothing
 			return i;
 		}
-		else if (List(i).PackageName == Package->GetFName() && List(i).Guid == Package->GetGuid())
+		else if (List(i).PackageName == Package->GetNetPackageName() && List(i).Guid == Package->GetGuid())
 		{
 			// there is an entry, but it's not hooked up to the UPackage reference
 			List(i).Parent = Package;
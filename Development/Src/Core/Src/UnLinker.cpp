@@ -789,8 +789,22 @@ UBOOL ULinkerLoad::CreateLoader()
 		}
 		else if (bIsSeekFree)
 		{
+			// Map uncompressed packages if wanted so their pages are shared with other processes loading them.
+			// Compressed ones are switched over to FArchiveAsync by SerializePackageFileSummary.
+			if( GUseMappedPackageLoading )
+			{
+				Loader = new FArchiveMapped( *Filename );
+				if( Loader->IsError() )
+				{
+					delete Loader;
+					Loader = NULL;
+				}
+			}
 			// Use the async archive as it supports proper Precache and package compression.
-			Loader = new FArchiveAsync( *Filename );
+			if( !Loader )
+			{
+				Loader = new FArchiveAsync( *Filename );
+			}
 			// An error signifies that the package couldn't be opened.
 			if( Loader->IsError() )
 			{
@@ -2957,6 +2971,11 @@ INT ULinkerLoad::TotalSize()
 	return Loader->TotalSize();
 }
 
+FMappedFile* ULinkerLoad::GetMappedFile()
+{
+	return Loader ? Loader->GetMappedFile() : NULL;
+}
+
 FArchive& ULinkerLoad::operator<<( UObject*& Object )
 {
 	INT Index;
@@ -0,0 +1,330 @@
+/*=============================================================================
+	UnMappedFile.cpp: Memory mapped files and the archive reading from them.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+
+#if __LINUX__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*-----------------------------------------------------------------------------
+	Mapping registry.
+-----------------------------------------------------------------------------*/
+
+/** All live mappings, sorted by address so FindContaining can binary search. */
+static TArray<FMappedFile*>	GMappedFiles;
+/** Number of live mappings, allowing FindContaining to bail without locking in the common case. */
+static volatile INT			GNumMappedFiles = 0;
+/** Critical section guarding GMappedFiles, created with the first mapping. */
+static FCriticalSection*	GMappedFilesCriticalSection = NULL;
+
+/*-----------------------------------------------------------------------------
+	FMappedFile.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, only called by Open.
+ */
+FMappedFile::FMappedFile( const TCHAR* InFilename, BYTE* InData, INT InSize, void* InPlatformHandle )
+:	Data( InData )
+,	Size( InSize )
+,	PlatformHandle( InPlatformHandle )
+,	Filename( InFilename )
+{
+	RefCount.Increment();
+}
+
+/**
+ * Destructor, unmapping the file. Only called by Release.
+ */
+FMappedFile::~FMappedFile()
+{
+	PlatformUnmap( Data, Size, PlatformHandle );
+}
+
+/**
+ * Maps the passed in file.
+ *
+ * @param	Filename	file to map
+ * @return	mapping holding a single reference, NULL if the file could not be mapped
+ */
+FMappedFile* FMappedFile::Open( const TCHAR* Filename )
+{
+	// Files the file manager transparently decompresses can't be mapped.
+	if( GFileManager->UncompressedFileSize( Filename ) != INDEX_NONE )
+	{
+		return NULL;
+	}
+
+	BYTE*	MappedData		= NULL;
+	INT		MappedSize		= 0;
+	void*	PlatformHandle	= NULL;
+	if( !PlatformMap( *appConvertRelativePathToFull( Filename ), MappedData, MappedSize, PlatformHandle ) )
+	{
+		return NULL;
+	}
+	FMappedFile* MappedFile = new FMappedFile( Filename, MappedData, MappedSize, PlatformHandle );
+
+	if( !GMappedFilesCriticalSection )
+	{
+		// Packages are opened from the game thread so this can't race.
+		check( IsInGameThread() );
+		GMappedFilesCriticalSection = GSynchronizeFactory->CreateCriticalSection();
+	}
+	FScopeLock ScopeLock( GMappedFilesCriticalSection );
+	INT InsertIndex = 0;
+	while( InsertIndex < GMappedFiles.Num() && GMappedFiles(InsertIndex)->Data < MappedData )
+	{
+		InsertIndex++;
+	}
+	GMappedFiles.InsertItem( MappedFile, InsertIndex );
+	appInterlockedIncrement( &GNumMappedFiles );
+	return MappedFile;
+}
+
+/**
+ * Removes a reference and unmaps the file once the last one is gone.
+ */
+void FMappedFile::Release()
+{
+	if( RefCount.Decrement() == 0 )
+	{
+		{
+			FScopeLock ScopeLock( GMappedFilesCriticalSection );
+			verify( GMappedFiles.RemoveItem( this ) == 1 );
+			appInterlockedDecrement( &GNumMappedFiles );
+		}
+		delete this;
+	}
+}
+
+/**
+ * Returns the mapping the passed in pointer points into.
+ *
+ * @param	Ptr		pointer to look up
+ * @return	mapping containing Ptr, NULL if Ptr doesn't point into any mapping
+ */
+FMappedFile* FMappedFile::FindContaining( const void* Ptr )
+{
+	if( GNumMappedFiles == 0 || Ptr == NULL )
+	{
+		return NULL;
+	}
+
+	FScopeLock ScopeLock( GMappedFilesCriticalSection );
+	// Find the last mapping starting at or before Ptr.
+	INT Low		= 0;
+	INT High	= GMappedFiles.Num() - 1;
+	INT Found	= INDEX_NONE;
+	while( Low <= High )
+	{
+		const INT Middle = (Low + High) / 2;
+		if( GMappedFiles(Middle)->Data <= Ptr )
+		{
+			Found	= Middle;
+			Low		= Middle + 1;
+		}
+		else
+		{
+			High	= Middle - 1;
+		}
+	}
+	if( Found != INDEX_NONE )
+	{
+		FMappedFile* MappedFile = GMappedFiles(Found);
+		if( (const BYTE*) Ptr < MappedFile->Data + MappedFile->Size )
+		{
+			return MappedFile;
+		}
+	}
+	return NULL;
+}
+
+#if __LINUX__
+
+/**
+ * Platform specific mapping of a file.
+ *
+ * @param	Filename		absolute path of file to map
+ * @param	OutData			receives the start of the mapping
+ * @param	OutSize			receives the size of the mapping
+ * @param	OutPlatformHandle	receives the handle needed to unmap the file
+ * @return	TRUE if successful, FALSE otherwise
+ */
+UBOOL FMappedFile::PlatformMap( const TCHAR* Filename, BYTE*& OutData, INT& OutSize, void*& OutPlatformHandle )
+{
+	const INT FileDescriptor = open( TCHAR_TO_ANSI(Filename), O_RDONLY );
+	if( FileDescriptor < 0 )
+	{
+		return FALSE;
+	}
+
+	UBOOL bSuccess = FALSE;
+	struct stat FileInfo;
+	if( fstat( FileDescriptor, &FileInfo ) == 0 && FileInfo.st_size > 0 && FileInfo.st_size <= MAXINT )
+	{
+		// Private read-only mappings of the same file share their pages across processes.
+		void* Mapping = mmap( NULL, FileInfo.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0 );
+		if( Mapping != MAP_FAILED )
+		{
+			OutData				= (BYTE*) Mapping;
+			OutSize				= (INT) FileInfo.st_size;
+			OutPlatformHandle	= NULL;
+			bSuccess			= TRUE;
+		}
+	}
+	// The mapping stays valid after the descriptor is closed.
+	close( FileDescriptor );
+	return bSuccess;
+}
+
+/**
+ * Platform specific unmapping of a file mapped by PlatformMap.
+ */
+void FMappedFile::PlatformUnmap( BYTE* Data, INT Size, void* PlatformHandle )
+{
+	munmap( Data, Size );
+}
+
+#elif _MSC_VER && !CONSOLE
+
+/**
+ * Platform specific mapping of a file.
+ *
+ * @param	Filename		absolute path of file to map
+ * @param	OutData			receives the start of the mapping
+ * @param	OutSize			receives the size of the mapping
+ * @param	OutPlatformHandle	receives the handle needed to unmap the file
+ * @return	TRUE if successful, FALSE otherwise
+ */
+UBOOL FMappedFile::PlatformMap( const TCHAR* Filename, BYTE*& OutData, INT& OutSize, void*& OutPlatformHandle )
+{
+	HANDLE FileHandle = CreateFileW( Filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( FileHandle == INVALID_HANDLE_VALUE )
+	{
+		return FALSE;
+	}
+
+	UBOOL bSuccess = FALSE;
+	LARGE_INTEGER FileSize;
+	if( GetFileSizeEx( FileHandle, &FileSize ) && FileSize.QuadPart > 0 && FileSize.QuadPart <= MAXINT )
+	{
+		HANDLE MappingHandle = CreateFileMappingW( FileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+		if( MappingHandle )
+		{
+			void* Mapping = MapViewOfFile( MappingHandle, FILE_MAP_READ, 0, 0, 0 );
+			if( Mapping )
+			{
+				OutData				= (BYTE*) Mapping;
+				OutSize				= (INT) FileSize.QuadPart;
+				OutPlatformHandle	= MappingHandle;
+				bSuccess			= TRUE;
+			}
+			else
+			{
+				CloseHandle( MappingHandle );
+			}
+		}
+	}
+	// The mapping object keeps the file open.
+	CloseHandle( FileHandle );
+	return bSuccess;
+}
+
+/**
+ * Platform specific unmapping of a file mapped by PlatformMap.
+ */
+void FMappedFile::PlatformUnmap( BYTE* Data, INT Size, void* PlatformHandle )
+{
+	UnmapViewOfFile( Data );
+	CloseHandle( (HANDLE) PlatformHandle );
+}
+
+#else
+
+/**
+ * Memory mapping is not supported on this platform so loading falls back to FArchiveAsync.
+ */
+UBOOL FMappedFile::PlatformMap( const TCHAR* Filename, BYTE*& OutData, INT& OutSize, void*& OutPlatformHandle )
+{
+	return FALSE;
+}
+
+/**
+ * Platform specific unmapping of a file mapped by PlatformMap.
+ */
+void FMappedFile::PlatformUnmap( BYTE* Data, INT Size, void* PlatformHandle )
+{
+	appErrorf( TEXT("Memory mapping is not supported on this platform") );
+}
+
+#endif
+
+/*-----------------------------------------------------------------------------
+	FArchiveMapped.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, mapping the passed in file. Sets the error state if mapping failed.
+ *
+ * @param	InFilename	file to map
+ */
+FArchiveMapped::FArchiveMapped( const TCHAR* InFilename )
+:	MappedFile( FMappedFile::Open( InFilename ) )
+,	CurrentPos( 0 )
+,	Filename( InFilename )
+{
+	ArIsLoading		= TRUE;
+	ArIsPersistent	= TRUE;
+	ArIsError		= MappedFile == NULL;
+}
+
+/**
+ * Destructor, releasing the mapping.
+ */
+FArchiveMapped::~FArchiveMapped()
+{
+	Close();
+}
+
+/**
+ * Releases the mapping. Bulk data referencing it keeps it alive until it is freed.
+ *
+ * @return	TRUE if there were NO errors, FALSE otherwise
+ */
+UBOOL FArchiveMapped::Close()
+{
+	if( MappedFile )
+	{
+		MappedFile->Release();
+		MappedFile = NULL;
+	}
+	return !ArIsError;
+}
+
+/**
+ * Copies data out of the mapping.
+ *
+ * @param	Data	Pointer to serialize to
+ * @param	Num		Number of bytes to read
+ */
+void FArchiveMapped::Serialize( void* Data, INT Num )
+{
+	if( !MappedFile || CurrentPos + Num > MappedFile->GetSize() )
+	{
+		ArIsError = TRUE;
+		appErrorf( TEXT("Read of %i bytes at %i beyond the end of %s"), Num, CurrentPos, *Filename );
+		return;
+	}
+	appMemcpy( Data, MappedFile->GetData() + CurrentPos, Num );
+	CurrentPos += Num;
+}
+
+/*-----------------------------------------------------------------------------
+	End.
+-----------------------------------------------------------------------------*/
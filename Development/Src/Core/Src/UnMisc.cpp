@@ -410,6 +410,38 @@ void FArray::Remove( INT Index, INT Count, INT ElementSize, DWORD Alignment )
 	checkSlow(ArrayMax >= ArrayNum);
 }
 
+/**
+ * Realloc for arrays with inline storage, only touching the heap if ArrayMax doesn't fit inline.
+ * Elements move back into the inline storage once they fit again, which is never smaller than
+ * the inline capacity.
+ */
+void FArray::ReallocInline( INT ElementSize, DWORD Alignment )
+{
+	const FInlineArrayStorage& InlineStorage = GetInlineStorage();
+	if( ArrayMax <= InlineStorage.Max )
+	{
+		if( Data != InlineStorage.Data )
+		{
+			// The heap allocation is larger than the inline storage so this can't read past its end.
+			appMemcpy( InlineStorage.Data, Data, Min<INT>( ArrayNum, InlineStorage.Max ) * ElementSize );
+			appFree( Data );
+			Data = InlineStorage.Data;
+		}
+		ArrayMax = InlineStorage.Max;
+	}
+	else if( Data == InlineStorage.Data )
+	{
+		// Spill to the heap. Callers growing the array already bumped ArrayNum, only the inline part is valid.
+		void* NewData = appMalloc( ArrayMax*ElementSize, Alignment );
+		appMemcpy( NewData, Data, Min<INT>( ArrayNum, InlineStorage.Max ) * ElementSize );
+		Data = NewData;
+	}
+	else
+	{
+		Data = appRealloc( Data, ArrayMax*ElementSize, Alignment );
+	}
+}
+
 
 /*-----------------------------------------------------------------------------
 	FString implementation.
@@ -3938,6 +3970,24 @@ void appInit( const TCHAR* InCmdLine, FOutputDevice* InLog, FOutputDeviceConsole
 		GIsSilent = TRUE;
 	}
 
+	// Keep the serial GC mark phase around for comparison and validation.
+	if( ParseParam(appCmdLine(),TEXT("SERIALGCMARK")) == TRUE )
+	{
+		GUseParallelGCMark = FALSE;
+	}
+
+	if( ParseParam(appCmdLine(),TEXT("VERIFYGCMARK")) == TRUE )
+	{
+		GVerifyParallelGCMark = TRUE;
+	}
+
+	// Lets several server processes on one host share the pages of the packages they load.
+	if( ParseParam(appCmdLine(),TEXT("MAPPEDPACKAGES")) == TRUE )
+	{
+		GUseMappedPackageLoading = TRUE;
+	}
+	Parse( appCmdLine(), TEXT("DECOMPRESSIONWINDOW="), GDecompressionWindowSize );
+
 #if ENABLE_SCRIPT_TRACING
 	if ( ParseParam(appCmdLine(), TEXT("UTRACE")) )
 	{
@@ -149,37 +149,181 @@ const TCHAR* DebugFullName(UObject* Object)
 -----------------------------------------------------------------------------*/
 
 // Static variables.
-FNameEntry*					FName::NameHash[4096];
-TArrayNoInit<FNameEntry*>	FName::Names;
+FNameEntry**				FName::NameChunks[MAX_NAME_TABLE_CHUNKS];
+INT							FName::NumNames;
+FNameEntry*					FName::NameHash[NAME_HASH_SIZE];
 INT							FName::NameEntryMemorySize;
 
 
+/*-----------------------------------------------------------------------------
+	Name entry arena.
+-----------------------------------------------------------------------------*/
+
+/** Size of a block of the name entry arena, including its header. */
+#define NAME_ARENA_BLOCK_SIZE	65536
+
+/**
+ * Block of the arena name entries are allocated from. Entries are never freed individually so their
+ * pointers stay stable for the lifetime of the name subsystem and allocation is a single compare
+ * exchange on the block offset in the common case.
+ */
+struct FNameArenaBlock
+{
+	/** Previously filled block, used to free all blocks on exit. */
+	FNameArenaBlock*	Next;
+	/** Offset of the first free byte, relative to the start of the block. */
+	INT					Used;
+};
+
+/** Block entries are currently allocated from. */
+static FNameArenaBlock* GNameArenaCurrentBlock = NULL;
+
+/** Offset of the first entry in a block, keeping entries 8 byte aligned for their flags. */
+#define NAME_ARENA_FIRST_OFFSET	Align<INT>( sizeof(FNameArenaBlock), 8 )
+
+/**
+ * Allocates memory for a name entry from the arena. Lock free and safe to call from any thread.
+ *
+ * @param	Size	size of the entry in bytes
+ * @return	8 byte aligned memory that is freed by FreeNameArena
+ */
+static void* AllocateFromNameArena( INT Size )
+{
+	Size = Align<INT>( Size, 8 );
+	check( NAME_ARENA_FIRST_OFFSET + Size <= NAME_ARENA_BLOCK_SIZE );
+	for( ;; )
+	{
+		FNameArenaBlock* Block = GNameArenaCurrentBlock;
+		if( Block )
+		{
+			const INT OldUsed = Block->Used;
+			if( OldUsed + Size <= NAME_ARENA_BLOCK_SIZE )
+			{
+				if( appInterlockedCompareExchange( &Block->Used, OldUsed + Size, OldUsed ) == OldUsed )
+				{
+					return (BYTE*)Block + OldUsed;
+				}
+				// Another thread allocated from the block in the meantime.
+				continue;
+			}
+		}
+
+		// The block is full, start a new one. If another thread beats us to it we use its block instead.
+		FNameArenaBlock* NewBlock = (FNameArenaBlock*) appMalloc( NAME_ARENA_BLOCK_SIZE );
+		NewBlock->Next = Block;
+		NewBlock->Used = NAME_ARENA_FIRST_OFFSET + Size;
+		if( appInterlockedCompareExchangePointer( (void**)&GNameArenaCurrentBlock, NewBlock, Block ) == Block )
+		{
+			return (BYTE*)NewBlock + NAME_ARENA_FIRST_OFFSET;
+		}
+		appFree( NewBlock );
+	}
+}
+
+/**
+ * Frees all arena blocks and with them all name entries.
+ */
+static void FreeNameArena()
+{
+	FNameArenaBlock* Block = GNameArenaCurrentBlock;
+	while( Block )
+	{
+		FNameArenaBlock* Next = Block->Next;
+		appFree( Block );
+		Block = Next;
+	}
+	GNameArenaCurrentBlock = NULL;
+}
+
+/**
+ * Walks a hash bin's list looking for a name.
+ *
+ * @param	First	first entry to check
+ * @param	Last	entry to stop at (exclusive), NULL to walk the whole list
+ * @param	Name	name to look for
+ * @param	Hash	case insensitive hash of Name
+ * @return	matching entry or NULL if none was found
+ */
+static FORCEINLINE FNameEntry* FindNameEntry( FNameEntry* First, FNameEntry* Last, const TCHAR* Name, DWORD Hash )
+{
+	for( FNameEntry* Entry = First; Entry != Last; Entry = Entry->HashNext )
+	{
+		if( Entry->Hash == Hash && appStricmp( Name, Entry->Name ) == 0 )
+		{
+			return Entry;
+		}
+	}
+	return NULL;
+}
+
+
 /*-----------------------------------------------------------------------------
 	FName implementation.
 -----------------------------------------------------------------------------*/
 
+/** Held while adding a name. A spin lock as names are added long before the synchronization factory exists. */
+static INT GNameAddLock = 0;
+
+/**
+ * Scoped lock serializing the addition of names. Finding names doesn't need it.
+ */
+class FNameAddScopeLock
+{
+public:
+	FNameAddScopeLock()
+	{
+		while( appInterlockedCompareExchange( &GNameAddLock, 1, 0 ) != 0 )
+		{
+			appSleep( 0 );
+		}
+	}
+	~FNameAddScopeLock()
+	{
+		appInterlockedExchange( &GNameAddLock, 0 );
+	}
+};
+
+/**
+ * Stores an entry in the name table, allocating the chunk holding its index if needed.
+ *
+ * @param	Index	name index to store the entry at
+ * @param	Entry	entry to store
+ */
+void FName::SetEntry( NAME_INDEX Index, FNameEntry* Entry )
+{
+	FNameEntry**& Chunk = NameChunks[Index / NAME_TABLE_CHUNK_SIZE];
+	if( Chunk == NULL )
+	{
+		// Several threads may get here at once for the same chunk, the first one to publish its chunk wins.
+		FNameEntry** NewChunk = (FNameEntry**) appMalloc( NAME_TABLE_CHUNK_SIZE * sizeof(FNameEntry*) );
+		appMemzero( NewChunk, NAME_TABLE_CHUNK_SIZE * sizeof(FNameEntry*) );
+		if( appInterlockedCompareExchangePointer( (void**)&Chunk, NewChunk, NULL ) != NULL )
+		{
+			appFree( NewChunk );
+		}
+	}
+	Chunk[Index % NAME_TABLE_CHUNK_SIZE] = Entry;
+}
+
 //
 // Hardcode a name.
 //
 void FName::Hardcode(FNameEntry* AutoName)
 {
 	// Add name to name hash.
-	INT iHash          = appStrihash(AutoName->Name) & (ARRAY_COUNT(NameHash)-1);
+	INT iHash          = AutoName->Hash & (NAME_HASH_SIZE-1);
 	AutoName->HashNext = NameHash[iHash];
 	NameHash[iHash]    = AutoName;
 
-	// Expand the table if needed.
-	for( INT i=Names.Num(); i<=AutoName->Index; i++ )
-	{
-		Names.AddItem( NULL );
-	}
+	// Expand the table if needed. Hardcoding happens during StaticInit so no other thread can be adding names.
+	NumNames = Max<INT>( NumNames, AutoName->Index + 1 );
 
 	// Add name to table.
-	if( Names(AutoName->Index) )
+	if( GetEntry(AutoName->Index) )
 	{
-		appErrorf( TEXT("Hardcoded name '%s' at index %i was duplicated. Existing entry is '%'."), AutoName->Name, AutoName->Index, Names(AutoName->Index)->Name );
+		appErrorf( TEXT("Hardcoded name '%s' at index %i was duplicated. Existing entry is '%s'."), AutoName->Name, AutoName->Index, GetEntry(AutoName->Index)->Name );
 	}
-	Names(AutoName->Index) = AutoName;
+	SetEntry( AutoName->Index, AutoName );
 }
 
 /**
@@ -260,48 +404,65 @@ void FName::Init(const TCHAR* InName, INT InNumber, EFindName FindType, UBOOL bS
 	// set the number
 	Number = InNumber;
 
-	// Try to find the name in the hash.
-	INT iHash = appStrihash(InName) & (ARRAY_COUNT(NameHash)-1);
-	for( FNameEntry* Hash=NameHash[iHash]; Hash; Hash=Hash->HashNext )
+	// Try to find the name in the hash. Entries are only ever pushed onto the front of a bin's list and
+	// never removed, so the list can be walked without locking while another thread is adding a name.
+	const DWORD NameHashValue = appStrihash(InName);
+	FNameEntry** Bin = &NameHash[NameHashValue & (NAME_HASH_SIZE-1)];
+	FNameEntry* Head = *(FNameEntry* volatile*)Bin;
+	FNameEntry* Hash = FindNameEntry( Head, NULL, InName, NameHashValue );
+
+	if( Hash == NULL )
 	{
-		if( appStricmp( InName, Hash->Name )==0 )
+		// Didn't find name.
+		if( FindType==FNAME_Find )
+		{
+			// Not found.
+			Index = NAME_None;
+			Number = NAME_NO_NUMBER_INTERNAL;
+			return;
+		}
+
+		// Adding is serialized so indices are handed out in order and without holes.
+		FNameAddScopeLock AddLock;
+
+		// Another thread might have added names to the bin while we were waiting. Only those need to be checked again.
+		FNameEntry* NewHead = *(FNameEntry* volatile*)Bin;
+		Hash = FindNameEntry( NewHead, Head, InName, NameHashValue );
+		if( Hash == NULL )
 		{
-			// Found it in the hash.
-			Index = Hash->Index;
-
-			// Check to see if the caller wants to replace the contents of the
-			// FName with the specified value. This is useful for compiling
-			// script classes where the file name is lower case but the class
-			// was intended to be uppercase.
-			if (FindType == FNAME_Replace)
+			const NAME_INDEX NewIndex = NumNames;
+			if( NewIndex >= MAX_NAME_TABLE_CHUNKS * NAME_TABLE_CHUNK_SIZE )
 			{
-				// This should be impossible due to the compare above
-				// This *must* be true, or we'll overwrite memory when the
-				// copy happens if it is longer
-				checkSlow(appStrlen(InName) == appStrlen(Hash->Name));
-				// Can't rely on the template override for static arrays since the safe crt version of strcpy will fill in
-				// the remainder of the array of NAME_SIZE with 0xfd.  So, we have to pass in the length of the dynamically allocated array instead.
-				appStrcpy(Hash->Name,appStrlen(Hash->Name)+1,InName);
+				appErrorf( TEXT("Name table overflow, more than %i names."), MAX_NAME_TABLE_CHUNKS * NAME_TABLE_CHUNK_SIZE );
 			}
 
-			return;
+			// The entry is stored in the table before NumNames covers it so code iterating the table never
+			// sees an empty slot, and NumNames covers it before the entry is published to the hash as other
+			// threads will use its index as soon as they can find it. Both interlocked operations act as barriers.
+			Hash = AllocateNameEntry( InName, NameHashValue, NewIndex, 0, NewHead );
+			SetEntry( NewIndex, Hash );
+			appInterlockedIncrement( &NumNames );
+			verify( appInterlockedCompareExchangePointer( (void**)Bin, Hash, NewHead ) == NewHead );
 		}
 	}
-
-	// Didn't find name.
-	if( FindType==FNAME_Find )
+	else if (FindType == FNAME_Replace)
 	{
-		// Not found.
-		Index = NAME_None;
-		Number = NAME_NO_NUMBER_INTERNAL;
-		return;
+		// Check to see if the caller wants to replace the contents of the
+		// FName with the specified value. This is useful for compiling
+		// script classes where the file name is lower case but the class
+		// was intended to be uppercase.
+
+		// This should be impossible due to the compare above
+		// This *must* be true, or we'll overwrite memory when the
+		// copy happens if it is longer
+		checkSlow(appStrlen(InName) == appStrlen(Hash->Name));
+		// Can't rely on the template override for static arrays since the safe crt version of strcpy will fill in
+		// the remainder of the array of NAME_SIZE with 0xfd.  So, we have to pass in the length of the dynamically allocated array instead.
+		appStrcpy(Hash->Name,appStrlen(Hash->Name)+1,InName);
 	}
 
-	// Add new entry.
-	Index = Names.Add();
-
-	// Allocate and set the name.
-	Names(Index) = NameHash[iHash] = AllocateNameEntry( InName, Index, 0, NameHash[iHash] );
+	// Found or added it.
+	Index = Hash->Index;
 }
 
 
@@ -312,15 +473,15 @@ void FName::Init(const TCHAR* InName, INT InNumber, EFindName FindType, UBOOL bS
  */
 FString FName::ToString() const
 {
-	checkName(Index < Names.Num());
-	checkName(Names(Index));
+	checkName(Index < NumNames);
+	checkName(GetEntry(Index));
 	if (Number != NAME_NO_NUMBER_INTERNAL)
 	{
-		return FString(Names(Index)->Name) + TEXT("_") + appItoa(NAME_INTERNAL_TO_EXTERNAL(Number));
+		return FString(GetEntry(Index)->Name) + TEXT("_") + appItoa(NAME_INTERNAL_TO_EXTERNAL(Number));
 	}
 	else
 	{
-		return FString(Names(Index)->Name);
+		return FString(GetEntry(Index)->Name);
 	}
 }
 
@@ -333,23 +494,18 @@ void FName::ToString(FString& Out) const
 {
 	// a version of ToString that saves at least one string copy
 
-	checkName(Index < Names.Num());
-	checkName(Names(Index));
+	checkName(Index < NumNames);
+	checkName(GetEntry(Index));
 	if (Number != NAME_NO_NUMBER_INTERNAL)
 	{
-		Out = FString(Names(Index)->Name) + TEXT("_") + appItoa(NAME_INTERNAL_TO_EXTERNAL(Number));
+		Out = FString(GetEntry(Index)->Name) + TEXT("_") + appItoa(NAME_INTERNAL_TO_EXTERNAL(Number));
 	}
 	else
 	{
-		Out = FString(Names(Index)->Name);
+		Out = FString(GetEntry(Index)->Name);
 	}
 }
 
-INT FName::GetNumber() const
-{
-	return Number;
-}
-
 
 /*-----------------------------------------------------------------------------
 	CRC functions. (MOVED FROM UNMISC.CPP FOR MASSIVE WORKAROUND @todo put back!
@@ -399,18 +555,13 @@ void FName::StaticInit()
 	check((ARRAY_COUNT(NameHash)&(ARRAY_COUNT(NameHash)-1)) == 0);
 	GetIsInitialized() = 1;
 
-	// initialize the TArrayNoInit() on first use, NOT when the constructor is called (as it could happen
-	// AFTER this function)
-	appMemzero(&FName::Names, sizeof(FName::Names));
-
-	// Init the name hash.
-	for (INT HashIndex = 0; HashIndex < ARRAY_COUNT(FName::NameHash); HashIndex++)
-	{
-		NameHash[HashIndex] = NULL;
-	}
+	// Init the name table and hash.
+	appMemzero(NameChunks, sizeof(NameChunks));
+	appMemzero(NameHash, sizeof(NameHash));
+	NumNames = 0;
 
 	// Register all hardcoded names.
-	#define REGISTER_NAME(num,namestr) Hardcode(AllocateNameEntry(TEXT(#namestr),num,0,NULL));
+	#define REGISTER_NAME(num,namestr) Hardcode(AllocateNameEntry(TEXT(#namestr),appStrihash(TEXT(#namestr)),num,0,NULL));
 	#include "UnNames.h"
 
 #if DO_CHECK
@@ -442,16 +593,20 @@ void FName::StaticExit()
 	debugf( NAME_Exit, TEXT("Name subsystem shutting down") );
 
 	// Kill all names.
-	for( INT i=0; i<Names.Num(); i++ )
+	FreeNameArena();
+
+	// Empty tables.
+	for( INT ChunkIndex=0; ChunkIndex<MAX_NAME_TABLE_CHUNKS; ChunkIndex++ )
 	{
-		if( Names(i) )
+		if( NameChunks[ChunkIndex] )
 		{
-			delete Names(i);
+			appFree( NameChunks[ChunkIndex] );
+			NameChunks[ChunkIndex] = NULL;
 		}
 	}
-
-	// Empty tables.
-	Names.Empty();
+	appMemzero(NameHash, sizeof(NameHash));
+	NumNames = 0;
+	NameEntryMemorySize = 0;
 	GetIsInitialized() = 0;
 }
 
@@ -460,18 +615,32 @@ void FName::StaticExit()
 //
 void FName::DisplayHash( FOutputDevice& Ar )
 {
-	INT UsedBins=0, NameCount=0, MemUsed = 0;
+	INT UsedBins=0, NameCount=0, MemUsed = 0, LongestBin = 0;
 	for( INT i=0; i<ARRAY_COUNT(NameHash); i++ )
 	{
 		if( NameHash[i] != NULL ) UsedBins++;
+		INT BinCount = 0;
 		for( FNameEntry *Hash = NameHash[i]; Hash; Hash=Hash->HashNext )
 		{
 			NameCount++;
+			BinCount++;
 			// Count how much memory this entry is using
 			MemUsed += sizeof(FNameEntry) - ((NAME_SIZE - appStrlen(Hash->Name) + 1) * sizeof(TCHAR));
 		}
+		LongestBin = Max( LongestBin, BinCount );
+	}
+	INT ArenaBlocks = 0, TableChunks = 0;
+	for( FNameArenaBlock* Block = GNameArenaCurrentBlock; Block; Block = Block->Next )
+	{
+		ArenaBlocks++;
+	}
+	for( INT ChunkIndex=0; ChunkIndex<MAX_NAME_TABLE_CHUNKS; ChunkIndex++ )
+	{
+		if( NameChunks[ChunkIndex] ) TableChunks++;
 	}
-	Ar.Logf( TEXT("Hash: %i names, %i/%i hash bins, Mem in bytes %i"), NameCount, UsedBins, ARRAY_COUNT(NameHash), MemUsed);
+	Ar.Logf( TEXT("Hash: %i names, %i/%i hash bins, longest bin %i, average used bin %.2f, Mem in bytes %i"), NameCount, UsedBins, ARRAY_COUNT(NameHash), LongestBin, UsedBins ? (FLOAT)NameCount / UsedBins : 0.f, MemUsed);
+	Ar.Logf( TEXT("Table: %i indices, %i chunks, %i arena blocks, Mem in bytes %i"), NumNames, TableChunks, ArenaBlocks,
+		(INT)(TableChunks * NAME_TABLE_CHUNK_SIZE * sizeof(FNameEntry*) + ArenaBlocks * NAME_ARENA_BLOCK_SIZE + sizeof(NameHash)) );
 }
 
 /**
@@ -578,13 +747,24 @@ FArchive& operator<<( FArchive& Ar, FNameEntry& E )
 	return Ar;
 }
 
-FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, EObjectFlags Flags, FNameEntry* HashNext )
+/**
+ * Allocates a name entry from the name arena. The returned entry lives until the name subsystem shuts down.
+ *
+ * @param	Name		string of the name
+ * @param	Hash		case insensitive hash of Name, see appStrihash
+ * @param	Index		index of the name in the name table
+ * @param	Flags		initial flags
+ * @param	HashNext	next entry in the hash bin
+ * @return	new entry
+ */
+FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Hash, DWORD Index, EObjectFlags Flags, FNameEntry* HashNext )
 {
 	const SIZE_T NameLen = appStrlen(Name);
 	INT NameEntrySize	  = sizeof(FNameEntry) - (NAME_SIZE - NameLen - 1)*sizeof(TCHAR);
-	FNameEntry* NameEntry = (FNameEntry*)appMalloc( NameEntrySize );
-	STAT( FName::NameEntryMemorySize += NameEntrySize );
+	FNameEntry* NameEntry = (FNameEntry*)AllocateFromNameArena( NameEntrySize );
+	STAT( appInterlockedAdd( &FName::NameEntryMemorySize, NameEntrySize ) );
 	NameEntry->Index      = Index;
+	NameEntry->Hash       = Hash;
 	NameEntry->Flags      = Flags;
 	NameEntry->HashNext   = HashNext;
 	// Can't rely on the template override for static arrays since the safe crt version of strcpy will fill in
@@ -25,8 +25,7 @@ UObject*					UObject::GAutoRegister							= NULL;
 UPackage*					UObject::GObjTransientPkg						= NULL;
 TCHAR						UObject::GObjCachedLanguage[32]					= TEXT("");
 TCHAR						UObject::GLanguage[64]							= TEXT("int");
-UObject*					UObject::GObjHash[OBJECT_HASH_BINS];
-UObject*					UObject::GObjHashOuter[OBJECT_HASH_BINS];
+FObjectHash					UObject::GObjHash;
 TArray<UObject*>			UObject::GObjLoaded;
 /** Objects that have been constructed during async loading phase.						*/
 TArray<UObject*>			UObject::GObjConstructedDuringAsyncLoading;
@@ -2800,10 +2799,10 @@ UObject* UObject::StaticFindObjectFastInternal( UClass* ObjectClass, UObject* Ob
 	// If they specified an outer use that during the hashing
 	if (ObjectPackage != NULL)
 	{
-		// Find in the specified package using the outer hash
-		INT iHash = GetObjectOuterHash(ObjectName,(DWORD)ObjectPackage);
-		for( UObject* Hash = GObjHashOuter[iHash]; Hash != NULL; Hash = Hash->HashOuterNext )
+		// Find in the specified package using the name/outer hash
+		for( INT SlotIndex = GObjHash.FindFirstNameOuter( ObjectName, ObjectPackage ); SlotIndex != INDEX_NONE; SlotIndex = GObjHash.FindNextNameOuter( ObjectName, ObjectPackage, SlotIndex ) )
 		{
+			UObject* Hash = GObjHash.GetNameOuterObject( SlotIndex );
 			/*
 			InName: the object name to search for. Two possibilities.
 				A = No dots. ie: 'S_Actor', a texture in Engine
@@ -2836,11 +2835,25 @@ UObject* UObject::StaticFindObjectFastInternal( UClass* ObjectClass, UObject* Ob
 			}
 		}
 	}
+	else if( !AnyPackage )
+	{
+		// Top level objects have a NULL outer so they are in the name/outer hash as well.
+		for( INT SlotIndex = GObjHash.FindFirstNameOuter( ObjectName, NULL ); SlotIndex != INDEX_NONE; SlotIndex = GObjHash.FindNextNameOuter( ObjectName, NULL, SlotIndex ) )
+		{
+			UObject* Hash = GObjHash.GetNameOuterObject( SlotIndex );
+			if
+			(	!Hash->HasAnyFlags(ExclusiveFlags)
+			&&	(ObjectClass==NULL || (ExactClass ? Hash->GetClass()==ObjectClass : Hash->IsA(ObjectClass))) )
+			{
+				checkf( !Hash->HasAnyFlags(RF_Unreachable), TEXT("%s"), *Hash->GetFullName() );
+				return Hash;
+			}
+		}
+	}
 	else
 	{
-		// Find in the specified package.
-		INT iHash = GetObjectHash( ObjectName );
-		for( UObject* Hash=GObjHash[iHash]; Hash!=NULL; Hash=Hash->HashNext )
+		// Find in any package, walking all objects with the name.
+		for( UObject* Hash = GObjHash.GetFirstWithName( ObjectName ); Hash != NULL; Hash = GObjHash.GetNextWithName( Hash ) )
 		{
 			/*
 			InName: the object name to search for. Two possibilities.
@@ -2878,6 +2891,33 @@ UObject* UObject::StaticFindObjectFastInternal( UClass* ObjectClass, UObject* Ob
 	return NULL;
 }
 
+/**
+ * Gathers the objects inside an outer using the object hash instead of iterating over all objects.
+ *
+ * @param	Outer					Outer to find the objects of
+ * @param	Results					Receives the objects, appended to any existing entries
+ * @param	bIncludeNestedObjects	If TRUE, objects inside the found objects are gathered as well
+ */
+void UObject::GetObjectsWithOuter( const UObject* Outer, TArray<UObject*>& Results, UBOOL bIncludeNestedObjects )
+{
+	const INT StartNum = Results.Num();
+	for( UObject* Object = GObjHash.GetFirstWithOuter( Outer ); Object != NULL; Object = GObjHash.GetNextWithOuter( Object ) )
+	{
+		Results.AddItem( Object );
+	}
+	if( bIncludeNestedObjects )
+	{
+		// Results grows while we iterate over it, picking up the children of each added object in turn.
+		for( INT ResultIndex = StartNum; ResultIndex < Results.Num(); ResultIndex++ )
+		{
+			for( UObject* Object = GObjHash.GetFirstWithOuter( Results(ResultIndex) ); Object != NULL; Object = GObjHash.GetNextWithOuter( Object ) )
+			{
+				Results.AddItem( Object );
+			}
+		}
+	}
+}
+
 /**
  * Fast version of StaticFindObject that relies on the passed in FName being the object name
  * without any group/ package qualifiers.
@@ -3397,6 +3437,13 @@ void UObject::StaticInit()
 		GConfig->GetInt( TEXT("Core.System"), TEXT("SizeOfPermanentObjectPool"), SizeOfPermanentObjectPool, GEngineIni );
 	}
 
+	// Whether script loaded by the game gets translated into superinstructions, see UStruct::Serialize.
+	GConfig->GetBool( TEXT("Core.System"), TEXT("bUseScriptSuperinstructions"), GUseScriptSuperinstructions, GEngineIni );
+	if( ParseParam( appCmdLine(), TEXT("NOSUPERINSTRUCTIONS") ) )
+	{
+		GUseScriptSuperinstructions = FALSE;
+	}
+
 	// GObjFirstGCIndex is the index at which the garbage collector will start for the mark phase.
 	GObjFirstGCIndex			= MaxObjectsNotConsideredByGC;
 	GPermanentObjectPoolSize	= SizeOfPermanentObjectPool;
@@ -3411,8 +3458,7 @@ void UObject::StaticInit()
 	}
 
 	// Init hash.
-	appMemzero(GObjHash,sizeof(UObject*) * OBJECT_HASH_BINS);
-	appMemzero(GObjHashOuter,sizeof(UObject*) * OBJECT_HASH_BINS);
+	GObjHash.Init();
 
 	// If statically linked, initialize registrants.
 	INT Lookup = 0; // Dummy required by AUTO_INITIALIZE_REGISTRANTS_CORE
@@ -3508,6 +3554,7 @@ void UObject::StaticExit()
 	GObjLoaders			.Empty();
 	GObjRegistrants		.Empty();
 	GObjAsyncPackages	.Empty();
+	GObjHash			.Exit();
 
 	GObjInitialized = 0;
 	debugf( NAME_Exit, TEXT("Object subsystem successfully closed.") );
@@ -4167,134 +4214,7 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 		{
 			// Hash info.
 			FName::DisplayHash( Ar );
-			INT ObjCount=0, HashCount=0;
-			for( FObjectIterator It; It; ++It )
-				ObjCount++;
-			for( INT i=0; i<ARRAY_COUNT(GObjHash); i++ )
-			{
-				INT c=0;
-				for( UObject* Hash=GObjHash[i]; Hash; Hash=Hash->HashNext )
-					c++;
-				if( c )
-					HashCount++;
-				//debugf( "%i: %i", i, c );
-			}
-			return 1;
-		}
-		else if( ParseCommand(&Str,TEXT("HASHOUTER")) )
-		{
-			INT SlotsInUse = 0;
-			INT TotalCollisions = 0;
-			INT MinCollisions = 0;
-			INT MaxCollisions = 0;
-			INT MaxBin = 0;
-			// Work through each slot and figure out how many collisions
-			for (DWORD CurrSlot = 0; CurrSlot < OBJECT_HASH_BINS; CurrSlot++)
-			{
-				INT Collisions = 0;
-				// Get the first item in the slot
-				UObject* Hash = GObjHashOuter[CurrSlot];
-				// Determine if this slot is being used
-				if (Hash != NULL)
-				{
-					// This slot is in use
-					SlotsInUse++;
-					// Now count how many hash collisions there are
-					while (Hash)
-					{
-						Hash = Hash->HashOuterNext;
-						// If there is another item in the chain
-						if (Hash != NULL)
-						{
-							// Then increment the number of collisions
-							Collisions++;
-						}
-					}
-					// Keep the global stats
-					TotalCollisions += Collisions;
-					if (Collisions > MaxCollisions)
-					{
-						MaxBin = CurrSlot;
-					}
-					MaxCollisions = Max<INT>(Collisions,MaxCollisions);
-					MinCollisions = Min<INT>(Collisions,MinCollisions);
-					// Now log the output
-					Ar.Logf(TEXT("\tSlot %d has %d collisions"),CurrSlot,Collisions);
-				}
-			}
-			// Dump how many slots were in use
-			Ar.Logf(TEXT("Slots in use %d"),SlotsInUse);
-			// Now dump how efficient the hash is
-			Ar.Logf(TEXT("Collision Stats: Best Case (%d), Average Case (%d), Worst Case (%d)"),
-				MinCollisions,appFloor(((FLOAT)TotalCollisions / (FLOAT)OBJECT_HASH_BINS)),
-				MaxCollisions);
-			// Dump the first 30 objects in the worst bin for inspection
-			INT Count = 0;
-			UObject* Hash = GObjHashOuter[MaxBin];
-			while (Hash != NULL && Count < 30)
-			{
-				Ar.Logf(TEXT("Object is %s (%s)"),*Hash->GetName(),*Hash->GetFullName());
-				Hash = Hash->HashOuterNext;
-				Count++;
-			}
-			return 1;
-		}
-		else if( ParseCommand(&Str,TEXT("HASHOBJ")) )
-		{
-			INT SlotsInUse = 0;
-			INT TotalCollisions = 0;
-			INT MinCollisions = 0;
-			INT MaxCollisions = 0;
-			INT MaxBin = 0;
-			// Work through each slot and figure out how many collisions
-			for (DWORD CurrSlot = 0; CurrSlot < OBJECT_HASH_BINS; CurrSlot++)
-			{
-				INT Collisions = 0;
-				// Get the first item in the slot
-				UObject* Hash = GObjHash[CurrSlot];
-				// Determine if this slot is being used
-				if (Hash != NULL)
-				{
-					// This slot is in use
-					SlotsInUse++;
-					// Now count how many hash collisions there are
-					while (Hash)
-					{
-						Hash = Hash->HashNext;
-						// If there is another item in the chain
-						if (Hash != NULL)
-						{
-							// Then increment the number of collisions
-							Collisions++;
-						}
-					}
-					// Keep the global stats
-					TotalCollisions += Collisions;
-					if (Collisions > MaxCollisions)
-					{
-						MaxBin = CurrSlot;
-					}
-					MaxCollisions = Max<INT>(Collisions,MaxCollisions);
-					MinCollisions = Min<INT>(Collisions,MinCollisions);
-					// Now log the output
-					Ar.Logf(TEXT("\tSlot %d has %d collisions"),CurrSlot,Collisions);
-				}
-			}
-			// Dump how many slots were in use
-			Ar.Logf(TEXT("Slots in use %d"),SlotsInUse);
-			// Now dump how efficient the hash is
-			Ar.Logf(TEXT("Collision Stats: Best Case (%d), Average Case (%d), Worst Case (%d)"),
-				MinCollisions,appFloor(((FLOAT)TotalCollisions / (FLOAT)OBJECT_HASH_BINS)),
-				MaxCollisions);
-			// Dump the first 30 objects in the worst bin for inspection
-			INT Count = 0;
-			UObject* Hash = GObjHash[MaxBin];
-			while (Hash != NULL && Count < 30)
-			{
-				Ar.Logf(TEXT("Object is %s (%s)"),*Hash->GetName(),*Hash->GetFullName());
-				Hash = Hash->HashNext;
-				Count++;
-			}
+			GObjHash.DumpStats( Ar );
 			return 1;
 		}
 		else if( ParseCommand(&Str,TEXT("CLASSES")) )
@@ -4325,51 +4245,50 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 				// Should we recurse into inner packages?
 				UBOOL bRecurse = ParseUBOOL(Str, TEXT("RECURSE"), Dummy);
 
-				// Iterate through the object list
-				for( FObjectIterator It; It; ++It )
+				// Gather the objects within the package specified through the object hash and serialize
+				// each one into a specialized archive which logs object names encountered during
+				// serialization -- rjp
+				TArray<UObject*> PackageObjects;
+				GetObjectsWithOuter( Pkg, PackageObjects, TRUE );
+				for( INT ObjectIndex=0; ObjectIndex<PackageObjects.Num(); ObjectIndex++ )
 				{
-					// if this object is within the package specified, serialize the object
-					// into a specialized archive which logs object names encountered during
-					// serialization -- rjp
-					if ( It->IsIn(Pkg) )
+					UObject* Object = PackageObjects(ObjectIndex);
+					if ( Object->GetOuter() == Pkg )
 					{
-						if ( It->GetOuter() == Pkg )
-						{
-							FArchiveShowReferences ArShowReferences( Ar, Pkg, *It, Exclude );
-						}
-						else if ( bRecurse )
+						FArchiveShowReferences ArShowReferences( Ar, Pkg, Object, Exclude );
+					}
+					else if ( bRecurse )
+					{
+						// Two options -
+						// a) this object is a function or something (which we don't care about)
+						// b) this object is inside a group inside the specified package (which we do care about)
+						UObject* CurrentObject = Object;
+						UObject* CurrentOuter = Object->GetOuter();
+						while ( CurrentObject && CurrentOuter )
 						{
-							// Two options -
-							// a) this object is a function or something (which we don't care about)
-							// b) this object is inside a group inside the specified package (which we do care about)
-							UObject* CurrentObject = *It;
-							UObject* CurrentOuter = It->GetOuter();
-							while ( CurrentObject && CurrentOuter )
-							{
-								// this object is a UPackage (a group inside a package)
-								// abort
-								if ( CurrentObject->GetClass() == UPackage::StaticClass() )
-									break;
+							// this object is a UPackage (a group inside a package)
+							// abort
+							if ( CurrentObject->GetClass() == UPackage::StaticClass() )
+								break;
 
-								// see if this object's outer is a UPackage
-								if ( CurrentOuter->GetClass() == UPackage::StaticClass() )
-								{
-									// if this object's outer is our original package, the original object (It)
-									// wasn't inside a group, it just wasn't at the base level of the package
-									// (its Outer wasn't the Pkg, it was something else e.g. a function, state, etc.)
-									/// ....just skip it
-									if ( CurrentOuter == Pkg )
-										break;
-
-									// otherwise, we've successfully found an object that was in the package we
-									// were searching, but would have been hidden within a group - let's log it
-									FArchiveShowReferences ArShowReferences( Ar, CurrentOuter, CurrentObject, Exclude );
+							// see if this object's outer is a UPackage
+							if ( CurrentOuter->GetClass() == UPackage::StaticClass() )
+							{
+								// if this object's outer is our original package, the original object
+								// wasn't inside a group, it just wasn't at the base level of the package
+								// (its Outer wasn't the Pkg, it was something else e.g. a function, state, etc.)
+								/// ....just skip it
+								if ( CurrentOuter == Pkg )
 									break;
-								}
 
-								CurrentObject = CurrentOuter;
-								CurrentOuter = CurrentObject->GetOuter();
+								// otherwise, we've successfully found an object that was in the package we
+								// were searching, but would have been hidden within a group - let's log it
+								FArchiveShowReferences ArShowReferences( Ar, CurrentOuter, CurrentObject, Exclude );
+								break;
 							}
+
+							CurrentObject = CurrentOuter;
+							CurrentOuter = CurrentObject->GetOuter();
 						}
 					}
 				}
@@ -4875,6 +4794,40 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 		}
 		return 0;
 	}
+	else if( ParseCommand(&Str,TEXT("SCRIPTSTATS")) )
+	{
+		if( ParseCommand(&Str,TEXT("START")) )
+		{
+			INT SampleRate = 1;
+			Parse( Str, TEXT("SAMPLE="), SampleRate );
+			GScriptProfiler.Start( SampleRate );
+			Ar.Logf( TEXT("Script stats started, sampling every %i call trees."), Max( SampleRate, 1 ) );
+		}
+		else if( ParseCommand(&Str,TEXT("STOP")) )
+		{
+			GScriptProfiler.Stop();
+			GScriptProfiler.Dump( Ar );
+		}
+		else if( ParseCommand(&Str,TEXT("DUMP")) )
+		{
+			GScriptProfiler.Dump( Ar );
+		}
+		else if( ParseCommand(&Str,TEXT("RESET")) )
+		{
+			GScriptProfiler.Reset();
+		}
+		else if( GScriptProfiler.bIsProfiling )
+		{
+			GScriptProfiler.Stop();
+			GScriptProfiler.Dump( Ar );
+		}
+		else
+		{
+			GScriptProfiler.Start();
+			Ar.Logf( TEXT("Script stats started.") );
+		}
+		return 1;
+	}
 	else if (ParseCommand(&Str,TEXT("SUPPRESS")))
 	{
 		FString EventNameString = ParseToken(Str,0);
@@ -5934,74 +5887,16 @@ FName UObject::MakeUniqueObjectName( UObject* Parent, UClass* Class, FName BaseN
 //
 void UObject::HashObject()
 {
-	INT iHash       = GetObjectHash( Name );
-	HashNext        = GObjHash[iHash];
-	GObjHash[iHash] = this;
-	// Now hash using the outer
-	iHash			= GetObjectOuterHash(Name,(DWORD)Outer);
-	HashOuterNext	= GObjHashOuter[iHash];
-	GObjHashOuter[iHash] = this;
+	GObjHash.Add( this );
 }
 
 //
 // Remove an object from the hash table.
+// NOTE: It relies on the outer being untouched and treats it as a key only to avoid potential crashes during GC
 //
 void UObject::UnhashObject()
 {
-	INT       iHash   = GetObjectHash( Name );
-	UObject** Hash    = &GObjHash[iHash];
-#if _DEBUG
-	INT       Removed = 0;
-#endif
-	while( *Hash != NULL )
-	{
-		if( *Hash != this )
-		{
-			Hash = &(*Hash)->HashNext;
- 		}
-		else
-		{
-			*Hash = (*Hash)->HashNext;
-#if _DEBUG
-			// Verify that we find one and just one object in debug builds.		
-			Removed++;
-#else
-			break;
-#endif
-		}
-	}
-#if _DEBUG
-	checkSlow(Removed != 0);
-	checkSlow(Removed == 1);
-#endif
-	// Remove the object from the outer hash.
-	// NOTE: It relies on the outer being untouched and treats it as an int to avoid potential crashes during GC
-	iHash   = GetObjectOuterHash(Name,(DWORD)Outer);
-	Hash    = &GObjHashOuter[iHash];
-#if _DEBUG
-	Removed = 0;
-#endif
-	// Search through the hash bin and remove the item
-	while( *Hash != NULL )
-	{
-		if( *Hash != this )
-		{
-			Hash = &(*Hash)->HashOuterNext;
- 		}
-		else
-		{
-			*Hash = (*Hash)->HashOuterNext;
-#if _DEBUG
-			Removed++;
-#else
-			return;
-#endif
-		}
-	}
-#if _DEBUG
-	checkSlow(Removed != 0);
-	checkSlow(Removed == 1);
-#endif
+	GObjHash.Remove( this );
 }
 
 /*-----------------------------------------------------------------------------
@@ -33,6 +33,11 @@ struct FClassCountInfo
 IMPLEMENT_COMPARE_CONSTREF(FClassCountInfo,UnObjGC,{ return B.InstanceCount - A.InstanceCount; });
 #endif
 
+DECLARE_CYCLE_STAT(TEXT("GC Mark Time"),STAT_GCMarkTime,STATGROUP_Object);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("GC Last Mark Time (ms)"),STAT_GCLastMarkTime,STATGROUP_Object);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("GC Mark Threads"),STAT_GCMarkThreads,STATGROUP_Object);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("GC Reachable Objects"),STAT_GCReachableObjects,STATGROUP_Object);
+
 /** Array of callbacks called first thing in UObject::CollectGarbage. */
 FGCCallback	GPreGarbageCollectionCallbacks[10];
 
@@ -234,12 +239,16 @@ private:
 	TArray<UObject*>	ObjectsToSerialize;
 };
 
+/** Whether a parallel mark phase is in progress, during which UObject::AddReferencedObjects must not be called. */
+static UBOOL GIsParallelGCMarkInProgress = FALSE;
+
 /**
  * Handles object reference, potentially NULL'ing
  *
  * @param Object						Object pointer passed by reference
  * @param bAllowReferenceElimination	Whether to allow NULL'ing the reference if RF_PendingKill is set
  */
+template<UBOOL bParallel>
 static FORCEINLINE void HandleObjectReference( TArray<UObject*>& ObjectsToSerialize, UObject*& Object, UBOOL bAllowReferenceElimination )
 {
 	checkSlow( Object == NULL || Object->IsValid() );
@@ -259,23 +268,235 @@ static FORCEINLINE void HandleObjectReference( TArray<UObject*>& ObjectsToSerial
 			// Add encountered object reference to list of to be serialized objects if it hasn't already been added.
 			else if( Object->HasAnyFlags( RF_Unreachable ) )
 			{
-				// Mark it as reachable.
-				Object->ClearFlags( RF_Unreachable );
-				// Add it to the list of objects to serialize.
-				ObjectsToSerialize.AddItem( Object );
+				if( bParallel )
+				{
+					// Other threads might reach the object at the same time so only the one that clears the flag adds it.
+					if( Object->ThisThreadAtomicallyClearedRFUnreachable() )
+					{
+						ObjectsToSerialize.AddItem( Object );
+					}
+				}
+				else
+				{
+					// Mark it as reachable.
+					Object->ClearFlags( RF_Unreachable );
+					// Add it to the list of objects to serialize.
+					ObjectsToSerialize.AddItem( Object );
+				}
 			}
 		}
 	}
 }
 
+/**
+ * Atomically clears RF_Unreachable, used by the parallel mark phase.
+ *
+ * @return TRUE if this call cleared the flag, FALSE if it was already clear
+ */
+UBOOL UObject::ThisThreadAtomicallyClearedRFUnreachable()
+{
+	// RF_Unreachable lives in the upper 32 bits of the flags so a 32 bit compare exchange on that half is enough.
+	const INT UnreachableFlag = (INT)(RF_Unreachable >> 32);
+#if __INTEL_BYTE_ORDER__
+	INT* FlagsHigh = ((INT*) &ObjectFlags) + 1;
+#else
+	INT* FlagsHigh = (INT*) &ObjectFlags;
+#endif
+	INT OldValue;
+	do
+	{
+		OldValue = *((volatile INT*) FlagsHigh);
+		if( !(OldValue & UnreachableFlag) )
+		{
+			return FALSE;
+		}
+	}
+	while( appInterlockedCompareExchange( FlagsHigh, OldValue & ~UnreachableFlag, OldValue ) != OldValue );
+	return TRUE;
+}
+
+/** Number of objects a worker takes from the shared pool at once during the parallel mark phase */
+#define GC_MARK_BATCH_SIZE		64
+/** Minimum number of objects in a worker's local queue before it shares half of them with starving workers */
+#define GC_MARK_SHARE_THRESHOLD	(2 * GC_MARK_BATCH_SIZE)
+
+/**
+ * State shared by the threads working on a parallel mark phase. Each worker processes objects from
+ * its own local queue and only touches the shared pool when it runs dry or when it has plenty of
+ * work while the pool is empty. The context is reference counted so helper threads that only start
+ * after marking has finished can still safely find out that there is nothing left to do.
+ */
+class FGCParallelMarkContext
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param InNumReferences	number of threads referencing the context, the last one to call Release deletes it
+	 */
+	FGCParallelMarkContext( INT InNumReferences )
+	:	SynchObject( GSynchronizeFactory->CreateCriticalSection() )
+	,	NumSharedObjects( 0 )
+	,	NumActiveWorkers( 0 )
+	,	NumWorkersUsed( 0 )
+	,	bIsDone( FALSE )
+	,	NumReferences( InNumReferences )
+	{}
+
+	/** Destructor, freeing the critical section */
+	~FGCParallelMarkContext()
+	{
+		GSynchronizeFactory->Destroy( SynchObject );
+	}
+
+	/**
+	 * Seeds the shared pool with the root objects. Needs to be called before any worker starts.
+	 *
+	 * @param Objects	objects to start marking from
+	 */
+	void AddInitialObjects( const TArray<UObject*>& Objects )
+	{
+		SharedObjects = Objects;
+		NumSharedObjects = SharedObjects.Num();
+	}
+
+	/**
+	 * Refills an empty local queue from the shared pool, waiting for other workers to share work if
+	 * the pool is empty but marking hasn't finished yet.
+	 *
+	 * @param LocalQueue		empty local queue of the calling worker
+	 * @param LocalProcessed	in/out objects the worker processed since it last went idle, handed to the context when it does
+	 * @param bIsActive			in/out whether the calling worker is counted as having work
+	 * @param bHasWorked		in/out whether the calling worker has been handed work before
+	 * @return TRUE if work was added to LocalQueue, FALSE if marking has finished
+	 */
+	UBOOL GetWork( TArray<UObject*>& LocalQueue, TArray<UObject*>& LocalProcessed, UBOOL& bIsActive, UBOOL& bHasWorked )
+	{
+		check( LocalQueue.Num() == 0 );
+		while( TRUE )
+		{
+			{
+				FScopeLock ScopeLock( SynchObject );
+				if( bIsDone )
+				{
+					return FALSE;
+				}
+				if( SharedObjects.Num() > 0 )
+				{
+					// Take the most recently shared objects as they are the most likely to still be in cache.
+					const INT NumToTake = Min( GC_MARK_BATCH_SIZE, SharedObjects.Num() );
+					const INT FirstIndex = SharedObjects.Num() - NumToTake;
+					LocalQueue.Add( NumToTake );
+					appMemcpy( LocalQueue.GetData(), &SharedObjects(FirstIndex), NumToTake * sizeof(UObject*) );
+					SharedObjects.Remove( FirstIndex, NumToTake );
+					NumSharedObjects = SharedObjects.Num();
+					if( !bIsActive )
+					{
+						bIsActive = TRUE;
+						NumActiveWorkers++;
+					}
+					if( !bHasWorked )
+					{
+						bHasWorked = TRUE;
+						NumWorkersUsed++;
+					}
+					return TRUE;
+				}
+				if( bIsActive )
+				{
+					bIsActive = FALSE;
+					NumActiveWorkers--;
+					ProcessedObjects += LocalProcessed;
+					LocalProcessed.Reset();
+				}
+				// Nobody has work left to share so everything reachable has been marked.
+				if( NumActiveWorkers == 0 )
+				{
+					bIsDone = TRUE;
+					return FALSE;
+				}
+			}
+			appSleep( 0 );
+		}
+	}
+
+	/**
+	 * Moves the older half of a worker's local queue to the shared pool.
+	 *
+	 * @param LocalQueue	local queue of the calling worker
+	 */
+	void ShareWork( TArray<UObject*>& LocalQueue )
+	{
+		const INT NumToShare = LocalQueue.Num() / 2;
+		FScopeLock ScopeLock( SynchObject );
+		const INT FirstIndex = SharedObjects.Add( NumToShare );
+		appMemcpy( &SharedObjects(FirstIndex), LocalQueue.GetData(), NumToShare * sizeof(UObject*) );
+		NumSharedObjects = SharedObjects.Num();
+		LocalQueue.Remove( 0, NumToShare );
+	}
+
+	/**
+	 * @return TRUE if the shared pool ran dry and workers might be waiting for work, read without the lock
+	 */
+	UBOOL WantsWork() const
+	{
+		return NumSharedObjects == 0;
+	}
+
+	/** Releases a reference, deleting the context when the last one is gone */
+	void Release()
+	{
+		if( NumReferences.Decrement() == 0 )
+		{
+			delete this;
+		}
+	}
+
+	/** @return objects processed by all workers, only valid once marking has finished */
+	const TArray<UObject*>& GetProcessedObjects() const
+	{
+		return ProcessedObjects;
+	}
+
+	/** @return number of threads that processed objects, only valid once marking has finished */
+	INT GetNumWorkersUsed() const
+	{
+		return NumWorkersUsed;
+	}
+
+private:
+	/** Guards everything but NumSharedObjects and NumReferences */
+	FCriticalSection* SynchObject;
+	/** Objects waiting to be picked up by any worker */
+	TArray<UObject*> SharedObjects;
+	/** Number of entries in SharedObjects, read without the lock */
+	volatile INT NumSharedObjects;
+	/** Number of workers that currently have objects in their local queue */
+	INT NumActiveWorkers;
+	/** Number of workers that have been handed work */
+	INT NumWorkersUsed;
+	/** Objects processed by workers that went idle */
+	TArray<UObject*> ProcessedObjects;
+	/** Whether marking has finished */
+	UBOOL bIsDone;
+	/** Threads still referencing the context */
+	FThreadSafeCounter NumReferences;
+};
+
 /**
  * Implementation of realtime garbage collector.
  *
- * The approach is to create an array of DWORD tokens for each class that describe object references. This is done for 
+ * The approach is to create an array of DWORD tokens for each class that describe object references. This is done for
  * script exposed classes by traversing the properties and additionally via manual function calls to emit tokens for
- * native only classes in the StaticConstructor. A third alternative is a AddReferencedObjects callback per object which 
- * is used to e.g. deal with object references inside TIndirectArrays and other cases where exposing a stream parsing 
+ * native only classes in the StaticConstructor. A third alternative is a AddReferencedObjects callback per object which
+ * is used to e.g. deal with object references inside TIndirectArrays and other cases where exposing a stream parsing
  * interface doesn't make sense to implement for.
+ *
+ * The objects reached from the root set can either be processed serially in a single growing array or in parallel,
+ * in which case the game thread and GThreadPool workers each process a local queue and share work through a
+ * FGCParallelMarkContext. Workers only parse token streams. AddReferencedObjects implementations are free to use
+ * serialization and other non thread safe code so they are called on the game thread in between parallel rounds
+ * while the workers are idle. Both produce the same set of unreachable objects.
  */
 class FArchiveRealtimeGC
 {
@@ -297,20 +518,23 @@ public:
 	/** Default constructor, initializing all members. */
 	FArchiveRealtimeGC()
 	: CurrentObject( NULL )
+	, NumReachableObjects( 0 )
+	, NumMarkThreads( 0 )
 	{}
 
 	/**
 	 * Performs reachability analysis.
 	 *
 	 * @param KeepFlags		Objects with these flags will be kept regardless of being referenced or not
+	 * @param bParallel		Whether to spread the work across GThreadPool workers
 	 */
-	void PerformReachabilityAnalysis( EObjectFlags KeepFlags )
+	void PerformReachabilityAnalysis( EObjectFlags KeepFlags, UBOOL bParallel )
 	{
 #if CATCH_GC_CRASHES
-		try 
+		try
 		{
 #endif
-		// Reset current object used for debugging. A NULL value indicates we're not currently in the 
+		// Reset current object used for debugging. A NULL value indicates we're not currently in the
 		// serialization/ token loop.
 		CurrentObject = NULL;
 
@@ -333,7 +557,7 @@ public:
 			if( (ObjectIndex+PREFETCH_DISTANCE) < UObject::GObjObjects.Num() )
 			{
 				PREFETCH( UObject::GObjObjects(ObjectIndex + PREFETCH_DISTANCE) );
-			}	
+			}
 
 			// Skip NULL entries.
 			if( !Object )
@@ -343,7 +567,7 @@ public:
 
 			// We can't collect garbage during an async load operation and by now all unreachable objects should've been purged.
 			checkf( !Object->HasAnyFlags(RF_AsyncLoading|RF_Unreachable), TEXT("%s"), *Object->GetFullName() );
-	
+
 			// Keep track of how many objects are around.
 			GObjectCountDuringLastMarkPhase++;
 
@@ -367,7 +591,7 @@ public:
 
 				// Mark objects as unreachable unless they have any of the passed in KeepFlags set and it's not marked for elimination..
 				if( Object->HasAnyFlags( KeepFlags ) && !Object->HasAnyFlags( RF_PendingKill ) )
-				{	
+				{
 					ObjectsToSerialize.AddItem( Object );
 				}
 				else
@@ -384,12 +608,131 @@ public:
 			}
 		}
 
+		// Only go wide if there is a pool with threads to help out.
+		const INT NumHelpers = GThreadPool ? Min<INT>( GThreadPool->GetNumThreads(), (INT)GNumHardwareThreads - 1 ) : 0;
+		if( bParallel && NumHelpers > 0 )
+		{
+			ParallelMark( NumHelpers );
+		}
+		else
+		{
+			SerialMark();
+		}
+#if CATCH_GC_CRASHES
+		}
+		catch ( ... )
+		{
+			FString CrashString = TEXT("Crashed during garbage collection. Please undefine CATCH_GC_CRASHES in UnObjGC.cpp to track this down further.");
+			if( CurrentObject->IsValid() )
+			{
+				CrashString += LINE_TERMINATOR;
+				CrashString += FString::Printf(TEXT("CurrentObject == %s"), *CurrentObject->GetFullName());
+			}
+			appErrorf(TEXT("%s"),*CrashString);
+		}
+#endif
+	}
+
+	/** @return number of objects found to be reachable by the last reachability analysis */
+	INT GetNumReachableObjects() const
+	{
+		return NumReachableObjects;
+	}
+
+	/** @return number of threads that took part in the last reachability analysis */
+	INT GetNumMarkThreads() const
+	{
+		return NumMarkThreads;
+	}
+
+	/**
+	 * Marks objects from the local queue of the calling thread until no worker has any work left.
+	 * Run by the game thread as well as by each helper queued on GThreadPool.
+	 *
+	 * @param Context	shared state of the mark phase
+	 */
+	static void ParallelMarkWorker( FGCParallelMarkContext* Context )
+	{
+		TArray<UObject*> LocalQueue;
+		LocalQueue.Empty( GC_MARK_SHARE_THRESHOLD * 2 );
+
+		// Objects whose AddReferencedObjects still needs to be called on the game thread.
+		TArray<UObject*> LocalProcessed;
+
+		// Presized "recursion" stack for handling arrays and structs.
+		TArray<FStackEntry> Stack;
+		Stack.Add( 128 );
+
+		UBOOL bIsActive = FALSE;
+		UBOOL bHasWorked = FALSE;
+		while( Context->GetWork( LocalQueue, LocalProcessed, bIsActive, bHasWorked ) )
+		{
+			// Process depth first to keep the local queue small and the working set in cache.
+			while( LocalQueue.Num() > 0 )
+			{
+				UObject* Object = LocalQueue.Pop();
+				ProcessObjectReferences<TRUE>( Object, LocalQueue, Stack );
+				LocalProcessed.AddItem( Object );
+
+				if( LocalQueue.Num() >= GC_MARK_SHARE_THRESHOLD && Context->WantsWork() )
+				{
+					Context->ShareWork( LocalQueue );
+				}
+			}
+		}
+	}
+
+	/**
+	 * Re-runs the mark phase serially after a parallel one and verifies that both consider the same objects unreachable.
+	 *
+	 * @param KeepFlags		Objects with these flags will be kept regardless of being referenced or not
+	 */
+	static void VerifyParallelMark( EObjectFlags KeepFlags )
+	{
+		// Remember and reset the parallel result.
+		TArray<BYTE> ParallelUnreachable;
+		ParallelUnreachable.AddZeroed( UObject::GObjObjects.Num() );
+		for( INT ObjectIndex=UObject::GObjFirstGCIndex; ObjectIndex<UObject::GObjObjects.Num(); ObjectIndex++ )
+		{
+			UObject* Object = UObject::GObjObjects(ObjectIndex);
+			if( Object && Object->HasAnyFlags( RF_Unreachable ) )
+			{
+				ParallelUnreachable(ObjectIndex) = 1;
+				Object->ClearFlags( RF_Unreachable );
+			}
+		}
+
+		FArchiveRealtimeGC SerialGC;
+		SerialGC.PerformReachabilityAnalysis( KeepFlags, FALSE );
+
+		INT NumMismatches = 0;
+		for( INT ObjectIndex=UObject::GObjFirstGCIndex; ObjectIndex<UObject::GObjObjects.Num(); ObjectIndex++ )
+		{
+			UObject* Object = UObject::GObjObjects(ObjectIndex);
+			if( Object && (Object->HasAnyFlags( RF_Unreachable ) ? 1 : 0) != ParallelUnreachable(ObjectIndex) )
+			{
+				debugf( NAME_Warning, TEXT("Parallel GC mark considers %s %s, serial mark disagrees"),
+					*Object->GetFullName(),
+					ParallelUnreachable(ObjectIndex) ? TEXT("unreachable") : TEXT("reachable") );
+				NumMismatches++;
+			}
+		}
+		if( NumMismatches > 0 )
+		{
+			appErrorf( TEXT("Parallel GC mark disagreed with serial mark on %i objects. Please check log for details."), NumMismatches );
+		}
+	}
+
+private:
+	/**
+	 * Keeps serializing objects till we reach the end of the growing array at which point we are done.
+	 */
+	void SerialMark()
+	{
 		// Presized "recursion" stack for handling arrays and structs.
 		TArray<FStackEntry> Stack;
 		Stack.Add( 128 ); //@todo rtgc: need to add code handling more than 128 layers of recursion or at least assert
-	
-		// Keep serializing objects till we reach the end of the growing array at which point
-		// we are done.
+
 		INT CurrentIndex = 0;
 		while( CurrentIndex < ObjectsToSerialize.Num() )
 		{
@@ -402,175 +745,279 @@ public:
 			PREFETCH( NextObject + 256 );
 			PREFETCH( NextObject + 384 );
 
-			//@todo rtgc: we could potentially add a class/ object flag to avoid calling this function but it might 
-			//@todo rtgc; not really be worth it.
-			CurrentObject->AddReferencedObjects( ObjectsToSerialize );
+			ProcessObjectReferences<FALSE>( CurrentObject, ObjectsToSerialize, Stack );
+		}
+		NumReachableObjects	= ObjectsToSerialize.Num();
+		NumMarkThreads		= 1;
+	}
 
-			//@todo rtgc: we need to handle object references in struct defaults
+	/**
+	 * Hands the objects gathered by the root set pass to the game thread and NumHelpers GThreadPool workers
+	 * and returns once all of them have run out of work.
+	 *
+	 * @param NumHelpers	number of workers to queue on GThreadPool
+	 */
+	void ParallelMark( INT NumHelpers );
 
-			// Make sure that token stream has been assembled at this point as the below code relies on it.
-			checkSlow( CurrentObject->GetClass()->HasAllFlags( RF_TokenStreamAssembled ) );
+	/**
+	 * Processes the references of a single object by parsing its class' token stream, adding newly reached objects
+	 * to ObjectsToSerialize. The serial path also calls AddReferencedObjects, the parallel one leaves that to
+	 * ParallelMark as it isn't safe to call on worker threads.
+	 *
+	 * @param Object				object to process
+	 * @param ObjectsToSerialize	array newly reached objects are added to
+	 * @param Stack					presized "recursion" stack for handling arrays and structs
+	 */
+	template<UBOOL bParallel>
+	static void ProcessObjectReferences( UObject* Object, TArray<UObject*>& ObjectsToSerialize, TArray<FStackEntry>& Stack )
+	{
+		//@todo rtgc: we could potentially add a class/ object flag to avoid calling this function but it might
+		//@todo rtgc; not really be worth it.
+		if( !bParallel )
+		{
+			Object->AddReferencedObjects( ObjectsToSerialize );
+		}
 
-			// Get pointer to token stream and jump to the start.
-			FGCReferenceTokenStream* RESTRICT TokenStream = &CurrentObject->GetClass()->ReferenceTokenStream;
-			DWORD TokenStreamIndex		= 0;
+		//@todo rtgc: we need to handle object references in struct defaults
 
-			// Create strack entry and initialize sane values.
-			FStackEntry* RESTRICT StackEntry = &Stack(0);
-			BYTE* StackEntryData		= (BYTE*) CurrentObject;
-			StackEntry->Data			= StackEntryData;
-			StackEntry->Stride			= 0;
-			StackEntry->Count			= -1;
-			StackEntry->LoopStartIndex	= -1;
-			
-			// Keep track of token return count in separate integer as arrays need to fiddle with it.
-			INT TokenReturnCount		= 0;
+		// Make sure that token stream has been assembled at this point as the below code relies on it.
+		checkSlow( Object->GetClass()->HasAllFlags( RF_TokenStreamAssembled ) );
 
-			// Parse the token stream.
-			while( TRUE )
-			{
-				// Handle returning from an array of structs, array of structs of arrays of ... (yadda yadda)
-				for( INT ReturnCount=0; ReturnCount<TokenReturnCount; ReturnCount++ )
-				{
-					// Make sure there's no stack underflow.
-					check( StackEntry->Count != -1 );
+		// Get pointer to token stream and jump to the start.
+		FGCReferenceTokenStream* RESTRICT TokenStream = &Object->GetClass()->ReferenceTokenStream;
+		DWORD TokenStreamIndex		= 0;
 
-					// We pre-decrement as we're already through the loop once at this point.
-					if( --StackEntry->Count > 0 )
-					{
-						// Point data to next entry.
-						StackEntryData	 = StackEntry->Data + StackEntry->Stride;
-						StackEntry->Data = StackEntryData;
-
-						// Jump back to the beginning of the loop.
-						TokenStreamIndex = StackEntry->LoopStartIndex;
-						// We're not done with this token loop so we need to early out instead of backing out further.
-						break;
-					}
-					else
-					{
-						StackEntry--;
-						StackEntryData = StackEntry->Data;
-					}
-				}
+		// Create strack entry and initialize sane values.
+		FStackEntry* RESTRICT StackEntry = &Stack(0);
+		BYTE* StackEntryData		= (BYTE*) Object;
+		StackEntry->Data			= StackEntryData;
+		StackEntry->Stride			= 0;
+		StackEntry->Count			= -1;
+		StackEntry->LoopStartIndex	= -1;
 
-				// Read information about reference from stream.
-				const FGCReferenceInfo ReferenceInfo = TokenStream->ReadReferenceInfo( TokenStreamIndex );
+		// Keep track of token return count in separate integer as arrays need to fiddle with it.
+		INT TokenReturnCount		= 0;
 
-				if( ReferenceInfo.Type == GCRT_Object )
-				{	
-					// We're dealing with an object reference.
-					UObject**	ObjectPtr	= (UObject**)(StackEntryData + ReferenceInfo.Offset);
-					UObject*&	Object		= *ObjectPtr;
-					TokenReturnCount		= ReferenceInfo.ReturnCount;
-					HandleObjectReference( ObjectsToSerialize, Object, TRUE );
-				}
-				else if( ReferenceInfo.Type == GCRT_ArrayObject )
-				{
-					// We're dealing with an array of object references.
-					TArray<UObject*>& ObjectArray = *((TArray<UObject*>*)(StackEntryData + ReferenceInfo.Offset));
-					TokenReturnCount = ReferenceInfo.ReturnCount;
-					for( INT ObjectIndex=0; ObjectIndex<ObjectArray.Num(); ObjectIndex++ )
-					{
-						UObject*& Object = ObjectArray(ObjectIndex);
-						HandleObjectReference( ObjectsToSerialize, Object, TRUE );
-					}
-				}
-				else if( ReferenceInfo.Type == GCRT_ArrayStruct )
+		// Parse the token stream.
+		while( TRUE )
+		{
+			// Handle returning from an array of structs, array of structs of arrays of ... (yadda yadda)
+			for( INT ReturnCount=0; ReturnCount<TokenReturnCount; ReturnCount++ )
+			{
+				// Make sure there's no stack underflow.
+				check( StackEntry->Count != -1 );
+
+				// We pre-decrement as we're already through the loop once at this point.
+				if( --StackEntry->Count > 0 )
 				{
-					// We're dealing with a dynamic array of structs.
-					const FArray& Array = *((FArray*)(StackEntryData + ReferenceInfo.Offset));
-					StackEntry++;
-					StackEntryData				= (BYTE*) Array.GetData();
-					StackEntry->Data			= StackEntryData;
-					StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
-					StackEntry->Count			= Array.Num();
-					
-					const FGCSkipInfo SkipInfo	= TokenStream->ReadSkipInfo( TokenStreamIndex );
-					StackEntry->LoopStartIndex	= TokenStreamIndex;
-					
-					if( StackEntry->Count == 0 )
-					{
-						// Skip empty array by jumping to skip index and set return count to the one about to be read in.
-						TokenStreamIndex		= SkipInfo.SkipIndex;
-						TokenReturnCount		= TokenStream->GetSkipReturnCount( SkipInfo );
-					}
-					else
-					{	
-						// Loop again.
-						check( StackEntry->Data );
-						TokenReturnCount		= 0;
-					}
+					// Point data to next entry.
+					StackEntryData	 = StackEntry->Data + StackEntry->Stride;
+					StackEntry->Data = StackEntryData;
+
+					// Jump back to the beginning of the loop.
+					TokenStreamIndex = StackEntry->LoopStartIndex;
+					// We're not done with this token loop so we need to early out instead of backing out further.
+					break;
 				}
-				else if( ReferenceInfo.Type == GCRT_PersistentObject )
+				else
 				{
-					// We're dealing with an object reference.
-					UObject**	ObjectPtr	= (UObject**)(StackEntryData + ReferenceInfo.Offset);
-					UObject*&	Object		= *ObjectPtr;
-					TokenReturnCount		= ReferenceInfo.ReturnCount;
-					HandleObjectReference( ObjectsToSerialize, Object, FALSE );
+					StackEntry--;
+					StackEntryData = StackEntry->Data;
 				}
-				else if( ReferenceInfo.Type == GCRT_FixedArray )
+			}
+
+			// Read information about reference from stream.
+			const FGCReferenceInfo ReferenceInfo = TokenStream->ReadReferenceInfo( TokenStreamIndex );
+
+			if( ReferenceInfo.Type == GCRT_Object )
+			{
+				// We're dealing with an object reference.
+				UObject**	ObjectPtr	= (UObject**)(StackEntryData + ReferenceInfo.Offset);
+				UObject*&	Object		= *ObjectPtr;
+				TokenReturnCount		= ReferenceInfo.ReturnCount;
+				HandleObjectReference<bParallel>( ObjectsToSerialize, Object, TRUE );
+			}
+			else if( ReferenceInfo.Type == GCRT_ArrayObject )
+			{
+				// We're dealing with an array of object references.
+				TArray<UObject*>& ObjectArray = *((TArray<UObject*>*)(StackEntryData + ReferenceInfo.Offset));
+				TokenReturnCount = ReferenceInfo.ReturnCount;
+				for( INT ObjectIndex=0; ObjectIndex<ObjectArray.Num(); ObjectIndex++ )
 				{
-					// We're dealing with a fixed size array
-					BYTE* PreviousData			= StackEntryData;
-					StackEntry++;
-					StackEntryData				= PreviousData;
-					StackEntry->Data			= PreviousData;
-					StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
-					StackEntry->Count			= TokenStream->ReadCount( TokenStreamIndex );
-					StackEntry->LoopStartIndex	= TokenStreamIndex;
-					TokenReturnCount			= 0;
+					UObject*& Object = ObjectArray(ObjectIndex);
+					HandleObjectReference<bParallel>( ObjectsToSerialize, Object, TRUE );
 				}
-				else if( ReferenceInfo.Type == GCRT_EndOfStream )
+			}
+			else if( ReferenceInfo.Type == GCRT_ArrayStruct )
+			{
+				// We're dealing with a dynamic array of structs.
+				const FArray& Array = *((FArray*)(StackEntryData + ReferenceInfo.Offset));
+				StackEntry++;
+				StackEntryData				= (BYTE*) Array.GetData();
+				StackEntry->Data			= StackEntryData;
+				StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
+				StackEntry->Count			= Array.Num();
+
+				const FGCSkipInfo SkipInfo	= TokenStream->ReadSkipInfo( TokenStreamIndex );
+				StackEntry->LoopStartIndex	= TokenStreamIndex;
+
+				if( StackEntry->Count == 0 )
 				{
-					// Break out of loop.
-					break;
+					// Skip empty array by jumping to skip index and set return count to the one about to be read in.
+					TokenStreamIndex		= SkipInfo.SkipIndex;
+					TokenReturnCount		= TokenStream->GetSkipReturnCount( SkipInfo );
 				}
-				else if (ReferenceInfo.Type == GCRT_ScriptDelegate)
+				else
 				{
-					// Script delegate, which requires special handling because if we NULL the object reference, we need to 
-					// clear the function name as well
-					FScriptDelegate*	DelegatePtr = (FScriptDelegate*) (StackEntryData + ReferenceInfo.Offset);
-					UObject*&			ObjectPtr	= DelegatePtr->Object;
-					UBOOL				bWasNULL	= (ObjectPtr == NULL);
-					TokenReturnCount				= ReferenceInfo.ReturnCount;
-					HandleObjectReference( ObjectsToSerialize, ObjectPtr, TRUE );
-					if( !bWasNULL && ObjectPtr == NULL )
-					{
-						// Clear the function name as well so the delegate isn't in an invalid state.
-						DelegatePtr->FunctionName = NAME_None;
-					}
+					// Loop again.
+					check( StackEntry->Data );
+					TokenReturnCount		= 0;
 				}
-				else
+			}
+			else if( ReferenceInfo.Type == GCRT_PersistentObject )
+			{
+				// We're dealing with an object reference.
+				UObject**	ObjectPtr	= (UObject**)(StackEntryData + ReferenceInfo.Offset);
+				UObject*&	Object		= *ObjectPtr;
+				TokenReturnCount		= ReferenceInfo.ReturnCount;
+				HandleObjectReference<bParallel>( ObjectsToSerialize, Object, FALSE );
+			}
+			else if( ReferenceInfo.Type == GCRT_FixedArray )
+			{
+				// We're dealing with a fixed size array
+				BYTE* PreviousData			= StackEntryData;
+				StackEntry++;
+				StackEntryData				= PreviousData;
+				StackEntry->Data			= PreviousData;
+				StackEntry->Stride			= TokenStream->ReadStride( TokenStreamIndex );
+				StackEntry->Count			= TokenStream->ReadCount( TokenStreamIndex );
+				StackEntry->LoopStartIndex	= TokenStreamIndex;
+				TokenReturnCount			= 0;
+			}
+			else if( ReferenceInfo.Type == GCRT_EndOfStream )
+			{
+				// Break out of loop.
+				break;
+			}
+			else if (ReferenceInfo.Type == GCRT_ScriptDelegate)
+			{
+				// Script delegate, which requires special handling because if we NULL the object reference, we need to
+				// clear the function name as well
+				FScriptDelegate*	DelegatePtr = (FScriptDelegate*) (StackEntryData + ReferenceInfo.Offset);
+				UObject*&			ObjectPtr	= DelegatePtr->Object;
+				UBOOL				bWasNULL	= (ObjectPtr == NULL);
+				TokenReturnCount				= ReferenceInfo.ReturnCount;
+				HandleObjectReference<bParallel>( ObjectsToSerialize, ObjectPtr, TRUE );
+				if( !bWasNULL && ObjectPtr == NULL )
 				{
-					appErrorf(TEXT("Unknown token"));
+					// Clear the function name as well so the delegate isn't in an invalid state.
+					DelegatePtr->FunctionName = NAME_None;
 				}
 			}
-			check( StackEntry == &Stack(0) );
-		}
-#if CATCH_GC_CRASHES
-		} 
-		catch ( ... )
-		{
-			FString CrashString = TEXT("Crashed during garbage collection. Please undefine CATCH_GC_CRASHES in UnObjGC.cpp to track this down further.");
-			if( CurrentObject->IsValid() )
+			else
 			{
-				CrashString += LINE_TERMINATOR;
-				CrashString += FString::Printf(TEXT("CurrentObject == %s"), *CurrentObject->GetFullName());
+				appErrorf(TEXT("Unknown token"));
 			}
-			appErrorf(TEXT("%s"),*CrashString);
 		}
-#endif
+		check( StackEntry == &Stack(0) );
 	}
 
-private:
 	/** Growing array of objects that require serialization */
 	TArray<UObject*>	ObjectsToSerialize;
 	/** Object we're currently serializing */
 	UObject*			CurrentObject;
+	/** Number of objects found to be reachable */
+	INT					NumReachableObjects;
+	/** Number of threads that took part in marking */
+	INT					NumMarkThreads;
 };
 
+/**
+ * Helper running FArchiveRealtimeGC::ParallelMarkWorker on a GThreadPool thread.
+ */
+class FGCParallelMarkWork : public FQueuedWork
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param InContext		shared state of the mark phase, this work holds a reference to it
+	 */
+	FGCParallelMarkWork( FGCParallelMarkContext* InContext )
+	:	Context( InContext )
+	{}
+
+	virtual void DoWork()
+	{
+		FArchiveRealtimeGC::ParallelMarkWorker( Context );
+	}
+
+	virtual void Abandon()
+	{
+		Dispose();
+	}
+
+	virtual void Dispose()
+	{
+		Context->Release();
+		delete this;
+	}
+
+private:
+	/** Shared state of the mark phase */
+	FGCParallelMarkContext* Context;
+};
+
+/**
+ * Hands the objects gathered by the root set pass to the game thread and NumHelpers GThreadPool workers
+ * and returns once all of them have run out of work.
+ *
+ * Workers only parse token streams. Once a round has finished the game thread calls AddReferencedObjects on
+ * everything the round processed and starts another round from the objects that reached, until no new
+ * objects are found.
+ *
+ * @param NumHelpers	number of workers to queue on GThreadPool
+ */
+void FArchiveRealtimeGC::ParallelMark( INT NumHelpers )
+{
+	NumReachableObjects	= 0;
+	NumMarkThreads		= 0;
+
+	while( ObjectsToSerialize.Num() > 0 )
+	{
+		// The game thread and each helper hold a reference so helpers that only get to run after
+		// marking has finished find the context still around.
+		FGCParallelMarkContext* Context = new FGCParallelMarkContext( NumHelpers + 1 );
+		Context->AddInitialObjects( ObjectsToSerialize );
+
+		GIsParallelGCMarkInProgress = TRUE;
+		for( INT HelperIndex=0; HelperIndex<NumHelpers; HelperIndex++ )
+		{
+			GThreadPool->AddQueuedWork( new FGCParallelMarkWork( Context ) );
+		}
+
+		// The game thread works along with the helpers. Once it runs out of work every other worker has
+		// as well so there is no need to wait for helpers that haven't started yet.
+		ParallelMarkWorker( Context );
+		GIsParallelGCMarkInProgress = FALSE;
+
+		// AddReferencedObjects implementations may serialize the object or touch other non thread safe state so
+		// they are called here, with all workers idle, using the serial path of AddReferencedObject.
+		const TArray<UObject*>& ProcessedObjects = Context->GetProcessedObjects();
+		ObjectsToSerialize.Reset();
+		for( INT ObjectIndex=0; ObjectIndex<ProcessedObjects.Num(); ObjectIndex++ )
+		{
+			CurrentObject = ProcessedObjects(ObjectIndex);
+			CurrentObject->AddReferencedObjects( ObjectsToSerialize );
+		}
+
+		NumReachableObjects	+= ProcessedObjects.Num();
+		NumMarkThreads		= Max( NumMarkThreads, Context->GetNumWorkersUsed() );
+		Context->Release();
+	}
+	CurrentObject = NULL;
+}
+
 
 /**
  * Incrementally purge garbage by deleting all unreferenced objects after routing Destroy.
@@ -832,9 +1279,23 @@ void UObject::CollectGarbage( EObjectFlags KeepFlags, UBOOL bPerformFullPurge )
 	{
 		// Use RTGC for game.
 		DOUBLE StartTime = appSeconds();
-		FArchiveRealtimeGC TagUsedRealtimeGC;		
-		TagUsedRealtimeGC.PerformReachabilityAnalysis( KeepFlags );
-		debugfSuppressed( NAME_DevGarbage, TEXT("%f ms for realtime GC"), (appSeconds() - StartTime) * 1000 );
+		FArchiveRealtimeGC TagUsedRealtimeGC;
+		{
+			SCOPE_CYCLE_COUNTER(STAT_GCMarkTime);
+			TagUsedRealtimeGC.PerformReachabilityAnalysis( KeepFlags, GUseParallelGCMark );
+		}
+		const FLOAT MarkTime = (appSeconds() - StartTime) * 1000;
+		SET_FLOAT_STAT( STAT_GCLastMarkTime, MarkTime );
+		SET_DWORD_STAT( STAT_GCMarkThreads, TagUsedRealtimeGC.GetNumMarkThreads() );
+		SET_DWORD_STAT( STAT_GCReachableObjects, TagUsedRealtimeGC.GetNumReachableObjects() );
+		debugfSuppressed( NAME_DevGarbage, TEXT("%f ms for realtime GC, %i threads marked %i objects"), MarkTime, TagUsedRealtimeGC.GetNumMarkThreads(), TagUsedRealtimeGC.GetNumReachableObjects() );
+
+#if !FINAL_RELEASE
+		if( GUseParallelGCMark && GVerifyParallelGCMark )
+		{
+			FArchiveRealtimeGC::VerifyParallelMark( KeepFlags );
+		}
+#endif
 	}
 
 	// Unhash all unreachable objects.
@@ -942,7 +1403,9 @@ UBOOL UObject::IsReferenced( UObject*& Obj, EObjectFlags KeepFlags )
  */
 void UObject::AddReferencedObject( TArray<UObject*>& ObjectArray, UObject* Object )
 {
-	HandleObjectReference( ObjectArray, Object, FALSE );
+	// AddReferencedObjects is only ever called on the game thread with mark workers idle.
+	checkSlow( !GIsParallelGCMarkInProgress );
+	HandleObjectReference<FALSE>( ObjectArray, Object, FALSE );
 }
 
 /**
@@ -0,0 +1,290 @@
+/*=============================================================================
+	UnObjHash.cpp: Open addressed object hash tables.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+
+/** Initial number of slots of the name/outer table, sized for a typical startup object count. */
+#define INITIAL_OBJECT_HASH_SIZE	65536
+/** Initial number of slots of the name and outer list tables. */
+#define INITIAL_LIST_HASH_SIZE		16384
+
+/*-----------------------------------------------------------------------------
+	FObjectHash.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Initializes all tables to empty.
+ */
+void FObjectHash::Init()
+{
+	NameOuterHash.Empty( INITIAL_OBJECT_HASH_SIZE );
+	NameHash.Empty( INITIAL_LIST_HASH_SIZE );
+	OuterHash.Empty( INITIAL_LIST_HASH_SIZE );
+	PrevLinks.Empty();
+}
+
+/**
+ * Frees all memory.
+ */
+void FObjectHash::Exit()
+{
+	NameOuterHash.Empty( 0 );
+	NameHash.Empty( 0 );
+	OuterHash.Empty( 0 );
+	PrevLinks.Empty();
+}
+
+/**
+ * Adds an object to all tables.
+ *
+ * @param Object	object to add, using its current name, outer and index
+ */
+void FObjectHash::Add( UObject* Object )
+{
+	check( Object->Index != INDEX_NONE );
+
+	FNameOuterEntry Entry;
+	Entry.Name		= Object->Name;
+	Entry.Outer		= Object->Outer;
+	Entry.Object	= Object;
+	NameOuterHash.Add( Entry );
+
+	if( Object->Index >= PrevLinks.Num() )
+	{
+		PrevLinks.AddZeroed( Object->Index + 1 - PrevLinks.Num() );
+	}
+
+	FListHeadEntry Key;
+	Key.Name	= Object->Name;
+	Key.Outer	= NULL;
+	LinkObject( NameHash, Key, Object, FALSE );
+
+	Key.Name	= NAME_None;
+	Key.Outer	= Object->Outer;
+	LinkObject( OuterHash, Key, Object, TRUE );
+}
+
+/**
+ * Removes an object from all tables. The outer is never dereferenced as it might have been
+ * destroyed already during garbage collection.
+ *
+ * @param Object	object to remove, with the name, outer and index it was added with
+ */
+void FObjectHash::Remove( UObject* Object )
+{
+	FNameOuterEntry Entry;
+	Entry.Name	= Object->Name;
+	Entry.Outer	= Object->Outer;
+	INT SlotIndex = NameOuterHash.FindFirst( Entry, Entry.GetHash() );
+	while( SlotIndex != INDEX_NONE && NameOuterHash.GetEntry( SlotIndex ).Object != Object )
+	{
+		SlotIndex = NameOuterHash.FindNext( Entry, SlotIndex );
+	}
+	check( SlotIndex != INDEX_NONE );
+	NameOuterHash.RemoveAt( SlotIndex );
+
+	FListHeadEntry Key;
+	Key.Name	= Object->Name;
+	Key.Outer	= NULL;
+	UnlinkObject( NameHash, Key, Object, FALSE );
+
+	Key.Name	= NAME_None;
+	Key.Outer	= Object->Outer;
+	UnlinkObject( OuterHash, Key, Object, TRUE );
+}
+
+/**
+ * Links an object into the list at a head entry, adding the head if there is none.
+ *
+ * @param Table		name or outer table
+ * @param Key		key of the list
+ * @param Object	object to link in
+ * @param bOuter	whether this is the outer list
+ */
+void FObjectHash::LinkObject( TLinearProbingHash<FListHeadEntry>& Table, const FListHeadEntry& Key, UObject* Object, UBOOL bOuter )
+{
+	UObject*& Next = bOuter ? Object->HashOuterNext : Object->HashNext;
+	FPrevLinks& Links = PrevLinks(Object->Index);
+	(bOuter ? Links.PrevWithOuter : Links.PrevWithName) = NULL;
+
+	const INT SlotIndex = Table.FindFirst( Key, Key.GetHash() );
+	if( SlotIndex == INDEX_NONE )
+	{
+		FListHeadEntry Head = Key;
+		Head.First	= Object;
+		Head.Count	= 1;
+		Table.Add( Head );
+		Next = NULL;
+	}
+	else
+	{
+		// Push to the front of the list.
+		FListHeadEntry& Head = Table.GetEntry( SlotIndex );
+		UObject* OldFirst = Head.First;
+		FPrevLinks& OldFirstLinks = PrevLinks(OldFirst->Index);
+		(bOuter ? OldFirstLinks.PrevWithOuter : OldFirstLinks.PrevWithName) = Object;
+		Next		= OldFirst;
+		Head.First	= Object;
+		Head.Count++;
+	}
+}
+
+/**
+ * Unlinks an object from the list at a head entry, removing the head if the list is now empty.
+ *
+ * @param Table		name or outer table
+ * @param Key		key of the list
+ * @param Object	object to unlink
+ * @param bOuter	whether this is the outer list
+ */
+void FObjectHash::UnlinkObject( TLinearProbingHash<FListHeadEntry>& Table, const FListHeadEntry& Key, UObject* Object, UBOOL bOuter )
+{
+	UObject*& Next = bOuter ? Object->HashOuterNext : Object->HashNext;
+	FPrevLinks& Links = PrevLinks(Object->Index);
+	UObject*& Prev = bOuter ? Links.PrevWithOuter : Links.PrevWithName;
+
+	const INT SlotIndex = Table.FindFirst( Key, Key.GetHash() );
+	check( SlotIndex != INDEX_NONE );
+	FListHeadEntry& Head = Table.GetEntry( SlotIndex );
+
+	if( Head.Count == 1 )
+	{
+		// Last object in the list, remove the head altogether.
+		check( Head.First == Object && Next == NULL );
+		Table.RemoveAt( SlotIndex );
+	}
+	else
+	{
+		if( Next )
+		{
+			FPrevLinks& NextLinks = PrevLinks(Next->Index);
+			(bOuter ? NextLinks.PrevWithOuter : NextLinks.PrevWithName) = Prev;
+		}
+		if( Prev )
+		{
+			(bOuter ? Prev->HashOuterNext : Prev->HashNext) = Next;
+		}
+		else
+		{
+			checkSlow( Head.First == Object );
+			Head.First = Next;
+		}
+		Head.Count--;
+	}
+	Next = NULL;
+	Prev = NULL;
+}
+
+/**
+ * @return first object with the passed in name, iterate the rest with GetNextWithName
+ */
+UObject* FObjectHash::GetFirstWithName( FName Name ) const
+{
+	FListHeadEntry Key;
+	Key.Name	= Name;
+	Key.Outer	= NULL;
+	const INT SlotIndex = NameHash.FindFirst( Key, Key.GetHash() );
+	return SlotIndex != INDEX_NONE ? NameHash.GetEntry( SlotIndex ).First : NULL;
+}
+
+/**
+ * @return next object with the same name as the passed in one or NULL
+ */
+UObject* FObjectHash::GetNextWithName( const UObject* Object ) const
+{
+	return Object->HashNext;
+}
+
+/**
+ * @return first object directly inside Outer, iterate the rest with GetNextWithOuter
+ */
+UObject* FObjectHash::GetFirstWithOuter( const UObject* Outer ) const
+{
+	FListHeadEntry Key;
+	Key.Name	= NAME_None;
+	Key.Outer	= (UObject*) Outer;
+	const INT SlotIndex = OuterHash.FindFirst( Key, Key.GetHash() );
+	return SlotIndex != INDEX_NONE ? OuterHash.GetEntry( SlotIndex ).First : NULL;
+}
+
+/**
+ * @return next object with the same outer as the passed in one or NULL
+ */
+UObject* FObjectHash::GetNextWithOuter( const UObject* Object ) const
+{
+	return Object->HashOuterNext;
+}
+
+/**
+ * @return number of objects directly inside Outer
+ */
+INT FObjectHash::GetNumWithOuter( const UObject* Outer ) const
+{
+	FListHeadEntry Key;
+	Key.Name	= NAME_None;
+	Key.Outer	= (UObject*) Outer;
+	const INT SlotIndex = OuterHash.FindFirst( Key, Key.GetHash() );
+	return SlotIndex != INDEX_NONE ? OuterHash.GetEntry( SlotIndex ).Count : 0;
+}
+
+/**
+ * Logs size, load and probe statistics of a single table.
+ */
+template<typename EntryType>
+static void DumpTableStats( FOutputDevice& Ar, const TCHAR* TableName, const TLinearProbingHash<EntryType>& Table )
+{
+	FLOAT AverageProbeLength = 0.f;
+	INT MaxProbeLength = 0;
+	Table.GetProbeStats( AverageProbeLength, MaxProbeLength );
+	Ar.Logf( TEXT("%-12s %8i entries in %8i slots (%5.1f%% load, %6.1f KByte), probe length average %.2f, worst %i"),
+		TableName,
+		Table.Num(),
+		Table.GetHashSize(),
+		Table.GetHashSize() ? 100.f * Table.Num() / Table.GetHashSize() : 0.f,
+		Table.GetAllocatedSize() / 1024.f,
+		AverageProbeLength,
+		MaxProbeLength );
+}
+
+/**
+ * Logs table sizes, load and probe statistics.
+ *
+ * @param Ar	device to log to
+ */
+void FObjectHash::DumpStats( FOutputDevice& Ar ) const
+{
+	DumpTableStats( Ar, TEXT("Name/Outer"), NameOuterHash );
+	DumpTableStats( Ar, TEXT("Name"), NameHash );
+	DumpTableStats( Ar, TEXT("Outer"), OuterHash );
+
+	// Find the longest lists as they are what ANY_PACKAGE lookups and outer iteration pay for.
+	const FListHeadEntry* LongestName = NULL;
+	for( INT SlotIndex = 0; SlotIndex < NameHash.GetHashSize(); SlotIndex++ )
+	{
+		const FListHeadEntry& Head = NameHash.GetEntry( SlotIndex );
+		if( !Head.IsFree() && (!LongestName || Head.Count > LongestName->Count) )
+		{
+			LongestName = &Head;
+		}
+	}
+	const FListHeadEntry* LongestOuter = NULL;
+	for( INT SlotIndex = 0; SlotIndex < OuterHash.GetHashSize(); SlotIndex++ )
+	{
+		const FListHeadEntry& Head = OuterHash.GetEntry( SlotIndex );
+		if( !Head.IsFree() && (!LongestOuter || Head.Count > LongestOuter->Count) )
+		{
+			LongestOuter = &Head;
+		}
+	}
+	if( LongestName )
+	{
+		Ar.Logf( TEXT("Most common name: %s (%i objects)"), *LongestName->Name.ToString(), LongestName->Count );
+	}
+	if( LongestOuter )
+	{
+		Ar.Logf( TEXT("Largest outer: %s (%i objects)"), LongestOuter->Outer ? *LongestOuter->Outer->GetFullName() : TEXT("None"), LongestOuter->Count );
+	}
+	Ar.Logf( TEXT("List links: %6.1f KByte"), PrevLinks.GetAllocatedSize() / 1024.f );
+}
@@ -0,0 +1,437 @@
+/*=============================================================================
+	UnScriptProfiler.cpp: Per function UnrealScript profiler.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+
+/** Global script profiler, toggled via the SCRIPTSTATS exec command. */
+FScriptProfiler GScriptProfiler;
+
+/*-----------------------------------------------------------------------------
+	Native dispatch thunks.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Installed in GNatives for single byte native functions while profiling. The dispatcher has
+ * just read the native index from the code stream, so it is used to look up what to call.
+ */
+void UObject::execProfiledNative( FFrame& Stack, RESULT_DECL )
+{
+	const INT iNative = Stack.Code[-1];
+	FScopedScriptProfile ScriptProfile( this, GScriptProfiler.GetProfiledNative( iNative ) );
+	(this->*GScriptProfiler.GetUnprofiledNative( iNative ))( Stack, Result );
+}
+
+/**
+ * Installed in place of the EX_ExtendedNative dispatchers while profiling. Single byte natives
+ * routed through here end up in execProfiledNative, so only the extended ones are measured.
+ */
+void UObject::execProfiledHighNative( FFrame& Stack, RESULT_DECL )
+{
+	const INT iNative = (Stack.Code[-1] - EX_ExtendedNative) * 0x100 + *Stack.Code++;
+	UFunction* Function = iNative >= 0x100 ? GScriptProfiler.GetProfiledNative( iNative ) : NULL;
+	if( Function )
+	{
+		FScopedScriptProfile ScriptProfile( this, Function );
+		(this->*GNatives[iNative])( Stack, Result );
+	}
+	else
+	{
+		(this->*GNatives[iNative])( Stack, Result );
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	FScriptProfiler implementation.
+-----------------------------------------------------------------------------*/
+
+/** Sorts stats by descending exclusive time. */
+struct FFunctionStatsSortEntry
+{
+	INT		StatsIndex;
+	QWORD	ExclusiveCycles;
+};
+IMPLEMENT_COMPARE_CONSTREF( FFunctionStatsSortEntry, UnScriptProfiler, { return B.ExclusiveCycles > A.ExclusiveCycles ? 1 : (B.ExclusiveCycles < A.ExclusiveCycles ? -1 : 0); } );
+
+/**
+ * Writes a formatted string to an archive as ANSI text.
+ *
+ * @param	Ar		archive to write to
+ * @param	Format	printf style format string
+ */
+static void CDECL WriteAnsiString( FArchive& Ar, const ANSICHAR* Format, ... )
+{
+	ANSICHAR Array[1024];
+	va_list ArgPtr;
+	va_start( ArgPtr, Format );
+	INT Result = appGetVarArgsAnsi( Array, ARRAY_COUNT(Array), ARRAY_COUNT(Array)-1, Format, ArgPtr );
+	va_end( ArgPtr );
+	Ar.Serialize( Array, Result );
+}
+
+/**
+ * Constructor, initializing the profiler to be idle.
+ */
+FScriptProfiler::FScriptProfiler()
+:	bIsProfiling( FALSE )
+,	CurrentScope( NULL )
+,	Session( 1 )
+,	SampleRate( 1 )
+,	SampleCounter( 0 )
+,	bInSkippedTree( FALSE )
+,	NumFrames( 0 )
+{
+	appMemzero( Cache, sizeof(Cache) );
+}
+
+/**
+ * Discards previously collected data and starts recording.
+ *
+ * @param	InSampleRate	only every InSampleRate'th top level call tree is measured
+ */
+void FScriptProfiler::Start( INT InSampleRate )
+{
+	Reset();
+	SampleRate = Max( InSampleRate, 1 );
+	if( !bIsProfiling )
+	{
+		InstallNativeThunks();
+		bIsProfiling = TRUE;
+	}
+}
+
+/**
+ * Stops recording, keeping the collected data around for Dump.
+ */
+void FScriptProfiler::Stop()
+{
+	if( bIsProfiling )
+	{
+		bIsProfiling = FALSE;
+		RemoveNativeThunks();
+
+		// Calls still on the stack are dropped rather than recorded with partial times.
+		if( ++Session == 0 )
+		{
+			Session = 1;
+		}
+		CurrentScope = NULL;
+		bInSkippedTree = FALSE;
+	}
+}
+
+/**
+ * Discards all collected data without changing whether we are recording.
+ */
+void FScriptProfiler::Reset()
+{
+	// Calls still on the stack refer to stats that are about to go away.
+	if( ++Session == 0 )
+	{
+		Session = 1;
+	}
+	CurrentScope = NULL;
+	bInSkippedTree = FALSE;
+	SampleCounter = 0;
+	NumFrames = 0;
+
+	Stats.Empty();
+	StatsMap.Empty();
+	appMemzero( Cache, sizeof(Cache) );
+}
+
+/**
+ * Finds or creates the stats for a function called in a state.
+ *
+ * @param	Function	function being called
+ * @param	State		state the function is called in, NULL if none
+ * @return	index into Stats
+ */
+INT FScriptProfiler::FindStats( UFunction* Function, UState* State )
+{
+	const FFunctionStatsKey Key( Function, State );
+	FCacheEntry& Entry = Cache[ GetTypeHash( Key ) & (CACHE_SIZE - 1) ];
+	if( Entry.Function == Function && Entry.State == State )
+	{
+		return Entry.StatsIndex;
+	}
+
+	INT StatsIndex;
+	INT* ExistingIndex = StatsMap.Find( Key );
+	if( ExistingIndex )
+	{
+		StatsIndex = *ExistingIndex;
+	}
+	else
+	{
+		StatsIndex = Stats.AddZeroed();
+		Stats(StatsIndex).Function	= Function;
+		Stats(StatsIndex).State		= State;
+		StatsMap.Set( Key, StatsIndex );
+	}
+
+	Entry.Function		= Function;
+	Entry.State			= State;
+	Entry.StatsIndex	= StatsIndex;
+	return StatsIndex;
+}
+
+/**
+ * Starts measuring a call. Only called while profiling.
+ *
+ * @param	Scope		scope to track the call with
+ * @param	Object		object the function is called on
+ * @param	Function	function being called
+ */
+void FScriptProfiler::BeginCall( FScopedScriptProfile& Scope, UObject* Object, UFunction* Function )
+{
+	if( bInSkippedTree )
+	{
+		return;
+	}
+
+	if( CurrentScope == NULL )
+	{
+		// Decide whether to measure this call tree. Only its root is tracked when it is skipped,
+		// so that the calls it makes cost a single branch.
+		if( ++SampleCounter < SampleRate )
+		{
+			bInSkippedTree		= TRUE;
+			Scope.Session		= Session;
+			Scope.StatsIndex	= INDEX_NONE;
+			return;
+		}
+		SampleCounter = 0;
+	}
+
+	UState* State = NULL;
+	FStateFrame* StateFrame = Object->GetStateFrame();
+	if( StateFrame && StateFrame->StateNode && StateFrame->StateNode != Object->GetClass() )
+	{
+		State = StateFrame->StateNode;
+	}
+
+	Scope.StatsIndex	= FindStats( Function, State );
+	Scope.Session		= Session;
+	Scope.ChildCycles	= 0;
+	Scope.Parent		= CurrentScope;
+	CurrentScope		= &Scope;
+	Stats(Scope.StatsIndex).NumActive++;
+
+	Scope.StartCycles	= appCycles();
+}
+
+/**
+ * Finishes measuring a call started by BeginCall.
+ *
+ * @param	Scope	scope the call was tracked with
+ */
+void FScriptProfiler::EndCall( FScopedScriptProfile& Scope )
+{
+	if( Scope.Session != Session )
+	{
+		return;
+	}
+	if( Scope.StatsIndex == INDEX_NONE )
+	{
+		bInSkippedTree = FALSE;
+		return;
+	}
+
+	const DWORD Cycles = appCycles() - Scope.StartCycles;
+
+	FFunctionStats& FunctionStats = Stats(Scope.StatsIndex);
+	FunctionStats.NumCalls++;
+	FunctionStats.ExclusiveCycles += Cycles - Scope.ChildCycles;
+	// Recursive calls are already part of the outermost call's inclusive time.
+	if( --FunctionStats.NumActive == 0 )
+	{
+		FunctionStats.InclusiveCycles += Cycles;
+	}
+
+	CurrentScope = Scope.Parent;
+	if( CurrentScope )
+	{
+		CurrentScope->ChildCycles += Cycles;
+	}
+}
+
+/**
+ * Swaps the native dispatch thunks into GNatives.
+ */
+void FScriptProfiler::InstallNativeThunks()
+{
+	OriginalNatives.Empty( EX_Max );
+	OriginalNatives.Add( EX_Max );
+	appMemcpy( &OriginalNatives(0), GNatives, EX_Max * sizeof(Native) );
+
+	NativeFunctions.Empty( EX_Max );
+	NativeFunctions.AddZeroed( EX_Max );
+	for( TObjectIterator<UFunction> It; It; ++It )
+	{
+		// Operators are too cheap to be worth the overhead of measuring them.
+		if( It->iNative && !(It->FunctionFlags & FUNC_Operator) )
+		{
+			NativeFunctions(It->iNative) = *It;
+		}
+	}
+
+	for( INT iNative=EX_ExtendedNative; iNative<EX_FirstNative; iNative++ )
+	{
+		GNatives[iNative] = &UObject::execProfiledHighNative;
+	}
+	for( INT iNative=EX_FirstNative; iNative<0x100; iNative++ )
+	{
+		if( NativeFunctions(iNative) )
+		{
+			GNatives[iNative] = &UObject::execProfiledNative;
+		}
+	}
+}
+
+/**
+ * Restores GNatives to the handlers present before InstallNativeThunks.
+ */
+void FScriptProfiler::RemoveNativeThunks()
+{
+	for( INT iNative=EX_ExtendedNative; iNative<0x100; iNative++ )
+	{
+		GNatives[iNative] = OriginalNatives(iNative);
+	}
+	OriginalNatives.Empty();
+	NativeFunctions.Empty();
+}
+
+/**
+ * Writes the collected data to a file readable by the stats viewer and logs the most
+ * expensive functions.
+ *
+ * @param	Ar	output device to log the summary to
+ * @return	TRUE if the file was written, FALSE otherwise
+ */
+UBOOL FScriptProfiler::Dump( FOutputDevice& Ar )
+{
+	// Functions and states might have been garbage collected since they were called.
+	TMap<UObject*,UBOOL> LiveFields;
+	for( TObjectIterator<UFunction> It; It; ++It )
+	{
+		LiveFields.Set( *It, TRUE );
+	}
+	for( TObjectIterator<UState> It; It; ++It )
+	{
+		LiveFields.Set( *It, TRUE );
+	}
+
+	TArray<FFunctionStatsSortEntry> SortedStats;
+	for( INT StatsIndex=0; StatsIndex<Stats.Num(); StatsIndex++ )
+	{
+		const FFunctionStats& FunctionStats = Stats(StatsIndex);
+		if( FunctionStats.NumCalls > 0
+		&&	LiveFields.Find( FunctionStats.Function )
+		&&	(!FunctionStats.State || LiveFields.Find( FunctionStats.State )) )
+		{
+			FFunctionStatsSortEntry* Entry = new(SortedStats) FFunctionStatsSortEntry;
+			Entry->StatsIndex		= StatsIndex;
+			Entry->ExclusiveCycles	= FunctionStats.ExclusiveCycles;
+		}
+	}
+	Sort<USE_COMPARE_CONSTREF(FFunctionStatsSortEntry,UnScriptProfiler)>( SortedStats.GetTypedData(), SortedStats.Num() );
+
+	// Results are reported as per frame averages, scaled up to account for skipped call trees.
+	const DOUBLE Scale = (DOUBLE)SampleRate / Max( NumFrames, 1 );
+	TArray<FString> StatNames;
+	for( INT SortIndex=0; SortIndex<SortedStats.Num(); SortIndex++ )
+	{
+		const FFunctionStats& FunctionStats = Stats(SortedStats(SortIndex).StatsIndex);
+		if( FunctionStats.State )
+		{
+			new(StatNames) FString( FString::Printf( TEXT("%s (%s)"), *FunctionStats.Function->GetPathName(), *FunctionStats.State->GetName() ) );
+		}
+		else
+		{
+			new(StatNames) FString( FunctionStats.Function->GetPathName() );
+		}
+	}
+
+	Ar.Logf( TEXT("Script profile: %i functions over %i frames, sample rate %i"), SortedStats.Num(), NumFrames, SampleRate );
+	Ar.Logf( TEXT("  Excl ms/frame  Incl ms/frame  Calls/frame  Function") );
+	const INT NumToLog = Min( SortedStats.Num(), 30 );
+	for( INT SortIndex=0; SortIndex<NumToLog; SortIndex++ )
+	{
+		const FFunctionStats& FunctionStats = Stats(SortedStats(SortIndex).StatsIndex);
+		Ar.Logf( TEXT("  %13.3f  %13.3f  %11.1f  %s"),
+			FunctionStats.ExclusiveCycles * Scale * GSecondsPerCycle * 1000.0,
+			FunctionStats.InclusiveCycles * Scale * GSecondsPerCycle * 1000.0,
+			FunctionStats.NumCalls * Scale,
+			*StatNames(SortIndex) );
+	}
+
+	// Create unique filename based on time.
+	INT Year, Month, DayOfWeek, Day, Hour, Min, Sec, MSec;
+	appSystemTime( Year, Month, DayOfWeek, Day, Hour, Min, Sec, MSec );
+
+#if XBOX
+	FString	Filename = FString::Printf(TEXT("%sProfiling\\%sGame-Xenon-ScriptStats-%i.%02i.%02i-%02i.%02i.%02i_Stats.xml"), *appGameDir(), GGameName, Year, Month, Day, Hour, Min, Sec );
+#elif PS3
+	FString	Filename = FString::Printf(TEXT("%sProfiling\\%sGame-PS3-ScriptStats-%i.%02i.%02i-%02i.%02i.%02i_Stats.xml"), *appGameDir(), GGameName, Year, Month, Day, Hour, Min, Sec );
+#else
+	FString	Filename = FString::Printf(TEXT("%sProfiling\\%sGame-ScriptStats-%i.%02i.%02i-%02i.%02i.%02i_Stats.xml"), *appGameDir(), GGameName, Year, Month, Day, Hour, Min, Sec );
+#endif
+
+	// Create the directory in case it doesn't exist yet.
+	GFileManager->MakeDirectory( *(appGameDir() + TEXT("Profiling\\")) );
+
+	FArchive* File = GFileManager->CreateFileWriter( *Filename );
+	if( !File )
+	{
+		Ar.Logf( NAME_Warning, TEXT("Failed to write script profile to '%s'"), *Filename );
+		return FALSE;
+	}
+
+	// Same layout as FStatNotifyProvider_XML, with every function reported as a cycle counter
+	// stat in an inclusive and an exclusive group and a single frame holding the averages.
+	// The stat type is STATTYPE_CycleCounter, spelled out as that enum only exists in STATS builds.
+	enum { GROUP_Inclusive = 1, GROUP_Exclusive = 2, STATTYPE_Cycles = 0 };
+	const INT NumStats = SortedStats.Num();
+	WriteAnsiString( *File, "<StatFile SecondsPerCycle=\"%e\">\r\n", GSecondsPerCycle );
+	WriteAnsiString( *File, "\t<Descriptions>\r\n" );
+	WriteAnsiString( *File, "\t\t<Groups>\r\n" );
+	WriteAnsiString( *File, "\t\t\t<Group ID=\"%d\" N=\"%s\"/>\r\n", GROUP_Inclusive, "Script Inclusive" );
+	WriteAnsiString( *File, "\t\t\t<Group ID=\"%d\" N=\"%s\"/>\r\n", GROUP_Exclusive, "Script Exclusive" );
+	WriteAnsiString( *File, "\t\t</Groups>\r\n" );
+	WriteAnsiString( *File, "\t\t<Stats>\r\n" );
+	for( INT SortIndex=0; SortIndex<NumStats; SortIndex++ )
+	{
+		WriteAnsiString( *File, "\t\t\t<Stat ID=\"%d\" N=\"%s\" ST=\"%d\" GID=\"%d\"/>\r\n",
+			SortIndex + 1, TCHAR_TO_ANSI(*StatNames(SortIndex)), STATTYPE_Cycles, GROUP_Inclusive );
+		WriteAnsiString( *File, "\t\t\t<Stat ID=\"%d\" N=\"%s\" ST=\"%d\" GID=\"%d\"/>\r\n",
+			NumStats + SortIndex + 1, TCHAR_TO_ANSI(*StatNames(SortIndex)), STATTYPE_Cycles, GROUP_Exclusive );
+	}
+	WriteAnsiString( *File, "\t\t</Stats>\r\n" );
+	WriteAnsiString( *File, "\t</Descriptions>\r\n" );
+	WriteAnsiString( *File, "\t<Frames>\r\n" );
+	WriteAnsiString( *File, "\t\t<Frame N=\"%d\">\r\n", 0 );
+	WriteAnsiString( *File, "\t\t\t<Stats>\r\n" );
+	for( INT SortIndex=0; SortIndex<NumStats; SortIndex++ )
+	{
+		const FFunctionStats& FunctionStats = Stats(SortedStats(SortIndex).StatsIndex);
+		const DWORD CallsPerFrame = appRound( FunctionStats.NumCalls * Scale );
+		WriteAnsiString( *File, "\t\t\t\t<Stat ID=\"%d\" IID=\"%d\" PID=\"%d\" TID=\"%d\" V=\"%d\" PF=\"%d\"/>\r\n",
+			SortIndex + 1, SortIndex + 1, 0, 0, (DWORD)(FunctionStats.InclusiveCycles * Scale), CallsPerFrame );
+		WriteAnsiString( *File, "\t\t\t\t<Stat ID=\"%d\" IID=\"%d\" PID=\"%d\" TID=\"%d\" V=\"%d\" PF=\"%d\"/>\r\n",
+			NumStats + SortIndex + 1, NumStats + SortIndex + 1, 0, 0, (DWORD)(FunctionStats.ExclusiveCycles * Scale), CallsPerFrame );
+	}
+	WriteAnsiString( *File, "\t\t\t</Stats>\r\n" );
+	WriteAnsiString( *File, "\t\t</Frame>\r\n" );
+	WriteAnsiString( *File, "\t</Frames>\r\n" );
+	WriteAnsiString( *File, "</StatFile>\r\n" );
+	delete File;
+
+	Ar.Logf( TEXT("Script profile written to '%s'"), *Filename );
+	return TRUE;
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
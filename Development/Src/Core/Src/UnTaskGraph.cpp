@@ -0,0 +1,502 @@
+/*=============================================================================
+	UnTaskGraph.cpp: Work stealing thread pool and dependent queued work.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+
+#if PLATFORM_UNIX
+	#include <unistd.h>
+#endif
+
+/*-----------------------------------------------------------------------------
+	FQueuedGraphWork implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor
+ *
+ * @param InWorkCompletionCounter	Counter to decrement on completion of task if non- NULL, see FAsyncWorkBase
+ */
+FQueuedGraphWork::FQueuedGraphWork( FThreadSafeCounter* InWorkCompletionCounter )
+:	FAsyncWorkBase( InWorkCompletionCounter )
+,	NumPendingPrerequisites( 1 )
+,	SubsequentsLock( 0 )
+,	bHasCompleted( FALSE )
+,	Pool( NULL )
+{
+}
+
+/** Acquires the spin lock guarding Subsequents and bHasCompleted */
+void FQueuedGraphWork::LockSubsequents()
+{
+	while( appInterlockedCompareExchange( (INT*) &SubsequentsLock, 1, 0 ) != 0 )
+	{
+		appSleep( 0 );
+	}
+}
+
+/** Releases the spin lock guarding Subsequents and bHasCompleted */
+void FQueuedGraphWork::UnlockSubsequents()
+{
+	appInterlockedExchange( &SubsequentsLock, 0 );
+}
+
+/**
+ * Makes this work wait for Prerequisite to complete before being queued.
+ *
+ * @param Prerequisite	work that needs to complete first
+ */
+void FQueuedGraphWork::AddPrerequisite( FQueuedGraphWork* Prerequisite )
+{
+	check( Prerequisite && Prerequisite != this );
+	check( Pool == NULL && "Prerequisites must be added before Dispatch" );
+
+	Prerequisite->LockSubsequents();
+	if( !Prerequisite->bHasCompleted )
+	{
+		NumPendingPrerequisites.Increment();
+		Prerequisite->Subsequents.AddItem( this );
+	}
+	Prerequisite->UnlockSubsequents();
+}
+
+/**
+ * Releases the work to the pool. It is queued immediately if all prerequisites
+ * have already completed, otherwise the last prerequisite to finish queues it.
+ *
+ * @param InPool	pool to queue the work on
+ */
+void FQueuedGraphWork::Dispatch( FQueuedThreadPool* InPool )
+{
+	check( InPool );
+	check( Pool == NULL && "Work has already been dispatched" );
+	Pool = InPool;
+	// Release the hold taken in the constructor.
+	PrerequisiteCompleted();
+}
+
+/**
+ * Called by a prerequisite upon completion, queues this work once nothing is pending.
+ */
+void FQueuedGraphWork::PrerequisiteCompleted()
+{
+	if( NumPendingPrerequisites.Decrement() == 0 )
+	{
+		Pool->AddQueuedWork( this );
+	}
+}
+
+/**
+ * Performs the task and queues any subsequents whose prerequisites are now met.
+ */
+void FQueuedGraphWork::DoWork()
+{
+	DoTask();
+
+	// Once bHasCompleted is set no new subsequents can be added, so the array can be
+	// walked outside of the lock.
+	LockSubsequents();
+	bHasCompleted = TRUE;
+	UnlockSubsequents();
+
+	for( INT SubsequentIndex = 0; SubsequentIndex < Subsequents.Num(); SubsequentIndex++ )
+	{
+		Subsequents(SubsequentIndex)->PrerequisiteCompleted();
+	}
+	Subsequents.Empty();
+}
+
+/*-----------------------------------------------------------------------------
+	FTaskGraphWorker.
+-----------------------------------------------------------------------------*/
+
+/**
+ * A single worker of FQueuedThreadPoolTaskGraph. Owns a work stealing deque
+ * and an event it sleeps on while there is no work to do or steal.
+ */
+class FTaskGraphWorker : public FRunnable
+{
+public:
+	/** Deque for work queued from this worker */
+	FWorkStealingQueue Queue;
+	/** Event triggered to wake this worker up */
+	FEvent* WorkEvent;
+	/** Owning pool */
+	FQueuedThreadPoolTaskGraph* Pool;
+	/** Index of this worker in the pool's worker array */
+	INT WorkerIndex;
+	/** Seed used to pick victims to steal from */
+	DWORD RandomSeed;
+	/** If TRUE, the worker exits its loop */
+	volatile UBOOL bTimeToDie;
+
+	/**
+	 * Constructor
+	 *
+	 * @param InPool		owning pool
+	 * @param InWorkerIndex	index of this worker in the pool's worker array
+	 */
+	FTaskGraphWorker( FQueuedThreadPoolTaskGraph* InPool, INT InWorkerIndex )
+	:	WorkEvent( NULL )
+	,	Pool( InPool )
+	,	WorkerIndex( InWorkerIndex )
+	,	RandomSeed( 0x9E3779B9 * (InWorkerIndex + 1) )
+	,	bTimeToDie( FALSE )
+	{
+		WorkEvent = GSynchronizeFactory->CreateSynchEvent();
+	}
+
+	/** Destructor, cleaning up the event */
+	virtual ~FTaskGraphWorker()
+	{
+		if( WorkEvent )
+		{
+			GSynchronizeFactory->Destroy( WorkEvent );
+		}
+	}
+
+	/**
+	 * @return the next pseudo random number used for victim selection
+	 */
+	DWORD NextRandom()
+	{
+		// Xorshift, cheap and good enough for spreading steal attempts.
+		RandomSeed ^= RandomSeed << 13;
+		RandomSeed ^= RandomSeed >> 17;
+		RandomSeed ^= RandomSeed << 5;
+		return RandomSeed;
+	}
+
+	// FRunnable interface.
+	virtual UBOOL Init()
+	{
+		return WorkEvent != NULL;
+	}
+
+	virtual DWORD Run()
+	{
+		appSetTlsValue( Pool->WorkerTlsSlot, this );
+		while( !bTimeToDie )
+		{
+			FQueuedWork* Work = Pool->FindWork( this );
+			if( Work == NULL )
+			{
+				// Register as idle and look again so work queued in between isn't missed.
+				Pool->MarkIdle( this );
+				Work = Pool->FindWork( this );
+				if( Work == NULL )
+				{
+					WorkEvent->Wait();
+					continue;
+				}
+				Pool->MarkBusy( this );
+			}
+			Work->DoWork();
+			Work->Dispose();
+			Pool->NumExecuted.Increment();
+		}
+		appSetTlsValue( Pool->WorkerTlsSlot, NULL );
+		return 0;
+	}
+
+	virtual void Stop()
+	{
+		bTimeToDie = TRUE;
+		WorkEvent->Trigger();
+	}
+
+	virtual void Exit()
+	{
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	FQueuedThreadPoolTaskGraph implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * @return the number of hardware threads as reported by the OS
+ */
+static DWORD GetNumHardwareThreadsForPool()
+{
+#if XBOX
+	return 6;
+#elif _MSC_VER
+	SYSTEM_INFO SI;
+	GetSystemInfo( &SI );
+	return SI.dwNumberOfProcessors;
+#elif PLATFORM_UNIX
+	return Max<INT>( 1, sysconf( _SC_NPROCESSORS_ONLN ) );
+#else
+	return Max<UINT>( 1, GNumHardwareThreads );
+#endif
+}
+
+/** Constructor, zeroing members */
+FQueuedThreadPoolTaskGraph::FQueuedThreadPoolTaskGraph()
+:	QueuedWorkHead( 0 )
+,	NumQueuedWork( 0 )
+,	SynchQueue( NULL )
+,	NumIdleWorkers( 0 )
+,	SynchIdle( NULL )
+,	WorkerTlsSlot( (DWORD) INDEX_NONE )
+{
+}
+
+/** Cleans up any threads that were allocated in the pool */
+FQueuedThreadPoolTaskGraph::~FQueuedThreadPoolTaskGraph()
+{
+	if( Workers.Num() > 0 )
+	{
+		Destroy();
+	}
+}
+
+/**
+ * Creates the thread pool with the specified number of threads
+ *
+ * @param InNumQueuedThreads Specifies the number of threads to use in the pool, 0 to use one per hardware thread minus one
+ * @param ProcessorMask Specifies which processors should be used by the pool
+ * @param StackSize The size of stack the threads in the pool need (32K default)
+ *
+ * @return Whether the pool creation was successful or not
+ */
+UBOOL FQueuedThreadPoolTaskGraph::Create(DWORD InNumQueuedThreads,DWORD ProcessorMask,DWORD StackSize)
+{
+	check( SynchQueue == NULL && Workers.Num() == 0 );
+	if( InNumQueuedThreads == 0 )
+	{
+		// Leave one hardware thread for the game thread.
+		InNumQueuedThreads = Max<DWORD>( 1, GetNumHardwareThreadsForPool() - 1 );
+	}
+
+	SynchQueue		= GSynchronizeFactory->CreateCriticalSection();
+	SynchIdle		= GSynchronizeFactory->CreateCriticalSection();
+	WorkerTlsSlot	= appAllocTlsSlot();
+	UBOOL bWasSuccessful = SynchQueue != NULL && SynchIdle != NULL;
+
+	// All workers need to exist before any of them runs as they steal from each other.
+	Workers.Empty( InNumQueuedThreads );
+	for( DWORD WorkerIndex = 0; WorkerIndex < InNumQueuedThreads && bWasSuccessful; WorkerIndex++ )
+	{
+		Workers.AddItem( new FTaskGraphWorker( this, WorkerIndex ) );
+	}
+
+	WorkerThreads.Empty( InNumQueuedThreads );
+	for( INT WorkerIndex = 0; WorkerIndex < Workers.Num() && bWasSuccessful; WorkerIndex++ )
+	{
+		FRunnableThread* Thread = GThreadFactory->CreateThread( Workers(WorkerIndex), TEXT("TaskGraphWorker"), FALSE, FALSE, StackSize );
+		if( Thread != NULL )
+		{
+			if( ProcessorMask > 0 )
+			{
+				// Spread workers round robin over the processors in the mask.
+				TArray<DWORD> Processors;
+				for( DWORD Bit = 0; Bit < 32; Bit++ )
+				{
+					if( ProcessorMask & (1 << Bit) )
+					{
+						Processors.AddItem( Bit );
+					}
+				}
+				Thread->SetProcessorAffinity( Processors(WorkerIndex % Processors.Num()) );
+			}
+			WorkerThreads.AddItem( Thread );
+		}
+		else
+		{
+			bWasSuccessful = FALSE;
+		}
+	}
+
+	// Destroy any created threads if the full set was not succesful
+	if( !bWasSuccessful )
+	{
+		Destroy();
+	}
+	return bWasSuccessful;
+}
+
+/**
+ * Tells the pool to clean up all background threads, abandoning work that hasn't started
+ */
+void FQueuedThreadPoolTaskGraph::Destroy(void)
+{
+	// Stop and wait for every worker. Kill calls Stop on the runnable.
+	for( INT ThreadIndex = 0; ThreadIndex < WorkerThreads.Num(); ThreadIndex++ )
+	{
+		WorkerThreads(ThreadIndex)->Kill( TRUE );
+		GThreadFactory->Destroy( WorkerThreads(ThreadIndex) );
+	}
+	WorkerThreads.Empty();
+
+	// Nothing runs anymore so the deques can be drained from this thread.
+	for( INT WorkerIndex = 0; WorkerIndex < Workers.Num(); WorkerIndex++ )
+	{
+		FTaskGraphWorker* Worker = Workers(WorkerIndex);
+		while( FQueuedWork* Work = Worker->Queue.Steal() )
+		{
+			Work->Abandon();
+		}
+		delete Worker;
+	}
+	Workers.Empty();
+	IdleWorkers.Empty();
+	NumIdleWorkers = 0;
+
+	if( SynchQueue )
+	{
+		{
+			FScopeLock Lock( SynchQueue );
+			for( INT WorkIndex = QueuedWorkHead; WorkIndex < QueuedWork.Num(); WorkIndex++ )
+			{
+				QueuedWork(WorkIndex)->Abandon();
+			}
+			QueuedWork.Empty();
+			QueuedWorkHead = 0;
+			NumQueuedWork = 0;
+		}
+		GSynchronizeFactory->Destroy( SynchQueue );
+		SynchQueue = NULL;
+	}
+	if( SynchIdle )
+	{
+		GSynchronizeFactory->Destroy( SynchIdle );
+		SynchIdle = NULL;
+	}
+	if( WorkerTlsSlot != (DWORD) INDEX_NONE )
+	{
+		appFreeTlsSlot( WorkerTlsSlot );
+		WorkerTlsSlot = (DWORD) INDEX_NONE;
+	}
+}
+
+/**
+ * Queues work on the calling worker's deque if called from a worker, otherwise
+ * on the shared queue, and wakes an idle worker if there is one.
+ *
+ * @param InQueuedWork The work that needs to be done asynchronously
+ */
+void FQueuedThreadPoolTaskGraph::AddQueuedWork(FQueuedWork* InQueuedWork)
+{
+	check( InQueuedWork != NULL );
+	check( SynchQueue && "Did you forget to call Create()?" );
+
+	FTaskGraphWorker* Worker = (FTaskGraphWorker*) appGetTlsValue( WorkerTlsSlot );
+	if( Worker == NULL || !Worker->Queue.Push( InQueuedWork ) )
+	{
+		FScopeLock Lock( SynchQueue );
+		QueuedWork.AddItem( InQueuedWork );
+		appInterlockedIncrement( &NumQueuedWork );
+	}
+	WakeIdleWorker();
+}
+
+/**
+ * Workers never return to the pool, they look for work themselves.
+ *
+ * @param InQueuedThread ignored
+ */
+void FQueuedThreadPoolTaskGraph::ReturnToPool(FQueuedThread* InQueuedThread)
+{
+	appErrorf( TEXT("FQueuedThreadPoolTaskGraph doesn't use FQueuedThread") );
+}
+
+/**
+ * Finds work for a worker, checking its own deque first, then the shared
+ * queue and finally stealing from other workers.
+ *
+ * @param Worker	worker looking for work
+ * @return work to execute or NULL if none was found
+ */
+FQueuedWork* FQueuedThreadPoolTaskGraph::FindWork(FTaskGraphWorker* Worker)
+{
+	FQueuedWork* Work = Worker->Queue.Pop();
+	if( Work )
+	{
+		return Work;
+	}
+
+	// Only take the lock if the shared queue looks non empty.
+	if( appInterlockedAdd( &NumQueuedWork, 0 ) > 0 )
+	{
+		FScopeLock Lock( SynchQueue );
+		if( QueuedWorkHead < QueuedWork.Num() )
+		{
+			// Consume oldest first so externally queued work can't starve.
+			Work = QueuedWork(QueuedWorkHead++);
+			appInterlockedDecrement( &NumQueuedWork );
+			if( QueuedWorkHead == QueuedWork.Num() )
+			{
+				QueuedWork.Reset();
+				QueuedWorkHead = 0;
+			}
+			return Work;
+		}
+	}
+
+	// Try every other worker once, starting at a random victim.
+	const INT NumWorkers = Workers.Num();
+	if( NumWorkers > 1 )
+	{
+		const INT FirstVictim = Worker->NextRandom() % NumWorkers;
+		for( INT Offset = 0; Offset < NumWorkers; Offset++ )
+		{
+			FTaskGraphWorker* Victim = Workers((FirstVictim + Offset) % NumWorkers);
+			if( Victim != Worker )
+			{
+				Work = Victim->Queue.Steal();
+				if( Work )
+				{
+					NumStolen.Increment();
+					return Work;
+				}
+			}
+		}
+	}
+	return NULL;
+}
+
+/** Adds a worker to the idle list */
+void FQueuedThreadPoolTaskGraph::MarkIdle(FTaskGraphWorker* Worker)
+{
+	FScopeLock Lock( SynchIdle );
+	IdleWorkers.AddItem( Worker );
+	appInterlockedIncrement( &NumIdleWorkers );
+}
+
+/** Removes a worker from the idle list if it is still on it */
+void FQueuedThreadPoolTaskGraph::MarkBusy(FTaskGraphWorker* Worker)
+{
+	FScopeLock Lock( SynchIdle );
+	// If the worker isn't on the list anymore someone already triggered its event,
+	// which only results in one spurious wake up.
+	if( IdleWorkers.RemoveItem( Worker ) > 0 )
+	{
+		appInterlockedDecrement( &NumIdleWorkers );
+	}
+}
+
+/** Wakes up one idle worker if there is any */
+void FQueuedThreadPoolTaskGraph::WakeIdleWorker()
+{
+	// The interlocked read doubles as a full barrier so the work queued by the
+	// caller is visible to a worker that registered as idle after this check.
+	if( appInterlockedAdd( &NumIdleWorkers, 0 ) > 0 )
+	{
+		FTaskGraphWorker* Worker = NULL;
+		{
+			FScopeLock Lock( SynchIdle );
+			if( IdleWorkers.Num() > 0 )
+			{
+				Worker = IdleWorkers.Pop();
+				appInterlockedDecrement( &NumIdleWorkers );
+			}
+		}
+		if( Worker )
+		{
+			Worker->WorkEvent->Trigger();
+		}
+	}
+}
@@ -56,6 +56,7 @@ void FQueuedThreadPoolBase::Destroy(void)
 		}
 		// All the pointers are invalid so clean up
 		QueuedThreads.Empty();
+		NumThreads = 0;
 	}
 }
 
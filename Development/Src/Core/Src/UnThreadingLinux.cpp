@@ -11,89 +11,119 @@
 #include "CorePrivate.h"
 #include "UnThreadingLinux.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/resource.h>
+
 /** The global synchonization object factory.	*/
 FSynchronizeFactory*	GSynchronizeFactory = NULL;
 /** The global thread factory.					*/
 FThreadFactory*			GThreadFactory		= NULL;
-
-/** Default constructor, initializing Value to 0 */
-FThreadSafeCounter::FThreadSafeCounter()
-{
-	Value = 0;
-}
+/** The global thread pool */
+FQueuedThreadPool*		GThreadPool			= NULL;
 
 /**
- * Constructor, initializing counter to passed in value.
- *
- * @param InValue	Value to initialize counter to
+ * Smallest stack handed to pthread_create. glibc carves TLS out of the stack, so
+ * the small stacks that are fine on Windows overflow here.
  */
-FThreadSafeCounter::FThreadSafeCounter( LONG InValue )
-{
-	Value = InValue;
-}
+#define MIN_THREAD_STACK_SIZE	(256 * 1024)
 
 /**
- * Increment and return new value.	
+ * Computes the absolute time a timed wait gives up at
  *
- * @return the incremented value
+ * @param Clock the clock the wait is measured against
+ * @param WaitTime time to wait in milliseconds
+ * @param Deadline [out] the absolute time to give up at
  */
-LONG FThreadSafeCounter::Increment()
+static void GetWaitDeadline(clockid_t Clock,DWORD WaitTime,timespec& Deadline)
 {
-	return ++Value;//@todo gcc
+	clock_gettime(Clock,&Deadline);
+	Deadline.tv_sec += WaitTime / 1000;
+	Deadline.tv_nsec += (WaitTime % 1000) * 1000000;
+	if (Deadline.tv_nsec >= 1000000000)
+	{
+		Deadline.tv_sec++;
+		Deadline.tv_nsec -= 1000000000;
+	}
 }
 
 /**
- * Decrement and return new value.
+ * Creates a joinable pthread
  *
- * @return the decremented value
- */
-LONG FThreadSafeCounter::Decrement()
-{
-	return --Value;//@todo gcc
-}
-
-/**
- * Return the current value.
+ * @param OutThread [out] the created thread
+ * @param ThreadProc the thread entry point
+ * @param Param the value passed to the entry point
+ * @param StackSize the size of the stack to create. 0 means use the default
  *
- * @return the current value
+ * @return TRUE if the thread was created, FALSE otherwise
  */
-LONG FThreadSafeCounter::GetValue() const
+static UBOOL CreatePThread(pthread_t& OutThread,void* (*ThreadProc)(void*),void* Param,DWORD StackSize)
 {
-	return Value;
+	pthread_attr_t Attributes;
+	if (pthread_attr_init(&Attributes) != 0)
+	{
+		return FALSE;
+	}
+	if (StackSize > 0)
+	{
+		pthread_attr_setstacksize(&Attributes,Max<DWORD>(StackSize,MIN_THREAD_STACK_SIZE));
+	}
+	const UBOOL bWasCreated = pthread_create(&OutThread,&Attributes,ThreadProc,Param) == 0;
+	pthread_attr_destroy(&Attributes);
+	return bWasCreated;
 }
 
 /**
- * Constructor that initializes the aggregated critical section
- */
-FCriticalSection::FCriticalSection(void)
-{
-}
-
-/**
- * Locks the critical section
- */
-void FCriticalSection::Lock(void)
-{
-}
-
-/**
- * Releases the lock on the critical seciton
+ * Waits for a thread to exit, killing it if it doesn't within the passed in time
+ *
+ * @param Thread the thread to join
+ * @param MaxWaitTime the time to wait in milliseconds, INFINITE to wait forever
+ *
+ * @return TRUE if the thread exited on its own, FALSE if it had to be killed
  */
-void FCriticalSection::Unlock(void)
+static UBOOL JoinPThread(pthread_t Thread,DWORD MaxWaitTime)
 {
+	if (MaxWaitTime == INFINITE)
+	{
+		return pthread_join(Thread,NULL) == 0;
+	}
+	timespec Deadline;
+	GetWaitDeadline(CLOCK_REALTIME,MaxWaitTime,Deadline);
+	if (pthread_timedjoin_np(Thread,NULL,&Deadline) == ETIMEDOUT)
+	{
+		// Kill the thread. This can leak TLS data
+		pthread_cancel(Thread);
+		pthread_detach(Thread);
+		return FALSE;
+	}
+	return TRUE;
 }
 
 /**
- * Destructor cleaning up the critical section
+ * Helper function to set thread names, visible by the debugger. The kernel
+ * only keeps the first 15 characters.
+ *
+ * @param Thread the thread whose name is going to be set
+ * @param ThreadName the name to set
  */
-FCriticalSection::~FCriticalSection(void)
+static void SetThreadName(pthread_t Thread,const TCHAR* ThreadName)
 {
+	ANSICHAR Name[16];
+	appStrncpyANSI(Name,TCHAR_TO_ANSI(ThreadName),ARRAY_COUNT(Name));
+	pthread_setname_np(Thread,Name);
 }
 
 /**
  * Constructor that zeroes the handle
  */
-FEventLinux::FEventLinux(void)
+FEventLinux::FEventLinux(void) :
+	bInitialized(FALSE),
+	bIsManualReset(FALSE),
+	bTriggered(FALSE),
+	NumWaitingThreads(0),
+	PulseCount(0)
 {
 }
 
@@ -102,6 +132,11 @@ FEventLinux::FEventLinux(void)
  */
 FEventLinux::~FEventLinux(void)
 {
+	if (bInitialized == TRUE)
+	{
+		pthread_cond_destroy(&Condition);
+		pthread_mutex_destroy(&Mutex);
+	}
 }
 
 /**
@@ -109,6 +144,7 @@ FEventLinux::~FEventLinux(void)
  */
 void FEventLinux::Lock(void)
 {
+	Wait(INFINITE);
 }
 
 /**
@@ -116,11 +152,12 @@ void FEventLinux::Lock(void)
  */
 void FEventLinux::Unlock(void)
 {
+	Pulse();
 }
 
 /**
  * Creates the event. Manually reset events stay triggered until reset.
- * Named events share the same underlying event.
+ * Events are process local, so names are ignored.
  *
  * @param bIsManualReset Whether the event requires manual reseting or not
  * @param InName Whether to use a commonly shared event or not. If so this
@@ -128,9 +165,27 @@ void FEventLinux::Unlock(void)
  *
  * @return Returns TRUE if the event was created, FALSE otherwise
  */
-UBOOL FEventLinux::Create(UBOOL bIsManualReset,const TCHAR* InName)
-{
-	return FALSE;
+UBOOL FEventLinux::Create(UBOOL bInIsManualReset,const TCHAR* InName)
+{
+	check(bInitialized == FALSE);
+	bIsManualReset = bInIsManualReset;
+	if (pthread_mutex_init(&Mutex,NULL) != 0)
+	{
+		return FALSE;
+	}
+	// Time out against the monotonic clock so wall clock changes don't affect waits
+	pthread_condattr_t ConditionAttributes;
+	pthread_condattr_init(&ConditionAttributes);
+	pthread_condattr_setclock(&ConditionAttributes,CLOCK_MONOTONIC);
+	const UBOOL bWasCreated = pthread_cond_init(&Condition,&ConditionAttributes) == 0;
+	pthread_condattr_destroy(&ConditionAttributes);
+	if (bWasCreated == FALSE)
+	{
+		pthread_mutex_destroy(&Mutex);
+		return FALSE;
+	}
+	bInitialized = TRUE;
+	return TRUE;
 }
 
 /**
@@ -138,6 +193,19 @@ UBOOL FEventLinux::Create(UBOOL bIsManualReset,const TCHAR* InName)
  */
 void FEventLinux::Trigger(void)
 {
+	check(bInitialized);
+	pthread_mutex_lock(&Mutex);
+	bTriggered = TRUE;
+	// Auto reset events only let a single waiting thread through
+	if (bIsManualReset == TRUE)
+	{
+		pthread_cond_broadcast(&Condition);
+	}
+	else
+	{
+		pthread_cond_signal(&Condition);
+	}
+	pthread_mutex_unlock(&Mutex);
 }
 
 /**
@@ -145,6 +213,10 @@ void FEventLinux::Trigger(void)
  */
 void FEventLinux::Reset(void)
 {
+	check(bInitialized);
+	pthread_mutex_lock(&Mutex);
+	bTriggered = FALSE;
+	pthread_mutex_unlock(&Mutex);
 }
 
 /**
@@ -154,6 +226,22 @@ void FEventLinux::Reset(void)
  */
 void FEventLinux::Pulse(void)
 {
+	check(bInitialized);
+	pthread_mutex_lock(&Mutex);
+	if (bIsManualReset == TRUE)
+	{
+		// Release everybody waiting right now, later waits block again
+		PulseCount++;
+		bTriggered = FALSE;
+		pthread_cond_broadcast(&Condition);
+	}
+	else if (NumWaitingThreads > 0)
+	{
+		// The released thread resets the event on its way out of Wait
+		bTriggered = TRUE;
+		pthread_cond_signal(&Condition);
+	}
+	pthread_mutex_unlock(&Mutex);
 }
 
 /**
@@ -166,7 +254,36 @@ void FEventLinux::Pulse(void)
  */
 UBOOL FEventLinux::Wait(DWORD WaitTime)
 {
-	return FALSE;
+	check(bInitialized);
+	timespec Deadline;
+	if (WaitTime != INFINITE)
+	{
+		GetWaitDeadline(CLOCK_MONOTONIC,WaitTime,Deadline);
+	}
+
+	pthread_mutex_lock(&Mutex);
+	const DWORD StartPulseCount = PulseCount;
+	NumWaitingThreads++;
+	// Loop as condition variables may wake up spuriously
+	while (bTriggered == FALSE && PulseCount == StartPulseCount)
+	{
+		if (WaitTime == INFINITE)
+		{
+			pthread_cond_wait(&Condition,&Mutex);
+		}
+		else if (pthread_cond_timedwait(&Condition,&Mutex,&Deadline) == ETIMEDOUT)
+		{
+			break;
+		}
+	}
+	NumWaitingThreads--;
+	const UBOOL bWasSignaled = bTriggered == TRUE || PulseCount != StartPulseCount;
+	if (bTriggered == TRUE && bIsManualReset == FALSE)
+	{
+		bTriggered = FALSE;
+	}
+	pthread_mutex_unlock(&Mutex);
+	return bWasSignaled;
 }
 
 /**
@@ -198,7 +315,15 @@ FCriticalSection* FSynchronizeFactoryLinux::CreateCriticalSection(void)
 FEvent* FSynchronizeFactoryLinux::CreateSynchEvent(UBOOL bIsManualReset,
 	const TCHAR* InName)
 {
-	return NULL;
+	// Allocate the new object
+	FEvent* Event = new FEventLinux();
+	// If the internal create fails, delete the instance and return NULL
+	if (Event->Create(bIsManualReset,InName) == FALSE)
+	{
+		delete Event;
+		Event = NULL;
+	}
+	return Event;
 }
 
 /**
@@ -208,19 +333,20 @@ FEvent* FSynchronizeFactoryLinux::CreateSynchEvent(UBOOL bIsManualReset,
  */
 void FSynchronizeFactoryLinux::Destroy(FSynchronize* InSynchObj)
 {
+	delete InSynchObj;
 }
 
 /**
  * Zeros any members
  */
-FQueuedThreadLinux::FQueuedThreadLinux(void)
+FQueuedThreadLinux::FQueuedThreadLinux(void) :
+	DoWorkEvent(NULL),
+	bIsJoinable(FALSE),
+	TimeToDie(FALSE),
+	QueuedWork(NULL),
+	QueuedWorkSynch(NULL),
+	OwningThreadPool(NULL)
 {
-	DoWorkEvent			= NULL;
-	TimeToDie			= FALSE;
-	QueuedWork			= NULL;
-	QueuedWorkSynch		= NULL;
-	OwningThreadPool	= NULL;
-	ThreadID			= 0;
 }
 
 /**
@@ -228,6 +354,23 @@ FQueuedThreadLinux::FQueuedThreadLinux(void)
  */
 FQueuedThreadLinux::~FQueuedThreadLinux(void)
 {
+	// If there is a background thread running, kill it
+	if (bIsJoinable == TRUE)
+	{
+		// Kill() will clean up the event
+		Kill(TRUE);
+	}
+}
+
+/**
+ * The thread entry point. Simply forwards the call on to the right
+ * thread main function
+ */
+void* FQueuedThreadLinux::_ThreadProc(void* pThis)
+{
+	check(pThis);
+	((FQueuedThreadLinux*)pThis)->Run();
+	return NULL;
 }
 
 /**
@@ -236,6 +379,30 @@ FQueuedThreadLinux::~FQueuedThreadLinux(void)
  */
 void FQueuedThreadLinux::Run(void)
 {
+	// While we are not told to die
+	while (TimeToDie == FALSE)
+	{
+		// Wait for some work to do
+		DoWorkEvent->Wait();
+		{
+			FScopeLock sl(QueuedWorkSynch);
+			// If there is a valid job, do it otherwise check for time to exit
+			if (QueuedWork != NULL)
+			{
+				// Tell the object to do the work
+				QueuedWork->DoWork();
+				// Let the object cleanup before we remove our ref to it
+				QueuedWork->Dispose();
+				QueuedWork = NULL;
+			}
+		}
+		// Don't try to return to the pool if we are exitting or we'll deadlock
+		if (TimeToDie == FALSE)
+		{
+			// Return ourselves to the owning pool
+			OwningThreadPool->ReturnToPool(this);
+		}
+	}
 }
 
 /**
@@ -244,14 +411,61 @@ void FQueuedThreadLinux::Run(void)
  *
  * @param InPool The thread pool interface used to place this thread
  * back into the pool of available threads when its work is done
+ * @param ProcessorMask Specifies which processors should be used by the pool
  * @param InStackSize The size of the stack to create. 0 means use the
  * current thread's stack size
  *
  * @return True if the thread and all of its initialization was successful, false otherwise
  */
-UBOOL FQueuedThreadLinux::Create(FQueuedThreadPool* InPool,DWORD InStackSize)
-{
-	return FALSE;
+UBOOL FQueuedThreadLinux::Create(FQueuedThreadPool* InPool,DWORD ProcessorMask,DWORD InStackSize)
+{
+	check(OwningThreadPool == NULL && bIsJoinable == FALSE);
+	// Copy the parameters for use in the thread
+	OwningThreadPool = InPool;
+	// Create the work event used to notify this thread of work
+	DoWorkEvent = GSynchronizeFactory->CreateSynchEvent();
+	QueuedWorkSynch = GSynchronizeFactory->CreateCriticalSection();
+	if (DoWorkEvent != NULL && QueuedWorkSynch != NULL)
+	{
+		// Create the new thread
+		bIsJoinable = CreatePThread(Thread,_ThreadProc,this,InStackSize);
+		// Move the thread to the specified processors if requested
+		if (bIsJoinable == TRUE && ProcessorMask > 0)
+		{
+			cpu_set_t CpuSet;
+			CPU_ZERO(&CpuSet);
+			for (DWORD ProcessorNum = 0; ProcessorNum < 32; ProcessorNum++)
+			{
+				if (ProcessorMask & (1 << ProcessorNum))
+				{
+					CPU_SET(ProcessorNum,&CpuSet);
+				}
+			}
+			pthread_setaffinity_np(Thread,sizeof(CpuSet),&CpuSet);
+		}
+	}
+	// If it fails, clear all the vars
+	if (bIsJoinable == FALSE)
+	{
+		OwningThreadPool = NULL;
+		// Use the factory to clean up this event
+		if (DoWorkEvent != NULL)
+		{
+			GSynchronizeFactory->Destroy(DoWorkEvent);
+		}
+		DoWorkEvent = NULL;
+		if (QueuedWorkSynch != NULL)
+		{
+			// Clean up the work synch
+			GSynchronizeFactory->Destroy(QueuedWorkSynch);
+		}
+		QueuedWorkSynch = NULL;
+	}
+	else
+	{
+		SetThreadName(Thread,TEXT("PoolThread"));
+	}
+	return bIsJoinable;
 }
 
 /**
@@ -269,7 +483,41 @@ UBOOL FQueuedThreadLinux::Create(FQueuedThreadPool* InPool,DWORD InStackSize)
  */
 UBOOL FQueuedThreadLinux::Kill(UBOOL bShouldWait,DWORD MaxWaitTime,UBOOL bShouldDeleteSelf)
 {
-	return FALSE;
+	UBOOL bDidExitOK = TRUE;
+	// Tell the thread it needs to die
+	appInterlockedExchange(&TimeToDie,TRUE);
+	// Trigger the thread so that it will come out of the wait state if
+	// it isn't actively doing work
+	DoWorkEvent->Trigger();
+	// If waiting was specified, wait the amount of time. If that fails,
+	// brute force kill that thread. Very bad as that might leak.
+	if (bShouldWait == TRUE)
+	{
+		if (JoinPThread(Thread,MaxWaitTime) == FALSE)
+		{
+			bDidExitOK = FALSE;
+			appErrorf(TEXT("Thread %p still alive. Kill failed: Aborting."),(void*)Thread);
+		}
+	}
+	else
+	{
+		// Let the thread clean up after itself once it exits
+		pthread_detach(Thread);
+	}
+	bIsJoinable = FALSE;
+	// Clean up the event
+	GSynchronizeFactory->Destroy(DoWorkEvent);
+	DoWorkEvent = NULL;
+	// Clean up the work synch
+	GSynchronizeFactory->Destroy(QueuedWorkSynch);
+	QueuedWorkSynch = NULL;
+	TimeToDie = FALSE;
+	// Delete ourselves if requested
+	if (bShouldDeleteSelf)
+	{
+		delete this;
+	}
+	return bDidExitOK;
 }
 
 /**
@@ -280,6 +528,14 @@ UBOOL FQueuedThreadLinux::Kill(UBOOL bShouldWait,DWORD MaxWaitTime,UBOOL bShould
  */
 void FQueuedThreadLinux::DoWork(FQueuedWork* InQueuedWork)
 {
+	{
+		FScopeLock sl(QueuedWorkSynch);
+		check(QueuedWork == NULL && "Can't do more than one task at a time");
+		// Tell the thread the work to be done
+		QueuedWork = InQueuedWork;
+	}
+	// Tell the thread to wake up and do its job
+	DoWorkEvent->Trigger();
 }
 
 /**
@@ -287,25 +543,72 @@ void FQueuedThreadLinux::DoWork(FQueuedWork* InQueuedWork)
  */
 FQueuedThreadPoolLinux::~FQueuedThreadPoolLinux(void)
 {
+	if (QueuedThreads.Num() > 0)
+	{
+		Destroy();
+	}
 }
 
 /**
  * Creates the thread pool with the specified number of threads
  *
  * @param InNumQueuedThreads Specifies the number of threads to use in the pool
+ * @param ProcessorMask Specifies which processors should be used by the pool
  * @param StackSize The size of stack the threads in the pool need (32K default)
  *
  * @return Whether the pool creation was successful or not
  */
-UBOOL FQueuedThreadPoolLinux::Create(DWORD InNumQueuedThreads,DWORD StackSize)
-{
-	return FALSE;
+UBOOL FQueuedThreadPoolLinux::Create(DWORD InNumQueuedThreads,DWORD ProcessorMask,DWORD StackSize)
+{
+	// Make sure we have synch objects
+	UBOOL bWasSuccessful = CreateSynchObjects();
+	if (bWasSuccessful == TRUE)
+	{
+		FScopeLock Lock(SynchQueue);
+		// Presize the array so there is no extra memory allocated
+		QueuedThreads.Empty(InNumQueuedThreads);
+		// Now create each thread and add it to the array
+		for (DWORD Count = 0; Count < InNumQueuedThreads && bWasSuccessful == TRUE;
+			Count++)
+		{
+			// Create a new queued thread
+			FQueuedThread* pThread = new FQueuedThreadLinux();
+			// Now create the thread and add it if ok
+			if (pThread->Create(this,ProcessorMask,StackSize) == TRUE)
+			{
+				QueuedThreads.AddItem(pThread);
+			}
+			else
+			{
+				// Failed to fully create so clean up
+				bWasSuccessful = FALSE;
+				delete pThread;
+			}
+		}
+	}
+	// Destroy any created threads if the full set was not succesful
+	if (bWasSuccessful == FALSE)
+	{
+		Destroy();
+	}
+	else
+	{
+		NumThreads = QueuedThreads.Num();
+	}
+	return bWasSuccessful;
 }
 
 /**
  * Zeroes members
  */
-FRunnableThreadLinux::FRunnableThreadLinux(void)
+FRunnableThreadLinux::FRunnableThreadLinux(void) :
+	bIsJoinable(FALSE),
+	ThreadID(0),
+	bCreateFinished(FALSE),
+	Runnable(NULL),
+	bShouldDeleteSelf(FALSE),
+	bShouldDeleteRunnable(FALSE),
+	ThreadPriority(TPri_Normal)
 {
 }
 
@@ -314,12 +617,18 @@ FRunnableThreadLinux::FRunnableThreadLinux(void)
  */
 FRunnableThreadLinux::~FRunnableThreadLinux(void)
 {
+	// Clean up our thread if it is still active
+	if (bIsJoinable == TRUE)
+	{
+		Kill(TRUE);
+	}
 }
 
 /**
  * Creates the thread with the specified stack size and thread priority.
  *
  * @param InRunnable The runnable object to execute
+ * @param ThreadName Name of the thread
  * @param bAutoDeleteSelf Whether to delete this object on exit
  * @param bAutoDeleteRunnable Whether to delete the runnable object on exit
  * @param InStackSize The size of the stack to create. 0 means use the
@@ -329,21 +638,47 @@ FRunnableThreadLinux::~FRunnableThreadLinux(void)
  *
  * @return True if the thread and all of its initialization was successful, false otherwise
  */
-UBOOL FRunnableThreadLinux::Create(FRunnable* InRunnable,
+UBOOL FRunnableThreadLinux::Create(FRunnable* InRunnable,const TCHAR* ThreadName,
 	UBOOL bAutoDeleteSelf,UBOOL bAutoDeleteRunnable,DWORD InStackSize,
 	EThreadPriority InThreadPri)
 {
-	return FALSE;
+	check(InRunnable);
+	Runnable = InRunnable;
+	ThreadPriority = InThreadPri;
+	bShouldDeleteSelf = bAutoDeleteSelf;
+	bShouldDeleteRunnable = bAutoDeleteRunnable;
+	// Create the new thread
+	bIsJoinable = CreatePThread(Thread,_ThreadProc,this,InStackSize);
+	// If it fails, clear all the vars
+	if (bIsJoinable == FALSE)
+	{
+		if (bAutoDeleteRunnable == TRUE)
+		{
+			delete InRunnable;
+		}
+		Runnable = NULL;
+		return FALSE;
+	}
+	// Wait for the thread to report its id, then set the name for debug purposes
+	while (ThreadID == 0)
+	{
+		appSleep(0.f);
+	}
+	SetThreadName(Thread,ThreadName);
+	// The thread may delete itself from here on
+	appInterlockedExchange(&bCreateFinished,TRUE);
+	return TRUE;
 }
 
 /**
  * Tells the thread to either pause execution or resume depending on the
- * passed in value.
+ * passed in value. Not supported by pthreads.
  *
  * @param bShouldPause Whether to pause the thread (true) or resume (false)
  */
 void FRunnableThreadLinux::Suspend(UBOOL bShouldPause)
 {
+	debugf(NAME_Warning,TEXT("Suspending threads is not supported on Linux"));
 }
 
 /**
@@ -360,7 +695,58 @@ void FRunnableThreadLinux::Suspend(UBOOL bShouldPause)
  */
 UBOOL FRunnableThreadLinux::Kill(UBOOL bShouldWait,DWORD MaxWaitTime)
 {
-	return FALSE;
+	check(Runnable && "Did you forget to call Create()?");
+	UBOOL bDidExitOK = TRUE;
+	// Let the runnable have a chance to stop without brute force killing
+	Runnable->Stop();
+	if (bIsJoinable == TRUE)
+	{
+		// If waiting was specified, wait the amount of time. If that fails,
+		// brute force kill that thread. Very bad as that might leak.
+		if (bShouldWait == TRUE)
+		{
+			if (JoinPThread(Thread,MaxWaitTime) == FALSE)
+			{
+				bDidExitOK = FALSE;
+				appErrorf(TEXT("Thread %p still alive. Kill failed: Aborting."),(void*)Thread);
+			}
+		}
+		else
+		{
+			// Let the thread clean up after itself once it exits
+			pthread_detach(Thread);
+		}
+		bIsJoinable = FALSE;
+	}
+	// Should we delete the runnable?
+	if (bShouldDeleteRunnable == TRUE)
+	{
+		delete Runnable;
+		Runnable = NULL;
+	}
+	// Delete ourselves if requested
+	if (bShouldDeleteSelf == TRUE)
+	{
+		GThreadFactory->Destroy(this);
+	}
+	return bDidExitOK;
+}
+
+/**
+ * The thread entry point. Simply forwards the call on to the right
+ * thread main function
+ */
+void* FRunnableThreadLinux::_ThreadProc(void* pThis)
+{
+	check(pThis);
+	FRunnableThreadLinux* RunnableThread = (FRunnableThreadLinux*)pThis;
+	RunnableThread->ThreadID = appGetCurrentThreadId();
+	// Hold off till Create is done touching the object
+	while (RunnableThread->bCreateFinished == FALSE)
+	{
+		appSleep(0.f);
+	}
+	return (void*)(PTRINT)RunnableThread->Run();
 }
 
 /**
@@ -371,16 +757,51 @@ UBOOL FRunnableThreadLinux::Kill(UBOOL bShouldWait,DWORD MaxWaitTime)
  */
 DWORD FRunnableThreadLinux::Run(void)
 {
-	return 0;
-}
-
-/**
- * Changes the thread priority of the currently running thread
+	// Assume we'll fail init
+	DWORD ExitCode = 1;
+	check(Runnable);
+	// Twiddle the thread priority
+	if (ThreadPriority != TPri_Normal)
+	{
+		SetThreadPriority(ThreadPriority);
+	}
+	// Initialize the runnable object
+	if (Runnable->Init() == TRUE)
+	{
+		// Now run the task that needs to be done
+		ExitCode = Runnable->Run();
+		// Allow any allocated resources to be cleaned up
+		Runnable->Exit();
+	}
+	// Should we delete the runnable?
+	if (bShouldDeleteRunnable == TRUE)
+	{
+		delete Runnable;
+		Runnable = NULL;
+	}
+	// Clean ourselves up without waiting
+	if (bShouldDeleteSelf == TRUE)
+	{
+		// Nobody is going to join us
+		pthread_detach(Thread);
+		bIsJoinable = FALSE;
+		GThreadFactory->Destroy(this);
+	}
+	return ExitCode;
+}
+
+/**
+ * Changes the thread priority of the currently running thread. Threads are
+ * scheduled with SCHED_OTHER, so this adjusts the thread's nice value.
+ * Raising it above normal needs privileges and silently fails without.
  *
  * @param NewPriority The thread priority to change to
  */
 void FRunnableThreadLinux::SetThreadPriority(EThreadPriority NewPriority)
 {
+	ThreadPriority = NewPriority;
+	const INT NiceValue = NewPriority == TPri_AboveNormal ? -5 : (NewPriority == TPri_BelowNormal ? 5 : 0);
+	setpriority(PRIO_PROCESS,ThreadID,NiceValue);
 }
 
 /**
@@ -390,6 +811,11 @@ void FRunnableThreadLinux::SetThreadPriority(EThreadPriority NewPriority)
  */
 void FRunnableThreadLinux::SetProcessorAffinity(DWORD ProcessorNum)
 {
+	check(bIsJoinable);
+	cpu_set_t CpuSet;
+	CPU_ZERO(&CpuSet);
+	CPU_SET(ProcessorNum,&CpuSet);
+	pthread_setaffinity_np(Thread,sizeof(CpuSet),&CpuSet);
 }
 
 /**
@@ -397,12 +823,28 @@ void FRunnableThreadLinux::SetProcessorAffinity(DWORD ProcessorNum)
  */
 void FRunnableThreadLinux::WaitForCompletion(void)
 {
+	if (bIsJoinable == TRUE)
+	{
+		pthread_join(Thread,NULL);
+		bIsJoinable = FALSE;
+	}
+}
+
+/**
+ * Thread ID for this thread 
+ *
+ * @return ID that was set by CreateThread
+ */
+DWORD FRunnableThreadLinux::GetThreadID(void)
+{
+	return ThreadID;
 }
 
 /**
  * Creates the thread with the specified stack size and thread priority.
  *
  * @param InRunnable The runnable object to execute
+ * @param ThreadName Name of the thread
  * @param bAutoDeleteSelf Whether to delete this object on exit
  * @param bAutoDeleteRunnable Whether to delete the runnable object on exit
  * @param InStackSize The size of the stack to create. 0 means use the
@@ -412,11 +854,21 @@ void FRunnableThreadLinux::WaitForCompletion(void)
  *
  * @return The newly created thread or NULL if it failed
  */
-FRunnableThread* FThreadFactoryLinux::CreateThread(FRunnable* InRunnable,
+FRunnableThread* FThreadFactoryLinux::CreateThread(FRunnable* InRunnable, const TCHAR* ThreadName,
 	UBOOL bAutoDeleteSelf,UBOOL bAutoDeleteRunnable,DWORD InStackSize,
 	EThreadPriority InThreadPri)
 {
-	return NULL;
+	check(InRunnable);
+	// Create a new thread object
+	FRunnableThreadLinux* NewThread = new FRunnableThreadLinux();
+	// Call fully create the thread. If it fails, delete the thread
+	if (NewThread->Create(InRunnable,ThreadName,bAutoDeleteSelf,bAutoDeleteRunnable,
+		InStackSize,InThreadPri) == FALSE)
+	{
+		delete NewThread;
+		NewThread = NULL;
+	}
+	return NewThread;
 }
 
 /**
@@ -426,6 +878,7 @@ FRunnableThread* FThreadFactoryLinux::CreateThread(FRunnable* InRunnable,
  */
 void FThreadFactoryLinux::Destroy(FRunnableThread* InThread)
 {
+	delete InThread;
 }
 
 #endif
@@ -498,6 +498,10 @@ UBOOL FQueuedThreadPoolWin::Create(DWORD InNumQueuedThreads,DWORD ProcessorMask,
 	{
 		Destroy();
 	}
+	else
+	{
+		NumThreads = QueuedThreads.Num();
+	}
 	return bWasSuccessful;
 }
 
@@ -1261,11 +1261,34 @@ BEGIN_COMMANDLET(TestCompression,Editor)
 	 * @param CompressedSize	The options for compressed package file
 	 */
 	void RunTest(const FFilename& PackageName, ECompressionFlags Flags, DWORD& UncompressedSize, DWORD& CompressedSize);
+
+	/**
+	 * Measures decompression throughput of the given package with the given compression options, decompressing
+	 * 1 up to MaxThreads chunks in parallel.
+	 *
+	 * @param PackageName		The package to compress/decompress
+	 * @param Flags				The options for compression
+	 * @param MaxThreads		Maximum number of chunks decompressed in parallel
+	 * @param Iterations		Number of times the package is decompressed per thread count
+	 */
+	void RunThroughputTest(const FFilename& PackageName, ECompressionFlags Flags, INT MaxThreads, INT Iterations);
 END_COMMANDLET
 
 BEGIN_COMMANDLET(StripSource,Editor)
 END_COMMANDLET
 
+BEGIN_COMMANDLET(ThreadPoolBenchmark,Editor)
+END_COMMANDLET
+
+BEGIN_COMMANDLET(ObjectHashBenchmark,Editor)
+END_COMMANDLET
+
+BEGIN_COMMANDLET(ContainerBenchmark,Editor)
+END_COMMANDLET
+
+BEGIN_COMMANDLET(ParallelTickBenchmark,Editor)
+END_COMMANDLET
+
 BEGIN_COMMANDLET(MergePackages,Editor)
 END_COMMANDLET
 
@@ -0,0 +1,621 @@
+/*=============================================================================
+	UBenchmarkCommandlets.cpp: Commandlets measuring engine subsystem performance.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "EditorPrivate.h"
+
+/*-----------------------------------------------------------------------------
+	UThreadPoolBenchmarkCommandlet.
+-----------------------------------------------------------------------------*/
+
+#if _MSC_VER
+typedef FQueuedThreadPoolWin	FSingleQueueThreadPool;
+#else
+typedef FQueuedThreadPoolLinux	FSingleQueueThreadPool;
+#endif
+
+/**
+ * Burns a fixed amount of CPU so work items have a measurable, uniform cost.
+ *
+ * @param Iterations	number of hash iterations
+ * @return hash result, used to keep the compiler from discarding the loop
+ */
+static DWORD BurnBenchmarkCycles( INT Iterations )
+{
+	DWORD Hash = 0x811C9DC5;
+	for( INT Iteration = 0; Iteration < Iterations; Iteration++ )
+	{
+		Hash = (Hash ^ (DWORD)Iteration) * 0x01000193;
+	}
+	return Hash;
+}
+
+/** Keeps the results of BurnBenchmarkCycles alive. */
+static volatile DWORD GBenchmarkSink = 0;
+
+/**
+ * Independent work item, optionally spawning two children on the pool it runs on
+ * to exercise work queued from worker threads.
+ */
+class FThreadPoolBenchmarkWork : public FAsyncWorkBase
+{
+public:
+	FThreadPoolBenchmarkWork( FQueuedThreadPool* InPool, INT InIterations, INT InDepth, FThreadSafeCounter* InCounter )
+	:	FAsyncWorkBase( InCounter )
+	,	Pool( InPool )
+	,	Iterations( InIterations )
+	,	Depth( InDepth )
+	,	Counter( InCounter )
+	{}
+
+	virtual void DoWork()
+	{
+		GBenchmarkSink += BurnBenchmarkCycles( Iterations );
+		if( Depth > 0 )
+		{
+			// Account for the children before this item's Dispose decrements the counter.
+			Counter->Increment();
+			Counter->Increment();
+			Pool->AddQueuedWork( new FThreadPoolBenchmarkWork( Pool, Iterations, Depth - 1, Counter ) );
+			Pool->AddQueuedWork( new FThreadPoolBenchmarkWork( Pool, Iterations, Depth - 1, Counter ) );
+		}
+	}
+
+private:
+	FQueuedThreadPool* Pool;
+	INT Iterations;
+	INT Depth;
+	FThreadSafeCounter* Counter;
+};
+
+/**
+ * Graph work item used for the layered dependency test.
+ */
+class FThreadPoolBenchmarkGraphWork : public FQueuedGraphWork
+{
+public:
+	FThreadPoolBenchmarkGraphWork( INT InIterations, FThreadSafeCounter* InCounter )
+	:	FQueuedGraphWork( InCounter )
+	,	Iterations( InIterations )
+	{}
+
+protected:
+	virtual void DoTask()
+	{
+		GBenchmarkSink += BurnBenchmarkCycles( Iterations );
+	}
+
+private:
+	INT Iterations;
+};
+
+/**
+ * Spins until the counter reaches zero.
+ */
+static void WaitForBenchmarkCounter( FThreadSafeCounter& Counter )
+{
+	while( Counter.GetValue() > 0 )
+	{
+		appSleep( 0 );
+	}
+}
+
+/**
+ * Runs the flat, fan out and dependency tests against a pool.
+ *
+ * @param PoolName		name to log
+ * @param Pool			pool to test, already created
+ * @param NumJobs		number of independent jobs in the flat test
+ * @param Iterations	cost of each job
+ * @param FanOutDepth	depth of the binary spawn tree in the fan out test
+ * @param NumLayers		number of layers in the dependency test
+ * @param LayerWidth	number of jobs per layer in the dependency test
+ */
+static void RunThreadPoolBenchmark( const TCHAR* PoolName, FQueuedThreadPool* Pool, INT NumJobs, INT Iterations, INT FanOutDepth, INT NumLayers, INT LayerWidth )
+{
+	// Flat: every job queued from the calling thread.
+	FThreadSafeCounter FlatCounter( NumJobs );
+	DOUBLE StartTime = appSeconds();
+	for( INT JobIndex = 0; JobIndex < NumJobs; JobIndex++ )
+	{
+		Pool->AddQueuedWork( new FThreadPoolBenchmarkWork( Pool, Iterations, 0, &FlatCounter ) );
+	}
+	WaitForBenchmarkCounter( FlatCounter );
+	const DOUBLE FlatTime = appSeconds() - StartTime;
+
+	// Fan out: jobs queued from within jobs.
+	FThreadSafeCounter FanOutCounter( 1 );
+	StartTime = appSeconds();
+	Pool->AddQueuedWork( new FThreadPoolBenchmarkWork( Pool, Iterations, FanOutDepth, &FanOutCounter ) );
+	WaitForBenchmarkCounter( FanOutCounter );
+	const DOUBLE FanOutTime = appSeconds() - StartTime;
+	const INT NumFanOutJobs = (1 << (FanOutDepth + 1)) - 1;
+
+	// Dependencies: each job waits on every job of the previous layer.
+	const INT NumGraphJobs = NumLayers * LayerWidth;
+	FThreadSafeCounter GraphCounter( NumGraphJobs );
+	TArray<FThreadPoolBenchmarkGraphWork*> GraphJobs;
+	GraphJobs.Empty( NumGraphJobs );
+	StartTime = appSeconds();
+	for( INT JobIndex = 0; JobIndex < NumGraphJobs; JobIndex++ )
+	{
+		FThreadPoolBenchmarkGraphWork* Job = new FThreadPoolBenchmarkGraphWork( Iterations, &GraphCounter );
+		const INT PreviousLayerStart = (JobIndex / LayerWidth - 1) * LayerWidth;
+		for( INT PrerequisiteIndex = PreviousLayerStart; PrerequisiteIndex >= 0 && PrerequisiteIndex < PreviousLayerStart + LayerWidth; PrerequisiteIndex++ )
+		{
+			Job->AddPrerequisite( GraphJobs(PrerequisiteIndex) );
+		}
+		GraphJobs.AddItem( Job );
+	}
+	// Dispatched jobs may complete and delete themselves at any point, but a job can't
+	// run before its own Dispatch so each one is still valid when it is reached here.
+	for( INT JobIndex = 0; JobIndex < NumGraphJobs; JobIndex++ )
+	{
+		GraphJobs(JobIndex)->Dispatch( Pool );
+	}
+	WaitForBenchmarkCounter( GraphCounter );
+	const DOUBLE GraphTime = appSeconds() - StartTime;
+
+	// Give workers that just disposed their last job time to return to the pool before it is destroyed.
+	appSleep( 0.1f );
+
+	warnf( TEXT("%-28s flat %8.0f jobs/s   fan out %8.0f jobs/s   dependencies %8.0f jobs/s"),
+		PoolName,
+		NumJobs / Max( FlatTime, 1e-6 ),
+		NumFanOutJobs / Max( FanOutTime, 1e-6 ),
+		NumGraphJobs / Max( GraphTime, 1e-6 ) );
+}
+
+/**
+ * Compares throughput of the single queue thread pool with the work stealing pool.
+ *
+ * Usage: ThreadPoolBenchmark [threads=N] [jobs=N] [iterations=N] [depth=N] [layers=N] [width=N]
+ */
+INT UThreadPoolBenchmarkCommandlet::Main( const FString& Params )
+{
+	const TCHAR* Parms = *Params;
+
+	INT NumThreads = Max<INT>( 1, GNumHardwareThreads - 1 );
+	INT NumJobs = 100000;
+	INT Iterations = 2000;
+	INT FanOutDepth = 16;
+	INT NumLayers = 64;
+	INT LayerWidth = 16;
+	Parse( Parms, TEXT("THREADS="), NumThreads );
+	Parse( Parms, TEXT("JOBS="), NumJobs );
+	Parse( Parms, TEXT("ITERATIONS="), Iterations );
+	Parse( Parms, TEXT("DEPTH="), FanOutDepth );
+	Parse( Parms, TEXT("LAYERS="), NumLayers );
+	Parse( Parms, TEXT("WIDTH="), LayerWidth );
+	FanOutDepth = Clamp( FanOutDepth, 0, 24 );
+
+	warnf( TEXT("Thread pool benchmark: %i threads, %i jobs, %i iterations per job"), NumThreads, NumJobs, Iterations );
+
+	{
+		FSingleQueueThreadPool Pool;
+		verify( Pool.Create( 1 ) );
+		RunThreadPoolBenchmark( TEXT("Single queue, 1 thread"), &Pool, NumJobs, Iterations, FanOutDepth, NumLayers, LayerWidth );
+		Pool.Destroy();
+	}
+	{
+		FSingleQueueThreadPool Pool;
+		verify( Pool.Create( NumThreads ) );
+		RunThreadPoolBenchmark( *FString::Printf( TEXT("Single queue, %i threads"), NumThreads ), &Pool, NumJobs, Iterations, FanOutDepth, NumLayers, LayerWidth );
+		Pool.Destroy();
+	}
+	{
+		FQueuedThreadPoolTaskGraph Pool;
+		verify( Pool.Create( NumThreads ) );
+		RunThreadPoolBenchmark( *FString::Printf( TEXT("Work stealing, %i threads"), NumThreads ), &Pool, NumJobs, Iterations, FanOutDepth, NumLayers, LayerWidth );
+		warnf( TEXT("  %i of %i jobs were stolen"), Pool.GetNumStolen(), Pool.GetNumExecuted() );
+		Pool.Destroy();
+	}
+
+	return 0;
+}
+IMPLEMENT_CLASS(UThreadPoolBenchmarkCommandlet);
+
+/*-----------------------------------------------------------------------------
+	UObjectHashBenchmarkCommandlet.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Measures object hash lookup and outer iteration cost with one or more packages loaded.
+ *
+ * Usage: ObjectHashBenchmark <map or package> [<map or package> ...] [passes=N]
+ */
+INT UObjectHashBenchmarkCommandlet::Main( const FString& Params )
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	ParseCommandLine( *Params, Tokens, Switches );
+
+	INT NumPasses = 10;
+	Parse( *Params, TEXT("PASSES="), NumPasses );
+	NumPasses = Max( NumPasses, 1 );
+
+	// Load the requested maps/ packages so lookups run against a realistic object population.
+	for( INT TokenIndex = 0; TokenIndex < Tokens.Num(); TokenIndex++ )
+	{
+		if( Tokens(TokenIndex).InStr( TEXT("=") ) != INDEX_NONE )
+		{
+			continue;
+		}
+		FString Filename;
+		if( !GPackageFileCache->FindPackageFile( *Tokens(TokenIndex), NULL, Filename ) || !UObject::LoadPackage( NULL, *Filename, LOAD_None ) )
+		{
+			warnf( NAME_Error, TEXT("Failed to load %s"), *Tokens(TokenIndex) );
+			return 1;
+		}
+	}
+
+	// Snapshot the live objects and the packages among them.
+	TArray<UObject*> Objects;
+	TArray<UPackage*> Packages;
+	for( FObjectIterator It; It; ++It )
+	{
+		Objects.AddItem( *It );
+		if( It->GetClass() == UPackage::StaticClass() )
+		{
+			Packages.AddItem( (UPackage*) *It );
+		}
+	}
+	warnf( TEXT("Object hash benchmark: %i objects in %i packages, %i passes"), Objects.Num(), Packages.Num(), NumPasses );
+	UObject::StaticExec( TEXT("OBJ HASH"), *GWarn );
+
+	// Lookups by name and outer, the path taken by StaticFindObjectFast with a known outer.
+	INT NumFound = 0;
+	DOUBLE StartTime = appSeconds();
+	for( INT PassIndex = 0; PassIndex < NumPasses; PassIndex++ )
+	{
+		for( INT ObjectIndex = 0; ObjectIndex < Objects.Num(); ObjectIndex++ )
+		{
+			UObject* Object = Objects(ObjectIndex);
+			if( UObject::StaticFindObjectFast( NULL, Object->GetOuter(), Object->GetFName() ) )
+			{
+				NumFound++;
+			}
+		}
+	}
+	const DOUBLE OuterLookupTime = appSeconds() - StartTime;
+
+	// Lookups by class and name in any package.
+	INT NumFoundAnyPackage = 0;
+	StartTime = appSeconds();
+	for( INT PassIndex = 0; PassIndex < NumPasses; PassIndex++ )
+	{
+		for( INT ObjectIndex = 0; ObjectIndex < Objects.Num(); ObjectIndex++ )
+		{
+			UObject* Object = Objects(ObjectIndex);
+			if( UObject::StaticFindObjectFast( Object->GetClass(), NULL, Object->GetFName(), TRUE, TRUE ) )
+			{
+				NumFoundAnyPackage++;
+			}
+		}
+	}
+	const DOUBLE AnyPackageLookupTime = appSeconds() - StartTime;
+
+	// Gathering everything inside each package through the outer index...
+	INT NumGathered = 0;
+	StartTime = appSeconds();
+	for( INT PassIndex = 0; PassIndex < NumPasses; PassIndex++ )
+	{
+		for( INT PackageIndex = 0; PackageIndex < Packages.Num(); PackageIndex++ )
+		{
+			TArray<UObject*> Results;
+			UObject::GetObjectsWithOuter( Packages(PackageIndex), Results, TRUE );
+			NumGathered += Results.Num();
+		}
+	}
+	const DOUBLE OuterIndexTime = appSeconds() - StartTime;
+
+	// ...compared to iterating over all objects once per package, as done before the index existed.
+	INT NumIterated = 0;
+	StartTime = appSeconds();
+	for( INT PackageIndex = 0; PackageIndex < Packages.Num(); PackageIndex++ )
+	{
+		for( FObjectIterator It; It; ++It )
+		{
+			if( It->IsIn( Packages(PackageIndex) ) )
+			{
+				NumIterated++;
+			}
+		}
+	}
+	const DOUBLE ObjectIteratorTime = appSeconds() - StartTime;
+
+	const DOUBLE NumLookups = (DOUBLE) Objects.Num() * NumPasses;
+	warnf( TEXT("Name/outer lookups:  %8.1f ns per lookup (%i of %.0f found)"), OuterLookupTime * 1e9 / Max( NumLookups, 1.0 ), NumFound, NumLookups );
+	warnf( TEXT("Any package lookups: %8.1f ns per lookup (%i of %.0f found)"), AnyPackageLookupTime * 1e9 / Max( NumLookups, 1.0 ), NumFoundAnyPackage, NumLookups );
+	warnf( TEXT("Objects in packages: %8.3f ms per pass through the outer index, %8.3f ms iterating all objects (%i vs %i objects)"),
+		OuterIndexTime * 1000 / NumPasses,
+		ObjectIteratorTime * 1000,
+		NumGathered / NumPasses,
+		NumIterated );
+
+	return 0;
+}
+IMPLEMENT_CLASS(UObjectHashBenchmarkCommandlet);
+
+/*-----------------------------------------------------------------------------
+	UContainerBenchmarkCommandlet.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Allocator forwarding to the real one while counting the allocations made by a single thread.
+ */
+class FMallocBenchmarkCounter : public FMalloc
+{
+public:
+	FMallocBenchmarkCounter( FMalloc* InInnerMalloc )
+	:	InnerMalloc( InInnerMalloc )
+	,	CountedThreadId( appGetCurrentThreadId() )
+	,	NumAllocs( 0 )
+	{}
+
+	virtual void* Malloc( DWORD Count, DWORD Alignment )
+	{
+		CountAlloc();
+		return InnerMalloc->Malloc( Count, Alignment );
+	}
+	virtual void* Realloc( void* Original, DWORD Count, DWORD Alignment )
+	{
+		// Growing an array is as expensive as allocating it.
+		if( Count )
+		{
+			CountAlloc();
+		}
+		return InnerMalloc->Realloc( Original, Count, Alignment );
+	}
+	virtual void Free( void* Original )
+	{
+		InnerMalloc->Free( Original );
+	}
+	virtual UBOOL IsInternallyThreadSafe()
+	{
+		return InnerMalloc->IsInternallyThreadSafe();
+	}
+
+	/** @return number of allocations made by the counted thread, resetting the count */
+	DWORD ConsumeNumAllocs()
+	{
+		const DWORD Result = NumAllocs;
+		NumAllocs = 0;
+		return Result;
+	}
+
+private:
+	void CountAlloc()
+	{
+		// Only the benchmark thread touches the count.
+		if( appGetCurrentThreadId() == CountedThreadId )
+		{
+			NumAllocs++;
+		}
+	}
+
+	FMalloc*	InnerMalloc;
+	DWORD		CountedThreadId;
+	DWORD		NumAllocs;
+};
+
+/**
+ * Simulates the per frame use of scratch arrays by octree queries and animation blending.
+ *
+ * @param NumFrames		number of frames to simulate
+ * @param NumQueries	octree queries per frame, each returning 0 to 47 primitives
+ * @param NumBlends		blend nodes evaluated per frame, each needing a scratch copy of the pose
+ * @param NumBones		bones per skeleton
+ * @return checksum, used to keep the compiler from discarding the work
+ */
+template<class PrimitiveArrayType, class BoneAtomArrayType> static DWORD SimulateContainerFrames( INT NumFrames, INT NumQueries, INT NumBlends, INT NumBones )
+{
+	DWORD Checksum = 0;
+	DWORD Seed = 0x12345678;
+	for( INT FrameIndex = 0; FrameIndex < NumFrames; FrameIndex++ )
+	{
+		for( INT QueryIndex = 0; QueryIndex < NumQueries; QueryIndex++ )
+		{
+			PrimitiveArrayType Primitives;
+			Seed = Seed * 196314165 + 907633515;
+			const INT NumResults = (Seed >> 16) % 48;
+			for( INT ResultIndex = 0; ResultIndex < NumResults; ResultIndex++ )
+			{
+				Primitives.AddItem( (UPrimitiveComponent*)(PTRINT)((ResultIndex + 1) * 16) );
+			}
+			Checksum += Primitives.Num();
+		}
+
+		FBoneAtom Pose = FBoneAtom::Identity;
+		for( INT BlendIndex = 0; BlendIndex < NumBlends; BlendIndex++ )
+		{
+			BoneAtomArrayType ChildAtoms;
+			ChildAtoms.Add( NumBones );
+			for( INT BoneIndex = 0; BoneIndex < NumBones; BoneIndex++ )
+			{
+				ChildAtoms(BoneIndex) = FBoneAtom::Identity;
+				ChildAtoms(BoneIndex).Translation.X = (FLOAT) BoneIndex;
+			}
+			Pose.Blend( Pose, ChildAtoms(BlendIndex % NumBones), 0.5f );
+		}
+		Checksum += appTrunc( Pose.Translation.X );
+	}
+	return Checksum;
+}
+
+/**
+ * Runs the simulated frames with one set of array types and logs allocations and time per frame.
+ */
+template<class PrimitiveArrayType, class BoneAtomArrayType> static void RunContainerBenchmark( const TCHAR* Description, FMallocBenchmarkCounter& Counter, INT NumFrames, INT NumQueries, INT NumBlends, INT NumBones )
+{
+	Counter.ConsumeNumAllocs();
+	const DOUBLE StartTime = appSeconds();
+	GBenchmarkSink += SimulateContainerFrames<PrimitiveArrayType,BoneAtomArrayType>( NumFrames, NumQueries, NumBlends, NumBones );
+	const DOUBLE Time = appSeconds() - StartTime;
+	const DWORD NumAllocs = Counter.ConsumeNumAllocs();
+
+	warnf( TEXT("%-28s %10.1f allocations per frame   %8.3f ms per frame"),
+		Description,
+		(DOUBLE) NumAllocs / NumFrames,
+		Time * 1000 / NumFrames );
+}
+
+/**
+ * Compares allocations and time per frame of plain TArrays with TInlineArray for octree query results
+ * and the pooled FBoneAtomArray for animation blending.
+ *
+ * Usage: ContainerBenchmark [frames=N] [queries=N] [blends=N] [bones=N]
+ */
+INT UContainerBenchmarkCommandlet::Main( const FString& Params )
+{
+	const TCHAR* Parms = *Params;
+
+	INT NumFrames = 1000;
+	INT NumQueries = 200;
+	INT NumBlends = 60;
+	INT NumBones = 90;
+	Parse( Parms, TEXT("FRAMES="), NumFrames );
+	Parse( Parms, TEXT("QUERIES="), NumQueries );
+	Parse( Parms, TEXT("BLENDS="), NumBlends );
+	Parse( Parms, TEXT("BONES="), NumBones );
+	NumFrames = Max( NumFrames, 1 );
+	NumBones = Max( NumBones, 1 );
+
+	warnf( TEXT("Container benchmark: %i frames, %i octree queries and %i blends of %i bones per frame"), NumFrames, NumQueries, NumBlends, NumBones );
+
+	// Count allocations by routing them through a counting proxy for the duration of the benchmark.
+	FMalloc* SavedMalloc = GMalloc;
+	FMallocBenchmarkCounter Counter( SavedMalloc );
+	GMalloc = &Counter;
+
+	RunContainerBenchmark< TArray<UPrimitiveComponent*>, TArray<FBoneAtom> >( TEXT("TArray"), Counter, NumFrames, NumQueries, NumBlends, NumBones );
+	RunContainerBenchmark< TInlineArray<UPrimitiveComponent*,64>, FBoneAtomArray >( TEXT("TInlineArray/FBoneAtomArray"), Counter, NumFrames, NumQueries, NumBlends, NumBones );
+
+	GMalloc = SavedMalloc;
+	return 0;
+}
+IMPLEMENT_CLASS(UContainerBenchmarkCommandlet);
+
+/*-----------------------------------------------------------------------------
+	UParallelTickBenchmarkCommandlet.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Actor whose TickParallel burns a fixed amount of CPU and records how it was ticked.
+ */
+class AParallelTickBenchmarkActor : public AActor
+{
+	DECLARE_CLASS(AParallelTickBenchmarkActor,AActor,CLASS_Transient|CLASS_Intrinsic,Editor)
+
+	/** Number of hash iterations per tick. */
+	INT Iterations;
+	/** Number of times TickParallel has been called. */
+	INT NumParallelTicks;
+	/** Whether TickParallel has been called on a thread other than the game thread. */
+	UBOOL bTickedOnWorker;
+
+	virtual UBOOL CanTickInParallel() const
+	{
+		return TRUE;
+	}
+
+	virtual void TickParallel( FLOAT DeltaSeconds, enum ELevelTick TickType )
+	{
+		GBenchmarkSink += BurnBenchmarkCycles( Iterations );
+		NumParallelTicks++;
+		if( !IsInGameThread() )
+		{
+			bTickedOnWorker = TRUE;
+		}
+	}
+};
+IMPLEMENT_CLASS(AParallelTickBenchmarkActor);
+
+/**
+ * Compares ticking actors' TickParallel serially on the game thread with TickInParallel and verifies that
+ * every live actor was ticked once per frame and that pending kill actors were skipped.
+ *
+ * Usage: ParallelTickBenchmark [actors=N] [iterations=N] [frames=N]
+ */
+INT UParallelTickBenchmarkCommandlet::Main( const FString& Params )
+{
+	const TCHAR* Parms = *Params;
+
+	INT NumActors = 2000;
+	INT Iterations = 2000;
+	INT NumFrames = 100;
+	Parse( Parms, TEXT("ACTORS="), NumActors );
+	Parse( Parms, TEXT("ITERATIONS="), Iterations );
+	Parse( Parms, TEXT("FRAMES="), NumFrames );
+	NumActors = Max( NumActors, 1 );
+	NumFrames = Max( NumFrames, 1 );
+
+	warnf( TEXT("Parallel tick benchmark: %i actors, %i iterations per tick, %i frames, %i hardware threads"), NumActors, Iterations, NumFrames, GNumHardwareThreads );
+
+	// Every 16th actor is destroyed, which TickInParallel has to skip the same way the level tick does.
+	TArray<AActor*> Actors;
+	for( INT ActorIndex = 0; ActorIndex < NumActors; ActorIndex++ )
+	{
+		AParallelTickBenchmarkActor* Actor = ConstructObject<AParallelTickBenchmarkActor>( AParallelTickBenchmarkActor::StaticClass() );
+		Actor->Iterations = Iterations;
+		Actor->bDeleteMe = (ActorIndex % 16) == 15;
+		Actors.AddItem( Actor );
+	}
+
+	const FLOAT DeltaSeconds = 1.f / 30.f;
+
+	DOUBLE StartTime = appSeconds();
+	for( INT Frame = 0; Frame < NumFrames; Frame++ )
+	{
+		for( INT ActorIndex = 0; ActorIndex < Actors.Num(); ActorIndex++ )
+		{
+			AActor* Actor = Actors(ActorIndex);
+			if( !Actor->ActorIsPendingKill() )
+			{
+				Actor->TickParallel( DeltaSeconds, LEVELTICK_All );
+			}
+		}
+	}
+	const DOUBLE SerialTime = appSeconds() - StartTime;
+
+	// Only count the parallel ticks.
+	for( INT ActorIndex = 0; ActorIndex < Actors.Num(); ActorIndex++ )
+	{
+		((AParallelTickBenchmarkActor*)Actors(ActorIndex))->NumParallelTicks = 0;
+	}
+
+	StartTime = appSeconds();
+	for( INT Frame = 0; Frame < NumFrames; Frame++ )
+	{
+		TickInParallel( Actors, TArray<UActorComponent*>(), DeltaSeconds, LEVELTICK_All );
+	}
+	const DOUBLE ParallelTime = appSeconds() - StartTime;
+
+	INT NumMismatches = 0;
+	INT NumTickedOnWorker = 0;
+	for( INT ActorIndex = 0; ActorIndex < Actors.Num(); ActorIndex++ )
+	{
+		AParallelTickBenchmarkActor* Actor = (AParallelTickBenchmarkActor*)Actors(ActorIndex);
+		const INT ExpectedTicks = Actor->bDeleteMe ? 0 : NumFrames;
+		if( Actor->NumParallelTicks != ExpectedTicks )
+		{
+			warnf( NAME_Error, TEXT("%s was ticked %i times instead of %i"), *Actor->GetName(), Actor->NumParallelTicks, ExpectedTicks );
+			NumMismatches++;
+		}
+		if( Actor->bTickedOnWorker )
+		{
+			NumTickedOnWorker++;
+		}
+	}
+
+	warnf( TEXT("Serial:   %8.3f ms per frame"), SerialTime * 1000 / NumFrames );
+	warnf( TEXT("Parallel: %8.3f ms per frame, %i of %i actors ticked on a worker thread at least once"), ParallelTime * 1000 / NumFrames, NumTickedOnWorker, Actors.Num() );
+	if( NumTickedOnWorker == 0 && GThreadPool != NULL && GNumHardwareThreads > 1 && !ParseParam( appCmdLine(), TEXT("SERIALTICK") ) && Actors.Num() > 1 )
+	{
+		warnf( NAME_Warning, TEXT("No actor was ticked on a worker thread, too few actors for more than one batch?") );
+	}
+
+	return NumMismatches > 0 ? 1 : 0;
+}
+IMPLEMENT_CLASS(UParallelTickBenchmarkCommandlet);
@@ -1625,6 +1625,61 @@ void UTestCompressionCommandlet::RunTest(const FFilename& PackageName, ECompress
 	warnf(TEXT("  Async Decompress time: %.3fs"), AsyncUncompressTime);
 }
 
+/**
+ * Measures decompression throughput of the given package with the given compression options, decompressing
+ * 1 up to MaxThreads chunks in parallel.
+ *
+ * @param PackageName		The package to compress/decompress
+ * @param Flags				The options for compression
+ * @param MaxThreads		Maximum number of chunks decompressed in parallel
+ * @param Iterations		Number of times the package is decompressed per thread count
+ */
+void UTestCompressionCommandlet::RunThroughputTest(const FFilename& PackageName, ECompressionFlags Flags, INT MaxThreads, INT Iterations)
+{
+	TArray<BYTE> SrcData;
+	if( !appLoadFileToArray( SrcData, *PackageName ) || SrcData.Num() == 0 )
+	{
+		warnf(NAME_Error, TEXT("Failed to load %s"), *PackageName);
+		return;
+	}
+
+	// Compress into memory so only decompression is being measured.
+	TArray<BYTE> CompressedData;
+	FMemoryWriter Writer( CompressedData );
+	Writer.SerializeCompressed( SrcData.GetData(), SrcData.Num(), Flags );
+
+	SET_WARN_COLOR(COLOR_YELLOW);
+	warnf(TEXT(""));
+	warnf(TEXT("%s, %s, %.3fMB -> %.3fMB"), 
+		*PackageName.GetCleanFilename(), 
+		(Flags & COMPRESS_ZLIB) ? TEXT("ZLIB") : TEXT("LZO"),
+		SrcData.Num() / (1024.0f * 1024.0f),
+		CompressedData.Num() / (1024.0f * 1024.0f));
+	SET_WARN_COLOR(COLOR_GRAY);
+
+	TArray<BYTE> DstData;
+	DstData.Add( SrcData.Num() );
+
+	const INT OldDecompressionWindowSize = GDecompressionWindowSize;
+	for( INT NumThreads=1; NumThreads<=MaxThreads; NumThreads++ )
+	{
+		// SerializeCompressed picks up the window size from the global.
+		GDecompressionWindowSize = NumThreads;
+
+		DOUBLE StartTime = appSeconds();
+		for( INT Iteration=0; Iteration<Iterations; Iteration++ )
+		{
+			FMemoryReader Reader( CompressedData );
+			Reader.SerializeCompressed( DstData.GetData(), 0, Flags );
+		}
+		DOUBLE Duration = appSeconds() - StartTime;
+
+		check( appMemcmp( SrcData.GetData(), DstData.GetData(), SrcData.Num() ) == 0 );
+		warnf(TEXT("  %2i threads: %8.1f MB/s"), NumThreads, (DOUBLE) SrcData.Num() * Iterations / (1024.0 * 1024.0) / Max( Duration, 0.000001 ));
+	}
+	GDecompressionWindowSize = OldDecompressionWindowSize;
+}
+
 INT UTestCompressionCommandlet::Main(const FString& Params)
 {
 	// Parse command line args.
@@ -1689,6 +1744,32 @@ INT UTestCompressionCommandlet::Main(const FString& Params)
 		}
 	}
 
+	// Only measure decompression throughput at increasing thread counts, using ZLIB and LZO if no tests were specified.
+	if (ParseParam(*Params, TEXT("throughput")))
+	{
+		if (CompressionTests.Num() == 0)
+		{
+			CompressionTests.AddItem(COMPRESS_ZLIB);
+#if WITH_LZO
+			CompressionTests.AddItem(COMPRESS_LZO);
+#endif	//#if WITH_LZO
+		}
+		// The thread pool bounds how many chunks are actually decompressed at once.
+		INT MaxThreads = GNumHardwareThreads;
+		Parse(*Params, TEXT("maxthreads="), MaxThreads);
+		INT Iterations = 4;
+		Parse(*Params, TEXT("iterations="), Iterations);
+
+		for (INT FileIndex = 0; FileIndex < FilesToCompress.Num(); FileIndex++)
+		{
+			for (INT TestIndex = 0; TestIndex < CompressionTests.Num(); TestIndex++)
+			{
+				RunThroughputTest(FilesToCompress(FileIndex), (ECompressionFlags)CompressionTests(TestIndex), Max(MaxThreads, 1), Max(Iterations, 1));
+			}
+		}
+		return 0;
+	}
+
 	// keep overall stats
 	QWORD TotalUncompressedSize = 0;
 	QWORD TotalCompressedSize = 0;
@@ -609,6 +609,7 @@ void UEditorEngine::Tick( FLOAT DeltaSeconds )
 	{
 		GScriptCallGraph->Tick();
 	}
+	GScriptProfiler.Tick();
 }
 
 /**
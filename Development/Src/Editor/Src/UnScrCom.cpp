@@ -5243,6 +5243,7 @@ void FScriptCompiler::PushNest( ENestType NestType, FName ThisName, UStruct* InN
 				if (topState != NULL)
 				{
 					topState->FuncMap.Set(ThisName,func);
+					GScriptCallCacheEpoch++;
 				}
 			}
 			break;
@@ -82,8 +82,18 @@ struct native TimerData
 	var Name			FuncName;
 	var float			Rate, Count;
 	var Object			TimerObj;
+	/** Function FuncName resolved to for the class and state of TimerObj below, see FScriptCallCache */
+	var transient const native pointer	CachedFunction{class UFunction};
+	var transient const native pointer	CachedClass{class UClass};
+	var transient const native pointer	CachedState{class UState};
+	/** GScriptCallCacheEpoch at the time CachedFunction was looked up */
+	var transient const int				CachedEpoch;
 };
 var const array<TimerData>			Timers;			// list of currently active timers
+/** Time the actor has been ticked by that hasn't been added to its timers' Count yet, see FTimerWheel */
+var transient const float			TimerPendingSeconds;
+/** Set by the world's timer wheel while none of the actor's timers can have expired yet */
+var transient const bool			bTimersIdle;
 
 // Flags.
 var			  const bool	bStatic;			// Does not move or change over time. Don't let L.D.s change this - screws up net play
@@ -633,6 +643,18 @@ cpptext
 	 * @return TRUE if the actor was ticked, FALSE if it was aborted (e.g. because it's in stasis)
 	 */
 	virtual UBOOL Tick( FLOAT DeltaTime, enum ELevelTick TickType );
+	/**
+	 * Whether this actor's native tick is split into a TickParallel that only touches the actor's own state and a
+	 * regular Tick that applies anything involving shared state. The TickParallel of such actors is run in batches
+	 * on worker threads once the rest of their tick group has been ticked.
+	 */
+	virtual UBOOL CanTickInParallel() const { return FALSE; }
+	/**
+	 * Part of the tick that runs before Tick for actors that CanTickInParallel, possibly on a worker thread. It must
+	 * not spawn or destroy actors, move through the collision hash, call script or touch other actors; Tick is called
+	 * on the game thread afterwards to apply its results. It may run even if Tick then decides not to tick the actor.
+	 */
+	virtual void TickParallel( FLOAT DeltaTime, enum ELevelTick TickType ) {}
 	/* AActor::InStasis()
 	 * Called from AActor::Tick() if Actor->bStasis==true
 	 * @return true if this actor ands its components can safely not be ticked.
@@ -34,10 +34,13 @@ class UDemoRecConnection : public UNetConnection
 	FString LowLevelGetRemoteAddress();
 	FString LowLevelDescribe();
 	void LowLevelSend( void* Data, INT Count );
-	INT IsNetReady( UBOOL Saturate );
+	INT IsNetReady( UBOOL Saturate, ESendPriority Priority=SENDPRI_Movement );
 	void FlushNet();
 	void HandleClientPlayer( APlayerController* PC );
 
+	/** Whether packets are added to the snapshot of the keyframe being taken rather than written to the demo stream */
+	UBOOL bRecordsSnapshot;
+
 	// UDemoRecConnection functions.
 	/**
 	 * @return The DemoRecording driver object
@@ -45,10 +48,255 @@ class UDemoRecConnection : public UNetConnection
 	class UDemoRecDriver* GetDriver();
 };
 
+/*-----------------------------------------------------------------------------
+	Demo file archives.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Tag starting demo files with a header. Old demo files start with the delta time of their first frame,
+ * which being a positive float never has the sign bit set that is set in the tag.
+ */
+#define DEMO_FILE_TAG		0xD3A0B1C1
+/** Version of the demo file header and index. */
+#define DEMO_FILE_VERSION	2
+/** First version storing keyframe snapshots in the index. */
+#define DEMO_FILE_VERSION_SNAPSHOTS	2
+
+/** Flags stored in the demo file header. */
+enum EDemoFileFlags
+{
+	/** Blocks are zlib compressed unless compressing didn't make them smaller. */
+	DEMOFILE_Compressed	= 0x00000001,
+};
+
+/**
+ * Point in a demo playback can be started from. The actors with open channels are replicated in full to a
+ * connection of their own when the keyframe is taken, and those packets are kept with the keyframe rather
+ * than in the demo stream. Seeking plays them back on fresh channels and continues with the stream.
+ */
+struct FDemoKeyframe
+{
+	/** Demo time at the start of the frame the keyframe was taken in */
+	FLOAT		Time;
+	/** Frame the keyframe was taken in */
+	INT			FrameNum;
+	/** Offset of the first packet following the keyframe in the uncompressed demo stream */
+	INT			StreamOffset;
+	/** Id of the last packet sent before the keyframe */
+	INT			PacketId;
+	/** Channels that had reliable bunches sent on them, matching ReliableSequences */
+	TArray<INT>	ReliableChannels;
+	/** Sequence of the last reliable bunch sent on each of ReliableChannels */
+	TArray<INT>	ReliableSequences;
+	/** Packets reopening the actors, each preceded by its size. Stored after the keyframes in the index */
+	TArray<BYTE>	SnapshotData;
+
+	/** Serializes everything but SnapshotData, which didn't exist in the first file version. */
+	friend FArchive& operator<<( FArchive& Ar, FDemoKeyframe& Keyframe )
+	{
+		return Ar << Keyframe.Time << Keyframe.FrameNum << Keyframe.StreamOffset << Keyframe.PacketId << Keyframe.ReliableChannels << Keyframe.ReliableSequences;
+	}
+};
+
+/**
+ * Archive demos are recorded to. Data serialized on the game thread is handed to a dedicated thread
+ * through a lock free ring buffer, so disk stalls don't hitch the game unless the ring buffer fills up.
+ * The writer thread stores the stream in fixed size blocks that are optionally compressed. Keyframes
+ * and the file offsets of the blocks are written to an index at the end of the file when it is closed.
+ */
+class FDemoFileWriter : public FArchive, public FRunnable
+{
+public:
+	enum { RING_BUFFER_SIZE	= 4 * 1024 * 1024	};
+	enum { STAGING_SIZE		= 16 * 1024			};
+	enum { BLOCK_SIZE		= 128 * 1024		};
+
+	/**
+	 * Opens a demo file for writing and starts the writer thread. Data is written on the game thread
+	 * instead if the writer thread can't be started.
+	 *
+	 * @param	Filename	file to record to
+	 * @param	bCompress	whether to compress the blocks of the stream
+	 * @return	new writer, NULL if the file couldn't be opened
+	 */
+	static FDemoFileWriter* Create( const TCHAR* Filename, UBOOL bCompress );
+
+	/** Destructor, closing the file without an index if Finish hasn't been called. */
+	virtual ~FDemoFileWriter();
+
+	/**
+	 * Waits for the writer thread to write all data and finishes the file with the passed in keyframes.
+	 *
+	 * @param	Keyframes	keyframes taken while recording
+	 * @return	TRUE if the file was written without errors
+	 */
+	UBOOL Finish( const TArray<FDemoKeyframe>& Keyframes );
+
+	// FArchive interface.
+	virtual void Serialize( void* V, INT Length );
+	virtual INT Tell();
+	virtual void Flush();
+
+	// FRunnable interface.
+	virtual UBOOL Init();
+	virtual DWORD Run();
+	virtual void Stop();
+	virtual void Exit();
+
+private:
+	/**
+	 * Constructor, taking ownership of the file writer.
+	 *
+	 * @param	InFileAr	archive writing to the demo file
+	 * @param	bCompress	whether to compress the blocks of the stream
+	 */
+	FDemoFileWriter( FArchive* InFileAr, UBOOL bCompress );
+
+	/**
+	 * Writes the file header, with the index offset and stream size known once the file is closed.
+	 *
+	 * @param	IndexOffset	file offset of the index, 0 if there is none yet
+	 */
+	void WriteHeader( INT IndexOffset );
+
+	/** Stops the writer thread after it has written all data committed to the ring buffer. */
+	void StopThread();
+
+	/** Writes the block gathered by the writer thread to the file. */
+	void WriteBlock();
+
+	/**
+	 * Adds stream data to the current block, writing out blocks as they fill up.
+	 *
+	 * @param	Data	data to add
+	 * @param	Length	number of bytes to add
+	 */
+	void AppendToBlock( const BYTE* Data, INT Length );
+
+	/** Archive writing to the demo file */
+	FArchive*			FileAr;
+	/** Flags stored in the header, see EDemoFileFlags */
+	DWORD				Flags;
+	/** Ring buffer the game thread hands data to the writer thread with */
+	FRingBuffer			RingBuffer;
+	/** Data serialized since the last commit to the ring buffer, STAGING_SIZE bytes */
+	TArray<BYTE>		Staging;
+	/** Number of bytes used in Staging */
+	INT					StagedSize;
+	/** Size of the data committed to the ring buffer */
+	INT					CommittedSize;
+	/** Number of times committing to the ring buffer had to wait for the writer thread */
+	INT					NumStalls;
+	/** Thread writing the ring buffer's data to the file, NULL if data is written on the game thread */
+	FRunnableThread*	Thread;
+	/** Event triggered to wake up the writer thread */
+	FEvent*				WorkEvent;
+	/** If TRUE, the writer thread exits once it has drained the ring buffer */
+	volatile UBOOL		bTimeToDie;
+	/** Set by the writer thread if writing to the file failed */
+	volatile UBOOL		bWriteError;
+	/** Stream data gathered by the writer thread, BLOCK_SIZE bytes */
+	TArray<BYTE>		Block;
+	/** Number of bytes used in Block, written out once it reaches BLOCK_SIZE */
+	INT					BlockFill;
+	/** Scratch memory blocks are compressed into */
+	TArray<BYTE>		CompressedBlock;
+	/** File offsets of all blocks written */
+	TArray<INT>			BlockOffsets;
+};
+
+/**
+ * Archive reading demo files written by FDemoFileWriter. Seeks and tells are in terms of the
+ * uncompressed stream. Use CreateDemoFileReader to open demos that might predate the file format.
+ */
+class FDemoFileReader : public FArchive
+{
+public:
+	/**
+	 * Constructor, taking ownership of the file reader which needs to be positioned after the tag.
+	 *
+	 * @param	InFileAr	archive reading the demo file
+	 */
+	FDemoFileReader( FArchive* InFileAr );
+
+	/** Destructor, closing the file. */
+	virtual ~FDemoFileReader();
+
+	/** @return keyframes stored in the index, empty if the file wasn't closed properly */
+	const TArray<FDemoKeyframe>& GetKeyframes() const
+	{
+		return Keyframes;
+	}
+
+	// FArchive interface.
+	virtual void Serialize( void* V, INT Length );
+	virtual INT Tell();
+	virtual INT TotalSize();
+	virtual void Seek( INT InPos );
+
+private:
+	/**
+	 * Reads and decompresses a block.
+	 *
+	 * @param	BlockIndex	index of block to load
+	 * @return	TRUE if successful
+	 */
+	UBOOL LoadBlock( INT BlockIndex );
+
+	/** Archive reading the demo file */
+	FArchive*				FileAr;
+	/** Flags stored in the header, see EDemoFileFlags */
+	DWORD					Flags;
+	/** Uncompressed size of all blocks but the last */
+	INT						BlockSize;
+	/** Size of the uncompressed stream */
+	INT						StreamSize;
+	/** File offsets of all blocks */
+	TArray<INT>				BlockOffsets;
+	/** Keyframes stored in the index */
+	TArray<FDemoKeyframe>	Keyframes;
+	/** Index of the block in BlockData, INDEX_NONE if none is loaded */
+	INT						CurrentBlock;
+	/** Uncompressed data of the current block, BlockSize bytes */
+	TArray<BYTE>			BlockData;
+	/** Number of bytes used in BlockData */
+	INT						BlockDataSize;
+	/** Scratch memory compressed blocks are read into */
+	TArray<BYTE>			CompressedBlock;
+	/** Current position in the uncompressed stream */
+	INT						Pos;
+};
+
+/**
+ * Opens a demo file for reading, handling files recorded before demo files had a header.
+ *
+ * @param	Filename	demo file to open
+ * @param	Keyframes	[out] keyframes stored in the file, left empty if there are none
+ * @return	archive reading the demo stream, NULL if the file couldn't be opened
+ */
+FArchive* CreateDemoFileReader( const TCHAR* Filename, TArray<FDemoKeyframe>& Keyframes );
+
 /*-----------------------------------------------------------------------------
 	UDemoRecDriver.
 -----------------------------------------------------------------------------*/
 
+/** Bandwidth used by the actors of a class while recording a demo with bandwidth measuring enabled. */
+struct FDemoActorBandwidth
+{
+	/** Name of the actor class */
+	FName	ClassName;
+	/** Bytes sent replicating the actors, including the overhead of packets they filled up */
+	DOUBLE	Bytes;
+	/** Recorded time summed up over all actors of the class replicated */
+	DOUBLE	ActorSeconds;
+
+	FDemoActorBandwidth( FName InClassName )
+	:	ClassName( InClassName )
+	,	Bytes( 0.0 )
+	,	ActorSeconds( 0.0 )
+	{}
+};
+
 //
 // Simulated network driver for recording and playing back game sessions.
 //
@@ -69,6 +317,12 @@ class UDemoRecDriver : public UNetDriver
 	INT				PlayCount;
 	/** Allow for playback without doing any package version checking. Can be used to attempt to play a demo that wouldn't normally open */
 	UBOOL			bShouldSkipPackageChecking;
+	/** Whether bytes sent per actor are gathered while recording, enabled with ?measurebandwidth or DEMOBANDWIDTH */
+	UBOOL			bMeasureBandwidth;
+	/** Whether recorded demos are compressed, can also be enabled with ?compress */
+	UBOOL			bCompressDemos;
+	/** Seconds between keyframes playback can seek to, 0 to disable keyframes. Can be overridden with ?keyframeinterval= */
+	FLOAT			KeyframeInterval;
 
 	// Variables.
 	FString			DemoFilename;
@@ -82,6 +336,14 @@ class UDemoRecDriver : public UNetDriver
 	/** for capping client-side demo recording FPS. */
 	DOUBLE			LastClientRecordTime; 
 	FLOAT			DemoRecMultiFrameDeltaTime;
+	/** Bandwidth used per actor class since bandwidth measuring was enabled or last reset */
+	TMap<FName,FDemoActorBandwidth>	ActorClassBandwidth;
+	/** Recorded time bandwidth was measured for */
+	DOUBLE			BandwidthSeconds;
+	/** Time recorded or played back so far */
+	DOUBLE			DemoTime;
+	/** Keyframes taken while recording or read from the demo file for playback */
+	TArray<FDemoKeyframe>	Keyframes;
 
 
 	// Constructors.
@@ -106,6 +368,53 @@ class UDemoRecDriver : public UNetDriver
 	UBOOL InitBase( UBOOL Connect, FNetworkNotify* InNotify, const FURL& ConnectURL, FString& Error );
 	void SpawnDemoRecSpectator( UNetConnection* Connection );
 	UBOOL UpdateDemoTime( FLOAT* DeltaTime, FLOAT TimeDilation );
+
+	/**
+	 * Adds the data sent replicating an actor in the current recording frame to the bandwidth of its class.
+	 *
+	 * @param	Actor	actor that was replicated
+	 * @param	Bits	number of bits sent
+	 */
+	void RecordActorBandwidth( AActor* Actor, INT Bits );
+
+	/**
+	 * Logs the bandwidth used per actor class, in bytes per actor per second and bytes per second overall.
+	 *
+	 * @param	Ar	device to log to
+	 */
+	void DumpActorBandwidth( FOutputDevice& Ar );
+
+	/** Closes the demo file, writing the keyframe index if recording. */
+	void CloseDemoFile();
+
+	/** @return TRUE if a keyframe should be taken before replicating the frame that is being recorded */
+	UBOOL ShouldTakeKeyframe();
+
+	/**
+	 * Remembers the stream position as a keyframe and sets up the connection its snapshot is recorded with,
+	 * which has a channel for every actor with an open channel but the demo spectator's. Called before
+	 * replicating the frame, the caller replicates the actors to the snapshot connection and calls EndKeyframe.
+	 *
+	 * @return	connection to replicate the snapshot to
+	 */
+	UNetConnection* BeginKeyframe();
+
+	/**
+	 * Finishes the snapshot of the keyframe being taken and throws the snapshot connection away without
+	 * sending anything, the actors stay open on the channels of the demo connection.
+	 *
+	 * @param	SnapshotConnection	connection returned by BeginKeyframe
+	 */
+	void EndKeyframe( UNetConnection* SnapshotConnection );
+
+	/**
+	 * Jumps playback to the last keyframe at or before the passed in time.
+	 *
+	 * @param	Time	demo time to seek to
+	 * @param	Ar		device to report errors to
+	 * @return	TRUE if a keyframe was found
+	 */
+	UBOOL SeekToTime( FLOAT Time, FOutputDevice& Ar );
 };
 
 
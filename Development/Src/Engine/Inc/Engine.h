@@ -235,6 +235,7 @@ struct FURL;
 #include "ShaderCompiler.h"					// Platform independent shader compilation definitions.
 #include "RHI.h"							// Common RHI definitions.
 #include "RenderingThread.h"				// Rendering thread definitions.
+#include "UnFrameArena.h"					// Frame scoped linear allocator.
 #include "RenderResource.h"					// Render resource definitions.
 #include "RHIStaticStates.h"				// RHI static state template definition.
 #include "RawIndexBuffer.h"					// Raw index buffer definitions.
@@ -281,6 +282,7 @@ struct FURL;
 #include "UnPhysic.h"						// Physics constants
 #include "EngineGameEngineClasses.h"		// Main Unreal engine declarations
 #include "UnLevel.h"						// Level object.
+#include "UnTimerWheel.h"					// Actor timer wheel.
 #include "UnWorld.h"						// World object.
 #include "UnKeys.h"							// Key name definitions.
 #include "UnUIKeys.h"						// UI key name definitions.
@@ -913,6 +913,10 @@ struct FTimerData
     FLOAT Rate;
     FLOAT Count;
     class UObject* TimerObj;
+    class UFunction* CachedFunction;
+    class UClass* CachedClass;
+    class UState* CachedState;
+    INT CachedEpoch;
 };
 
 struct FTraceHitInfo
@@ -1524,6 +1528,7 @@ public:
     class AActor* Owner;
     class AActor* Base;
     TArrayNoInit<struct FTimerData> Timers;
+    FLOAT TimerPendingSeconds;
     BITFIELD bStatic:1;
     BITFIELD bHidden:1;
     BITFIELD bNoDelete:1;
@@ -1591,6 +1596,7 @@ public:
     BITFIELD bPathColliding:1;
     BITFIELD bScriptInitialized:1;
     BITFIELD bLockLocation:1;
+    BITFIELD bTimersIdle:1;
     BITFIELD bTicked:1;
     BITFIELD bNetDirty:1;
     BITFIELD BlockRigidBody:1;
@@ -2582,6 +2588,18 @@ public:
 	 * @return TRUE if the actor was ticked, FALSE if it was aborted (e.g. because it's in stasis)
 	 */
 	virtual UBOOL Tick( FLOAT DeltaTime, enum ELevelTick TickType );
+	/**
+	 * Whether this actor's native tick is split into a TickParallel that only touches the actor's own state and a
+	 * regular Tick that applies anything involving shared state. The TickParallel of such actors is run in batches
+	 * on worker threads once the rest of their tick group has been ticked.
+	 */
+	virtual UBOOL CanTickInParallel() const { return FALSE; }
+	/**
+	 * Part of the tick that runs before Tick for actors that CanTickInParallel, possibly on a worker thread. It must
+	 * not spawn or destroy actors, move through the collision hash, call script or touch other actors; Tick is called
+	 * on the game thread afterwards to apply its results. It may run even if Tick then decides not to tick the actor.
+	 */
+	virtual void TickParallel( FLOAT DeltaTime, enum ELevelTick TickType ) {}
 	/* AActor::InStasis()
 	 * Called from AActor::Tick() if Actor->bStasis==true
 	 * @return true if this actor ands its components can safely not be ticked.
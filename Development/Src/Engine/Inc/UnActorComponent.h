@@ -108,6 +108,27 @@ public:
 	 */
 	void ConditionalTick(FLOAT DeltaTime);
 
+	/**
+	 * Conditionally calls TickParallel if bAttached == true.
+	 * @param DeltaTime - The time since the last tick.
+	 */
+	void ConditionalTickParallel(FLOAT DeltaTime);
+
+	/**
+	 * Whether this component's TickParallel only touches the component's own state, which allows it to be run
+	 * on a worker thread alongside other components of the same tick group.
+	 */
+	virtual UBOOL CanTickInParallel() const { return FALSE; }
+
+	/**
+	 * Part of the tick that runs before Tick for components that CanTickInParallel. It runs on a worker thread when
+	 * the component is ticked as part of a deferred tick group and on the game thread otherwise. It must not touch
+	 * other components or actors, the scene, the collision hash or script; Tick applies its results instead.
+	 * Requires bAttached == true.
+	 * @param DeltaTime - The time since the last tick.
+	 */
+	virtual void TickParallel(FLOAT DeltaTime) {}
+
 	/**
 	 * Returns whether the component's owner is selected.
 	 */
@@ -273,4 +273,32 @@ struct FBoneAtom
 
 template <> class TTypeInfo<FBoneAtom> : public TTypeInfoAtomicBase<FBoneAtom> {};
 
+/**
+ * Scratch array of bone atoms used while blending. GetBoneAtoms recurses through the tree so the
+ * atoms can't live on the stack; instead allocations are recycled through a small pool when used
+ * from the game thread, which keeps blending off the heap once the pool has warmed up.
+ */
+class FBoneAtomArray : public TArray<FBoneAtom>
+{
+public:
+	/** Takes an allocation from the pool if one is available. */
+	FBoneAtomArray();
+
+	/** Hands the allocation back to the pool, freeing it if the pool is full. */
+	~FBoneAtomArray();
+
+private:
+	/** Maximum number of allocations kept around, enough for the nesting depth of typical trees. */
+	enum { MAX_POOLED_ARRAYS = 32 };
+
+	/** Allocations not currently in use. Only accessed from the game thread. */
+	static TArray<FBoneAtom>	Pool[MAX_POOLED_ARRAYS];
+	/** Number of valid entries in Pool. */
+	static INT					NumPooled;
+
+	/** Not copyable, copies would share the pooled allocation. */
+	FBoneAtomArray( const FBoneAtomArray& );
+	FBoneAtomArray& operator=( const FBoneAtomArray& );
+};
+
 #endif // __UNANIMTREE_H__
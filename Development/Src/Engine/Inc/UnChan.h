@@ -45,6 +45,7 @@ class UChannel : public UObject
 	virtual FString Describe();
 	virtual void ReceivedBunch( FInBunch& Bunch ) PURE_VIRTUAL(UChannel::ReceivedBunch,);
 	virtual void ReceivedNak( INT NakPacketId );
+	virtual void ReceivedAck( INT AckPacketId );
 	virtual void Tick();
 
 	// General channel functions.
@@ -52,7 +53,7 @@ class UChannel : public UObject
 	UBOOL ReceivedSequencedBunch( FInBunch& Bunch );
 	void ReceivedRawBunch( FInBunch& Bunch );
 	INT SendBunch( FOutBunch* Bunch, UBOOL Merge );
-	INT IsNetReady( UBOOL Saturate );
+	INT IsNetReady( UBOOL Saturate, ESendPriority Priority=SENDPRI_Movement );
 	void AssertInSequenced();
 	INT MaxSendBytes();
 
@@ -135,6 +136,130 @@ class UControlChannel : public UChannel, public FOutputDevice
 	FString Describe();
 };
 
+/*-----------------------------------------------------------------------------
+	FNetDeltaHistory.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Values of a replicated vector or rotator recently sent or received by an actor channel, used to delta compress
+ * the property against a value the other side is known to have.
+ *
+ * Property bunches are unreliable so the sender can't assume the value in Recent arrived. Instead every value sent
+ * in an unreliable bunch gets a sequence number, and once the packet it was sent in is acked it may serve as the
+ * baseline of the sequence numbers that follow within HISTORY_SIZE. Lost packets are never acked, so values keep
+ * being sent in full till one of them arrives. Values are kept quantized the way they are sent in full so both sides
+ * add the delta to the same baseline.
+ */
+struct FNetDeltaHistory
+{
+	/** Number of values remembered, a power of two. Deltas are only sent against values this many sequence numbers back */
+	enum { HISTORY_SIZE			= 8			};
+	/** Sequence numbers of values sent in full are sent modulo this */
+	enum { MAX_FULL_SEQUENCE	= 256		};
+	/** Sequence numbers of deltas are sent modulo this, they are at most HISTORY_SIZE ahead of the last received one */
+	enum { MAX_DELTA_SEQUENCE	= 16		};
+	/** Vector components only get delta compressed if the delta is below 1<<MAX_VECTOR_DELTA_BITS */
+	enum { MAX_VECTOR_DELTA_BITS = 16		};
+
+	/** Quantized value with its sequence number */
+	struct FEntry
+	{
+		/** sequence number of the value, INDEX_NONE if unused */
+		INT		Sequence;
+		/** packet the value was sent in, INDEX_NONE if unknown (sender only) */
+		INT		OutPacketId;
+		/** whether that packet was acked (sender only) */
+		UBOOL	bAcked;
+		/** quantized components */
+		INT		Value[3];
+	};
+
+	/** Entries, indexed by sequence number modulo HISTORY_SIZE */
+	FEntry	Entries[HISTORY_SIZE];
+	/** Last sequence number assigned by the sender, highest sequence number received by the receiver */
+	INT		LastSequence;
+	/** Whether the value was written to the bunch being built, waiting for its packet id */
+	UBOOL	bPendingSend;
+	/** Whether the property is a rotator rather than a vector */
+	UBOOL	bRotator;
+
+	/**
+	 * Constructor, initializing an empty history.
+	 *
+	 * @param	bInRotator	whether the property is a rotator rather than a vector
+	 */
+	FNetDeltaHistory( UBOOL bInRotator );
+
+	/**
+	 * Quantizes a property value the way UStructProperty::NetSerializeItem sends it.
+	 *
+	 * @param	Data	vector or rotator
+	 * @param	Value	[out] quantized components
+	 */
+	void Quantize( const BYTE* Data, INT* Value ) const;
+
+	/**
+	 * Sets a property value from its quantized components.
+	 *
+	 * @param	Value	quantized components
+	 * @param	Data	[out] vector or rotator
+	 */
+	void Dequantize( const INT* Value, BYTE* Data ) const;
+
+	/**
+	 * Serializes the difference between two quantized values, sized by the magnitude of the difference.
+	 *
+	 * @param	Ar		bunch to serialize to or from
+	 * @param	Delta	[in/out] difference of components
+	 * @return	FALSE if the difference is too large to be delta compressed (saving only)
+	 */
+	UBOOL SerializeDelta( FArchive& Ar, INT* Delta ) const;
+
+	/**
+	 * Finds the most recent acked entry a value with the passed in sequence number may be sent as a delta of.
+	 *
+	 * @param	Sequence	sequence number of the value to send
+	 * @return	baseline entry, NULL if there is none
+	 */
+	const FEntry* FindBaseline( INT Sequence ) const;
+
+	/**
+	 * Remembers a value. Values older than the one in its slot are ignored, they were received out of order.
+	 *
+	 * @param	Sequence	sequence number of the value
+	 * @param	Value		quantized components
+	 * @param	bAcked		whether the other side is known to have the value
+	 */
+	void AddValue( INT Sequence, const INT* Value, UBOOL bAcked );
+
+	/** Forgets all values, so the next one is sent in full. Sequence numbers carry on. */
+	void ForgetValues()
+	{
+		for( INT i=0; i<HISTORY_SIZE; i++ )
+		{
+			Entries[i].Sequence		= INDEX_NONE;
+			Entries[i].OutPacketId	= INDEX_NONE;
+			Entries[i].bAcked		= FALSE;
+		}
+	}
+
+	/**
+	 * Marks the values sent in the passed in packet as acked.
+	 *
+	 * @param	AckPacketId	packet that was acked
+	 */
+	void ReceivedAck( INT AckPacketId )
+	{
+		for( INT i=0; i<HISTORY_SIZE; i++ )
+		{
+			if( Entries[i].OutPacketId==AckPacketId )
+			{
+				Entries[i].bAcked = TRUE;
+			}
+		}
+	}
+};
+
 /*-----------------------------------------------------------------------------
 	UActorChannel.
 -----------------------------------------------------------------------------*/
@@ -170,6 +295,14 @@ class UActorChannel : public UChannel
 	 * this is used to NULL Recent's references to Actors that lose relevancy
 	 */
 	TArray<UObjectProperty*> ReplicatedActorProperties;
+	/** history index of the actor's FPropertyChangeHistory this channel is up to date with, INDEX_NONE if unknown */
+	INT LastPropertyHistoryIndex;
+	/** properties that may differ from their Recent value as they weren't sent, bit per ClassReps entry */
+	TArray<DWORD> UnsentPropertyMask;
+	/** index into DeltaHistories per ClassReps entry, INDEX_NONE for properties that aren't delta compressed; empty if the connection doesn't delta compress */
+	TArray<INT> DeltaHistoryIndices;
+	/** values of delta compressed vector and rotator properties, see FNetDeltaHistory */
+	TArray<FNetDeltaHistory> DeltaHistories;
 
 	// Constructor.
 	void StaticConstructor();
@@ -191,6 +324,7 @@ class UActorChannel : public UChannel
 	virtual void SetClosingFlag();
 	virtual void ReceivedBunch( FInBunch& Bunch );
 	virtual void ReceivedNak( INT NakPacketId );
+	virtual void ReceivedAck( INT AckPacketId );
 	virtual void Close();
 
 	// UActorChannel interface and accessors.
@@ -200,6 +334,28 @@ class UActorChannel : public UChannel
 	void SetChannelActor( AActor* InActor );
 
 protected:
+	/**
+	 * Sends a delta compressed property, as a delta of the most recent acked value if possible and in full otherwise.
+	 *
+	 * @param	Bunch		bunch to write to
+	 * @param	History		values previously sent
+	 * @param	Property	vector or rotator property
+	 * @param	Data		value to send
+	 * @return	TRUE, vectors and rotators are always mapped
+	 */
+	UBOOL SendDeltaProperty( FOutBunch& Bunch, FNetDeltaHistory& History, UProperty* Property, BYTE* Data );
+
+	/**
+	 * Receives a property sent by SendDeltaProperty. Data is left untouched if the baseline of a delta is missing.
+	 *
+	 * @param	Bunch		bunch to read from
+	 * @param	History		values previously received
+	 * @param	Property	vector or rotator property
+	 * @param	Data		[out] received value
+	 */
+	void ReceiveDeltaProperty( FInBunch& Bunch, FNetDeltaHistory& History, UProperty* Property, BYTE* Data );
+
+
 	/** cleans up channel structures and NULLs references to the channel */
 	virtual void CleanUp();
 };
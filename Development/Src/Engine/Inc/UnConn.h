@@ -52,6 +52,53 @@ struct DelayedPacket
 };
 #endif
 
+/**
+ * Priority classes of outgoing data, deciding what is held back first while a paced connection is saturated.
+ */
+enum ESendPriority
+{
+	SENDPRI_Reliable	= 0,	// Reliable RPCs and control messages, never held back.
+	SENDPRI_Movement	= 1,	// Updates of actors the remote side already knows about, unreliable RPCs.
+	SENDPRI_Bulk		= 2,	// Initial state of newly relevant actors, file downloads.
+	SENDPRI_MAX			= 3,
+};
+
+/**
+ * Finished packet waiting in a connection's send queue, its data is kept in UNetConnection::SendQueueData.
+ */
+struct FQueuedPacket
+{
+	/** Size of the packet in bytes. */
+	INT		Size;
+	/** Id of the packet, for lag measurement once it is sent. */
+	INT		PacketId;
+	/** Time the packet was queued at. */
+	DOUBLE	QueueTime;
+};
+
+/**
+ * Send statistics of a connection, gathered over one stat period.
+ */
+struct FConnectionSendStats
+{
+	/** Number of packets sent. */
+	INT		PacketsSent;
+	/** Number of bytes sent, including packet overhead. */
+	INT		BytesSent;
+	/** Number of packets the remote side didn't acknowledge. */
+	INT		PacketsLost;
+	/** Number of packets that had to wait for the token bucket. */
+	INT		PacketsDelayed;
+	/** Sum of the time packets spent in the send queue. */
+	FLOAT	QueueDelayAcc;
+	/** Longest time a packet spent in the send queue. */
+	FLOAT	MaxQueueDelay;
+	/** Number of times data was held back, per ESendPriority. */
+	INT		HeldBack[SENDPRI_MAX];
+	/** Pacing rate at the end of the period, in bytes per second. */
+	FLOAT	SendRate;
+};
+
 struct FDownloadInfo
 {
 	UClass* Class;
@@ -81,6 +128,8 @@ class UNetConnection : public UPlayer, public FOutputDevice
 	UBOOL				bNeedsByteSwapping;
 	/** whether the server has welcomed this client (i.e. called UWorld::WelcomePlayer() for it) */
 	UBOOL				bWelcomed;
+	/** whether replicated vectors and rotators are delta compressed, negotiated through the WELCOME message */
+	UBOOL				bDeltaCompressVectors;
 
 	// Negotiated parameters.
 	INT				ProtocolVersion;		// Protocol version we're communicating with (<=PROTOCOL_VERSION).
@@ -133,6 +182,24 @@ class UNetConnection : public UPlayer, public FOutputDevice
 	INT				OutPacketId;			// Most recently sent packet.
 	INT 			OutAckPacketId;			// Most recently acked outgoing packet.
 
+	// Send pacing, only used if the driver's bPaceConnections is set.
+	/** Finished packets waiting for the token bucket, back to back */
+	TArray<BYTE>	SendQueueData;
+	/** Packets in SendQueueData, oldest first */
+	TArray<FQueuedPacket> SendQueue;
+	/** Bytes the token bucket allows to send right away, negative if a packet was sent on credit */
+	FLOAT			SendTokens;
+	/** Rate the token bucket is refilled at in bytes per second, adapted to measured loss and lag */
+	FLOAT			SendRate;
+	/** Last time the token bucket was refilled */
+	DOUBLE			LastSendTokenTime;
+	/** Lowest average lag measured, lag well above it is considered queueing on the way to the remote side */
+	FLOAT			MinAvgLag;
+	/** Send statistics of the current stat period */
+	FConnectionSendStats SendStats;
+	/** Send statistics of the last complete stat period */
+	FConnectionSendStats LastSendStats;
+
 	// Channel table.
 	UChannel*  Channels     [ MAX_CHANNELS ];
 	INT        OutReliable  [ MAX_CHANNELS ];
@@ -140,7 +207,8 @@ class UNetConnection : public UPlayer, public FOutputDevice
 	INT		PendingOutRec[ MAX_CHANNELS ];	// Outgoing reliable unacked data from previous (now destroyed) channel in this slot.  This contains the first chsequence not acked
 	TArray<INT> QueuedAcks, ResendAcks;
 	TArray<UChannel*> OpenChannels;
-	TArray<AActor*> SentTemporaries;
+	/** Temporary actors sent over this connection, a map so lookups while building priority lists stay cheap. */
+	TMap<AActor*,UBOOL> SentTemporaries;
 	TMap<AActor*,UActorChannel*> ActorChannels;
 
 	// File Download
@@ -216,7 +284,13 @@ class UNetConnection : public UPlayer, public FOutputDevice
 	virtual void SendAck( INT PacketId, UBOOL FirstTime=1 );
 	virtual void FlushNet();
 	virtual void Tick();
-	virtual INT IsNetReady( UBOOL Saturate );
+	/**
+	 * Returns whether more data can be sent without saturating the connection.
+	 *
+	 * @param Saturate whether to ignore the configured rate, see UFileChannel::Tick
+	 * @param Priority priority class of the data, only used by paced connections
+	 */
+	virtual INT IsNetReady( UBOOL Saturate, ESendPriority Priority=SENDPRI_Movement );
 	virtual void HandleClientPlayer( APlayerController* PC );
 	virtual void SetActorDirty(AActor* DirtyActor);
 	/** closes the connection (including sending a close notify across the network) */
@@ -254,6 +328,29 @@ class UNetConnection : public UPlayer, public FOutputDevice
 	void PreSend( INT SizeBits );
 	void PostSend();
 
+	/** @return whether outgoing packets are queued and paced by a token bucket, see UNetDriver::bPaceConnections */
+	UBOOL IsSendPaced() const;
+	/**
+	 * Hands a finished packet to the socket, applying the packet simulation settings.
+	 *
+	 * @param Data the packet to send
+	 * @param Count the size of the packet
+	 * @param PacketId the id of the packet, for lag measurement
+	 */
+	void SendPacket( BYTE* Data, INT Count, INT PacketId );
+	/** Refills the token bucket according to the time passed since the last refill */
+	void RefillSendTokens();
+	/**
+	 * Sends queued packets as far as the token bucket allows.
+	 *
+	 * @param bForce whether to send all queued packets regardless of the bucket, e.g. when closing
+	 */
+	void SendQueuedPackets( UBOOL bForce=FALSE );
+	/** Adapts the pacing rate to the loss and lag measured over the last stat period */
+	void UpdateSendRate();
+	/** Prints the send statistics of the last stat period */
+	void LogSendStats( FOutputDevice& Ar );
+
 	/** parses the passed in string and fills the given package info struct with that data
 	 * @param Text pointer to the string
 	 * @param Info (out) FPackageInfo that receives the parsed data
@@ -353,9 +450,9 @@ public:
 	{
 		Parent->FlushNet();
 	}
-	virtual INT IsNetReady(UBOOL Saturate)
+	virtual INT IsNetReady(UBOOL Saturate, ESendPriority Priority=SENDPRI_Movement)
 	{
-		return Parent->IsNetReady(Saturate);
+		return Parent->IsNetReady(Saturate, Priority);
 	}
 	void SetActorDirty(AActor* DirtyActor)
 	{
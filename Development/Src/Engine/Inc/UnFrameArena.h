@@ -0,0 +1,230 @@
+/*=============================================================================
+	UnFrameArena.h: Frame scoped linear allocator shared by the game and rendering threads.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#ifndef _UNFRAMEARENA_H
+#define _UNFRAMEARENA_H
+
+/*-----------------------------------------------------------------------------
+	FFrameArena.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Double buffered linear allocator for data that lives no longer than the frame it was allocated in.
+ *
+ * Every frame owns one of two slots. The game thread and any thread working on its behalf allocate
+ * from the slot of the frame being ticked, the rendering thread allocates from the slot of the frame
+ * it is currently executing commands for. Each thread has its own sub-arena per slot so allocating
+ * never takes a lock unless a new chunk is needed.
+ *
+ * A slot is released wholesale by BeginFrame once the fence of the frame that used it has retired,
+ * i.e. once the rendering thread is done with every command enqueued during that frame. This makes
+ * the arena suitable for render command payloads allocated on the game thread. Threads other than
+ * the game and rendering thread must be done with their allocations before the frame ends.
+ *
+ * Use it like GMem, including FFrameArenaMark for scoped allocations:
+ *
+ *	FFrameArenaMark Mark(GFrameArena);
+ *	AActor** List = new(GFrameArena,Count) AActor*;
+ *	...
+ *	Mark.Pop();
+ *
+ * Objects with destructors need to be destructed manually, their memory is never freed individually.
+ */
+class FFrameArena
+{
+public:
+	enum { NUM_SLOTS			= 2				};
+	enum { DEFAULT_CHUNK_SIZE	= 65536			};
+	enum { CHUNK_HEADER_SIZE	= 16			};
+
+	/** Chunk of memory the sub-arenas allocate from, data follows the header. */
+	struct FChunk
+	{
+		/** Next chunk in the same sub-arena or the free pool. */
+		FChunk*	Next;
+		/** Size of the data following the header. */
+		INT		DataSize;
+
+		/** @return first byte of the chunk's data */
+		BYTE* GetData()
+		{
+			return (BYTE*) this + CHUNK_HEADER_SIZE;
+		}
+	};
+
+	/** Linear allocation state of a thread for a single slot. */
+	struct FSubArena
+	{
+		/** Top of the current chunk (Top<=End). */
+		BYTE*	Top;
+		/** End of the current chunk. */
+		BYTE*	End;
+		/** Current chunk, linked to the previously used ones. */
+		FChunk*	TopChunk;
+		/** Size of all chunks in use. */
+		INT		ChunkBytes;
+		/** Largest ChunkBytes since the slot was last released, gathered for stats. */
+		INT		PeakChunkBytes;
+	};
+
+	/** State of a thread that allocated from the arena. */
+	struct FThreadState
+	{
+		/** Sub-arena per slot. */
+		FSubArena		SubArenas[NUM_SLOTS];
+		/** Next state in the list of all thread states. */
+		FThreadState*	Next;
+	};
+
+	/** Constructor, initializing member variables. */
+	FFrameArena();
+
+	/**
+	 * Allocates uninitialized memory that stays valid till the current frame has been rendered.
+	 *
+	 * @param	Size	size of allocation in bytes
+	 * @param	Align	alignment of allocation, needs to be a power of two
+	 * @return	allocated memory, never NULL
+	 */
+	BYTE* PushBytes( INT Size, INT Align )
+	{
+		checkSlow(Size>=0);
+		checkSlow((Align&(Align-1))==0);
+
+		FSubArena& SubArena = GetSubArena();
+		BYTE* Result = (BYTE*)(((PTRINT)SubArena.Top+(Align-1))&~(Align-1));
+		if( Result + Size > SubArena.End )
+		{
+			AllocateNewChunk( SubArena, Size + Align );
+			Result = (BYTE*)(((PTRINT)SubArena.Top+(Align-1))&~(Align-1));
+		}
+		SubArena.Top = Result + Size;
+		return Result;
+	}
+
+	/**
+	 * Starts a new frame, releasing the memory of the frame that used the same slot before. Waits for
+	 * that frame to be rendered if necessary. Must be called from the game thread.
+	 */
+	void BeginFrame();
+
+	/**
+	 * Frees all memory held by the arena. Must be called after the rendering thread has been stopped.
+	 */
+	void Exit();
+
+	/** @return sub-arena the calling thread allocates from */
+	FSubArena& GetSubArena();
+
+private:
+	friend class FFrameArenaMark;
+
+	/**
+	 * Makes a new chunk the top chunk of the passed in sub-arena.
+	 *
+	 * @param	SubArena	sub-arena to add chunk to
+	 * @param	MinSize		minimum size of chunk's data
+	 */
+	void AllocateNewChunk( FSubArena& SubArena, INT MinSize );
+
+	/**
+	 * Hands chunks of the passed in sub-arena back to the pool until NewTopChunk is the top chunk.
+	 *
+	 * @param	SubArena	sub-arena to free chunks of
+	 * @param	NewTopChunk	chunk to stop at, NULL to free all chunks
+	 */
+	void FreeChunks( FSubArena& SubArena, FChunk* NewTopChunk );
+
+	/**
+	 * Releases all memory allocated from the passed in slot by any thread.
+	 *
+	 * @param	Slot	slot to release
+	 * @return	largest size of chunks that were in use at once, in bytes
+	 */
+	INT ResetSlot( INT Slot );
+
+	/** Slot the game thread and its helpers allocate from. */
+	volatile INT		GameSlot;
+	/** Slot the rendering thread allocates from. */
+	volatile INT		RenderSlot;
+	/** Fences of the last frame that used each slot. */
+	FRenderCommandFence	SlotFences[NUM_SLOTS];
+	/** TLS slot holding each thread's FThreadState. */
+	DWORD				ThreadStateTlsSlot;
+	/** All thread states. */
+	FThreadState*		ThreadStates;
+	/** Guards ThreadStates. */
+	FCriticalSection	ThreadStatesCriticalSection;
+	/** Pool of unused DEFAULT_CHUNK_SIZE chunks. */
+	FChunk*				FreeChunkPool;
+	/** Guards FreeChunkPool. */
+	FCriticalSection	FreeChunkPoolCriticalSection;
+	/** Largest amount of memory used by a single frame. */
+	INT					PeakFrameBytes;
+};
+
+/** Global frame arena. */
+extern FFrameArena GFrameArena;
+
+/*-----------------------------------------------------------------------------
+	FFrameArena operator new's.
+-----------------------------------------------------------------------------*/
+
+/** Operator new for frame arena allocation. */
+inline void* operator new( size_t Size, FFrameArena& Arena, INT Count=1, INT Align=DEFAULT_ALIGNMENT )
+{
+	return Arena.PushBytes( Size*Count, Align );
+}
+inline void* operator new( size_t Size, FFrameArena& Arena, EMemZeroed Tag, INT Count=1, INT Align=DEFAULT_ALIGNMENT )
+{
+	BYTE* Result = Arena.PushBytes( Size*Count, Align );
+	appMemzero( Result, Size*Count );
+	return Result;
+}
+
+/*-----------------------------------------------------------------------------
+	FFrameArenaMark.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Marks the calling thread's top of stack position in the frame arena, allowing to release anything
+ * allocated after it before the end of the frame. Needs to be popped on the thread that created it.
+ */
+class FFrameArenaMark
+{
+public:
+	FFrameArenaMark( FFrameArena& InArena )
+	:	Arena( &InArena )
+	,	SubArena( &InArena.GetSubArena() )
+	,	Top( SubArena->Top )
+	,	End( SubArena->End )
+	,	SavedChunk( SubArena->TopChunk )
+	{}
+
+	/** Releases everything allocated from the sub-arena since the mark was created. */
+	void Pop()
+	{
+		checkSlow(SubArena == &Arena->GetSubArena());
+		if( SavedChunk != SubArena->TopChunk )
+		{
+			Arena->FreeChunks( *SubArena, SavedChunk );
+		}
+		SubArena->Top = Top;
+		SubArena->End = End;
+	}
+
+private:
+	FFrameArena*			Arena;
+	FFrameArena::FSubArena*	SubArena;
+	BYTE*					Top;
+	BYTE*					End;
+	FFrameArena::FChunk*	SavedChunk;
+};
+
+#endif	// _UNFRAMEARENA_H
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -670,6 +670,26 @@ class ULevel : public ULevelBase
 	void ResetNavList();
 };
 
+/*-----------------------------------------------------------------------------
+	Parallel ticking.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Calls TickParallel on a set of actors and components, spreading the work
+ * across the game thread and GThreadPool workers. Only returns once all of
+ * them are done, which is the sync point after which their regular ticks
+ * apply anything involving shared state on the game thread. Actors that are
+ * pending kill by the time their batch is reached are skipped.
+ *
+ * @param Actors actors that can tick in parallel
+ * @param Components components that can tick in parallel
+ * @param DeltaSeconds time in seconds since last tick
+ * @param TickType type of tick (viewports only, time only, etc)
+ */
+void TickInParallel(const TArray<class AActor*>& Actors,
+	const TArray<class UActorComponent*>& Components,FLOAT DeltaSeconds,
+	ELevelTick TickType);
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
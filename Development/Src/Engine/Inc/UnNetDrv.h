@@ -88,7 +88,218 @@ enum ENetStats
 	STAT_InBunches,
 	STAT_OutBunches,
 	STAT_OutLoss,
-	STAT_InLoss
+	STAT_InLoss,
+	STAT_NetReplicateActorTime,
+	STAT_NetPropertyCompareTime,
+	STAT_NetSendQueueBytes,
+	STAT_NetHeldBackSends
+};
+
+/*-----------------------------------------------------------------------------
+	FPropertyChangeHistory.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Keeps track of which script replicated properties of an actor changed during the last few replication
+ * passes of a net driver. The actor is compared against a shadow copy of its properties once per pass and
+ * the changed properties are recorded as a bit per ClassReps entry. Actor channels then only need to compare
+ * the properties that changed since they last replicated the actor, plus the ones they couldn't send, against
+ * their Recent values. This relies on actors not being modified while a pass replicates them.
+ *
+ * Native replicated properties are left to GetOptimizedRepList and object properties are always compared by
+ * the channel as whether they can be sent depends on the connection's package map.
+ */
+class FPropertyChangeHistory
+{
+public:
+	/** Number of passes changes are remembered for. Channels that fall further behind compare everything. */
+	enum { HISTORY_SIZE = 16 };
+
+	/**
+	 * Constructor, initializing the shadow copy to the class defaults.
+	 *
+	 * @param	InActorClass	class of the actor the history is for
+	 */
+	FPropertyChangeHistory( UClass* InActorClass );
+
+	/** Destructor, destroying the shadow copy. */
+	~FPropertyChangeHistory();
+
+	/**
+	 * Compares the actor against the shadow copy and records the changed properties as a new history entry.
+	 *
+	 * @param	Actor				actor to compare, needs to be of ActorClass
+	 * @param	ReplicationPass		replication pass of the net driver the comparison is done for
+	 */
+	void Update( AActor* Actor, INT ReplicationPass );
+
+	/**
+	 * Adds the properties that changed since the passed in history index to the mask.
+	 *
+	 * @param	InHistoryIndex	history index the caller is up to date with
+	 * @param	Mask			mask of GetMaskSize() DWORDs to OR the changed properties into
+	 * @return	FALSE if the index is too old to tell, in which case Mask is left untouched
+	 */
+	UBOOL GetChangedSince( INT InHistoryIndex, DWORD* Mask ) const;
+
+	/** @return class of the actor */
+	UClass* GetActorClass() const
+	{
+		return ActorClass;
+	}
+	/** @return number of DWORDs in a property mask */
+	INT GetMaskSize() const
+	{
+		return MaskSize;
+	}
+	/** @return mask of the properties channels always need to compare themselves */
+	const DWORD* GetAlwaysCompareMask() const
+	{
+		return &AlwaysCompareMask(0);
+	}
+	/** @return history index following the last entry */
+	INT GetHistoryIndex() const
+	{
+		return HistoryIndex;
+	}
+	/** @return replication pass of the last Update */
+	INT GetLastReplicationPass() const
+	{
+		return LastReplicationPass;
+	}
+
+private:
+	/** Class of the actor. */
+	UClass*			ActorClass;
+	/** ClassReps indices of the properties compared against the shadow copy. */
+	TArray<INT>		ComparedReps;
+	/** Properties channels always need to compare themselves. */
+	TArray<DWORD>	AlwaysCompareMask;
+	/** Property values as of the last Update, laid out like an instance of ActorClass. */
+	TArray<BYTE>	Shadow;
+	/** HISTORY_SIZE masks of MaskSize DWORDs each, entry i is stored at i % HISTORY_SIZE. */
+	TArray<DWORD>	ChangedMasks;
+	/** Number of DWORDs in a property mask, one bit per ClassReps entry but at least one. */
+	INT				MaskSize;
+	/** Index of the next history entry. */
+	INT				HistoryIndex;
+	/** Replication pass of the last Update. */
+	INT				LastReplicationPass;
+};
+
+/*-----------------------------------------------------------------------------
+	FNetRelevancyGrid.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Uniform grid of the actors a net driver considers for replication, letting connections skip actors further
+ * than the driver's NetCullDistance from all their viewers without looking at them. Actors are moved to another
+ * cell when they have crossed a cell border by the time they are considered again, see UpdateActor.
+ *
+ * Also caches the line checks done by relevancy checks during a replication pass. Viewers whose view locations
+ * fall into the same visibility cell share the results, which makes no noticeable difference as long as cells
+ * are small compared to the distance view locations are predicted ahead by.
+ */
+class FNetRelevancyGrid
+{
+public:
+	/** Constructor, initializing member variables. */
+	FNetRelevancyGrid();
+
+	/**
+	 * Sets the size of cells, emptying the grid if it changed.
+	 *
+	 * @param	InCellSize				size of a grid cell
+	 * @param	InVisibilityCellSize	size of a visibility cell, 0 to only share line checks between identical view locations
+	 */
+	void SetCellSizes( FLOAT InCellSize, FLOAT InVisibilityCellSize );
+
+	/**
+	 * Adds an actor to the grid or moves it to the cell containing its current location.
+	 *
+	 * @param	Actor	actor to update
+	 */
+	void UpdateActor( AActor* Actor );
+
+	/**
+	 * Removes an actor from the grid if it is in it.
+	 *
+	 * @param	Actor	actor to remove
+	 */
+	void RemoveActor( AActor* Actor );
+
+	/**
+	 * Gathers the cells within a distance of a set of viewers, each cell only once.
+	 *
+	 * @param	Viewers		viewers to gather cells for
+	 * @param	NumViewers	number of entries in Viewers
+	 * @param	Distance	distance from viewers
+	 * @param	OutCells	list to add actors of the cells to
+	 */
+	void GetCellsNear( const FNetViewer* Viewers, INT NumViewers, FLOAT Distance, TArray<const TArray<AActor*>*>& OutCells ) const;
+
+	/** Forgets all cached line checks, needs to be called before actors move. */
+	void ResetLineChecks();
+
+	/**
+	 * Line check of a relevancy check, cached till the next call to ResetLineChecks.
+	 *
+	 * @param	Actor			actor whose relevancy is checked, ignored by the line check
+	 * @param	End				end of the line check
+	 * @param	Start			start of the line check
+	 * @param	ViewLocation	location relevancy is checked for, either End or Start
+	 * @return	TRUE if nothing blocks the line
+	 */
+	UBOOL LineCheck( AActor* Actor, const FVector& End, const FVector& Start, const FVector& ViewLocation );
+
+private:
+	/** Key of a cached line check. */
+	struct FLineCheckKey
+	{
+		/** Actor whose relevancy is checked. */
+		AActor*	Actor;
+		/** End of the line check that isn't the view location. */
+		FVector	ActorPoint;
+		/** View location, snapped to its visibility cell. */
+		FVector	ViewPoint;
+
+		UBOOL operator==( const FLineCheckKey& Other ) const
+		{
+			return Actor==Other.Actor && ActorPoint==Other.ActorPoint && ViewPoint==Other.ViewPoint;
+		}
+		friend DWORD GetTypeHash( const FLineCheckKey& Key )
+		{
+			return GetTypeHash( Key.Actor ) ^ GetTypeHash( Key.ActorPoint ) ^ GetTypeHash( Key.ViewPoint );
+		}
+	};
+
+	/**
+	 * Removes an actor from the actor list of a cell, removing the cell if it becomes empty.
+	 *
+	 * @param	Cell	cell the actor is in
+	 * @param	Actor	actor to remove
+	 */
+	void RemoveFromCell( const FIntPoint& Cell, AActor* Actor );
+
+	/**
+	 * @param	Location	location to return cell of
+	 * @return	coordinates of the grid cell containing Location
+	 */
+	FIntPoint GetCell( const FVector& Location ) const
+	{
+		return FIntPoint( appFloor( Location.X / CellSize ), appFloor( Location.Y / CellSize ) );
+	}
+
+	/** Size of a grid cell. */
+	FLOAT							CellSize;
+	/** Size of a visibility cell. */
+	FLOAT							VisibilityCellSize;
+	/** Actors in each non-empty cell. */
+	TMap<FIntPoint,TArray<AActor*> >	Cells;
+	/** Cell each actor in the grid is in. */
+	TMap<AActor*,FIntPoint>			ActorCells;
+	/** Line checks done since the last call to ResetLineChecks and whether nothing blocked them. */
+	TMap<FLineCheckKey,UBOOL>		LineChecks;
 };
 
 /*-----------------------------------------------------------------------------
@@ -113,6 +324,16 @@ class UNetDriver : public USubsystem, public FNetObjectNotify
 	FLOAT						KeepAliveTime;
 	FLOAT						RelevantTimeout;
 	FLOAT						SpawnPrioritySeconds;
+	/** Actors further than this from all viewers of a connection aren't relevant to it unless they are always relevant or only relevant to owner, 0 to disable */
+	FLOAT						NetCullDistance;
+	/** Size of the cells of RelevancyGrid */
+	FLOAT						NetRelevancyCellSize;
+	/** Size of the cells of view locations sharing the line checks of relevancy checks, 0 to only share them between identical view locations */
+	FLOAT						NetVisibilityCellSize;
+	/** Whether replicated vectors and rotators are sent as deltas of values acked by clients, see FNetDeltaHistory */
+	UBOOL						bDeltaCompressVectors;
+	/** Whether connections queue outgoing packets and pace them with a token bucket adapted to measured loss and lag, see UNetConnection::IsSendPaced */
+	UBOOL						bPaceConnections;
 	FLOAT						ServerTravelPause;
 	INT							MaxClientRate;
 	INT							MaxInternetClientRate;
@@ -138,6 +359,18 @@ class UNetDriver : public USubsystem, public FNetObjectNotify
 	DWORD						OutOutOfOrderPackets;
 	/** map of Actors to properties they need to be forced to replicate when the Actor is bNetInitial */
 	TMap< AActor*, TArray<UProperty*> >	ForcedInitialReplicationMap;
+	/** Property change history of actors replicated by this driver, see FPropertyChangeHistory */
+	TMap<AActor*,FPropertyChangeHistory*>	PropertyChangeHistories;
+	/** Number of the current replication pass, INDEX_NONE while not replicating actors to all connections */
+	INT							ReplicationPass;
+	/** Number of replication passes so far */
+	INT							ReplicationPassCount;
+	/** Whether actor channels share property change detection, disabled with -nosharedpropertycompare for comparison */
+	UBOOL						bSharePropertyCompare;
+	/** Whether the actor priority lists of connections are built on GThreadPool as well, disabled with -serialnetpriority */
+	UBOOL						bParallelPriorityLists;
+	/** Grid of the actors considered for replication, only kept up to date if NetCullDistance is set */
+	FNetRelevancyGrid			RelevancyGrid;
 	/** Time of last stat update */
 	DOUBLE						StatUpdateTime;
 	/** Interval between gathering stats */
@@ -184,8 +417,34 @@ class UNetDriver : public USubsystem, public FNetObjectNotify
 	virtual UBOOL InitListen( FNetworkNotify* InNotify, FURL& ListenURL, FString& Error );
 	virtual void TickFlush();
 	virtual void TickDispatch( FLOAT DeltaTime );
+	/**
+	 * Blocks until network data arrives or the wait time has passed, used by the server to sleep between
+	 * ticks. Drivers that can wait are expected to pick up the data that woke them so it can be dispatched
+	 * by the next TickDispatch.
+	 *
+	 * @param	WaitSeconds	max time to wait
+	 * @return	TRUE if the driver waited, FALSE if it can't wait (any more this frame) and the caller should sleep instead
+	 */
+	virtual UBOOL WaitForIncomingData( FLOAT WaitSeconds )
+	{
+		return FALSE;
+	}
 	virtual UBOOL Exec( const TCHAR* Cmd, FOutputDevice& Ar=*GLog );
 	virtual void NotifyActorDestroyed( AActor* Actor );
+	/**
+	 * Starts a replication pass, during which actors replicated to several connections are compared only once
+	 * for property changes. Actors must not be modified till EndReplicationPass is called.
+	 */
+	void BeginReplicationPass();
+	/** Ends the current replication pass. */
+	void EndReplicationPass();
+	/**
+	 * Returns the property change history of an actor, updated for the current replication pass.
+	 *
+	 * @param	Actor	actor to return history for
+	 * @return	the actor's history or NULL if not in a replication pass or sharing is disabled
+	 */
+	FPropertyChangeHistory* GetPropertyChangeHistory( AActor* Actor );
 	/** creates a child connection and adds it to the given parent connection */
 	virtual class UChildConnection* CreateChild(UNetConnection* Parent);
 
@@ -0,0 +1,193 @@
+/*=============================================================================
+	UnTimerWheel.h: Hierarchical timing wheel driving actor timers.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#ifndef _UNTIMERWHEEL_H
+#define _UNTIMERWHEEL_H
+
+/*-----------------------------------------------------------------------------
+	FTimerWheel.
+-----------------------------------------------------------------------------*/
+
+/**
+ * World level index of the actors that have active timers, set up so actors only pay for their timers
+ * in the frames one of them might expire in instead of in every tick.
+ *
+ * AActor::Timers stays the list of record and timers still fire from AActor::UpdateTimers inside their
+ * owner's tick, exactly like before. The wheel only keeps an entry per owner holding the clock value
+ * its earliest timer expires at, the owner itself keeps the time it has been ticked by since its
+ * timers' Count was last brought up to date in TimerPendingSeconds. While the entry isn't due the
+ * owner's bTimersIdle is set, UpdateTimers then just adds to TimerPendingSeconds without looking
+ * the entry up. Entries are hashed by their expiration time into one of NUM_LEVELS
+ * levels of SLOTS_PER_LEVEL slots. Level 0 slots are TICKS_PER_SECOND-th of a second wide, each
+ * higher level covers a full turn of the level below it. Advancing the clock moves the level 0 slots
+ * it passes into the due list and cascades higher level slots down as lower levels wrap.
+ *
+ * The clock advances by the world's delta time, owners ticked by something else, e.g. through
+ * CustomTimeDilation, go through UpdateActor every tick to shift their entry by the difference.
+ * Entries are only ever due early, never late, in which case UpdateTimers finds no expired timer and
+ * the owner is scheduled again.
+ */
+class FTimerWheel
+{
+public:
+	enum { TICKS_PER_SECOND	= 64								};
+	enum { SLOT_BITS		= 6									};
+	enum { SLOTS_PER_LEVEL	= 1 << SLOT_BITS					};
+	enum { NUM_LEVELS		= 4									};
+	enum { LIST_Due			= NUM_LEVELS * SLOTS_PER_LEVEL		};
+	enum { LIST_Overflow	= LIST_Due + 1						};
+	enum { NUM_LISTS		= LIST_Overflow + 1					};
+
+	/** Constructor, initializing member variables. */
+	FTimerWheel();
+
+	/**
+	 * Returns the timer wheel of the world an actor is ticked by, which is the world owning the
+	 * persistent level its WorldInfo is in as streamed in levels keep their own, unticked, world.
+	 *
+	 * @param	Owner	actor to look up the timer wheel for
+	 * @return	timer wheel of the actor's world, NULL if the actor isn't part of one
+	 */
+	static FTimerWheel* GetActorTimerWheel( AActor* Owner );
+
+	/**
+	 * Advances the clock by the world's delta time, moving owners whose timers might expire into the
+	 * due list. Called right before actors are ticked.
+	 *
+	 * @param	DeltaSeconds	dilated time since the last frame
+	 */
+	void BeginFrame( FLOAT DeltaSeconds );
+
+	/** Called once all actors have been ticked. */
+	void EndFrame()
+	{
+		bActorsTicking = FALSE;
+	}
+
+	/**
+	 * Whether an owner ticked by the passed in time is ticked in step with the clock, in which case its
+	 * entry doesn't need to be shifted and an idle owner can skip UpdateActor.
+	 *
+	 * @param	DeltaSeconds	time the owner is ticked by
+	 * @return	TRUE if actors are being ticked and the clock advanced by DeltaSeconds this frame
+	 */
+	UBOOL IsInStep( FLOAT DeltaSeconds ) const
+	{
+		return bActorsTicking && DeltaSeconds == FrameDeltaSeconds;
+	}
+
+	/**
+	 * Adds the time an actor has been ticked by to the time pending for its timers, shifting its entry
+	 * if the actor isn't ticked in step with the clock. If one of its timers might have expired, the
+	 * pending time is added to the Count of all of them.
+	 *
+	 * @param	Owner			actor being ticked
+	 * @param	DeltaSeconds	time the actor is ticked by
+	 * @return	TRUE if the Count of the actor's timers has been brought up to date and they need to be
+	 *			checked for expired ones, FALSE if none of them can have expired yet
+	 */
+	UBOOL UpdateActor( AActor* Owner, FLOAT DeltaSeconds );
+
+	/**
+	 * Adds the time pending for an actor's timers to their Count. Needs to be called before Timers
+	 * is modified or Count is looked at outside of UpdateTimers.
+	 *
+	 * @param	Owner	actor whose timers to bring up to date
+	 */
+	void SyncActor( AActor* Owner );
+
+	/**
+	 * Brings an actor's timers up to date and (re)schedules its entry for the earliest of them to
+	 * expire, removing the entry if it has no active timers left.
+	 *
+	 * @param	Owner			actor whose timers changed
+	 * @param	bTickedThisFrame	whether the time of the current frame has been added to the actor's timers
+	 */
+	void ScheduleActor( AActor* Owner, UBOOL bTickedThisFrame = FALSE );
+
+	/**
+	 * Brings an actor's timers up to date and removes its entry. Used for actors leaving the world,
+	 * the entry is added again once they are ticked with active timers.
+	 *
+	 * @param	Owner	actor to remove
+	 */
+	void RemoveActor( AActor* Owner );
+
+	/** Removes all entries, e.g. when the world is cleaned up. */
+	void Reset();
+
+private:
+	/** An actor with active timers. */
+	struct FEntry
+	{
+		/** Actor owning the timers, NULL for unused entries. */
+		AActor*		Owner;
+		/** Clock value the owner's earliest timer expires at. */
+		DOUBLE		ExpireTime;
+		/** List the entry is linked into, INDEX_NONE if unlinked. */
+		INT			List;
+		/** Next/ previous entry in the same list, free entries are chained through Next. */
+		INT			Next;
+		INT			Prev;
+	};
+
+	/** Unlinks, unindexes and frees an entry. */
+	void FreeEntry( INT EntryIndex );
+
+	/** Links an unlinked entry into the list matching its expiration time, updating its owner's bTimersIdle. */
+	void LinkEntry( INT EntryIndex );
+
+	/** Unlinks an entry from the list it is in. */
+	void UnlinkEntry( INT EntryIndex );
+
+	/** Unlinks an entry if necessary and links it into the list matching its expiration time. */
+	void RelinkEntry( INT EntryIndex )
+	{
+		UnlinkEntry( EntryIndex );
+		LinkEntry( EntryIndex );
+	}
+
+	/** Relinks all entries of a list, used to cascade slots down a level. */
+	void CascadeList( INT List );
+
+	/** Adds the pending time of an owner to the Count of its timers. */
+	static void SyncOwner( AActor* Owner );
+
+	/** @return clock value the time pending for owners counts from */
+	DOUBLE GetBaseTime() const
+	{
+		// Owners that have yet to tick this frame are going to add this frame's time to their timers.
+		return bActorsTicking ? Time - FrameDeltaSeconds : Time;
+	}
+
+	/** @return wheel tick a clock value falls into */
+	static QWORD GetTick( DOUBLE InTime )
+	{
+		return InTime > 0.0 ? (QWORD)(InTime * TICKS_PER_SECOND) : 0;
+	}
+
+	/** Clock, advanced by the world's dilated delta time whenever actors are ticked. */
+	DOUBLE						Time;
+	/** Delta time of the current frame. */
+	FLOAT						FrameDeltaSeconds;
+	/** Wheel tick Time falls into. */
+	QWORD						CurrentTick;
+	/** Whether actors are being ticked, i.e. between BeginFrame and EndFrame. */
+	UBOOL						bActorsTicking;
+	/** Pool of entries, referenced by index. */
+	TArray<FEntry>				Entries;
+	/** First unused entry. */
+	INT							FirstFreeEntry;
+	/** First entry of each list. */
+	INT							ListHeads[NUM_LISTS];
+	/** Maps actors to their entry. */
+	TDynamicMap<AActor*,INT>	EntryMap;
+};
+
+#endif	// _UNTIMERWHEEL_H
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
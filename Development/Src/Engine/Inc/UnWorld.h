@@ -85,6 +85,9 @@ class UWorld : public UObject, public FNetworkNotify
 	
 	/** Decal manager. */
 	class UDecalManager*						DecalManager;
+
+	/** Index of the actors with active timers, deciding which of them check their timers when ticked. */
+	FTimerWheel									TimerWheel;
 	
 	/** Whether world object has been initialized via Init()																	*/
 	UBOOL										bIsWorldInitialized;
@@ -731,6 +734,136 @@ public:
 /** global travel handler */
 extern FSeamlessTravelHandler GSeamlessTravelHandler;
 
+/**
+ * Hosts game worlds next to GWorld in a dedicated server process. Each hosted world loads its map file into
+ * a package of its own so it gets its own actors, physics scene and net driver listening on its own port,
+ * while the packages the map references (script, meshes, collision data, ...) are loaded once and shared by
+ * all worlds. Hosted worlds are ticked after GWorld, with GWorld pointing at the world being ticked.
+ *
+ * Hosted worlds don't support level streaming, seamless travel or demo recording. A server travel reloads
+ * the hosted world with the new map.
+ */
+class FHostedWorldManager : public FNetObjectNotify
+{
+public:
+	/** A world hosted next to GWorld. */
+	struct FHostedWorld
+	{
+		/** The world. */
+		UWorld*	World;
+		/** URL the world was loaded with. */
+		FURL	URL;
+	};
+
+	/** Points GWorld at another world for the lifetime of the scope. */
+	class FScopedWorld
+	{
+	public:
+		FScopedWorld( FHostedWorldManager& InManager, UWorld* World );
+		~FScopedWorld();
+	private:
+		FHostedWorldManager&	Manager;
+		UWorld*					SavedWorld;
+	};
+
+	FHostedWorldManager()
+	:	MainWorld( NULL )
+	,	NextInstanceIndex( 1 )
+	{}
+
+	/**
+	 * Loads a map into a new hosted world and starts listening for clients. Only dedicated servers host worlds.
+	 *
+	 * @param	InURL	URL of the map to host, gets a port of its own unless it specifies one
+	 * @param	Error	receives the reason hosting the world failed
+	 * @return	TRUE if the world is hosted, FALSE otherwise
+	 */
+	UBOOL HostWorld( const FURL& InURL, FString& Error );
+
+	/**
+	 * Shuts down a hosted world, disconnecting its clients. Its memory is freed by the next garbage collection.
+	 *
+	 * @param	Index	index of the world in the list of hosted worlds
+	 */
+	void UnhostWorld( INT Index );
+
+	/** Shuts down all hosted worlds. */
+	void UnhostAllWorlds();
+
+	/**
+	 * Hosts the worlds listed by HostedWorldURLs in the [Engine.GameEngine] section.
+	 *
+	 * @param	BaseURL	URL the configured URLs are relative to
+	 */
+	void HostConfiguredWorlds( const FURL& BaseURL );
+
+	/**
+	 * Ticks all hosted worlds and handles their server travels.
+	 *
+	 * @param	DeltaSeconds	time since the last tick
+	 */
+	void Tick( FLOAT DeltaSeconds );
+
+	/** Handles HOSTWORLD <url>, UNHOSTWORLD <index> and HOSTEDWORLDS. */
+	UBOOL Exec( const TCHAR* Cmd, FOutputDevice& Ar );
+
+	/** @return whether the passed in world is a hosted world */
+	UBOOL IsHostedWorld( UWorld* World ) const;
+
+	/** @return the number of hosted worlds */
+	INT Num() const
+	{
+		return HostedWorlds.Num();
+	}
+
+	/**
+	 * Returns whether the net driver of the passed in world should send the passed in package to its clients.
+	 * Map packages are only relevant to the world they belong to once worlds are hosted.
+	 *
+	 * @param	World	world the net driver belongs to
+	 * @param	Package	package to check
+	 */
+	UBOOL IsNetPackageRelevant( UWorld* World, UPackage* Package ) const;
+
+	// FNetObjectNotify interface, forwarding to the net drivers of GWorld and all hosted worlds.
+	virtual void NotifyNetPackageAdded( UPackage* Package );
+	virtual void NotifyNetPackageRemoved( UPackage* Package );
+	virtual void NotifyNetObjectRemoved( UObject* Object );
+
+private:
+	/**
+	 * Loads the map of the passed in URL into a new package and starts playing it.
+	 *
+	 * @param	URL		URL of the map to load
+	 * @param	Error	receives the reason loading failed
+	 * @return	the loaded world or NULL if loading failed
+	 */
+	UWorld* LoadWorld( const FURL& URL, FString& Error );
+
+	/**
+	 * Ends play in a hosted world and releases it to garbage collection.
+	 *
+	 * @param	World	world to destroy
+	 */
+	void DestroyWorld( UWorld* World );
+
+	/**
+	 * Collects the worlds whose net drivers are notified about net package changes.
+	 *
+	 * @param	Worlds	receives GWorld, the main world, followed by the hosted worlds
+	 */
+	void GetAllWorlds( TArray<UWorld*>& Worlds ) const;
+
+	/** The hosted worlds. */
+	TArray<FHostedWorld>	HostedWorlds;
+	/** The world GWorld points at when no hosted world is being worked on, NULL while it points at the main world. */
+	UWorld*					MainWorld;
+	/** Suffix of the package the next hosted world is loaded into. */
+	INT						NextInstanceIndex;
+};
+/** global hosted world manager */
+extern FHostedWorldManager GHostedWorlds;
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
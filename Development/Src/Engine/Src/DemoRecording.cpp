@@ -19,6 +19,7 @@ UDemoRecConnection::UDemoRecConnection()
 {
 	MaxPacket   = PACKETSIZE;
 	InternalAck = 1;
+	bRecordsSnapshot = FALSE;
 }
 
 /**
@@ -50,7 +51,14 @@ FString UDemoRecConnection::LowLevelGetRemoteAddress()
 
 void UDemoRecConnection::LowLevelSend( void* Data, INT Count )
 {
-	if (!GetDriver()->ServerConnection && GetDriver()->FileAr)
+	if (bRecordsSnapshot)
+	{
+		TArray<BYTE>& SnapshotData = GetDriver()->Keyframes.Last().SnapshotData;
+		const INT Offset = SnapshotData.Add( sizeof(INT) + Count );
+		appMemcpy( &SnapshotData(Offset), &Count, sizeof(INT) );
+		appMemcpy( &SnapshotData(Offset + sizeof(INT)), Data, Count );
+	}
+	else if (!GetDriver()->ServerConnection && GetDriver()->FileAr)
 	{
 		*GetDriver()->FileAr << GetDriver()->LastDeltaTime << GetDriver()->FrameNum << Count;
 		GetDriver()->FileAr->Serialize( Data, Count );
@@ -63,7 +71,7 @@ FString UDemoRecConnection::LowLevelDescribe()
 	return TEXT("Demo recording driver connection");
 }
 
-INT UDemoRecConnection::IsNetReady( UBOOL Saturate )
+INT UDemoRecConnection::IsNetReady( UBOOL Saturate, ESendPriority Priority )
 {
 	return 1;
 }
@@ -98,6 +106,8 @@ UBOOL UDemoRecDriver::InitBase( UBOOL Connect, FNetworkNotify* InNotify, const F
 	Time			= 0;
 	FrameNum	    = 0;
 	bHasDemoEnded	= FALSE;
+	DemoTime		= 0.0;
+	Keyframes.Empty();
 
 	return TRUE;
 }
@@ -119,7 +129,7 @@ UBOOL UDemoRecDriver::InitConnect( FNetworkNotify* InNotify, const FURL& Connect
 	ServerConnection->InitConnection(this, USOCK_Pending, ConnectURL, 1000000);
 
 	// open the pre-recorded demo file
-	FileAr = GFileManager->CreateFileReader(*DemoFilename);
+	FileAr = CreateDemoFileReader( *DemoFilename, Keyframes );
 	if( !FileAr )
 	{
 		Error = FString::Printf( TEXT("Couldn't open demo file %s for reading"), *DemoFilename );//@todo demorec: localize
@@ -165,8 +175,15 @@ UBOOL UDemoRecDriver::InitListen( FNetworkNotify* InNotify, FURL& ConnectURL, FS
 	Connection->InitConnection(this, USOCK_Open, ConnectURL, 1000000);
 	Connection->InitOut();
 
-	FileAr = GFileManager->CreateFileWriter( *DemoFilename );
+	// The file is written by a thread of its own, keep disk stalls from hitching the game.
+	FileAr = FDemoFileWriter::Create( *DemoFilename, bCompressDemos || ConnectURL.HasOption(TEXT("compress")) );
 	ClientConnections.AddItem( Connection );
+	bMeasureBandwidth = ConnectURL.HasOption(TEXT("measurebandwidth"));
+	const TCHAR* KeyframeIntervalOption = ConnectURL.GetOption(TEXT("keyframeinterval="), NULL);
+	if( KeyframeIntervalOption )
+	{
+		KeyframeInterval = appAtof( KeyframeIntervalOption );
+	}
 
 	if( !FileAr )
 	{
@@ -246,6 +263,8 @@ UBOOL UDemoRecDriver::InitListen( FNetworkNotify* InNotify, FURL& ConnectURL, FS
 void UDemoRecDriver::StaticConstructor()
 {
 	new(GetClass(),TEXT("DemoSpectatorClass"), RF_Public)UStrProperty(CPP_PROPERTY(DemoSpectatorClass), TEXT("Client"), CPF_Config);
+	new(GetClass(),TEXT("bCompressDemos"), RF_Public)UBoolProperty(CPP_PROPERTY(bCompressDemos), TEXT("Client"), CPF_Config);
+	new(GetClass(),TEXT("KeyframeInterval"), RF_Public)UFloatProperty(CPP_PROPERTY(KeyframeInterval), TEXT("Client"), CPF_Config);
 }
 
 void UDemoRecDriver::LowLevelDestroy()
@@ -253,8 +272,22 @@ void UDemoRecDriver::LowLevelDestroy()
 	debugf( TEXT("Closing down demo driver.") );
 
 	// Shut down file.
+	CloseDemoFile();
+}
+
+/** Closes the demo file, writing the keyframe index if recording. */
+void UDemoRecDriver::CloseDemoFile()
+{
 	if( FileAr )
-	{	
+	{
+		if( !ServerConnection )
+		{
+			// Recording always goes through the threaded writer.
+			if( !((FDemoFileWriter*)FileAr)->Finish( Keyframes ) )
+			{
+				debugf( NAME_Warning, TEXT("Failed to write demo file %s"), *DemoFilename );
+			}
+		}
 		delete FileAr;
 		FileAr = NULL;
 	}
@@ -288,6 +321,7 @@ UBOOL UDemoRecDriver::UpdateDemoTime( FLOAT* DeltaTime, FLOAT TimeDilation )
 
 				*FileAr << NewDeltaTime << NewFrameNum;
 				FileAr->Seek(FileAr->Tell() - sizeof(NewDeltaTime) - sizeof(NewFrameNum));
+				DemoTime += NewDeltaTime;
 
 				// If the real delta time is too small, sleep for the appropriate amount.
 				if( !bNoFrameCap )
@@ -328,6 +362,14 @@ UBOOL UDemoRecDriver::UpdateDemoTime( FLOAT* DeltaTime, FLOAT TimeDilation )
 			LastDeltaTime				= DemoRecMultiFrameDeltaTime;
 			DemoRecMultiFrameDeltaTime	= 0.f;
 			Result						= 1;
+			DemoTime					+= LastDeltaTime;
+			if( bMeasureBandwidth )
+			{
+				BandwidthSeconds += LastDeltaTime;
+			}
+
+			// Hand the previous frame to the writer thread.
+			FileAr->Flush();
 
 			// Save the new delta-time and frame number, with no data, in case there is nothing to replicate.
 			INT Count = 0;
@@ -467,8 +509,39 @@ UBOOL UDemoRecDriver::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
 			ServerConnection->State = USOCK_Closed;
 		}
 
-		delete FileAr;
-		FileAr = NULL;
+		if( bMeasureBandwidth )
+		{
+			DumpActorBandwidth( Ar );
+		}
+
+		CloseDemoFile();
+		return TRUE;
+	}
+	else if( ParseCommand(&Cmd,TEXT("DEMOSEEK")) )
+	{
+		SeekToTime( appAtof(Cmd), Ar );
+		return TRUE;
+	}
+	else if( ParseCommand(&Cmd,TEXT("DEMOBANDWIDTH")) )
+	{
+		if( ServerConnection )
+		{
+			Ar.Logf( TEXT("Demo bandwidth can only be measured while recording") );
+		}
+		else if( !bMeasureBandwidth )
+		{
+			bMeasureBandwidth = TRUE;
+			Ar.Logf( TEXT("Measuring demo bandwidth per actor class") );
+		}
+		else
+		{
+			DumpActorBandwidth( Ar );
+			if( ParseCommand(&Cmd,TEXT("RESET")) )
+			{
+				ActorClassBandwidth.Empty();
+				BandwidthSeconds = 0.0;
+			}
+		}
 		return TRUE;
 	}
 	else 
@@ -477,6 +550,246 @@ UBOOL UDemoRecDriver::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
 	}
 }
 
+/**
+ * Adds the data sent replicating an actor in the current recording frame to the bandwidth of its class.
+ *
+ * @param	Actor	actor that was replicated
+ * @param	Bits	number of bits sent
+ */
+void UDemoRecDriver::RecordActorBandwidth( AActor* Actor, INT Bits )
+{
+	const FName ClassName = Actor->GetClass()->GetFName();
+	FDemoActorBandwidth* Bandwidth = ActorClassBandwidth.Find( ClassName );
+	if( !Bandwidth )
+	{
+		Bandwidth = &ActorClassBandwidth.Set( ClassName, FDemoActorBandwidth(ClassName) );
+	}
+	Bandwidth->Bytes		+= Bits / 8.0;
+	Bandwidth->ActorSeconds	+= LastDeltaTime;
+}
+
+IMPLEMENT_COMPARE_CONSTREF( FDemoActorBandwidth, DemoRecording, { return A.Bytes < B.Bytes ? 1 : A.Bytes > B.Bytes ? -1 : 0; } )
+
+/**
+ * Logs the bandwidth used per actor class, in bytes per actor per second and bytes per second overall.
+ *
+ * @param	Ar	device to log to
+ */
+void UDemoRecDriver::DumpActorBandwidth( FOutputDevice& Ar )
+{
+	if( BandwidthSeconds <= 0.0 )
+	{
+		Ar.Logf( TEXT("No demo bandwidth measured yet") );
+		return;
+	}
+
+	TArray<FDemoActorBandwidth> SortedBandwidth;
+	DOUBLE TotalBytes = 0.0;
+	for( TMap<FName,FDemoActorBandwidth>::TIterator It(ActorClassBandwidth); It; ++It )
+	{
+		SortedBandwidth.AddItem( It.Value() );
+		TotalBytes += It.Value().Bytes;
+	}
+	Sort<USE_COMPARE_CONSTREF(FDemoActorBandwidth,DemoRecording)>( SortedBandwidth.GetTypedData(), SortedBandwidth.Num() );
+
+	Ar.Logf( TEXT("Demo bandwidth over %.1f seconds: %.1f bytes/s"), BandwidthSeconds, TotalBytes / BandwidthSeconds );
+	Ar.Logf( TEXT("%-40s %10s %12s %16s"), TEXT("Class"), TEXT("Avg actors"), TEXT("Bytes/s"), TEXT("Bytes/actor/s") );
+	for( INT i=0; i<SortedBandwidth.Num(); i++ )
+	{
+		const FDemoActorBandwidth& Bandwidth = SortedBandwidth(i);
+		Ar.Logf( TEXT("%-40s %10.1f %12.1f %16.1f"),
+			*Bandwidth.ClassName.ToString(),
+			Bandwidth.ActorSeconds / BandwidthSeconds,
+			Bandwidth.Bytes / BandwidthSeconds,
+			Bandwidth.ActorSeconds > 0.0 ? Bandwidth.Bytes / Bandwidth.ActorSeconds : 0.0 );
+	}
+}
+
+/** @return TRUE if a keyframe should be taken before replicating the frame that is being recorded */
+UBOOL UDemoRecDriver::ShouldTakeKeyframe()
+{
+	if( ServerConnection || !FileAr || KeyframeInterval <= 0.f || ClientConnections.Num() == 0 || ClientConnections(0)->State != USOCK_Open )
+	{
+		return FALSE;
+	}
+	const FLOAT LastKeyframeTime = Keyframes.Num() ? Keyframes.Last().Time : 0.f;
+	return DemoTime - LastDeltaTime - LastKeyframeTime >= KeyframeInterval;
+}
+
+/**
+ * Remembers the stream position as a keyframe and sets up the connection its snapshot is recorded with,
+ * which has a channel for every actor with an open channel but the demo spectator's. Called before
+ * replicating the frame, the caller replicates the actors to the snapshot connection and calls EndKeyframe.
+ *
+ * @return	connection to replicate the snapshot to
+ */
+UNetConnection* UDemoRecDriver::BeginKeyframe()
+{
+	UNetConnection* Connection = ClientConnections(0);
+	Connection->FlushNet();
+
+	// Playback jumping here needs to pick up the sequence numbers where the stream continues.
+	FDemoKeyframe& Keyframe	= Keyframes(Keyframes.AddZeroed());
+	Keyframe.Time			= DemoTime - LastDeltaTime;
+	Keyframe.FrameNum		= FrameNum;
+	Keyframe.StreamOffset	= FileAr->Tell();
+	Keyframe.PacketId		= Connection->OutPacketId - 1;
+	for( INT ChIndex=0; ChIndex<MAX_CHANNELS; ChIndex++ )
+	{
+		if( Connection->OutReliable[ChIndex] )
+		{
+			Keyframe.ReliableChannels.AddItem( ChIndex );
+			Keyframe.ReliableSequences.AddItem( Connection->OutReliable[ChIndex] );
+		}
+	}
+
+	// The snapshot connection shares the package map and spectator, its channels use the same indices as the
+	// demo connection's so the stream following the keyframe finds the actors where it expects them.
+	UDemoRecConnection* SnapshotConnection = ConstructObject<UDemoRecConnection>(UDemoRecConnection::StaticClass());
+	SnapshotConnection->InitConnection( this, USOCK_Open, Connection->URL, 1000000 );
+	SnapshotConnection->InitOut();
+	SnapshotConnection->PackageMap				= Connection->PackageMap;
+	SnapshotConnection->Actor					= Connection->Actor;
+	SnapshotConnection->bDeltaCompressVectors	= Connection->bDeltaCompressVectors;
+	SnapshotConnection->bRecordsSnapshot		= TRUE;
+	for( INT ChannelIndex=0; ChannelIndex<Connection->OpenChannels.Num(); ChannelIndex++ )
+	{
+		UChannel* Channel = Connection->OpenChannels(ChannelIndex);
+		AActor* Actor = Channel->ChType == CHTYPE_Actor ? ((UActorChannel*)Channel)->Actor : NULL;
+		if( Actor && !Channel->Closing && Actor != Connection->Actor )
+		{
+			UActorChannel* SnapshotChannel = (UActorChannel*)SnapshotConnection->CreateChannel( CHTYPE_Actor, 1, Channel->ChIndex );
+			SnapshotChannel->SetChannelActor( Actor );
+
+			// Send delta compressed properties in full next, playback jumping here doesn't have older values.
+			UActorChannel* ActorChannel = (UActorChannel*)Channel;
+			for( INT HistoryIndex=0; HistoryIndex<ActorChannel->DeltaHistories.Num(); HistoryIndex++ )
+			{
+				ActorChannel->DeltaHistories(HistoryIndex).ForgetValues();
+			}
+		}
+	}
+	return SnapshotConnection;
+}
+
+/**
+ * Finishes the snapshot of the keyframe being taken and throws the snapshot connection away without
+ * sending anything, the actors stay open on the channels of the demo connection.
+ *
+ * @param	SnapshotConnection	connection returned by BeginKeyframe
+ */
+void UDemoRecDriver::EndKeyframe( UNetConnection* SnapshotConnection )
+{
+	SnapshotConnection->FlushNet();
+
+	// Cleaning up actor channels on the recording side leaves the actors alone.
+	for( INT ChannelIndex=SnapshotConnection->OpenChannels.Num()-1; ChannelIndex>=0; ChannelIndex-- )
+	{
+		SnapshotConnection->OpenChannels(ChannelIndex)->ConditionalCleanUp();
+	}
+
+	// Detach it from the driver and the shared objects, so its clean up doesn't touch them once it is collected.
+	((UDemoRecConnection*)SnapshotConnection)->bRecordsSnapshot = FALSE;
+	SnapshotConnection->State		= USOCK_Closed;
+	SnapshotConnection->PackageMap	= NULL;
+	SnapshotConnection->Actor		= NULL;
+	SnapshotConnection->Driver		= NULL;
+}
+
+/**
+ * Jumps playback to the last keyframe at or before the passed in time.
+ *
+ * @param	Time	demo time to seek to
+ * @param	Ar		device to report errors to
+ * @return	TRUE if a keyframe was found
+ */
+UBOOL UDemoRecDriver::SeekToTime( FLOAT Time, FOutputDevice& Ar )
+{
+	if( !ServerConnection || ServerConnection->State != USOCK_Open || !FileAr )
+	{
+		Ar.Logf( TEXT("Demo seeking is only possible during playback") );//@todo demorec: localize
+		return FALSE;
+	}
+
+	INT KeyframeIndex = INDEX_NONE;
+	for( INT i=0; i<Keyframes.Num() && Keyframes(i).Time<=Time; i++ )
+	{
+		KeyframeIndex = i;
+	}
+	if( KeyframeIndex == INDEX_NONE )
+	{
+		Ar.Logf( TEXT("Demo %s has no keyframe at or before %.1f seconds"), *DemoFilename, Time );//@todo demorec: localize
+		return FALSE;
+	}
+	const FDemoKeyframe& Keyframe = Keyframes(KeyframeIndex);
+
+	// Clean up actor channels like a close would, the keyframe's snapshot reopens them.
+	TArray<UChannel*> ChannelsToCleanUp;
+	for( INT ChannelIndex=0; ChannelIndex<ServerConnection->OpenChannels.Num(); ChannelIndex++ )
+	{
+		UChannel* Channel = ServerConnection->OpenChannels(ChannelIndex);
+		if( Channel->ChType == CHTYPE_Actor && ((UActorChannel*)Channel)->Actor != ServerConnection->Actor )
+		{
+			ChannelsToCleanUp.AddItem( Channel );
+		}
+	}
+	for( INT ChannelIndex=0; ChannelIndex<ChannelsToCleanUp.Num(); ChannelIndex++ )
+	{
+		if( ChannelsToCleanUp(ChannelIndex)->Connection )
+		{
+			ChannelsToCleanUp(ChannelIndex)->ConditionalCleanUp();
+		}
+	}
+
+	// The snapshot was sent by a connection of its own, starting out with no packets or reliable bunches received.
+	appMemzero( ServerConnection->InReliable, sizeof(ServerConnection->InReliable) );
+	ServerConnection->InPacketId = INDEX_NONE;
+	for( INT Offset=0; Offset + (INT)sizeof(INT) <= Keyframe.SnapshotData.Num(); )
+	{
+		INT Count;
+		appMemcpy( &Count, &Keyframe.SnapshotData(Offset), sizeof(INT) );
+		Offset += sizeof(INT);
+		if( Count <= 0 || Offset + Count > Keyframe.SnapshotData.Num() )
+		{
+			debugf( NAME_DevNet, TEXT("Corrupt snapshot in keyframe at %.1f seconds"), Keyframe.Time );
+			break;
+		}
+		ServerConnection->ReceivedRawPacket( (void*)&Keyframe.SnapshotData(Offset), Count );
+		Offset += Count;
+	}
+
+	// Delta compressed properties are sent in full after a keyframe, the sequence numbers of the snapshot don't apply.
+	for( INT ChannelIndex=0; ChannelIndex<ServerConnection->OpenChannels.Num(); ChannelIndex++ )
+	{
+		UChannel* Channel = ServerConnection->OpenChannels(ChannelIndex);
+		if( Channel->ChType == CHTYPE_Actor )
+		{
+			UActorChannel* ActorChannel = (UActorChannel*)Channel;
+			for( INT HistoryIndex=0; HistoryIndex<ActorChannel->DeltaHistories.Num(); HistoryIndex++ )
+			{
+				ActorChannel->DeltaHistories(HistoryIndex).ForgetValues();
+			}
+		}
+	}
+
+	// Continue with the sequence numbers of the demo connection.
+	appMemzero( ServerConnection->InReliable, sizeof(ServerConnection->InReliable) );
+	for( INT i=0; i<Keyframe.ReliableChannels.Num(); i++ )
+	{
+		ServerConnection->InReliable[Keyframe.ReliableChannels(i)] = Keyframe.ReliableSequences(i);
+	}
+	ServerConnection->InPacketId = Keyframe.PacketId;
+
+	// UpdateDemoTime advances to the keyframe's frame before anything is dispatched.
+	FileAr->Seek( Keyframe.StreamOffset );
+	FrameNum		= Keyframe.FrameNum - 1;
+	DemoTime		= Keyframe.Time;
+	LastFrameTime	= appSeconds();
+
+	Ar.Logf( TEXT("Demo %s jumped to %.1f seconds"), *DemoFilename, Keyframe.Time );//@todo demorec: localize
+	return TRUE;
+}
+
 void UDemoRecDriver::SpawnDemoRecSpectator( UNetConnection* Connection )
 {
 	UClass* C = StaticLoadClass( AActor::StaticClass(), NULL, *DemoSpectatorClass, NULL, LOAD_None, NULL );
@@ -591,6 +904,9 @@ void UDemoPlayPendingLevel::NotifyReceivedText( UNetConnection* Connection, cons
 	{
 		// Parse welcome message.
 		Parse( Text, TEXT("LEVEL="), URL.Map );
+		INT DeltaCompressVectors = 0;
+		Parse( Text, TEXT("DELTAVECTORS="), DeltaCompressVectors );
+		Connection->bDeltaCompressVectors = DeltaCompressVectors != 0;
 
 		// only check the package versions if desired
 		if (!DemoRecDriver->bShouldSkipPackageChecking)
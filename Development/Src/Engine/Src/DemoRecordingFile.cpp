@@ -0,0 +1,518 @@
+/*=============================================================================
+	DemoRecordingFile.cpp: Threaded demo file writer and block based demo file reader.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+#include "UnNet.h"
+#include "DemoRecording.h"
+
+/** Size of the header following the tag: version, flags, block size, stream size and index offset. */
+#define DEMO_HEADER_SIZE	20
+/** Size of the header of a block: stored size and uncompressed size. */
+#define DEMO_BLOCK_HEADER_SIZE	8
+
+/*-----------------------------------------------------------------------------
+	FDemoFileWriter implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Opens a demo file for writing and starts the writer thread. Data is written on the game thread
+ * instead if the writer thread can't be started.
+ *
+ * @param	Filename	file to record to
+ * @param	bCompress	whether to compress the blocks of the stream
+ * @return	new writer, NULL if the file couldn't be opened
+ */
+FDemoFileWriter* FDemoFileWriter::Create( const TCHAR* Filename, UBOOL bCompress )
+{
+	FArchive* FileAr = GFileManager->CreateFileWriter( Filename );
+	if( !FileAr )
+	{
+		return NULL;
+	}
+
+	FDemoFileWriter* Writer = new FDemoFileWriter( FileAr, bCompress );
+	if( Writer->WorkEvent )
+	{
+		Writer->Thread = GThreadFactory->CreateThread( Writer, TEXT("DemoFileWriter"), FALSE, FALSE, 0, TPri_BelowNormal );
+	}
+	if( !Writer->Thread )
+	{
+		debugf( NAME_Warning, TEXT("Failed to start demo writer thread, writing %s on the game thread"), Filename );
+	}
+	return Writer;
+}
+
+/**
+ * Constructor, taking ownership of the file writer.
+ *
+ * @param	InFileAr	archive writing to the demo file
+ * @param	bCompress	whether to compress the blocks of the stream
+ */
+FDemoFileWriter::FDemoFileWriter( FArchive* InFileAr, UBOOL bCompress )
+:	FileAr( InFileAr )
+,	Flags( bCompress ? DEMOFILE_Compressed : 0 )
+,	RingBuffer( RING_BUFFER_SIZE )
+,	StagedSize( 0 )
+,	CommittedSize( 0 )
+,	NumStalls( 0 )
+,	Thread( NULL )
+,	WorkEvent( NULL )
+,	bTimeToDie( FALSE )
+,	bWriteError( FALSE )
+,	BlockFill( 0 )
+{
+	ArIsSaving = ArIsPersistent = TRUE;
+
+	Staging.Add( STAGING_SIZE );
+	Block.Add( BLOCK_SIZE );
+	if( Flags & DEMOFILE_Compressed )
+	{
+		// Room for zlib's worst case expansion, incompressible blocks are stored as is.
+		CompressedBlock.Add( BLOCK_SIZE + BLOCK_SIZE / 8 + 64 );
+	}
+	WorkEvent = GSynchronizeFactory->CreateSynchEvent();
+
+	WriteHeader( 0 );
+}
+
+/** Destructor, closing the file without an index if Finish hasn't been called. */
+FDemoFileWriter::~FDemoFileWriter()
+{
+	if( FileAr )
+	{
+		// The reader finds the blocks of files without an index by walking them.
+		Flush();
+		StopThread();
+		WriteBlock();
+		delete FileAr;
+		FileAr = NULL;
+	}
+	if( WorkEvent )
+	{
+		GSynchronizeFactory->Destroy( WorkEvent );
+	}
+}
+
+/**
+ * Waits for the writer thread to write all data and finishes the file with the passed in keyframes.
+ *
+ * @param	Keyframes	keyframes taken while recording
+ * @return	TRUE if the file was written without errors
+ */
+UBOOL FDemoFileWriter::Finish( const TArray<FDemoKeyframe>& Keyframes )
+{
+	check(FileAr);
+	Flush();
+	StopThread();
+	WriteBlock();
+
+	// The writer thread is gone so its state can be accessed freely.
+	INT IndexOffset = FileAr->Tell();
+	TArray<FDemoKeyframe> Index = Keyframes;
+	*FileAr << BlockOffsets << Index;
+	for( INT KeyframeIndex=0; KeyframeIndex<Index.Num(); KeyframeIndex++ )
+	{
+		*FileAr << Index(KeyframeIndex).SnapshotData;
+	}
+	const INT FileSize = FileAr->Tell();
+	FileAr->Seek( 0 );
+	WriteHeader( IndexOffset );
+
+	const UBOOL bSuccess = !bWriteError && FileAr->Close();
+	debugf( NAME_DevNet, TEXT("Demo file closed: %i bytes recorded, %i bytes written, %i keyframes, %i ring buffer stalls"), CommittedSize, FileSize, Keyframes.Num(), NumStalls );
+	delete FileAr;
+	FileAr = NULL;
+	return bSuccess;
+}
+
+/**
+ * Writes the file header, with the index offset and stream size known once the file is closed.
+ *
+ * @param	IndexOffset	file offset of the index, 0 if there is none yet
+ */
+void FDemoFileWriter::WriteHeader( INT IndexOffset )
+{
+	DWORD	Tag			= DEMO_FILE_TAG;
+	INT		Version		= DEMO_FILE_VERSION;
+	INT		BlockSize	= BLOCK_SIZE;
+	INT		StreamSize	= CommittedSize;
+	*FileAr << Tag << Version << Flags << BlockSize << StreamSize << IndexOffset;
+}
+
+/** Stops the writer thread after it has written all data committed to the ring buffer. */
+void FDemoFileWriter::StopThread()
+{
+	if( Thread )
+	{
+		// Kill calls Stop and waits for Run to return.
+		Thread->Kill( TRUE );
+		GThreadFactory->Destroy( Thread );
+		Thread = NULL;
+	}
+}
+
+/** Writes the block gathered by the writer thread to the file. */
+void FDemoFileWriter::WriteBlock()
+{
+	if( BlockFill == 0 )
+	{
+		return;
+	}
+
+	INT UncompressedSize	= BlockFill;
+	INT StoredSize			= BlockFill;
+	BYTE* StoredData		= Block.GetTypedData();
+	if( Flags & DEMOFILE_Compressed )
+	{
+		INT CompressedSize = CompressedBlock.Num();
+		if( appCompressMemory( COMPRESS_ZLIB, CompressedBlock.GetData(), CompressedSize, Block.GetData(), BlockFill ) && CompressedSize < BlockFill )
+		{
+			StoredSize = CompressedSize;
+			StoredData = CompressedBlock.GetTypedData();
+		}
+	}
+
+	BlockOffsets.AddItem( FileAr->Tell() );
+	*FileAr << StoredSize << UncompressedSize;
+	FileAr->Serialize( StoredData, StoredSize );
+	if( FileAr->IsError() )
+	{
+		bWriteError = TRUE;
+	}
+	BlockFill = 0;
+}
+
+/**
+ * Adds stream data to the current block, writing out blocks as they fill up.
+ *
+ * @param	Data	data to add
+ * @param	Length	number of bytes to add
+ */
+void FDemoFileWriter::AppendToBlock( const BYTE* Data, INT Length )
+{
+	while( Length > 0 )
+	{
+		const INT Size = Min( Length, BLOCK_SIZE - BlockFill );
+		appMemcpy( &Block(BlockFill), Data, Size );
+		BlockFill	+= Size;
+		Data		+= Size;
+		Length		-= Size;
+		if( BlockFill == BLOCK_SIZE )
+		{
+			WriteBlock();
+		}
+	}
+}
+
+void FDemoFileWriter::Serialize( void* V, INT Length )
+{
+	BYTE* Src = (BYTE*) V;
+	while( Length > 0 )
+	{
+		const INT Size = Min( Length, STAGING_SIZE - StagedSize );
+		appMemcpy( &Staging(StagedSize), Src, Size );
+		StagedSize	+= Size;
+		Src			+= Size;
+		Length		-= Size;
+		if( StagedSize == STAGING_SIZE )
+		{
+			Flush();
+		}
+	}
+}
+
+INT FDemoFileWriter::Tell()
+{
+	return CommittedSize + StagedSize;
+}
+
+/**
+ * Hands the staged data to the writer thread, or adds it to the current block right away if there is none.
+ */
+void FDemoFileWriter::Flush()
+{
+	if( bWriteError )
+	{
+		ArIsError = TRUE;
+	}
+	if( StagedSize > 0 && !Thread )
+	{
+		AppendToBlock( Staging.GetTypedData(), StagedSize );
+		CommittedSize	+= StagedSize;
+		StagedSize		= 0;
+	}
+	else if( StagedSize > 0 )
+	{
+		const DOUBLE StartTime = appSeconds();
+		{
+			FRingBuffer::AllocationContext Allocation( RingBuffer, StagedSize );
+			appMemcpy( Allocation.GetAllocation(), Staging.GetData(), StagedSize );
+		}
+		// Allocating only takes long if it had to wait for the writer thread to make room.
+		if( appSeconds() - StartTime > 0.001 )
+		{
+			NumStalls++;
+		}
+		CommittedSize	+= StagedSize;
+		StagedSize		= 0;
+		WorkEvent->Trigger();
+	}
+}
+
+UBOOL FDemoFileWriter::Init()
+{
+	return WorkEvent != NULL;
+}
+
+DWORD FDemoFileWriter::Run()
+{
+	for( ; ; )
+	{
+		// Look at the flag before draining so everything committed before Stop gets written.
+		const UBOOL bExit = bTimeToDie;
+		appMemoryBarrier();
+
+		volatile void* ReadPointer;
+		UINT ReadSize;
+		while( RingBuffer.BeginRead( ReadPointer, ReadSize ) )
+		{
+			AppendToBlock( (const BYTE*) ReadPointer, ReadSize );
+			RingBuffer.FinishRead( ReadSize );
+		}
+
+		if( bExit )
+		{
+			break;
+		}
+		WorkEvent->Wait( 100 );
+	}
+	return 0;
+}
+
+void FDemoFileWriter::Stop()
+{
+	bTimeToDie = TRUE;
+	WorkEvent->Trigger();
+}
+
+void FDemoFileWriter::Exit()
+{
+}
+
+/*-----------------------------------------------------------------------------
+	FDemoFileReader implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, taking ownership of the file reader which needs to be positioned after the tag.
+ *
+ * @param	InFileAr	archive reading the demo file
+ */
+FDemoFileReader::FDemoFileReader( FArchive* InFileAr )
+:	FileAr( InFileAr )
+,	Flags( 0 )
+,	BlockSize( 0 )
+,	StreamSize( 0 )
+,	CurrentBlock( INDEX_NONE )
+,	BlockDataSize( 0 )
+,	Pos( 0 )
+{
+	ArIsLoading = ArIsPersistent = TRUE;
+
+	INT Version		= 0;
+	INT IndexOffset	= 0;
+	*FileAr << Version << Flags << BlockSize << StreamSize << IndexOffset;
+	if( FileAr->IsError() || Version > DEMO_FILE_VERSION || BlockSize <= 0 )
+	{
+		debugf( NAME_DevNet, TEXT("Unsupported demo file version %i"), Version );
+		ArIsError = TRUE;
+		return;
+	}
+
+	if( IndexOffset )
+	{
+		FileAr->Seek( IndexOffset );
+		*FileAr << BlockOffsets << Keyframes;
+		// Keyframes of older files have no snapshot, channels were closed before taking them instead.
+		if( Version >= DEMO_FILE_VERSION_SNAPSHOTS )
+		{
+			for( INT KeyframeIndex=0; KeyframeIndex<Keyframes.Num(); KeyframeIndex++ )
+			{
+				*FileAr << Keyframes(KeyframeIndex).SnapshotData;
+			}
+		}
+	}
+	else
+	{
+		// Recording didn't finish, so there is no index. Walk the blocks that made it to disk.
+		const INT FileSize = FileAr->TotalSize();
+		INT Offset = 4 + DEMO_HEADER_SIZE;
+		StreamSize = 0;
+		while( Offset + DEMO_BLOCK_HEADER_SIZE <= FileSize )
+		{
+			INT StoredSize, UncompressedSize;
+			FileAr->Seek( Offset );
+			*FileAr << StoredSize << UncompressedSize;
+			if( StoredSize < 0 || UncompressedSize < 0 || Offset + DEMO_BLOCK_HEADER_SIZE + StoredSize > FileSize )
+			{
+				break;
+			}
+			BlockOffsets.AddItem( Offset );
+			StreamSize	+= UncompressedSize;
+			Offset		+= DEMO_BLOCK_HEADER_SIZE + StoredSize;
+		}
+		debugf( NAME_DevNet, TEXT("Demo file has no index, recovered %i bytes"), StreamSize );
+	}
+
+	if( FileAr->IsError() )
+	{
+		ArIsError = TRUE;
+	}
+	BlockData.Add( BlockSize );
+}
+
+/** Destructor, closing the file. */
+FDemoFileReader::~FDemoFileReader()
+{
+	delete FileAr;
+	FileAr = NULL;
+}
+
+/**
+ * Reads and decompresses a block.
+ *
+ * @param	BlockIndex	index of block to load
+ * @return	TRUE if successful
+ */
+UBOOL FDemoFileReader::LoadBlock( INT BlockIndex )
+{
+	CurrentBlock = INDEX_NONE;
+	if( !BlockOffsets.IsValidIndex(BlockIndex) )
+	{
+		return FALSE;
+	}
+
+	INT StoredSize, UncompressedSize;
+	FileAr->Seek( BlockOffsets(BlockIndex) );
+	*FileAr << StoredSize << UncompressedSize;
+	if( FileAr->IsError() || StoredSize < 0 || UncompressedSize < 0 || UncompressedSize > BlockSize )
+	{
+		return FALSE;
+	}
+
+	// Blocks are only stored compressed if that made them smaller.
+	if( StoredSize == UncompressedSize )
+	{
+		FileAr->Serialize( BlockData.GetData(), StoredSize );
+	}
+	else
+	{
+		if( CompressedBlock.Num() < StoredSize )
+		{
+			CompressedBlock.Add( StoredSize - CompressedBlock.Num() );
+		}
+		FileAr->Serialize( CompressedBlock.GetData(), StoredSize );
+		if( FileAr->IsError() || !appUncompressMemory( COMPRESS_ZLIB, BlockData.GetData(), UncompressedSize, CompressedBlock.GetData(), StoredSize ) )
+		{
+			return FALSE;
+		}
+	}
+	if( FileAr->IsError() )
+	{
+		return FALSE;
+	}
+
+	BlockDataSize	= UncompressedSize;
+	CurrentBlock	= BlockIndex;
+	return TRUE;
+}
+
+void FDemoFileReader::Serialize( void* V, INT Length )
+{
+	BYTE* Dest = (BYTE*) V;
+	while( Length > 0 )
+	{
+		const INT BlockIndex = Pos / BlockSize;
+		if( ArIsError || Pos >= StreamSize || (BlockIndex != CurrentBlock && !LoadBlock(BlockIndex)) )
+		{
+			ArIsError = TRUE;
+			appMemzero( Dest, Length );
+			return;
+		}
+
+		const INT BlockPos	= Pos - BlockIndex * BlockSize;
+		const INT Size		= Min( Length, BlockDataSize - BlockPos );
+		if( Size <= 0 )
+		{
+			// Block is shorter than the stream size claims.
+			ArIsError = TRUE;
+			appMemzero( Dest, Length );
+			return;
+		}
+		appMemcpy( Dest, &BlockData(BlockPos), Size );
+		Pos		+= Size;
+		Dest	+= Size;
+		Length	-= Size;
+	}
+}
+
+INT FDemoFileReader::Tell()
+{
+	return Pos;
+}
+
+INT FDemoFileReader::TotalSize()
+{
+	return StreamSize;
+}
+
+void FDemoFileReader::Seek( INT InPos )
+{
+	check(InPos>=0);
+	check(InPos<=StreamSize);
+	Pos = InPos;
+}
+
+/*-----------------------------------------------------------------------------
+	Demo file helpers.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Opens a demo file for reading, handling files recorded before demo files had a header.
+ *
+ * @param	Filename	demo file to open
+ * @param	Keyframes	[out] keyframes stored in the file, left empty if there are none
+ * @return	archive reading the demo stream, NULL if the file couldn't be opened
+ */
+FArchive* CreateDemoFileReader( const TCHAR* Filename, TArray<FDemoKeyframe>& Keyframes )
+{
+	Keyframes.Empty();
+
+	FArchive* FileAr = GFileManager->CreateFileReader( Filename );
+	if( !FileAr )
+	{
+		return NULL;
+	}
+
+	DWORD Tag = 0;
+	if( FileAr->TotalSize() >= 4 + DEMO_HEADER_SIZE )
+	{
+		*FileAr << Tag;
+	}
+	if( Tag != DEMO_FILE_TAG )
+	{
+		// Recorded before demo files had a header, the file is the uncompressed stream.
+		FileAr->Seek( 0 );
+		return FileAr;
+	}
+
+	FDemoFileReader* Reader = new FDemoFileReader( FileAr );
+	Keyframes = Reader->GetKeyframes();
+	return Reader;
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
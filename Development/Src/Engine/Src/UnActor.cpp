@@ -1199,6 +1199,12 @@ void APlayerController::SetPlayer( UPlayer* InPlayer )
 void AActor::BeginDestroy()
 {
 	ClearComponents();
+	// Make sure the timer wheel of the actor's world doesn't hold on to actors that got collected without being destroyed.
+	FTimerWheel* TimerWheel = FTimerWheel::GetActorTimerWheel( this );
+	if( TimerWheel )
+	{
+		TimerWheel->RemoveActor( this );
+	}
 	Super::BeginDestroy();
 }
 
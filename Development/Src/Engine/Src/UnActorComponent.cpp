@@ -566,6 +566,14 @@ void UActorComponent::ConditionalTick(FLOAT DeltaTime)
 	}
 }
 
+void UActorComponent::ConditionalTickParallel(FLOAT DeltaTime)
+{
+	if(bAttached)
+	{
+		TickParallel(DeltaTime);
+	}
+}
+
 /**
  * Sets the ticking group for this component
  *
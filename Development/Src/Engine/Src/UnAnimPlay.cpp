@@ -1246,7 +1246,7 @@ void UAnimNodeSequenceBlendBase::GetBoneAtoms(TArray<FBoneAtom>& Atoms, const TA
 	check(LastChildIndex != INDEX_NONE);
 
 	// We don't allocate this array until we need it.
-	TArray<FBoneAtom> ChildAtoms;
+	FBoneAtomArray ChildAtoms;
 	UBOOL bNoChildrenYet = TRUE;
 
 	// Root Motion
@@ -43,6 +43,30 @@ static const FColor InactiveColor(128,128,128,255);
 /** Anim stats */
 DECLARE_STATS_GROUP(TEXT("Anim"),STATGROUP_Anim);
 
+/*-----------------------------------------------------------------------------
+	FBoneAtomArray.
+-----------------------------------------------------------------------------*/
+
+TArray<FBoneAtom> FBoneAtomArray::Pool[FBoneAtomArray::MAX_POOLED_ARRAYS];
+INT FBoneAtomArray::NumPooled = 0;
+
+FBoneAtomArray::FBoneAtomArray()
+{
+	if( NumPooled > 0 && IsInGameThread() )
+	{
+		ExchangeArray<FBoneAtom>( *this, Pool[--NumPooled] );
+	}
+}
+
+FBoneAtomArray::~FBoneAtomArray()
+{
+	if( GetSlack() + Num() > 0 && NumPooled < MAX_POOLED_ARRAYS && IsInGameThread() )
+	{
+		Reset();
+		ExchangeArray<FBoneAtom>( *this, Pool[NumPooled++] );
+	}
+}
+
 /****
 SeklCompTick
 
@@ -666,7 +690,7 @@ void UAnimNodeBlendBase::GetBoneAtoms(TArray<FBoneAtom>& Atoms, const TArray<BYT
 	check(LastChildIndex != INDEX_NONE);
 
 	// We don't allocate this array until we need it.
-	TArray<FBoneAtom> ChildAtoms;
+	FBoneAtomArray ChildAtoms;
 	UBOOL bNoChildrenYet = TRUE;
 
 	bHasRootMotion						= 0;
@@ -815,7 +839,7 @@ void UAnimNodeBlendBase::GetMirroredBoneAtoms(TArray<FBoneAtom>& Atoms, INT Chil
 	if( SkelMesh->SkelMirrorTable.Num() == Atoms.Num() )
 	{
 		// Get atoms from SourceNode.
-		TArray<FBoneAtom> ChildAtoms;
+		FBoneAtomArray ChildAtoms;
 		ChildAtoms.Add(Atoms.Num());
 
 		FBoneAtom RMD;
@@ -1431,7 +1455,7 @@ void UAnimNodeBlendPerBone::GetBoneAtoms(TArray<FBoneAtom>& Atoms, const TArray<
 	TArray<FMeshBone>& RefSkel = SkelComponent->SkeletalMesh->RefSkeleton;
 	const INT NumAtoms = RefSkel.Num();
 
-	TArray<FBoneAtom> Child1Atoms, Child2Atoms;
+	FBoneAtomArray Child1Atoms, Child2Atoms;
 
 	// Get bone atoms from each child (if no child - use ref pose).
 	Child1Atoms.Add(NumAtoms);
@@ -3008,7 +3032,7 @@ void UAnimNodeBlendMultiBone::GetBoneAtoms(TArray<FBoneAtom>& Atoms, const TArra
 	check(LastChildIndex != INDEX_NONE);
 
 	// We don't allocate this array until we need it.
-	TArray<FBoneAtom> ChildAtoms;
+	FBoneAtomArray ChildAtoms;
 	if( LastChildIndex == 0 )
 	{
 		if( Children(0).Anim )
@@ -390,7 +390,8 @@ public:
 		checkSlow(Data);
 		// current render target set for the canvas
 		const FRenderTarget* CanvasRenderTarget = Canvas->GetRenderTarget();
-		FSceneViewFamily* ViewFamily = new FSceneViewFamily(
+		// The view only lives till the tile has been drawn so it is allocated from the frame arena.
+		FSceneViewFamily* ViewFamily = new(GFrameArena,1,16) FSceneViewFamily(
 			CanvasRenderTarget,
 			NULL,
 			SHOW_DefaultGame,
@@ -401,7 +402,7 @@ public:
 			);
 
 		// make a temporary view
-		FViewInfo* View = new FViewInfo(ViewFamily, 
+		FViewInfo* View = new(GFrameArena,1,16) FViewInfo(ViewFamily, 
 			NULL, 
 			NULL, 
 			NULL, 
@@ -433,8 +434,8 @@ public:
 				Canvas->IsHitTesting(), Canvas->GetHitProxyId()
 				);
 
-			delete View->Family;
-			delete View;
+			View->Family->~FSceneViewFamily();
+			View->~FViewInfo();
 			delete Data;
 		}
 		else
@@ -468,8 +469,8 @@ public:
 					Parameters.bIsHitTesting, Parameters.HitProxyId
 					);
 
-				delete Parameters.View->Family;
-				delete Parameters.View;
+				Parameters.View->Family->~FSceneViewFamily();
+				Parameters.View->~FViewInfo();
 				delete Parameters.RenderData;
 			});
 		}
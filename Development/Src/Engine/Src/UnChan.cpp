@@ -447,12 +447,12 @@ FString UChannel::Describe()
 //
 // Return whether this channel is ready for sending.
 //
-INT UChannel::IsNetReady( UBOOL Saturate )
+INT UChannel::IsNetReady( UBOOL Saturate, ESendPriority Priority )
 {
 	// If saturation allowed, ignore queued byte count.
 	if( NumOutRec>=RELIABLE_BUFFER-1 )
 		return 0;
-	return Connection->IsNetReady( Saturate );
+	return Connection->IsNetReady( Saturate, Priority );
 
 }
 
@@ -481,6 +481,12 @@ void UChannel::ReceivedNak( INT NakPacketId )
 	}
 }
 
+//
+// Positive acknowledgement of a packet, received before ReceivedAcks is called.
+//
+void UChannel::ReceivedAck( INT AckPacketId )
+{}
+
 // UChannel statics.
 UClass* UChannel::ChannelClasses[CHTYPE_MAX]={0,0,0,0,0,0,0,0};
 IMPLEMENT_CLASS(UChannel)
@@ -696,6 +702,176 @@ FString UControlChannel::Describe()
 
 IMPLEMENT_CLASS(UControlChannel);
 
+/*-----------------------------------------------------------------------------
+	FNetDeltaHistory implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, initializing an empty history.
+ *
+ * @param	bInRotator	whether the property is a rotator rather than a vector
+ */
+FNetDeltaHistory::FNetDeltaHistory( UBOOL bInRotator )
+:	LastSequence( INDEX_NONE )
+,	bPendingSend( FALSE )
+,	bRotator( bInRotator )
+{
+	for( INT i=0; i<HISTORY_SIZE; i++ )
+	{
+		Entries[i].Sequence		= INDEX_NONE;
+		Entries[i].OutPacketId	= INDEX_NONE;
+		Entries[i].bAcked		= FALSE;
+	}
+}
+
+/**
+ * Quantizes a property value the way UStructProperty::NetSerializeItem sends it.
+ *
+ * @param	Data	vector or rotator
+ * @param	Value	[out] quantized components
+ */
+void FNetDeltaHistory::Quantize( const BYTE* Data, INT* Value ) const
+{
+	if( bRotator )
+	{
+		const FRotator& R = *(const FRotator*)Data;
+		Value[0] = (R.Pitch >> 8) & 255;
+		Value[1] = (R.Yaw   >> 8) & 255;
+		Value[2] = (R.Roll  >> 8) & 255;
+	}
+	else
+	{
+		// Full values are sent with at most 20 bits plus sign.
+		const FVector& V = *(const FVector*)Data;
+		Value[0] = Clamp<INT>( appRound(V.X), -(1<<20), (1<<20)-1 );
+		Value[1] = Clamp<INT>( appRound(V.Y), -(1<<20), (1<<20)-1 );
+		Value[2] = Clamp<INT>( appRound(V.Z), -(1<<20), (1<<20)-1 );
+	}
+}
+
+/**
+ * Sets a property value from its quantized components.
+ *
+ * @param	Value	quantized components
+ * @param	Data	[out] vector or rotator
+ */
+void FNetDeltaHistory::Dequantize( const INT* Value, BYTE* Data ) const
+{
+	if( bRotator )
+	{
+		*(FRotator*)Data = FRotator( Value[0] << 8, Value[1] << 8, Value[2] << 8 );
+	}
+	else
+	{
+		*(FVector*)Data = FVector( Value[0], Value[1], Value[2] );
+	}
+}
+
+/**
+ * Serializes the difference between two quantized values, sized by the magnitude of the difference.
+ *
+ * Vector deltas use the scheme of full vectors with a smaller bit count. Rotator deltas send a bit per component
+ * telling whether it changed, followed by a small change in 4 bits or any change in 8 bits.
+ *
+ * @param	Ar		bunch to serialize to or from
+ * @param	Delta	[in/out] difference of components
+ * @return	FALSE if the difference is too large to be delta compressed (saving only)
+ */
+UBOOL FNetDeltaHistory::SerializeDelta( FArchive& Ar, INT* Delta ) const
+{
+	if( bRotator )
+	{
+		for( INT i=0; i<3; i++ )
+		{
+			// Bytes wrap around, so any difference fits in [-128,127].
+			INT D = ((Delta[i] + 128) & 255) - 128;
+			BYTE B = (D != 0);
+			Ar.SerializeBits( &B, 1 );
+			if( B )
+			{
+				B = (D >= -8 && D < 8);
+				Ar.SerializeBits( &B, 1 );
+				DWORD Bits = (D + (B ? 8 : 128)) & 255;
+				Ar.SerializeInt( Bits, B ? 16 : 256 );
+				D = (INT)Bits - (B ? 8 : 128);
+			}
+			else
+			{
+				D = 0;
+			}
+			Delta[i] = D;
+		}
+	}
+	else
+	{
+		DWORD Bits = 0;
+		if( Ar.IsSaving() )
+		{
+			const INT MaxDelta = Max( Max( Abs(Delta[0]), Abs(Delta[1]) ), Abs(Delta[2]) );
+			if( MaxDelta >= (1 << MAX_VECTOR_DELTA_BITS) )
+			{
+				return FALSE;
+			}
+			Bits = Clamp<DWORD>( appCeilLogTwo(1+MaxDelta), 1, MAX_VECTOR_DELTA_BITS ) - 1;
+		}
+		Ar.SerializeInt( Bits, MAX_VECTOR_DELTA_BITS );
+		INT   Bias = 1<<(Bits+1);
+		DWORD Max  = 1<<(Bits+2);
+		for( INT i=0; i<3; i++ )
+		{
+			DWORD D = Delta[i] + Bias;
+			Ar.SerializeInt( D, Max );
+			Delta[i] = (INT)D - Bias;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Finds the most recent acked entry a value with the passed in sequence number may be sent as a delta of.
+ *
+ * @param	Sequence	sequence number of the value to send
+ * @return	baseline entry, NULL if there is none
+ */
+const FNetDeltaHistory::FEntry* FNetDeltaHistory::FindBaseline( INT Sequence ) const
+{
+	const FEntry* Baseline = NULL;
+	for( INT i=0; i<HISTORY_SIZE; i++ )
+	{
+		const FEntry& Entry = Entries[i];
+		if( Entry.bAcked
+		&&	Entry.Sequence != INDEX_NONE
+		&&	Sequence - Entry.Sequence < HISTORY_SIZE
+		&&	(!Baseline || Entry.Sequence > Baseline->Sequence) )
+		{
+			Baseline = &Entry;
+		}
+	}
+	return Baseline;
+}
+
+/**
+ * Remembers a value. Values older than the one in its slot are ignored, they were received out of order.
+ *
+ * @param	Sequence	sequence number of the value
+ * @param	Value		quantized components
+ * @param	bAcked		whether the other side is known to have the value
+ */
+void FNetDeltaHistory::AddValue( INT Sequence, const INT* Value, UBOOL bAcked )
+{
+	FEntry& Entry = Entries[Sequence & (HISTORY_SIZE-1)];
+	if( Entry.Sequence == INDEX_NONE || Entry.Sequence < Sequence )
+	{
+		Entry.Sequence		= Sequence;
+		Entry.OutPacketId	= INDEX_NONE;
+		Entry.bAcked		= bAcked;
+		Entry.Value[0]		= Value[0];
+		Entry.Value[1]		= Value[1];
+		Entry.Value[2]		= Value[2];
+	}
+	LastSequence = Max( LastSequence, Sequence );
+}
+
 /*-----------------------------------------------------------------------------
 	UActorChannel.
 -----------------------------------------------------------------------------*/
@@ -812,7 +988,7 @@ void UActorChannel::CleanUp()
 	else if (Actor && !OpenAcked)
 	{
 		// Resend temporary actors if nak'd.
-		Connection->SentTemporaries.RemoveItem(Actor);
+		Connection->SentTemporaries.Remove(Actor);
 	}
 
 	Super::CleanUp();
@@ -831,6 +1007,135 @@ void UActorChannel::ReceivedNak( INT NakPacketId )
     ActorDirty = true; 
 }
 
+//
+// Positive acknowledgements.
+//
+void UActorChannel::ReceivedAck( INT AckPacketId )
+{
+	for( INT i=0; i<DeltaHistories.Num(); i++ )
+	{
+		DeltaHistories(i).ReceivedAck( AckPacketId );
+	}
+}
+
+/**
+ * Sends a delta compressed property, as a delta of the most recent acked value if possible and in full otherwise.
+ *
+ * @param	Bunch		bunch to write to
+ * @param	History		values previously sent
+ * @param	Property	vector or rotator property
+ * @param	Data		value to send
+ * @return	TRUE, vectors and rotators are always mapped
+ */
+UBOOL UActorChannel::SendDeltaProperty( FOutBunch& Bunch, FNetDeltaHistory& History, UProperty* Property, BYTE* Data )
+{
+	// Reliable bunches may be processed long after the packet they were sent in was acked, so only values sent
+	// unreliably are tracked. ReplicateActor sets the packet id once the bunch has been sent.
+	History.bPendingSend = OpenAcked && !Bunch.bReliable;
+	Bunch.WriteBit( History.bPendingSend );
+	if( !History.bPendingSend )
+	{
+		return Property->NetSerializeItem( Bunch, Connection->PackageMap, Data );
+	}
+
+	INT Value[3];
+	History.Quantize( Data, Value );
+	const INT Sequence = History.LastSequence + 1;
+
+	// Send the difference to the most recent value the other side is known to have.
+	UBOOL bSentDelta = FALSE;
+	const FNetDeltaHistory::FEntry* Baseline = History.FindBaseline( Sequence );
+	if( Baseline )
+	{
+		INT Delta[3];
+		for( INT i=0; i<3; i++ )
+		{
+			Delta[i] = Value[i] - Baseline->Value[i];
+		}
+		FBitWriterMark DeltaMark( Bunch );
+		Bunch.WriteBit( 1 );
+		Bunch.WriteInt( Sequence & (FNetDeltaHistory::MAX_DELTA_SEQUENCE-1), FNetDeltaHistory::MAX_DELTA_SEQUENCE );
+		Bunch.WriteInt( Sequence - Baseline->Sequence - 1, FNetDeltaHistory::HISTORY_SIZE-1 );
+		bSentDelta = History.SerializeDelta( Bunch, Delta );
+		if( !bSentDelta )
+		{
+			DeltaMark.Pop( Bunch );
+		}
+	}
+
+	// Fall back to the full value if nothing was acked recently, e.g. after packet loss, or the delta is too large.
+	if( !bSentDelta )
+	{
+		Bunch.WriteBit( 0 );
+		Bunch.WriteInt( Sequence & (FNetDeltaHistory::MAX_FULL_SEQUENCE-1), FNetDeltaHistory::MAX_FULL_SEQUENCE );
+		Property->NetSerializeItem( Bunch, Connection->PackageMap, Data );
+	}
+
+	History.AddValue( Sequence, Value, FALSE );
+	return TRUE;
+}
+
+/**
+ * Receives a property sent by SendDeltaProperty. Data is left untouched if the baseline of a delta is missing.
+ *
+ * @param	Bunch		bunch to read from
+ * @param	History		values previously received
+ * @param	Property	vector or rotator property
+ * @param	Data		[out] received value
+ */
+void UActorChannel::ReceiveDeltaProperty( FInBunch& Bunch, FNetDeltaHistory& History, UProperty* Property, BYTE* Data )
+{
+	if( !Bunch.ReadBit() )
+	{
+		// Untracked full value.
+		Property->NetSerializeItem( Bunch, Connection->PackageMap, Data );
+		return;
+	}
+
+	INT Value[3] = { 0, 0, 0 };
+	INT Sequence;
+	if( Bunch.ReadBit() )
+	{
+		// Delta of a recent value, the sequence number is at most HISTORY_SIZE ahead of the last one received.
+		Sequence = MakeRelative( Bunch.ReadInt(FNetDeltaHistory::MAX_DELTA_SEQUENCE), History.LastSequence, FNetDeltaHistory::MAX_DELTA_SEQUENCE );
+		const INT BaselineSequence = Sequence - 1 - Bunch.ReadInt( FNetDeltaHistory::HISTORY_SIZE-1 );
+		History.SerializeDelta( Bunch, Value );
+		if( Bunch.IsError() )
+		{
+			return;
+		}
+
+		const FNetDeltaHistory::FEntry& Baseline = History.Entries[BaselineSequence & (FNetDeltaHistory::HISTORY_SIZE-1)];
+		if( Baseline.Sequence != BaselineSequence )
+		{
+			// Only happens if the sender's and our sequence numbers got out of sync, keep the old value.
+			debugfSlow( NAME_DevNetTraffic, TEXT("Missing delta baseline %i of %s in %s"), BaselineSequence, *Property->GetName(), *Describe() );
+			return;
+		}
+		for( INT i=0; i<3; i++ )
+		{
+			Value[i] += Baseline.Value[i];
+			if( History.bRotator )
+			{
+				Value[i] &= 255;
+			}
+		}
+		History.Dequantize( Value, Data );
+	}
+	else
+	{
+		// Full value.
+		Sequence = MakeRelative( Bunch.ReadInt(FNetDeltaHistory::MAX_FULL_SEQUENCE), History.LastSequence, FNetDeltaHistory::MAX_FULL_SEQUENCE );
+		Property->NetSerializeItem( Bunch, Connection->PackageMap, Data );
+		History.Quantize( Data, Value );
+	}
+
+	if( !Bunch.IsError() )
+	{
+		History.AddValue( Sequence, Value, TRUE );
+	}
+}
+
 //
 // Allocate replication tables for the actor channel.
 //
@@ -874,6 +1179,26 @@ void UActorChannel::SetChannelActor( AActor* InActor )
 	// Allocate replication condition evaluation cache.
 	RepEval.AddZeroed( ClassCache->GetRepConditionCount() );
 
+	// Nothing has been compared yet.
+	LastPropertyHistoryIndex = INDEX_NONE;
+
+	// Set up delta compression of vector and rotator properties.
+	if( Connection->bDeltaCompressVectors )
+	{
+		DeltaHistoryIndices.Empty( ActorClass->ClassReps.Num() );
+		for( INT i=0; i<ActorClass->ClassReps.Num(); i++ )
+		{
+			INT HistoryIndex = INDEX_NONE;
+			UStructProperty* StructProperty = Cast<UStructProperty>( ActorClass->ClassReps(i).Property, CLASS_IsAUStructProperty );
+			if( StructProperty && (StructProperty->Struct->GetFName()==NAME_Vector || StructProperty->Struct->GetFName()==NAME_Rotator) )
+			{
+				HistoryIndex = DeltaHistories.Num();
+				new(DeltaHistories)FNetDeltaHistory( StructProperty->Struct->GetFName()==NAME_Rotator );
+			}
+			DeltaHistoryIndices.AddItem( HistoryIndex );
+		}
+	}
+
 	// Init recent properties.
 	if( !InActor->bNetTemporary )
 	{
@@ -1083,7 +1408,15 @@ void UActorChannel::ReceivedBunch( FInBunch& Bunch )
 			FMemMark Mark(GMem);
 			INT   Offset = It->Offset + Element*It->ElementSize;
 			BYTE* Data   = DestActor ? (DestActor + Offset) : NewZeroed<BYTE>(GMem,It->ElementSize);
-			It->NetSerializeItem( Bunch, Connection->PackageMap, Data );
+			const INT DeltaHistoryIndex = DeltaHistoryIndices.Num() ? DeltaHistoryIndices(It->RepIndex + Element) : INDEX_NONE;
+			if( DeltaHistoryIndex != INDEX_NONE )
+			{
+				ReceiveDeltaProperty( Bunch, DeltaHistories(DeltaHistoryIndex), It, Data );
+			}
+			else
+			{
+				It->NetSerializeItem( Bunch, Connection->PackageMap, Data );
+			}
 			if( DestRecent )
 				It->CopySingleValue( DestRecent + Offset, Data );
 			Mark.Pop();
@@ -1191,11 +1524,42 @@ void UActorChannel::ReceivedBunch( FInBunch& Bunch )
 	}
 }
 
+/**
+ * Evaluates the replication condition of a property, natively if it was translated and by running its
+ * bytecode otherwise.
+ *
+ * @param	Actor		actor to evaluate condition for
+ * @param	ClassCache	net cache of the actor's class
+ * @param	FieldCache	net cache of the property
+ * @param	Property	property to evaluate condition of
+ * @return	result of the condition, or'ed with 2 to mark it as evaluated
+ */
+static BYTE EvaluateRepCondition( AActor* Actor, FClassNetCache* ClassCache, FFieldNetCache* FieldCache, UProperty* Property )
+{
+	const FRepConditionProgram& Condition = ClassCache->GetRepCondition( FieldCache->ConditionIndex );
+	DWORD Val=0;
+	if( Condition.IsCompiled() )
+	{
+		Val = Condition.Evaluate( (BYTE*)Actor );
+#if DO_GUARD_SLOW
+		DWORD ScriptVal=0;
+		FFrame( Actor, Property->RepOwner->GetOwnerClass(), Property->RepOwner->RepOffset, NULL ).Step( Actor, &ScriptVal );
+		checkSlow(Val == (ScriptVal ? 1 : 0));
+#endif
+	}
+	else
+	{
+		FFrame( Actor, Property->RepOwner->GetOwnerClass(), Property->RepOwner->RepOffset, NULL ).Step( Actor, &Val );
+	}
+	return Val | 2;
+}
+
 //
 // Replicate this channel's actor differences.
 //
 void UActorChannel::ReplicateActor()
 {
+	SCOPE_CYCLE_COUNTER(STAT_NetReplicateActorTime);
 	checkSlow(Actor);
 	checkSlow(!Closing);
 
@@ -1329,6 +1693,39 @@ void UActorChannel::ReplicateActor()
 	BYTE*   CompareBin = Recent.Num() ? &Recent(0) : ActorClass->GetDefaults();
 	INT     iCount     = ClassCache->RepProperties.Num();
 	LastRep            = Actor->GetOptimizedRepList( CompareBin, &Retirement(0), Reps, Connection->PackageMap,this );
+
+	// Narrow down the properties that may differ from Recent using the actor's shared change history. Bits
+	// of properties found identical or sent are cleared below, the remaining ones are compared next time.
+	DWORD* CompareMask = NULL;
+	FPropertyChangeHistory* History = NULL;
+	if( Recent.Num() )
+	{
+		SCOPE_CYCLE_COUNTER(STAT_NetPropertyCompareTime);
+		History = Connection->Driver->GetPropertyChangeHistory( Actor );
+	}
+	if( History )
+	{
+		const INT MaskSize = History->GetMaskSize();
+		CompareMask = NewZeroed<DWORD>( GMem, MaskSize );
+		if( UnsentPropertyMask.Num()==MaskSize && History->GetChangedSince(LastPropertyHistoryIndex,CompareMask) )
+		{
+			const DWORD* AlwaysCompareMask = History->GetAlwaysCompareMask();
+			for( INT i=0; i<MaskSize; i++ )
+			{
+				CompareMask[i] |= UnsentPropertyMask(i) | AlwaysCompareMask[i];
+			}
+		}
+		else
+		{
+			appMemset( CompareMask, 0xff, MaskSize * sizeof(DWORD) );
+		}
+		LastPropertyHistoryIndex = History->GetHistoryIndex();
+	}
+	else
+	{
+		LastPropertyHistoryIndex = INDEX_NONE;
+	}
+
 	if ( Actor->bNetDirty )
 	{
 		//if ( iCount > 0 ) debugf(TEXT("%s iCount %d"),Actor->GetName(), iCount);
@@ -1339,6 +1736,7 @@ void UActorChannel::ReplicateActor()
 		}
 		else
 		{
+			SCOPE_CYCLE_COUNTER(STAT_NetPropertyCompareTime);
 			for( INT iField=0; iField<iCount; iField++  )
 			{
 				FFieldNetCache* FieldCache = ClassCache->RepProperties(iField);
@@ -1349,6 +1747,13 @@ void UActorChannel::ReplicateActor()
 					UObjectProperty* Op = Cast<UObjectProperty>(It,CLASS_IsAUObjectProperty);
 					for( INT Index=0; Index<It->ArrayDim; Index++ )
 					{
+						// Skip properties that can't have changed since they were last sent.
+						const INT RepIndex = It->RepIndex + Index;
+						if( CompareMask && !(CompareMask[RepIndex / 32] & (1 << (RepIndex & 31))) )
+						{
+							continue;
+						}
+
 						// Evaluate need to send the property.
 						INT Offset = It->Offset + Index*It->ElementSize;
 						BYTE* Src = (BYTE*)Actor + Offset;
@@ -1358,9 +1763,7 @@ void UActorChannel::ReplicateActor()
 							{
 								if( !(Eval & 2) )
 								{
-									DWORD Val=0;
-									FFrame( Actor, It->RepOwner->GetOwnerClass(), It->RepOwner->RepOffset, NULL ).Step( Actor, &Val );
-									Eval = Val | 2;
+									Eval = EvaluateRepCondition( Actor, ClassCache, FieldCache, It );
 								}
 								if( Eval & 1 )
 								{
@@ -1374,13 +1777,15 @@ void UActorChannel::ReplicateActor()
 						{
 							if( !(Eval & 2) )
 							{
-								DWORD Val=0;
-								FFrame( Actor, It->RepOwner->GetOwnerClass(), It->RepOwner->RepOffset, NULL ).Step( Actor, &Val );
-								Eval = Val | 2;
+								Eval = EvaluateRepCondition( Actor, ClassCache, FieldCache, It );
 							}
 							if( Eval & 1 )
 								*LastRep++ = It->RepIndex+Index;
 						}
+						else if( CompareMask )
+						{
+							CompareMask[RepIndex / 32] &= ~(1 << (RepIndex & 31));
+						}
 					}
 				}
 			}
@@ -1415,6 +1820,7 @@ void UActorChannel::ReplicateActor()
 			*LastRep++=D;
 	}
 	TArray<INT>  StillDirty;
+	UBOOL bSentDeltaValues = FALSE;
 
 	// Replicate those properties.
 	for( INT* iPtr=Reps; iPtr<LastRep; iPtr++ )
@@ -1444,7 +1850,17 @@ void UActorChannel::ReplicateActor()
 		}
 
 		// Send property.
-		UBOOL Mapped = It->NetSerializeItem( Bunch, Connection->PackageMap, (BYTE*)Actor + Offset );
+		UBOOL Mapped;
+		const INT DeltaHistoryIndex = DeltaHistoryIndices.Num() ? DeltaHistoryIndices(*iPtr) : INDEX_NONE;
+		if( DeltaHistoryIndex != INDEX_NONE )
+		{
+			Mapped = SendDeltaProperty( Bunch, DeltaHistories(DeltaHistoryIndex), It, (BYTE*)Actor + Offset );
+			bSentDeltaValues |= DeltaHistories(DeltaHistoryIndex).bPendingSend;
+		}
+		else
+		{
+			Mapped = It->NetSerializeItem( Bunch, Connection->PackageMap, (BYTE*)Actor + Offset );
+		}
 		debugfSuppressed(NAME_DevNetTraffic,TEXT("   Send %s %i"),*It->GetName(),Mapped);
 		if( !Bunch.IsError() )
 		{
@@ -1452,7 +1868,13 @@ void UActorChannel::ReplicateActor()
 			if( Recent.Num() )
 			{
 				if( Mapped )
+				{
 					It->CopySingleValue( &Recent(Offset), (BYTE*)Actor + Offset );
+					if( CompareMask )
+					{
+						CompareMask[*iPtr / 32] &= ~(1 << (*iPtr & 31));
+					}
+				}
 				else
 					StillDirty.AddUniqueItem(*iPtr);
 			}
@@ -1470,22 +1892,44 @@ void UActorChannel::ReplicateActor()
 	// If not empty, send and mark as updated.
 	if( Bunch.GetNumBits() )
 	{
-		INT PacketId = SendBunch( &Bunch, 1 );
+		// Merging could turn the bunch reliable, delaying its processing past the ack of its packet.
+		INT PacketId = SendBunch( &Bunch, !bSentDeltaValues );
 		for( INT* Rep=Reps; Rep<LastRep; Rep++ )
 		{
 			Dirty.RemoveItem(*Rep);
 			FPropertyRetirement& Retire = Retirement(*Rep);
 			Retire.OutPacketId = PacketId;
 			Retire.Reliable    = Bunch.bReliable;
+
+			// Delta compressed values may serve as baseline once the packet has been acked.
+			if( DeltaHistoryIndices.Num() && DeltaHistoryIndices(*Rep) != INDEX_NONE )
+			{
+				FNetDeltaHistory& History = DeltaHistories(DeltaHistoryIndices(*Rep));
+				if( History.bPendingSend )
+				{
+					FNetDeltaHistory::FEntry& Entry = History.Entries[History.LastSequence & (FNetDeltaHistory::HISTORY_SIZE-1)];
+					Entry.OutPacketId		= PacketId;
+					Entry.bAcked			= Connection->InternalAck;
+					History.bPendingSend	= FALSE;
+				}
+			}
 		}
 		if( Actor->bNetTemporary )
 		{
-			Connection->SentTemporaries.AddItem( Actor );
+			Connection->SentTemporaries.Set( Actor, TRUE );
 		}
 	}
 	for ( INT i=0; i<StillDirty.Num(); i++ )
 		Dirty.AddUniqueItem(StillDirty(i));
 
+	// Remember what is left to compare next time.
+	if( CompareMask )
+	{
+		UnsentPropertyMask.Empty( History->GetMaskSize() );
+		UnsentPropertyMask.Add( History->GetMaskSize() );
+		appMemcpy( &UnsentPropertyMask(0), CompareMask, History->GetMaskSize() * sizeof(DWORD) );
+	}
+
 	// If we evaluated everything, mark LastUpdateTime, even if nothing changed.
 	if ( FilledUp )
 	{
@@ -1624,7 +2068,7 @@ void UFileChannel::Tick()
 	//TIM: IsNetReady(1) causes the client's bandwidth to be saturated. Good for clients, very bad
 	// for bandwidth-limited servers. IsNetReady(0) caps the clients bandwidth.
 	static UBOOL LanPlay = ParseParam(appCmdLine(),TEXT("lanplay"));
-	while( !OpenedLocally && SendFileAr && IsNetReady(LanPlay) && (Size=MaxSendBytes())!=0 )
+	while( !OpenedLocally && SendFileAr && IsNetReady(LanPlay,SENDPRI_Bulk) && (Size=MaxSendBytes())!=0 )
 	{
 		// Sending.
 		// get the filesize (we can't use the PackageInfo's size, because this may be a streaming texture pacakge
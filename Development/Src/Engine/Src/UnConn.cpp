@@ -6,6 +6,13 @@
 #include "EnginePrivate.h"
 #include "UnNet.h"
 
+/** Longest burst a paced connection may send at once, in seconds of its rate. */
+static const FLOAT SEND_PACING_BURST_SECONDS	= 0.1f;
+/** Share of lost packets over a stat period above which a paced connection is considered congested. */
+static const FLOAT SEND_PACING_LOSS_THRESHOLD	= 0.05f;
+/** Minimum number of packets sent over a stat period for its loss to be taken into account. */
+static const INT   SEND_PACING_MIN_PACKETS		= 10;
+
 /*-----------------------------------------------------------------------------
 	UNetConnection implementation.
 -----------------------------------------------------------------------------*/
@@ -47,7 +54,14 @@ UNetConnection::UNetConnection()
 ,	InPacketId			( -1 )
 ,	OutPacketId			( 0 ) // must be initialized as OutAckPacketId + 1 so loss of first packet can be detected
 ,	OutAckPacketId		( -1 )
+
+,	SendTokens			( 0 )
+,	SendRate			( 0 )
+,	LastSendTokenTime	( 0 )
+,	MinAvgLag			( 9999 )
 {
+	appMemzero( &SendStats, sizeof(SendStats) );
+	appMemzero( &LastSendStats, sizeof(LastSendStats) );
 }
 
 /**
@@ -494,58 +508,38 @@ void UNetConnection::FlushNet()
 			Out.WriteBit( 0 );
 		check(!Out.IsError());
 
-		// Send now.
-#if DO_ENABLE_NET_TEST
-		if( PacketSimulationSettings.PktOrder )
+		// Send now, or queue the packet for the token bucket if the connection is paced.
+		const UBOOL bPaced = IsSendPaced();
+		if( bPaced )
 		{
-			DelayedPacket& B = *(new(Delayed)DelayedPacket);
-			B.Data.Add( Out.GetNumBytes() );
-			appMemcpy( &B.Data(0), Out.GetData(), Out.GetNumBytes() );
-
-			for( INT i=Delayed.Num()-1; i>=0; i-- )
-			{
-				if( appFrand()>0.50 )
-				{
-					if( !PacketSimulationSettings.PktLoss || appFrand()*100.f > PacketSimulationSettings.PktLoss )
-					{
-						LowLevelSend( (char*)&Delayed(i).Data(0), Delayed(i).Data.Num() );
-					}
-					Delayed.Remove( i );
-				}
-			}
-		}
-		else if( PacketSimulationSettings.PktLag )
-		{
-			if( !PacketSimulationSettings.PktLoss || appFrand()*100.f > PacketSimulationSettings.PktLoss )
-			{
-				DelayedPacket& B = *(new(Delayed)DelayedPacket);
-				B.Data.Add( Out.GetNumBytes() );
-				appMemcpy( &B.Data(0), Out.GetData(), Out.GetNumBytes() );
-				B.SendTime = appSeconds() + (DOUBLE(PacketSimulationSettings.PktLag)  + 2.0f * (appFrand() - 0.5f) * DOUBLE(PacketSimulationSettings.PktLagVariance))/ 1000.f;
-			}
+			FQueuedPacket* Packet	= new(SendQueue)FQueuedPacket;
+			Packet->Size			= Out.GetNumBytes();
+			Packet->PacketId		= OutPacketId;
+			Packet->QueueTime		= appSeconds();
+			appMemcpy( &SendQueueData(SendQueueData.Add(Packet->Size)), Out.GetData(), Packet->Size );
 		}
-		else if( !PacketSimulationSettings.PktLoss || appFrand()*100.f >= PacketSimulationSettings.PktLoss )
+		else
 		{
-#endif
-			LowLevelSend( Out.GetData(), Out.GetNumBytes() );
-#if DO_ENABLE_NET_TEST
-			if( PacketSimulationSettings.PktDup && appFrand()*100.f < PacketSimulationSettings.PktDup )
-			{
-				LowLevelSend( (char*)Out.GetData(), Out.GetNumBytes() );
-			}
+			SendPacket( Out.GetData(), Out.GetNumBytes(), OutPacketId );
 		}
-#endif
 
 		// Update stuff.
-		INT Index = OutPacketId & (ARRAY_COUNT(OutLagPacketId)-1);
-		OutLagPacketId [Index] = OutPacketId;
-		OutLagTime     [Index] = Driver->Time;
 		OutPacketId++;
 		Driver->OutPackets++;
 		LastSendTime = Driver->Time;
 		QueuedBytes += Out.GetNumBytes() + PacketOverhead;
 		Driver->OutBytes += Out.GetNumBytes() + PacketOverhead;
 		InitOut();
+
+		if( bPaced )
+		{
+			// Everything goes out right away once the connection is closed as it won't be ticked anymore.
+			SendQueuedPackets( State==USOCK_Closed );
+			if( SendQueue.Num() )
+			{
+				SendStats.PacketsDelayed++;
+			}
+		}
 	}
 
 	// Move acks around.
@@ -554,6 +548,178 @@ void UNetConnection::FlushNet()
 	QueuedAcks.Empty(32);
 
 }
+
+/**
+ * Hands a finished packet to the socket, applying the packet simulation settings.
+ *
+ * @param Data the packet to send
+ * @param Count the size of the packet
+ * @param PacketId the id of the packet, for lag measurement
+ */
+void UNetConnection::SendPacket( BYTE* Data, INT Count, INT PacketId )
+{
+#if DO_ENABLE_NET_TEST
+	if( PacketSimulationSettings.PktOrder )
+	{
+		DelayedPacket& B = *(new(Delayed)DelayedPacket);
+		B.Data.Add( Count );
+		appMemcpy( &B.Data(0), Data, Count );
+
+		for( INT i=Delayed.Num()-1; i>=0; i-- )
+		{
+			if( appFrand()>0.50 )
+			{
+				if( !PacketSimulationSettings.PktLoss || appFrand()*100.f > PacketSimulationSettings.PktLoss )
+				{
+					LowLevelSend( (char*)&Delayed(i).Data(0), Delayed(i).Data.Num() );
+				}
+				Delayed.Remove( i );
+			}
+		}
+	}
+	else if( PacketSimulationSettings.PktLag )
+	{
+		if( !PacketSimulationSettings.PktLoss || appFrand()*100.f > PacketSimulationSettings.PktLoss )
+		{
+			DelayedPacket& B = *(new(Delayed)DelayedPacket);
+			B.Data.Add( Count );
+			appMemcpy( &B.Data(0), Data, Count );
+			B.SendTime = appSeconds() + (DOUBLE(PacketSimulationSettings.PktLag)  + 2.0f * (appFrand() - 0.5f) * DOUBLE(PacketSimulationSettings.PktLagVariance))/ 1000.f;
+		}
+	}
+	else if( !PacketSimulationSettings.PktLoss || appFrand()*100.f >= PacketSimulationSettings.PktLoss )
+	{
+#endif
+		LowLevelSend( Data, Count );
+#if DO_ENABLE_NET_TEST
+		if( PacketSimulationSettings.PktDup && appFrand()*100.f < PacketSimulationSettings.PktDup )
+		{
+			LowLevelSend( Data, Count );
+		}
+	}
+#endif
+
+	// Lag is measured from the time the packet actually left.
+	INT Index = PacketId & (ARRAY_COUNT(OutLagPacketId)-1);
+	OutLagPacketId [Index] = PacketId;
+	OutLagTime     [Index] = Driver->Time;
+	SendStats.PacketsSent++;
+	SendStats.BytesSent += Count + PacketOverhead;
+}
+
+/**
+ * @return whether outgoing packets are queued and paced by a token bucket, see UNetDriver::bPaceConnections
+ */
+UBOOL UNetConnection::IsSendPaced() const
+{
+	// Demo recording and other internally acked connections have nothing to pace.
+	return Driver && Driver->bPaceConnections && !InternalAck;
+}
+
+/**
+ * Refills the token bucket according to the time passed since the last refill.
+ */
+void UNetConnection::RefillSendTokens()
+{
+	// The rate starts at and never exceeds the one negotiated with the remote side.
+	if( SendRate <= 0.f || SendRate > CurrentNetSpeed )
+	{
+		SendRate = CurrentNetSpeed;
+	}
+	const FLOAT DeltaTime	= Driver->Time - LastSendTokenTime;
+	const FLOAT MaxTokens	= ::Max<FLOAT>( 2 * MaxPacket, SendRate * SEND_PACING_BURST_SECONDS );
+	SendTokens				= ::Min<FLOAT>( SendTokens + SendRate * DeltaTime, MaxTokens );
+	LastSendTokenTime		= Driver->Time;
+}
+
+/**
+ * Sends queued packets as far as the token bucket allows.
+ *
+ * @param bForce whether to send all queued packets regardless of the bucket, e.g. when closing
+ */
+void UNetConnection::SendQueuedPackets( UBOOL bForce )
+{
+	RefillSendTokens();
+
+	// A packet may be sent on credit as long as there are tokens left, the bucket pays it back.
+	const DOUBLE CurrentTime = appSeconds();
+	INT SentPackets = 0;
+	INT SentBytes = 0;
+	while( SentPackets < SendQueue.Num() && (bForce || SendTokens > 0.f) )
+	{
+		const FQueuedPacket& Packet = SendQueue(SentPackets);
+		SendPacket( &SendQueueData(SentBytes), Packet.Size, Packet.PacketId );
+		SendTokens -= Packet.Size + PacketOverhead;
+
+		const FLOAT QueueDelay = CurrentTime - Packet.QueueTime;
+		SendStats.QueueDelayAcc += QueueDelay;
+		SendStats.MaxQueueDelay = ::Max( SendStats.MaxQueueDelay, QueueDelay );
+
+		SentBytes += Packet.Size;
+		SentPackets++;
+	}
+	if( SentPackets )
+	{
+		SendQueue.Remove( 0, SentPackets );
+		SendQueueData.Remove( 0, SentBytes );
+	}
+}
+
+/**
+ * Adapts the pacing rate to the loss and lag measured over the last stat period.
+ */
+void UNetConnection::UpdateSendRate()
+{
+	if( IsSendPaced() )
+	{
+		if( LagCount )
+		{
+			MinAvgLag = ::Min( MinAvgLag, AvgLag );
+		}
+
+		// Back off quickly on loss or if lag grows well beyond the lowest measured, which means packets queue up
+		// on the way, and probe back up to the negotiated rate slowly otherwise.
+		const UBOOL bLossy		= SendStats.PacketsSent >= SEND_PACING_MIN_PACKETS && SendStats.PacketsLost > SendStats.PacketsSent * SEND_PACING_LOSS_THRESHOLD;
+		const UBOOL bQueueing	= LagCount && AvgLag > 2.f * MinAvgLag + 0.05f;
+		if( bLossy || bQueueing )
+		{
+			SendRate = ::Max<FLOAT>( SendRate * 0.75f, CurrentNetSpeed * 0.25f );
+		}
+		else
+		{
+			SendRate = ::Min<FLOAT>( SendRate + CurrentNetSpeed * 0.1f, CurrentNetSpeed );
+		}
+		SendStats.SendRate = SendRate;
+	}
+	else
+	{
+		SendStats.SendRate = CurrentNetSpeed;
+	}
+
+	LastSendStats = SendStats;
+	appMemzero( &SendStats, sizeof(SendStats) );
+}
+
+/**
+ * Prints the send statistics of the last stat period.
+ */
+void UNetConnection::LogSendStats( FOutputDevice& Ar )
+{
+	const FConnectionSendStats& Stats = LastSendStats;
+	Ar.Logf( TEXT("   %s: rate %i, sent %i packets (%i bytes), lost %i, delayed %i, queue delay avg %.1f ms max %.1f ms, held back movement %i bulk %i, queued %i bytes"),
+		*LowLevelDescribe(),
+		appTrunc(Stats.SendRate),
+		Stats.PacketsSent,
+		Stats.BytesSent,
+		Stats.PacketsLost,
+		Stats.PacketsDelayed,
+		Stats.PacketsSent ? 1000.f * Stats.QueueDelayAcc / Stats.PacketsSent : 0.f,
+		1000.f * Stats.MaxQueueDelay,
+		Stats.HeldBack[SENDPRI_Movement],
+		Stats.HeldBack[SENDPRI_Bulk],
+		SendQueueData.Num() );
+}
+
 void UNetConnection::Serialize( const TCHAR* Data, EName MsgType )
 {
 	// Send data to the control channel.
@@ -561,8 +727,31 @@ void UNetConnection::Serialize( const TCHAR* Data, EName MsgType )
 		((UControlChannel*)Channels[0])->Serialize( Data, MsgType );
 
 }
-INT UNetConnection::IsNetReady( UBOOL Saturate )
+INT UNetConnection::IsNetReady( UBOOL Saturate, ESendPriority Priority )
 {
+	if( IsSendPaced() )
+	{
+		// Anything beyond what the token bucket lets out right away only adds latency. Movement may queue up one
+		// more packet than bulk data so it still goes out when bulk data is held back. Reliable data is never
+		// held back as it would only be resent.
+		RefillSendTokens();
+		const INT Backlog = SendQueueData.Num() + Out.GetNumBytes();
+		UBOOL bReady = TRUE;
+		if( Priority == SENDPRI_Bulk && !Saturate )
+		{
+			bReady = Backlog < SendTokens;
+		}
+		else if( Priority != SENDPRI_Reliable )
+		{
+			bReady = Backlog < SendTokens + MaxPacket;
+		}
+		if( !bReady )
+		{
+			SendStats.HeldBack[Priority]++;
+		}
+		return bReady;
+	}
+
 	// Return whether we can send more data without saturation the connection.
 	if( Saturate )
 		QueuedBytes = -Out.GetNumBytes();
@@ -656,6 +845,7 @@ void UNetConnection::ReceivedPacket( FBitReader& Reader )
 			{
 				for( INT NakPacketId=OutAckPacketId+1; NakPacketId<AckPacketId; NakPacketId++,Driver->OutPacketsLost++ )
 				{
+					SendStats.PacketsLost++;
 					debugfSlow( NAME_DevNetTraffic, TEXT("   Received virtual nak %i (%.1f)"), NakPacketId, (Reader.GetPosBits()-StartPos)/8.f );
 					ReceivedNak( NakPacketId );
 				}
@@ -691,6 +881,7 @@ void UNetConnection::ReceivedPacket( FBitReader& Reader )
 				}
 				if( Channel->OpenPacketId==AckPacketId ) // Necessary for unreliable "bNetTemporary" channels.
 					Channel->OpenAcked = 1;
+				Channel->ReceivedAck( AckPacketId );
 				Channel->ReceivedAcks(); //warning: May destroy Channel.
 			}
 		}
@@ -1031,6 +1222,7 @@ void UNetConnection::Tick()
 		if( LagCount )
 			AvgLag = LagAcc/LagCount;
 		BestLag = AvgLag;
+		UpdateSendRate();
 
 		if( Actor )
 		{
@@ -1077,7 +1269,14 @@ void UNetConnection::Tick()
 
 	// Flush.
 	PurgeAcks();
-	if( TimeSensitive || Driver->Time-LastSendTime>Driver->KeepAliveTime )
+	UBOOL bHoldPacket = FALSE;
+	if( IsSendPaced() )
+	{
+		// While earlier packets wait for the token bucket keep adding to the current one, so fewer and fuller packets go out.
+		SendQueuedPackets();
+		bHoldPacket = SendQueue.Num() > 0 && State != USOCK_Closed;
+	}
+	if( !bHoldPacket && (TimeSensitive || Driver->Time-LastSendTime>Driver->KeepAliveTime) )
 		FlushNet();
 
 	if( Download )
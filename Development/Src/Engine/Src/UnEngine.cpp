@@ -1211,11 +1211,112 @@ UBOOL UEngine::GetPropertyColorationColor(UObject* Object, FColor& OutColor)
 	UServerCommandlet.
 -----------------------------------------------------------------------------*/
 
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+/**
+ * @return	CPU time used by the process so far, in seconds, or 0 if the platform doesn't report it
+ */
+static DOUBLE GetProcessCpuSeconds()
+{
+#if _MSC_VER
+	FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+	if( GetProcessTimes( GetCurrentProcess(), &CreationTime, &ExitTime, &KernelTime, &UserTime ) )
+	{
+		const QWORD Kernel	= ((QWORD)KernelTime.dwHighDateTime << 32) | KernelTime.dwLowDateTime;
+		const QWORD User	= ((QWORD)UserTime.dwHighDateTime << 32) | UserTime.dwLowDateTime;
+		// FILETIME is in 100 ns units.
+		return (Kernel + User) / 10000000.0;
+	}
+	return 0;
+#elif defined(__linux__)
+	rusage Usage;
+	if( getrusage( RUSAGE_SELF, &Usage ) == 0 )
+	{
+		return Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec + (Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec) / 1000000.0;
+	}
+	return 0;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * Gathers how far server ticks are off the tick rate and how much CPU time they use, for tuning the
+ * frame pacing of dedicated servers.
+ */
+struct FServerTickStats
+{
+	/** Number of ticks measured. */
+	INT		NumTicks;
+	/** Sum of the jitter of all ticks, in seconds. */
+	DOUBLE	JitterSum;
+	/** Sum of the squared jitter of all ticks. */
+	DOUBLE	JitterSquaredSum;
+	/** Largest absolute jitter of any tick, in seconds. */
+	DOUBLE	MaxJitter;
+	/** Process CPU time at the start of the measurement, in seconds. */
+	DOUBLE	StartCpuSeconds;
+	/** Time the measurement started at. */
+	DOUBLE	StartTime;
+
+	FServerTickStats()
+	{
+		Reset();
+	}
+
+	/** Starts a new measurement. */
+	void Reset()
+	{
+		NumTicks			= 0;
+		JitterSum			= 0;
+		JitterSquaredSum	= 0;
+		MaxJitter			= 0;
+		StartCpuSeconds		= GetProcessCpuSeconds();
+		StartTime			= appSeconds();
+	}
+
+	/**
+	 * Adds a tick to the measurement.
+	 *
+	 * @param	Jitter	difference between the tick's delta time and the intended one, in seconds
+	 */
+	void AddTick( DOUBLE Jitter )
+	{
+		NumTicks++;
+		JitterSum			+= Jitter;
+		JitterSquaredSum	+= Jitter * Jitter;
+		MaxJitter			= Max( MaxJitter, Abs(Jitter) );
+	}
+
+	/** Logs the measurement. */
+	void Dump()
+	{
+		if( NumTicks > 0 )
+		{
+			const DOUBLE CpuSeconds = GetProcessCpuSeconds() - StartCpuSeconds;
+			debugf( NAME_Log, TEXT("Server ticks: %i in %.1f s, jitter mean %.3f ms rms %.3f ms max %.3f ms, CPU %.3f ms per tick"),
+				NumTicks,
+				appSeconds() - StartTime,
+				JitterSum / NumTicks * 1000.0,
+				appSqrt( JitterSquaredSum / NumTicks ) * 1000.0,
+				MaxJitter * 1000.0,
+				CpuSeconds / NumTicks * 1000.0 );
+		}
+	}
+};
+
 INT UServerCommandlet::Main( const FString& Params )
 {
 	GIsRunning = 1;
 	GIsRequestingExit = FALSE;
 
+	// -TICKSTATS=<seconds> periodically logs the tick jitter and CPU time per tick.
+	FLOAT TickStatsInterval = 0.f;
+	Parse( appCmdLine(), TEXT("TICKSTATS="), TickStatsInterval );
+	FServerTickStats TickStats;
+
 #if !CONSOLE && !__GNUC__// Windows only
 	/**
 	 * Used by the .com wrapper to notify that the Ctrl-C handler was triggered.
@@ -1232,8 +1333,25 @@ INT UServerCommandlet::Main( const FString& Params )
  		extern void appUpdateTimaAndHandleMaxTickRate();
 		appUpdateTimaAndHandleMaxTickRate();
 
+		// The jitter is how much the tick's delta time is off the one the tick rate asks for.
+		const FLOAT MaxTickRate = GEngine->GetMaxTickRate( GDeltaTime, FALSE );
+		const DOUBLE TickCpuStart = GetProcessCpuSeconds();
+		if( MaxTickRate > 0 )
+		{
+			const FLOAT Jitter = GDeltaTime - 1.f / MaxTickRate;
+			TickStats.AddTick( Jitter );
+			SET_FLOAT_STAT(STAT_ServerTickJitter,Jitter * 1000.f);
+		}
+
 		// Tick the engine.
 		GEngine->Tick( GDeltaTime );
+
+		SET_FLOAT_STAT(STAT_ServerTickCpuTime,(GetProcessCpuSeconds() - TickCpuStart) * 1000.f);
+		if( TickStatsInterval > 0 && appSeconds() - TickStats.StartTime >= TickStatsInterval )
+		{
+			TickStats.Dump();
+			TickStats.Reset();
+		}
 	
 #if STATS
 		// Write all stats for this frame out
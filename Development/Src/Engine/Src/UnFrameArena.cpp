@@ -0,0 +1,187 @@
+/*=============================================================================
+	UnFrameArena.cpp: Frame scoped linear allocator shared by the game and rendering threads.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+
+DECLARE_MEMORY_STAT(TEXT("Frame Arena Memory"),STAT_FrameArenaMemory,STATGROUP_Memory);
+DECLARE_MEMORY_STAT(TEXT("Frame Arena Peak Memory"),STAT_FrameArenaPeakMemory,STATGROUP_Memory);
+
+/** Global frame arena. */
+FFrameArena GFrameArena;
+
+/*-----------------------------------------------------------------------------
+	FFrameArena implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, initializing member variables.
+ */
+FFrameArena::FFrameArena()
+:	GameSlot( 0 )
+,	RenderSlot( 0 )
+,	ThreadStateTlsSlot( appAllocTlsSlot() )
+,	ThreadStates( NULL )
+,	FreeChunkPool( NULL )
+,	PeakFrameBytes( 0 )
+{}
+
+/**
+ * Returns the sub-arena the calling thread allocates from, creating the thread's state on first use.
+ */
+FFrameArena::FSubArena& FFrameArena::GetSubArena()
+{
+	FThreadState* ThreadState = (FThreadState*) appGetTlsValue( ThreadStateTlsSlot );
+	if( !ThreadState )
+	{
+		// Thread states are kept around till exit as we don't get notified about threads going away.
+		ThreadState = (FThreadState*) appMalloc( sizeof(FThreadState) );
+		appMemzero( ThreadState, sizeof(FThreadState) );
+		appSetTlsValue( ThreadStateTlsSlot, ThreadState );
+
+		FScopeLock ScopeLock( &ThreadStatesCriticalSection );
+		ThreadState->Next	= ThreadStates;
+		ThreadStates		= ThreadState;
+	}
+	// The rendering thread lags behind the game thread so it uses the slot of the frame it is rendering.
+	const INT Slot = GIsThreadedRendering && IsInRenderingThread() ? RenderSlot : GameSlot;
+	return ThreadState->SubArenas[Slot];
+}
+
+/**
+ * Makes a new chunk the top chunk of the passed in sub-arena.
+ *
+ * @param	SubArena	sub-arena to add chunk to
+ * @param	MinSize		minimum size of chunk's data
+ */
+void FFrameArena::AllocateNewChunk( FSubArena& SubArena, INT MinSize )
+{
+	FChunk* Chunk = NULL;
+	if( MinSize <= DEFAULT_CHUNK_SIZE )
+	{
+		FScopeLock ScopeLock( &FreeChunkPoolCriticalSection );
+		if( FreeChunkPool )
+		{
+			Chunk			= FreeChunkPool;
+			FreeChunkPool	= Chunk->Next;
+		}
+	}
+	if( !Chunk )
+	{
+		// Large requests get a chunk of their own that is freed again when released.
+		const INT DataSize	= Max<INT>( MinSize, DEFAULT_CHUNK_SIZE );
+		Chunk				= (FChunk*) appMalloc( CHUNK_HEADER_SIZE + DataSize );
+		Chunk->DataSize		= DataSize;
+	}
+
+	Chunk->Next				= SubArena.TopChunk;
+	SubArena.TopChunk		= Chunk;
+	SubArena.Top			= Chunk->GetData();
+	SubArena.End			= Chunk->GetData() + Chunk->DataSize;
+	SubArena.ChunkBytes		+= Chunk->DataSize;
+	SubArena.PeakChunkBytes	= Max( SubArena.PeakChunkBytes, SubArena.ChunkBytes );
+}
+
+/**
+ * Hands chunks of the passed in sub-arena back to the pool until NewTopChunk is the top chunk.
+ *
+ * @param	SubArena	sub-arena to free chunks of
+ * @param	NewTopChunk	chunk to stop at, NULL to free all chunks
+ */
+void FFrameArena::FreeChunks( FSubArena& SubArena, FChunk* NewTopChunk )
+{
+	FScopeLock ScopeLock( &FreeChunkPoolCriticalSection );
+	while( SubArena.TopChunk != NewTopChunk )
+	{
+		FChunk* Chunk		= SubArena.TopChunk;
+		SubArena.TopChunk	= Chunk->Next;
+		SubArena.ChunkBytes	-= Chunk->DataSize;
+		if( Chunk->DataSize == DEFAULT_CHUNK_SIZE )
+		{
+			Chunk->Next		= FreeChunkPool;
+			FreeChunkPool	= Chunk;
+		}
+		else
+		{
+			appFree( Chunk );
+		}
+	}
+}
+
+/**
+ * Releases all memory allocated from the passed in slot by any thread.
+ *
+ * @param	Slot	slot to release
+ * @return	largest size of chunks that were in use at once, in bytes
+ */
+INT FFrameArena::ResetSlot( INT Slot )
+{
+	INT FrameBytes = 0;
+	FScopeLock ScopeLock( &ThreadStatesCriticalSection );
+	for( FThreadState* ThreadState=ThreadStates; ThreadState; ThreadState=ThreadState->Next )
+	{
+		FSubArena& SubArena = ThreadState->SubArenas[Slot];
+		FrameBytes += SubArena.PeakChunkBytes;
+		FreeChunks( SubArena, NULL );
+		SubArena.Top			= NULL;
+		SubArena.End			= NULL;
+		SubArena.PeakChunkBytes	= 0;
+	}
+	return FrameBytes;
+}
+
+/**
+ * Starts a new frame, releasing the memory of the frame that used the same slot before. Waits for
+ * that frame to be rendered if necessary. Must be called from the game thread.
+ */
+void FFrameArena::BeginFrame()
+{
+	check(IsInGameThread());
+
+	// Keep track of when the rendering thread is done with the frame that just ended.
+	SlotFences[GameSlot].BeginFence();
+
+	// Switch to the other slot, which is free once the frame before the last one has been rendered.
+	// The engine loop doesn't let the rendering thread fall further behind so this rarely blocks.
+	GameSlot ^= 1;
+	SlotFences[GameSlot].Wait();
+
+	const INT FrameBytes = ResetSlot( GameSlot );
+	PeakFrameBytes = Max( PeakFrameBytes, FrameBytes );
+	SET_DWORD_STAT(STAT_FrameArenaMemory,FrameBytes);
+	SET_DWORD_STAT(STAT_FrameArenaPeakMemory,PeakFrameBytes);
+
+	// Commands enqueued from here on belong to the new frame.
+	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+		SetFrameArenaRenderSlot,
+		FFrameArena*,Arena,this,
+		INT,Slot,GameSlot,
+	{
+		Arena->RenderSlot = Slot;
+	});
+}
+
+/**
+ * Frees all memory held by the arena. Must be called after the rendering thread has been stopped.
+ */
+void FFrameArena::Exit()
+{
+	check(!GIsThreadedRendering);
+	for( INT Slot=0; Slot<NUM_SLOTS; Slot++ )
+	{
+		ResetSlot( Slot );
+	}
+
+	FScopeLock ScopeLock( &FreeChunkPoolCriticalSection );
+	while( FreeChunkPool )
+	{
+		FChunk* Chunk	= FreeChunkPool;
+		FreeChunkPool	= Chunk->Next;
+		appFree( Chunk );
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
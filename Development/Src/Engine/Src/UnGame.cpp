@@ -222,6 +222,12 @@ void UGameEngine::Init()
 		appErrorf( *LocalizeError(TEXT("FailedBrowse"),TEXT("Engine")), Parm, *Error );
 	}
 
+	// Dedicated servers can host more worlds next to the initial one.
+	if( !Client )
+	{
+		GHostedWorlds.HostConfiguredWorlds( DefaultURL );
+	}
+
 #if USING_REMOTECONTROL
 	extern UBOOL GUsewxWindows;
 	if( GUsewxWindows && RemoteControlExec && !GIsEditor )
@@ -259,6 +265,9 @@ void UGameEngine::PreExit()
 		CancelPending();
 	}
 
+	// Clean up hosted worlds.
+	GHostedWorlds.UnhostAllWorlds();
+
 	// Clean up world.
 	if ( GWorld != NULL )
 	{
@@ -340,7 +349,11 @@ IMPLEMENT_COMPARE_POINTER( UStaticMesh, UnGame, { return B->GetResourceSize() -
 UBOOL UGameEngine::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
 {
 	const TCHAR* Str=Cmd;
-	if( ParseCommand( &Str, TEXT("OPEN") ) )
+	if( GHostedWorlds.Exec( Cmd, Ar ) )
+	{
+		return TRUE;
+	}
+	else if( ParseCommand( &Str, TEXT("OPEN") ) )
 	{
 		// make sure the file exists if we are opening a local file
 		FURL TestURL(&LastURL, Str, TRAVEL_Partial);
@@ -1455,6 +1468,10 @@ UBOOL UGameEngine::LoadMap( const FURL& URL, UPendingLevel* Pending, FString& Er
 	for( TObjectIterator<UWorld> It; It; ++It )
 	{
 		UWorld* World = *It;
+		if( GHostedWorlds.IsHostedWorld( World ) )
+		{
+			continue;
+		}
 		// Print some debug information...
 		debugf(TEXT("%s not cleaned up by garbage collection! "), *World->GetFullName());
 		UObject::StaticExec(*FString::Printf(TEXT("OBJ REFS CLASS=WORLD NAME=%s.TheWorld"), *World->GetOutermost()->GetName()));
@@ -2364,6 +2381,7 @@ void UGameEngine::Tick( FLOAT DeltaSeconds )
 	GameCycles=0;
 	clock(GameCycles);
 	GWorld->Tick( LEVELTICK_All, DeltaSeconds );
+	GHostedWorlds.Tick( DeltaSeconds );
 	unclock(GameCycles);
 
 	// Issue cause event after first tick to provide a chance for the game to spawn the player and such.
@@ -2598,6 +2616,7 @@ void UGameEngine::Tick( FLOAT DeltaSeconds )
 	{
 		GScriptCallGraph->Tick();
 	}
+	GScriptProfiler.Tick();
 
 #if USING_REMOTECONTROL
 	if ( RemoteControlExec )
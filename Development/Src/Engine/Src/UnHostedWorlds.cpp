@@ -0,0 +1,414 @@
+/*=============================================================================
+	UnHostedWorlds.cpp: Hosting several game worlds in one server process.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+
+/** Global hosted world manager. */
+FHostedWorldManager GHostedWorlds;
+
+/*-----------------------------------------------------------------------------
+	FHostedWorldManager::FScopedWorld.
+-----------------------------------------------------------------------------*/
+
+FHostedWorldManager::FScopedWorld::FScopedWorld( FHostedWorldManager& InManager, UWorld* World )
+:	Manager( InManager )
+,	SavedWorld( GWorld )
+{
+	if( !Manager.MainWorld )
+	{
+		Manager.MainWorld = GWorld;
+	}
+	GWorld = World;
+}
+
+FHostedWorldManager::FScopedWorld::~FScopedWorld()
+{
+	GWorld = SavedWorld;
+	if( GWorld == Manager.MainWorld )
+	{
+		Manager.MainWorld = NULL;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	FHostedWorldManager implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Loads a map into a new hosted world and starts listening for clients. Only dedicated servers host worlds.
+ *
+ * @param	InURL	URL of the map to host, gets a port of its own unless it specifies one
+ * @param	Error	receives the reason hosting the world failed
+ * @return	TRUE if the world is hosted, FALSE otherwise
+ */
+UBOOL FHostedWorldManager::HostWorld( const FURL& InURL, FString& Error )
+{
+	if( GIsClient || !GWorld || MainWorld )
+	{
+		Error = TEXT("Worlds can only be hosted by dedicated servers outside of world ticks");
+		return FALSE;
+	}
+
+	// Each world listens on a port of its own.
+	FURL URL = InURL;
+	if( URL.Port == FURL::DefaultPort )
+	{
+		URL.Port = FURL::DefaultPort + NextInstanceIndex;
+	}
+
+	UWorld* World = LoadWorld( URL, Error );
+	if( !World )
+	{
+		debugf( NAME_Error, TEXT("Failed to host %s: %s"), *URL.String(), *Error );
+		return FALSE;
+	}
+
+	debugf( NAME_Log, TEXT("Hosting %s as %s"), *URL.String(), *World->GetOutermost()->GetName() );
+	return TRUE;
+}
+
+/**
+ * Loads the map of the passed in URL into a new package and starts playing it.
+ *
+ * @param	URL		URL of the map to load
+ * @param	Error	receives the reason loading failed
+ * @return	the loaded world or NULL if loading failed
+ */
+UWorld* FHostedWorldManager::LoadWorld( const FURL& URL, FString& Error )
+{
+	DOUBLE StartTime = appSeconds();
+
+	// Load the map file into a package named after the instance. Packages the map imports from are looked up
+	// by name and hence shared with the other worlds, only the map's own objects are loaded again.
+	const FString MapName = FFilename(URL.Map).GetBaseFilename();
+	UPackage* WorldPackage = UObject::CreatePackage( NULL, *FString::Printf(TEXT("%s_Hosted%i"), *MapName, NextInstanceIndex++) );
+	// Clients load the map by the name of its file.
+	WorldPackage->SetNetPackageName( FName(*MapName) );
+	if( !UObject::LoadPackage( WorldPackage, *URL.Map, LOAD_None ) )
+	{
+		Error = FString::Printf( TEXT("Failed to load package '%s'"), *URL.Map );
+		UObject::ResetLoaders( WorldPackage );
+		return NULL;
+	}
+
+	UWorld* World = FindObject<UWorld>( WorldPackage, TEXT("TheWorld") );
+	if( !World )
+	{
+		Error = FString::Printf( TEXT("'%s' is not a map"), *URL.Map );
+		UObject::ResetLoaders( WorldPackage );
+		return NULL;
+	}
+	// Streaming levels are loaded by package name so they would be shared with the other worlds.
+	if( World->GetWorldInfo()->StreamingLevels.Num() > 0 )
+	{
+		Error = FString::Printf( TEXT("'%s' uses level streaming, which hosted worlds don't support"), *URL.Map );
+		UObject::ResetLoaders( WorldPackage );
+		return NULL;
+	}
+
+	World->AddToRoot();
+	FHostedWorld* HostedWorld = new(HostedWorlds) FHostedWorld;
+	HostedWorld->World	= World;
+	HostedWorld->URL	= URL;
+
+	// Forward net package changes to the net drivers of all worlds from now on.
+	UPackage::NetObjectNotify = this;
+
+	{
+		FScopedWorld ScopedWorld( *this, World );
+		World->Init();
+		World->SetGameInfo( URL );
+		if( !World->Listen( URL, Error ) )
+		{
+			DestroyWorld( World );
+			HostedWorlds.Pop();
+			return NULL;
+		}
+		World->BeginPlay( URL );
+	}
+
+	debugf( TEXT("########### Finished loading hosted world %s: %f seconds"), *World->GetOutermost()->GetName(), appSeconds() - StartTime );
+	return World;
+}
+
+/**
+ * Shuts down a hosted world, disconnecting its clients. Its memory is freed by the next garbage collection.
+ *
+ * @param	Index	index of the world in the list of hosted worlds
+ */
+void FHostedWorldManager::UnhostWorld( INT Index )
+{
+	check(!MainWorld);
+	UWorld* World = HostedWorlds(Index).World;
+	debugf( NAME_Log, TEXT("No longer hosting %s"), *World->GetOutermost()->GetName() );
+
+	{
+		FScopedWorld ScopedWorld( *this, World );
+		AGameInfo* GameInfo = World->GetGameInfo();
+		if( GameInfo )
+		{
+			GameInfo->eventGameEnding();
+		}
+	}
+	DestroyWorld( World );
+	HostedWorlds.Remove( Index );
+}
+
+/** Shuts down all hosted worlds. */
+void FHostedWorldManager::UnhostAllWorlds()
+{
+	while( HostedWorlds.Num() )
+	{
+		UnhostWorld( HostedWorlds.Num() - 1 );
+	}
+}
+
+/**
+ * Ends play in a hosted world and releases it to garbage collection.
+ *
+ * @param	World	world to destroy
+ */
+void FHostedWorldManager::DestroyWorld( UWorld* World )
+{
+	FScopedWorld ScopedWorld( *this, World );
+
+	// Same as LoadMap does for GWorld, the net driver shuts down its connections when it is collected.
+	World->NetDriver = NULL;
+	World->FlushLevelStreaming( NULL, TRUE );
+	World->TermWorldRBPhys();
+	World->CleanupWorld();
+	World->RemoveFromRoot();
+
+	// Detach the linker of the world's package so it can be collected along with the world.
+	UObject::ResetLoaders( World->GetOutermost() );
+}
+
+/**
+ * Hosts the worlds listed by HostedWorldURLs in the [Engine.GameEngine] section.
+ *
+ * @param	BaseURL	URL the configured URLs are relative to
+ */
+void FHostedWorldManager::HostConfiguredWorlds( const FURL& BaseURL )
+{
+	FURL Base = BaseURL;
+	TArray<FString> HostedWorldURLs;
+	GConfig->GetArray( TEXT("Engine.GameEngine"), TEXT("HostedWorldURLs"), HostedWorldURLs, GEngineIni );
+	for( INT URLIndex=0; URLIndex<HostedWorldURLs.Num(); URLIndex++ )
+	{
+		FString Error;
+		HostWorld( FURL( &Base, *HostedWorldURLs(URLIndex), TRAVEL_Partial ), Error );
+	}
+}
+
+/**
+ * Ticks all hosted worlds and handles their server travels.
+ *
+ * @param	DeltaSeconds	time since the last tick
+ */
+void FHostedWorldManager::Tick( FLOAT DeltaSeconds )
+{
+	if( HostedWorlds.Num() == 0 )
+	{
+		return;
+	}
+
+	// GWorld's net driver takes over the notifications when it starts listening.
+	UPackage::NetObjectNotify = this;
+
+	for( INT WorldIndex=0; WorldIndex<HostedWorlds.Num(); WorldIndex++ )
+	{
+		FHostedWorld& HostedWorld = HostedWorlds(WorldIndex);
+		FString NextURL;
+		{
+			FScopedWorld ScopedWorld( *this, HostedWorld.World );
+			HostedWorld.World->Tick( LEVELTICK_All, DeltaSeconds );
+
+			// Handle server travelling.
+			AWorldInfo* WorldInfo = HostedWorld.World->GetWorldInfo();
+			if( WorldInfo->NextURL != TEXT("") && (WorldInfo->NextSwitchCountdown -= DeltaSeconds) <= 0.f )
+			{
+				NextURL = WorldInfo->NextURL;
+				WorldInfo->NextURL = TEXT("");
+			}
+		}
+
+		if( NextURL.Len() )
+		{
+			// Replace the world with one running the new map, keeping its port.
+			FURL URL( &HostedWorld.URL, *NextURL, TRAVEL_Relative );
+			URL.Port = HostedWorld.URL.Port;
+			debugf( TEXT("Hosted world switch level: %s"), *URL.String() );
+			{
+				FScopedWorld ScopedWorld( *this, HostedWorld.World );
+				AGameInfo* GameInfo = HostedWorld.World->GetGameInfo();
+				if( GameInfo )
+				{
+					GameInfo->eventGameEnding();
+				}
+			}
+			DestroyWorld( HostedWorld.World );
+			HostedWorlds.Remove( WorldIndex-- );
+
+			// The old world needs to be collected first so its net driver releases the port.
+			UObject::CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+			FString Error;
+			if( !LoadWorld( URL, Error ) )
+			{
+				debugf( NAME_Error, TEXT("Failed to switch hosted world to %s: %s"), *URL.String(), *Error );
+			}
+		}
+	}
+}
+
+/** Handles HOSTWORLD <url>, UNHOSTWORLD <index> and HOSTEDWORLDS. */
+UBOOL FHostedWorldManager::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
+{
+	if( ParseCommand( &Cmd, TEXT("HOSTWORLD") ) )
+	{
+		FURL BaseURL;
+		FURL URL( &BaseURL, Cmd, TRAVEL_Partial );
+		FString Error;
+		if( !URL.Valid || !HostWorld( URL, Error ) )
+		{
+			Ar.Logf( TEXT("Failed to host %s: %s"), Cmd, *Error );
+		}
+		return TRUE;
+	}
+	else if( ParseCommand( &Cmd, TEXT("UNHOSTWORLD") ) )
+	{
+		const INT Index = appAtoi( Cmd );
+		if( Index >= 0 && Index < HostedWorlds.Num() && !MainWorld )
+		{
+			UnhostWorld( Index );
+			UObject::CollectGarbage( GARBAGE_COLLECTION_KEEPFLAGS );
+		}
+		else
+		{
+			Ar.Logf( TEXT("No hosted world %i"), Index );
+		}
+		return TRUE;
+	}
+	else if( ParseCommand( &Cmd, TEXT("HOSTEDWORLDS") ) )
+	{
+		for( INT WorldIndex=0; WorldIndex<HostedWorlds.Num(); WorldIndex++ )
+		{
+			const FHostedWorld& HostedWorld = HostedWorlds(WorldIndex);
+			UNetDriver* NetDriver = HostedWorld.World->NetDriver;
+			Ar.Logf( TEXT("%i: %s (%s) with %i clients"),
+				WorldIndex,
+				*HostedWorld.World->GetOutermost()->GetName(),
+				*HostedWorld.URL.String(),
+				NetDriver ? NetDriver->ClientConnections.Num() : 0 );
+		}
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/** @return whether the passed in world is a hosted world */
+UBOOL FHostedWorldManager::IsHostedWorld( UWorld* World ) const
+{
+	for( INT WorldIndex=0; WorldIndex<HostedWorlds.Num(); WorldIndex++ )
+	{
+		if( HostedWorlds(WorldIndex).World == World )
+		{
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * Returns whether the net driver of the passed in world should send the passed in package to its clients.
+ * Map packages are only relevant to the world they belong to once worlds are hosted.
+ *
+ * @param	World	world the net driver belongs to
+ * @param	Package	package to check
+ */
+UBOOL FHostedWorldManager::IsNetPackageRelevant( UWorld* World, UPackage* Package ) const
+{
+	if( HostedWorlds.Num() == 0 || !Package->ContainsMap() )
+	{
+		return TRUE;
+	}
+	if( IsHostedWorld( World ) )
+	{
+		return Package == World->GetOutermost();
+	}
+	// The main world may stream levels, so only leave out the packages of hosted worlds.
+	for( INT WorldIndex=0; WorldIndex<HostedWorlds.Num(); WorldIndex++ )
+	{
+		if( HostedWorlds(WorldIndex).World->GetOutermost() == Package )
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Collects the worlds whose net drivers are notified about net package changes.
+ *
+ * @param	Worlds	receives GWorld, the main world, followed by the hosted worlds
+ */
+void FHostedWorldManager::GetAllWorlds( TArray<UWorld*>& Worlds ) const
+{
+	UWorld* TheMainWorld = MainWorld ? MainWorld : GWorld;
+	if( TheMainWorld )
+	{
+		Worlds.AddItem( TheMainWorld );
+	}
+	for( INT WorldIndex=0; WorldIndex<HostedWorlds.Num(); WorldIndex++ )
+	{
+		Worlds.AddItem( HostedWorlds(WorldIndex).World );
+	}
+}
+
+void FHostedWorldManager::NotifyNetPackageAdded( UPackage* Package )
+{
+	TArray<UWorld*> Worlds;
+	GetAllWorlds( Worlds );
+	for( INT WorldIndex=0; WorldIndex<Worlds.Num(); WorldIndex++ )
+	{
+		// The net drivers look at GWorld to find out whether they are serving it.
+		FScopedWorld ScopedWorld( *this, Worlds(WorldIndex) );
+		if( GWorld->NetDriver )
+		{
+			GWorld->NetDriver->NotifyNetPackageAdded( Package );
+		}
+	}
+}
+
+void FHostedWorldManager::NotifyNetPackageRemoved( UPackage* Package )
+{
+	TArray<UWorld*> Worlds;
+	GetAllWorlds( Worlds );
+	for( INT WorldIndex=0; WorldIndex<Worlds.Num(); WorldIndex++ )
+	{
+		FScopedWorld ScopedWorld( *this, Worlds(WorldIndex) );
+		if( GWorld->NetDriver )
+		{
+			GWorld->NetDriver->NotifyNetPackageRemoved( Package );
+		}
+	}
+}
+
+void FHostedWorldManager::NotifyNetObjectRemoved( UObject* Object )
+{
+	TArray<UWorld*> Worlds;
+	GetAllWorlds( Worlds );
+	for( INT WorldIndex=0; WorldIndex<Worlds.Num(); WorldIndex++ )
+	{
+		FScopedWorld ScopedWorld( *this, Worlds(WorldIndex) );
+		if( GWorld->NetDriver )
+		{
+			GWorld->NetDriver->NotifyNetObjectRemoved( Object );
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
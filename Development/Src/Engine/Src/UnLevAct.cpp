@@ -701,6 +701,9 @@ UBOOL UWorld::DestroyActor( AActor* ThisActor, UBOOL bNetForce, UBOOL bShouldMod
 
 	// Remove the actor from the actor list.
 	RemoveActor( ThisActor, bShouldModifyLevel );
+
+	// Its timers won't fire anymore.
+	TimerWheel.RemoveActor( ThisActor );
 	
 	// Mark the actor and its direct components as pending kill.
 	ThisActor->bDeleteMe = 1;
@@ -2207,6 +2210,12 @@ void AActor::PreSave()
 	Super::PreSave();
 	// update the base of this actor
 	EditorUpdateBase();
+	// save the time that has passed for timers
+	FTimerWheel* TimerWheel = FTimerWheel::GetActorTimerWheel(this);
+	if (TimerWheel != NULL)
+	{
+		TimerWheel->SyncActor(this);
+	}
 }
 
 /**
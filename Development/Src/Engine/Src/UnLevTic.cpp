@@ -104,21 +104,304 @@ struct FActorPriority
 	UActorChannel*	Channel;	// Actor channel.
 	FActorPriority()
 	{}
-	FActorPriority(UNetConnection* InConnection, UActorChannel* InChannel, AActor* InActor, const TArray<FNetViewer>& Viewers, UBOOL bLowBandwidth)
+	FActorPriority(UNetConnection* InConnection, UActorChannel* InChannel, AActor* InActor, const FNetViewer* Viewers, INT NumViewers, UBOOL bLowBandwidth)
 		: Actor(InActor), Channel(InChannel)
 	{	
 		FLOAT Time  = Channel ? (InConnection->Driver->Time - Channel->LastUpdateTime) : InConnection->Driver->SpawnPrioritySeconds;
 		// take the highest priority of the viewers on this connection
 		Priority = 0;
-		for (INT i = 0; i < Viewers.Num(); i++)
+		for (INT i = 0; i < NumViewers; i++)
 		{
-			Priority = Max<INT>(Priority, appRound(65536.0f * Actor->GetNetPriority(Viewers(i).ViewLocation, Viewers(i).ViewDir, Viewers(i).InViewer, InChannel, Time, bLowBandwidth)));
+			Priority = Max<INT>(Priority, appRound(65536.0f * Actor->GetNetPriority(Viewers[i].ViewLocation, Viewers[i].ViewDir, Viewers[i].InViewer, InChannel, Time, bLowBandwidth)));
 		}
 	}
 };
 
 IMPLEMENT_COMPARE_POINTER( FActorPriority, UnLevTic, { return B->Priority - A->Priority; } )
 
+/**
+ * Returns whether an actor is too far away from all viewers of a connection to be relevant to it, see UNetDriver::NetCullDistance.
+ *
+ * @param	Actor		actor to check
+ * @param	Viewers		viewers of the connection
+ * @param	NumViewers	number of entries in Viewers
+ * @param	NetDriver	net driver replicating the actor
+ * @return	TRUE if the actor isn't relevant because of its distance
+ */
+static UBOOL IsBeyondNetCullDistance(AActor* Actor, const FNetViewer* Viewers, INT NumViewers, UNetDriver* NetDriver)
+{
+	if (NetDriver->NetCullDistance <= 0.f || Actor->bAlwaysRelevant || Actor->bOnlyRelevantToOwner)
+	{
+		return FALSE;
+	}
+	const FLOAT CullDistanceSquared = Square(NetDriver->NetCullDistance);
+	for (INT i = 0; i < NumViewers; i++)
+	{
+		if ((Actor->Location - Viewers[i].ViewLocation).SizeSquared() <= CullDistanceSquared)
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Per connection state of UWorld::ServerTickClients, allocated from the frame arena.
+ */
+struct FConnectionReplicationList
+{
+	/** Connection to replicate to, its children share the list. */
+	UNetConnection*		Connection;
+	/** Viewers of the connection and its children. */
+	FNetViewer*			Viewers;
+	/** Number of entries in Viewers. */
+	INT					NumViewers;
+	/** Whether actors are prioritized for a low bandwidth connection. */
+	UBOOL				bLowNetBandwidth;
+	/** Whether actors need to be sorted by priority as the connection was saturated last tick. */
+	UBOOL				bPrioritySort;
+	/** Actors to consider for replication along with their priority. */
+	FActorPriority*		PriorityList;
+	/** Entries of PriorityList in the order they are replicated in. */
+	FActorPriority**	PriorityActors;
+	/** Number of entries in PriorityList and PriorityActors. */
+	INT					ConsiderCount;
+};
+
+/**
+ * Builds the prioritized lists of actors to replicate to each connection, spread across the game thread and
+ * GThreadPool helpers that claim one connection at a time. Building a list reads state that isn't modified
+ * till all lists are built and only writes to its own connection so the result doesn't depend on the thread.
+ */
+class FNetPriorityListBuilder
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param InLists				lists to build, connection and viewer information needs to be filled in
+	 * @param InNumLists			number of entries in InLists
+	 * @param InConsiderList		actors considered for all connections
+	 * @param InConsiderListSize	number of entries in InConsiderList
+	 * @param InMaxConsiderCount	upper bound of the number of actors considered for a single connection
+	 * @param InNetDriver			net driver whose relevancy grid holds the actors considered for connections they are near to
+	 * @param InNetTag				NetTag of the actors in the relevancy grid that are considered this tick
+	 * @param InNumReferences		number of threads referencing the builder, the last one to call Release deletes it
+	 */
+	FNetPriorityListBuilder( FConnectionReplicationList* InLists, INT InNumLists, AActor** InConsiderList, INT InConsiderListSize, INT InMaxConsiderCount, UNetDriver* InNetDriver, INT InNetTag, INT InNumReferences )
+	:	Lists( InLists )
+	,	NumLists( InNumLists )
+	,	ConsiderList( InConsiderList )
+	,	ConsiderListSize( InConsiderListSize )
+	,	MaxConsiderCount( InMaxConsiderCount )
+	,	NetDriver( InNetDriver )
+	,	NetTag( InNetTag )
+	,	NextList( 0 )
+	,	NumListsBuilt( 0 )
+	,	NumReferences( InNumReferences )
+	{}
+
+	/** Builds lists till there are none left to claim. */
+	void BuildLists()
+	{
+		INT ListIndex;
+		while( (ListIndex = NextList.Increment() - 1) < NumLists )
+		{
+			BuildList( Lists[ListIndex] );
+			NumListsBuilt.Increment();
+		}
+	}
+
+	/** Waits for lists claimed by other threads to be built. */
+	void WaitForLists()
+	{
+		while( NumListsBuilt.GetValue() < NumLists )
+		{
+			appSleep( 0 );
+		}
+	}
+
+	/** Releases a reference, deleting the builder when the last one is gone. */
+	void Release()
+	{
+		if( NumReferences.Decrement() == 0 )
+		{
+			delete this;
+		}
+	}
+
+private:
+	/**
+	 * Adds an actor to a list unless it is known to have nothing to replicate.
+	 *
+	 * @param List				list to add actor to
+	 * @param OwnerConnection	connection or child connection the actor is considered for
+	 * @param Actor				actor to consider
+	 */
+	static void ConsiderActor( FConnectionReplicationList& List, UNetConnection* OwnerConnection, AActor* Actor )
+	{
+		UNetConnection* Connection = List.Connection;
+
+		// Skip all sent temporary actors.
+		if( Actor->bNetTemporary && Connection->SentTemporaries.FindRef(Actor) )
+		{
+			return;
+		}
+
+		UActorChannel* Channel = Connection->ActorChannels.FindRef(Actor);
+		if( Actor->bOnlyDirtyReplication
+		&&	Channel
+		&&	!Channel->ActorDirty
+		&&	Channel->Recent.Num()
+		&&	Channel->Dirty.Num() == 0 )
+		{
+			Channel->RelevantTime = Connection->Driver->Time;
+		}
+		else
+		{
+			List.PriorityList  [List.ConsiderCount] = FActorPriority(OwnerConnection, Channel, Actor, List.Viewers, List.NumViewers, List.bLowNetBandwidth);
+			List.PriorityActors[List.ConsiderCount] = List.PriorityList + List.ConsiderCount;
+			List.ConsiderCount++;
+		}
+	}
+
+	/**
+	 * Builds the list of a single connection.
+	 *
+	 * @param List	list to build
+	 */
+	void BuildList( FConnectionReplicationList& List )
+	{
+		UNetConnection* Connection = List.Connection;
+		List.PriorityList	= new(GFrameArena,MaxConsiderCount)FActorPriority;
+		List.PriorityActors	= new(GFrameArena,MaxConsiderCount)FActorPriority*;
+		List.ConsiderCount	= 0;
+
+		// Actors only relevant to owners are never in the shared list.
+		for( INT j=0; j<ConsiderListSize; j++ )
+		{
+			ConsiderActor( List, Connection, ConsiderList[j] );
+		}
+
+		if( NetDriver->NetCullDistance > 0.f )
+		{
+			// Actors near the viewers.
+			TArray<const TArray<AActor*>*> NearCells;
+			NetDriver->RelevancyGrid.GetCellsNear( List.Viewers, List.NumViewers, NetDriver->NetCullDistance, NearCells );
+			for( INT CellIndex=0; CellIndex<NearCells.Num(); CellIndex++ )
+			{
+				const TArray<AActor*>& CellActors = *NearCells(CellIndex);
+				for( INT j=0; j<CellActors.Num(); j++ )
+				{
+					AActor* Actor = CellActors(j);
+					if( Actor->NetTag == NetTag && !IsBeyondNetCullDistance( Actor, List.Viewers, List.NumViewers, NetDriver ) )
+					{
+						ConsiderActor( List, Connection, Actor );
+					}
+				}
+			}
+
+			// Actors out of range that still have a channel, which is closed once it times out.
+			for( TMap<AActor*,UActorChannel*>::TIterator It(Connection->ActorChannels); It; ++It )
+			{
+				AActor* Actor = It.Key();
+				if( Actor->NetTag == NetTag && IsBeyondNetCullDistance( Actor, List.Viewers, List.NumViewers, NetDriver ) )
+				{
+					ConsiderActor( List, Connection, Actor );
+				}
+			}
+		}
+
+		// An actor can be owned by several viewers of the same connection but is only considered once.
+		const INT FirstOwnedIndex = List.ConsiderCount;
+		UNetConnection* NextConnection = Connection;
+		INT ChildIndex = 0;
+		while (NextConnection != NULL)
+		{
+			for (INT j = 0; j < NextConnection->OwnedConsiderListSize; j++)
+			{
+				AActor* Actor = NextConnection->OwnedConsiderList[j];
+				UBOOL bAlreadyConsidered = FALSE;
+				for (INT k = FirstOwnedIndex; k < List.ConsiderCount && !bAlreadyConsidered; k++)
+				{
+					bAlreadyConsidered = List.PriorityList[k].Actor == Actor;
+				}
+				if (!bAlreadyConsidered)
+				{
+					ConsiderActor( List, NextConnection, Actor );
+				}
+			}
+			NextConnection->OwnedConsiderList = NULL;
+			NextConnection->OwnedConsiderListSize = 0;
+
+			NextConnection = (ChildIndex < Connection->Children.Num()) ? Connection->Children(ChildIndex++) : NULL;
+		}
+
+		// Sort by priority, if network connection is saturated
+		if ( List.bPrioritySort )
+		{
+			Sort<USE_COMPARE_POINTER(FActorPriority,UnLevTic)>( List.PriorityActors, List.ConsiderCount );
+		}
+	}
+
+	/** Lists to build */
+	FConnectionReplicationList*	Lists;
+	/** Number of entries in Lists */
+	INT							NumLists;
+	/** Actors considered for all connections */
+	AActor**					ConsiderList;
+	/** Number of entries in ConsiderList */
+	INT							ConsiderListSize;
+	/** Upper bound of the number of actors considered for a single connection */
+	INT							MaxConsiderCount;
+	/** Net driver whose relevancy grid holds the actors considered for connections they are near to */
+	UNetDriver*					NetDriver;
+	/** NetTag of the actors in the relevancy grid that are considered this tick */
+	INT							NetTag;
+	/** Index of the next list to claim, plus one */
+	FThreadSafeCounter			NextList;
+	/** Number of lists built */
+	FThreadSafeCounter			NumListsBuilt;
+	/** Number of threads referencing the builder */
+	FThreadSafeCounter			NumReferences;
+};
+
+/**
+ * Helper building priority lists on a GThreadPool thread.
+ */
+class FNetPriorityListWork : public FQueuedWork
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param InBuilder		builder to help, this work holds a reference to it
+	 */
+	FNetPriorityListWork( FNetPriorityListBuilder* InBuilder )
+	:	Builder( InBuilder )
+	{}
+
+	virtual void DoWork()
+	{
+		Builder->BuildLists();
+	}
+
+	virtual void Abandon()
+	{
+		Dispose();
+	}
+
+	virtual void Dispose()
+	{
+		Builder->Release();
+		delete this;
+	}
+
+private:
+	/** Builder to help */
+	FNetPriorityListBuilder* Builder;
+};
+
 /**
  * Class that holds lists of objects that need deferred ticking
  */
@@ -140,6 +423,10 @@ class FDeferredTickList
 	 * Post async operations list for ActorComponents
 	 */
 	TArray<UActorComponent*> ComponentsPostAsync;
+	/**
+	 * Actors of the current tick group that are ticked in parallel once the rest of the group is done
+	 */
+	TArray<AActor*> ActorsParallel;
 
 public:
 	/**
@@ -164,6 +451,7 @@ public:
 		ComponentsDuringAsync.Empty(Max<INT>(NumComponentsPreSize,ComponentsDuringAsync.Num()));
 		ActorsPostAsync.Empty(Max<INT>(NumActorsPreSize,ActorsPostAsync.Num()));
 		ComponentsPostAsync.Empty(Max<INT>(NumComponentsPreSize,ComponentsPostAsync.Num()));
+		ActorsParallel.Empty(Max<INT>(NumActorsPreSize,ActorsParallel.Num()));
 	}
 
 	/**
@@ -198,6 +486,36 @@ public:
 		return bDeferred;
 	}
 
+	/**
+	 * Decides whether to hold back ticking of this actor until the rest of
+	 * the current tick group has been ticked, so that it can be ticked in
+	 * parallel with the other actors that were held back.
+	 *
+	 * @param Actor the actor to check for parallel ticking
+	 *
+	 * @return TRUE if the actor was held back, FALSE if it needs ticking
+	 */
+	FORCEINLINE UBOOL ConditionalDeferParallel(AActor* Actor)
+	{
+		if (Actor->CanTickInParallel())
+		{
+			ActorsParallel.AddItem(Actor);
+			return TRUE;
+		}
+		return FALSE;
+	}
+
+	/**
+	 * Hands out the actors held back by ConditionalDeferParallel. The caller
+	 * empties the list once they have been ticked.
+	 *
+	 * @return the list of actors to tick in parallel
+	 */
+	FORCEINLINE TArray<AActor*>& GetParallelActors(void)
+	{
+		return ActorsParallel;
+	}
+
 	/**
 	 * Places a newly spawned actor in the post async work list
 	 *
@@ -385,6 +703,209 @@ public:
 	friend class FActorDuringAsyncWorkIterator;
 };
 
+/*-----------------------------------------------------------------------------
+	Parallel ticking.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Number of actors/components handed to a thread at a time. Small enough to
+ * balance uneven ticks, large enough to amortize claiming a batch.
+ */
+#define PARALLEL_TICK_BATCH_SIZE 32
+
+/**
+ * Shared state of a parallel tick. The actors and components are split into
+ * batches that the game thread and GThreadPool workers claim until none are
+ * left. The last thread to call Release deletes the context, so workers that
+ * only get to run after all batches are done find it still around.
+ */
+class FParallelTickContext
+{
+	/**
+	 * Actors to call TickParallel on. Only accessed while batches are left
+	 */
+	const TArray<AActor*>& Actors;
+	/**
+	 * Components to call TickParallel on. Only accessed while batches are left
+	 */
+	const TArray<UActorComponent*>& Components;
+	/**
+	 * Time in seconds since last tick
+	 */
+	FLOAT DeltaSeconds;
+	/**
+	 * Type of tick (viewports only, time only, etc)
+	 */
+	ELevelTick TickType;
+	/**
+	 * Total number of batches
+	 */
+	INT NumBatches;
+	/**
+	 * Number of batches that have been claimed by a thread
+	 */
+	FThreadSafeCounter NumClaimedBatches;
+	/**
+	 * Number of batches that have been ticked
+	 */
+	FThreadSafeCounter NumCompletedBatches;
+	/**
+	 * Number of threads referencing the context
+	 */
+	FThreadSafeCounter NumReferences;
+
+public:
+	/**
+	 * Sets up the batches
+	 *
+	 * @param InActors actors to tick
+	 * @param InComponents components to tick
+	 * @param InDeltaSeconds time in seconds since last tick
+	 * @param InTickType type of tick (viewports only, time only, etc)
+	 * @param InNumReferences number of threads referencing the context
+	 */
+	FParallelTickContext(const TArray<AActor*>& InActors,
+		const TArray<UActorComponent*>& InComponents,FLOAT InDeltaSeconds,
+		ELevelTick InTickType,INT InNumReferences) :
+		Actors(InActors),
+		Components(InComponents),
+		DeltaSeconds(InDeltaSeconds),
+		TickType(InTickType),
+		NumBatches((InActors.Num() + InComponents.Num() + PARALLEL_TICK_BATCH_SIZE - 1) / PARALLEL_TICK_BATCH_SIZE),
+		NumReferences(InNumReferences)
+	{
+	}
+
+	/**
+	 * Ticks batches until all of them have been claimed. Run by the game
+	 * thread as well as by each worker queued on GThreadPool.
+	 */
+	void TickBatches(void)
+	{
+		INT BatchIndex;
+		while ((BatchIndex = NumClaimedBatches.Increment() - 1) < NumBatches)
+		{
+			const INT NumActors = Actors.Num();
+			const INT FirstIndex = BatchIndex * PARALLEL_TICK_BATCH_SIZE;
+			const INT LastIndex = Min<INT>(FirstIndex + PARALLEL_TICK_BATCH_SIZE,NumActors + Components.Num());
+			for (INT Index = FirstIndex; Index < LastIndex; Index++)
+			{
+				if (Index < NumActors)
+				{
+					AActor* Actor = Actors(Index);
+					// Actors ticked after this one was held back might have destroyed it
+					if (Actor->ActorIsPendingKill() == FALSE)
+					{
+						Actor->TickParallel(DeltaSeconds * Actor->CustomTimeDilation,TickType);
+					}
+				}
+				else
+				{
+					Components(Index - NumActors)->ConditionalTickParallel(DeltaSeconds);
+				}
+			}
+			NumCompletedBatches.Increment();
+		}
+	}
+
+	/**
+	 * @return TRUE once every batch has been ticked
+	 */
+	UBOOL IsDone(void) const
+	{
+		return NumCompletedBatches.GetValue() == NumBatches;
+	}
+
+	/**
+	 * Drops a reference, deleting the context once nobody references it
+	 */
+	void Release(void)
+	{
+		if (NumReferences.Decrement() == 0)
+		{
+			delete this;
+		}
+	}
+};
+
+/**
+ * Helper running FParallelTickContext::TickBatches on a GThreadPool thread
+ */
+class FParallelTickWork : public FQueuedWork
+{
+	/**
+	 * Shared state of the parallel tick
+	 */
+	FParallelTickContext* Context;
+
+public:
+	/**
+	 * Holds on to the context, which this work holds a reference to
+	 */
+	FParallelTickWork(FParallelTickContext* InContext) :
+		Context(InContext)
+	{
+	}
+
+	virtual void DoWork()
+	{
+		Context->TickBatches();
+	}
+
+	virtual void Abandon()
+	{
+		Dispose();
+	}
+
+	virtual void Dispose()
+	{
+		Context->Release();
+		delete this;
+	}
+};
+
+/**
+ * Calls TickParallel on a set of actors and components, spreading the work
+ * across the game thread and GThreadPool workers. Only returns once all of
+ * them are done, which is the sync point after which their regular ticks
+ * apply anything involving shared state on the game thread.
+ *
+ * @param Actors actors that can tick in parallel
+ * @param Components components that can tick in parallel
+ * @param DeltaSeconds time in seconds since last tick
+ * @param TickType type of tick (viewports only, time only, etc)
+ */
+void TickInParallel(const TArray<AActor*>& Actors,
+	const TArray<UActorComponent*>& Components,FLOAT DeltaSeconds,
+	ELevelTick TickType)
+{
+	const INT NumItems = Actors.Num() + Components.Num();
+	if (NumItems == 0)
+	{
+		return;
+	}
+	// Allow comparing against ticking everything on the game thread
+	static const UBOOL bUseParallelTick = !ParseParam(appCmdLine(),TEXT("SERIALTICK"));
+	const INT NumBatches = (NumItems + PARALLEL_TICK_BATCH_SIZE - 1) / PARALLEL_TICK_BATCH_SIZE;
+	const INT NumHelpers = (bUseParallelTick && GThreadPool != NULL) ?
+		Min<INT>((INT)GNumHardwareThreads - 1,NumBatches - 1) : 0;
+
+	FParallelTickContext* Context = new FParallelTickContext(Actors,Components,
+		DeltaSeconds,TickType,NumHelpers + 1);
+	for (INT HelperIndex = 0; HelperIndex < NumHelpers; HelperIndex++)
+	{
+		GThreadPool->AddQueuedWork(new FParallelTickWork(Context));
+	}
+	// The game thread works along with the helpers and then waits for the
+	// batches other threads are still busy with
+	Context->TickBatches();
+	while (Context->IsDone() == FALSE)
+	{
+		appSleep(0);
+	}
+	Context->Release();
+}
+
 /*-----------------------------------------------------------------------------
 	Tick a single actor.
 -----------------------------------------------------------------------------*/
@@ -833,17 +1354,70 @@ UBOOL APlayerController::Tick( FLOAT DeltaSeconds, ELevelTick TickType )
 	return 1;
 }
 
+/**
+ * Returns the function a timer calls, remembering it in the timer for the class and state its object is in
+ * the same way FScriptCallCache does for script call sites.
+ *
+ * @param	Timer	timer to look up the function for
+ * @return	function to call, NULL if the timer object doesn't have it
+ */
+static FORCEINLINE UFunction* FindTimerFunction( FTimerData& Timer )
+{
+	UObject* TimerObj = Timer.TimerObj;
+	if( !GUseScriptCallCaches )
+	{
+		return TimerObj->FindFunction( Timer.FuncName );
+	}
+
+	FStateFrame* StateFrame = TimerObj->GetStateFrame();
+	UState* State = StateFrame ? StateFrame->StateNode : NULL;
+	UClass* Class = TimerObj->GetClass();
+	if( Timer.CachedClass != Class || Timer.CachedState != State || (DWORD)Timer.CachedEpoch != GScriptCallCacheEpoch )
+	{
+		Timer.CachedFunction	= TimerObj->FindFunction( Timer.FuncName );
+		Timer.CachedClass		= Class;
+		Timer.CachedState		= State;
+		Timer.CachedEpoch		= (INT)GScriptCallCacheEpoch;
+	}
+	return Timer.CachedFunction;
+}
+
 /* Update active timers */
 void AActor::UpdateTimers(FLOAT DeltaSeconds)
 {
+	if (Timers.Num() == 0)
+	{
+		return;
+	}
+
+	// while none of the timers can have expired, only remember the time we've been ticked by. GWorld is the
+	// world ticking us, owners ticked at a different rate than its clock need to shift their wheel entry
+	if (bTimersIdle && GWorld->TimerWheel.IsInStep(DeltaSeconds))
+	{
+		TimerPendingSeconds += DeltaSeconds;
+		return;
+	}
+
 	// split into two loops to avoid infinite loop where
 	// the timer is called, causes settimer to be called
 	// again with a rate less than our current delta
 	// and causing an invalid index to be accessed
-	for (INT Idx = 0; Idx < Timers.Num(); Idx++)
+	FTimerWheel* TimerWheel = FTimerWheel::GetActorTimerWheel(this);
+	if (TimerWheel != NULL)
 	{
-		// just increment the counters
-		Timers(Idx).Count += DeltaSeconds;
+		// the wheel increments the counters, but only once one of them might have expired
+		if (!TimerWheel->UpdateActor(this,DeltaSeconds))
+		{
+			return;
+		}
+	}
+	else
+	{
+		for (INT Idx = 0; Idx < Timers.Num(); Idx++)
+		{
+			// just increment the counters
+			Timers(Idx).Count += DeltaSeconds;
+		}
 	}
 
 	UBOOL bRemoveTimer = false;
@@ -867,7 +1441,7 @@ void AActor::UpdateTimers(FLOAT DeltaSeconds)
 			INT CallCount = Timers(Idx).bLoop == 1 ? appTrunc(Timers(Idx).Count/Timers(Idx).Rate) : 1;
 			
 			// lookup the function to call
-			UFunction *Func = TimerObj->FindFunction(Timers(Idx).FuncName);
+			UFunction *Func = FindTimerFunction(Timers(Idx));
 			// if we didn't find the function, or it's not looping
 			if( Func == NULL ||
 				!Timers(Idx).bLoop )
@@ -929,6 +1503,11 @@ void AActor::UpdateTimers(FLOAT DeltaSeconds)
 		}
 	}
 
+	// let the wheel know when to look at the remaining timers again
+	if (TimerWheel != NULL)
+	{
+		TimerWheel->ScheduleActor(this,TRUE);
+	}
 }
 
 /*-----------------------------------------------------------------------------
@@ -971,6 +1550,26 @@ UBOOL AActor::IsRelevantThroughPortals(const TArray<APortalTeleporter*>& Portals
 	return FALSE;
 }
 
+/**
+ * Line check of a relevancy check. While replicating, results are shared by viewers in the same visibility cell.
+ *
+ * @param	Actor		actor whose relevancy is checked, ignored by the line check
+ * @param	End			end of the line check
+ * @param	Start		start of the line check
+ * @param	SrcLocation	location relevancy is checked for, either End or Start
+ * @return	TRUE if nothing blocks the line
+ */
+static UBOOL NetRelevancyLineCheck(AActor* Actor, const FVector& End, const FVector& Start, const FVector& SrcLocation)
+{
+	UNetDriver* NetDriver = GWorld->NetDriver;
+	if (NetDriver != NULL && NetDriver->ReplicationPass != INDEX_NONE)
+	{
+		return NetDriver->RelevancyGrid.LineCheck(Actor, End, Start, SrcLocation);
+	}
+	FCheckResult Hit(1.f);
+	return GWorld->SingleLineCheck(Hit, Actor, End, Start, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f));
+}
+
 UBOOL AActor::IsNetRelevantFor(APlayerController* RealViewer, AActor* Viewer, const FVector& SrcLocation)
 {
 	if( bAlwaysRelevant || IsOwnedBy(Viewer) || IsOwnedBy(RealViewer) || this==Viewer || Viewer==Instigator )
@@ -987,8 +1586,7 @@ UBOOL AActor::IsNetRelevantFor(APlayerController* RealViewer, AActor* Viewer, co
 	}
 	else
 	{
-		FCheckResult Hit(1.f);
-		return ( GWorld->SingleLineCheck( Hit, this, SrcLocation, Location, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f) ) || IsRelevantThroughPortals(RealViewer->VisiblePortals));
+		return ( NetRelevancyLineCheck( this, SrcLocation, Location, SrcLocation ) || IsRelevantThroughPortals(RealViewer->VisiblePortals));
 	}
 }
 
@@ -1037,9 +1635,8 @@ UBOOL APawn::IsNetRelevantFor(APlayerController* RealViewer, AActor* Viewer, con
 #endif
 		// check against BSP - check head and center
 		//debugf(TEXT("Check relevance of %s"),*(PlayerReplicationInfo->PlayerName));
-		FCheckResult Hit(1.f);
-		if ( !GWorld->SingleLineCheck( Hit, this, Location + FVector(0.f,0.f,BaseEyeHeight), SrcLocation, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f) )
-			&& !GWorld->SingleLineCheck( Hit, this, Location, SrcLocation, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f) )
+		if ( !NetRelevancyLineCheck( this, Location + FVector(0.f,0.f,BaseEyeHeight), SrcLocation, SrcLocation )
+			&& !NetRelevancyLineCheck( this, Location, SrcLocation, SrcLocation )
 			 && !IsRelevantThroughPortals(RealViewer->VisiblePortals) )
 		{
 			return CacheNetRelevancy(false,RealViewer,Viewer);
@@ -1072,9 +1669,8 @@ UBOOL AVehicle::IsNetRelevantFor(APlayerController* RealViewer, AActor* Viewer,
 			return CacheNetRelevancy(true,RealViewer,Viewer);
 		}
 		// check Location and collision bounds
-		FCheckResult Hit(1.f);
-		if ( GWorld->SingleLineCheck( Hit, this, Location + FVector(0.f,0.f,CylinderComponent->CollisionHeight), SrcLocation, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f) )
-			|| GWorld->SingleLineCheck( Hit, this, Location, SrcLocation, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f) )
+		if ( NetRelevancyLineCheck( this, Location + FVector(0.f,0.f,CylinderComponent->CollisionHeight), SrcLocation, SrcLocation )
+			|| NetRelevancyLineCheck( this, Location, SrcLocation, SrcLocation )
 			 || IsRelevantThroughPortals(RealViewer->VisiblePortals) )
 		{
 			return CacheNetRelevancy(true,RealViewer,Viewer);
@@ -1085,6 +1681,7 @@ UBOOL AVehicle::IsNetRelevantFor(APlayerController* RealViewer, AActor* Viewer,
 			FVector Y = ((Location - SrcLocation) ^ FVector(0.f, 0.f, 1.f)).SafeNormal();
 
 			// randomize point somewhat so stopped vehicle can't worst case stay not relevant
+			FCheckResult Hit(1.f);
 			if ( GWorld->SingleLineCheck( Hit, this, Location + Y*(0.5f + 0.5*appFrand())*CylinderComponent->CollisionRadius + FVector(0.f,0.f,CylinderComponent->CollisionHeight), SrcLocation, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f))
 				|| GWorld->SingleLineCheck( Hit, this, Location - Y*(0.5f + 0.5*appFrand())*CylinderComponent->CollisionRadius + FVector(0.f,0.f,CylinderComponent->CollisionHeight), SrcLocation, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f)) )
 			{
@@ -1103,7 +1700,10 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 
 	INT NetRelevantActorCount = FActorIteratorBase::GetNetRelevantActorCount() + 2;
 
-	FMemMark Mark(GMem);
+	// Allocate from the frame arena so the lists can be built from any thread.
+	FFrameArenaMark Mark(GFrameArena);
+	// Actors replicated to several connections are only compared for property changes once.
+	NetDriver->BeginReplicationPass();
 	// initialize connections
 	for( INT i=NetDriver->ClientConnections.Num()-1; i>=0; i-- )
 	{
@@ -1118,7 +1718,7 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 		if (Connection->Actor != NULL && Connection->State == USOCK_Open && (Connection->Driver->Time - Connection->LastReceiveTime < 1.5f))
 		{
 			Connection->Viewer = Connection->Actor->GetViewTarget();
-			Connection->OwnedConsiderList = new(GMem,NetRelevantActorCount)AActor*;
+			Connection->OwnedConsiderList = new(GFrameArena,NetRelevantActorCount)AActor*;
 			Connection->OwnedConsiderListSize = 0;
 
 			for (INT j = 0; j < Connection->Children.Num(); j++)
@@ -1126,7 +1726,7 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 				if (Connection->Children(j)->Actor != NULL)
 				{
 					Connection->Children(j)->Viewer = Connection->Children(j)->Actor->GetViewTarget();
-					Connection->Children(j)->OwnedConsiderList = new(GMem, NetRelevantActorCount) AActor*;
+					Connection->Children(j)->OwnedConsiderList = new(GFrameArena, NetRelevantActorCount) AActor*;
 					Connection->Children(j)->OwnedConsiderListSize = 0;
 				}
 				else
@@ -1146,7 +1746,7 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 	}
 
 	// make list of actors to consider
-	AActor **ConsiderList = new(GMem,NetRelevantActorCount)AActor*;
+	AActor **ConsiderList = new(GFrameArena,NetRelevantActorCount)AActor*;
 	INT ConsiderListSize = 0;
 
 	// Add WorldInfo to considerlist
@@ -1157,6 +1757,11 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 		ConsiderListSize++;
 	}
 
+	// When culling by distance actors that aren't always relevant go into the relevancy grid instead of the
+	// consider list, tagged so connections can tell which ones are due for an update.
+	const UBOOL bCullByDistance = NetDriver->NetCullDistance > 0.f;
+	NetTag++;
+
 	UBOOL bCPUSaturated		= FALSE;
 	FLOAT ServerTickTime	= GEngine->GetMaxTickRate( DeltaSeconds );
 	if ( ServerTickTime == 0.f )
@@ -1180,8 +1785,16 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 		
 			if ( Actor->bAlwaysRelevant || !Actor->bOnlyRelevantToOwner ) 
 			{
-				ConsiderList[ConsiderListSize] = Actor;
-				ConsiderListSize++;
+				if ( bCullByDistance && !Actor->bAlwaysRelevant )
+				{
+					Actor->NetTag = NetTag;
+					NetDriver->RelevancyGrid.UpdateActor(Actor);
+				}
+				else
+				{
+					ConsiderList[ConsiderListSize] = Actor;
+					ConsiderListSize++;
+				}
 			}
 			else
 			{
@@ -1241,25 +1854,17 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 		*/
 	}
 
+	// Gather the viewers of each connection, this calls script so it can't be done by the list builders.
+	FConnectionReplicationList* Lists = new(GFrameArena,NetDriver->ClientConnections.Num())FConnectionReplicationList;
+	INT NumLists = 0;
 	for( INT i=NetDriver->ClientConnections.Num()-1; i>=0; i-- )
 	{
 		UNetConnection* Connection = NetDriver->ClientConnections(i);
 
 		if (Connection->Viewer)
 		{
-			// Get list of visible/relevant actors.
-			FLOAT PruneActors = 0.f;
-			clock(PruneActors);
-			FMemMark RelevantActorMark(GMem);
-			NetTag++;
 			Connection->TickCount++;
 
-			// Set up to skip all sent temporary actors.
-			for( INT j=0; j<Connection->SentTemporaries.Num(); j++ )
-			{
-				Connection->SentTemporaries(j)->NetTag = NetTag;
-			}
-
 			TArray<FNetViewer>& ConnectionViewers = WorldInfo->ReplicationViewers;
 			ConnectionViewers.Reset();
 			new(ConnectionViewers) FNetViewer(Connection, DeltaSeconds);
@@ -1271,228 +1876,195 @@ INT UWorld::ServerTickClients( FLOAT DeltaSeconds )
 				}
 			}
 
-			// Make list of all actors to consider.
-			INT					ConsiderCount	= 0;
-			INT					NetRelevantCount = FActorIteratorBase::GetNetRelevantActorCount();
-			FActorPriority* PriorityList = new(GMem,NetRelevantCount+2)FActorPriority;
-			FActorPriority** PriorityActors = new(GMem,NetRelevantCount+2)FActorPriority*;
-			UBOOL bLowNetBandwidth = !bCPUSaturated && (Connection->CurrentNetSpeed/FLOAT(WorldInfo->Game->NumPlayers + GWorld->GetGameInfo()->NumBots) < (WorldInfo->Game->bAllowVehicles ? 500.f : 300.f) );
-			UBOOL bPrioritySort = FALSE;
-			for (INT j = 0; j < ConnectionViewers.Num(); j++)
+			FConnectionReplicationList& List = Lists[NumLists++];
+			List.Connection = Connection;
+			List.NumViewers = ConnectionViewers.Num();
+			List.Viewers = (FNetViewer*)GFrameArena.PushBytes(List.NumViewers * sizeof(FNetViewer), DEFAULT_ALIGNMENT);
+			appMemcpy(List.Viewers, ConnectionViewers.GetData(), List.NumViewers * sizeof(FNetViewer));
+
+			List.bLowNetBandwidth = !bCPUSaturated && (Connection->CurrentNetSpeed/FLOAT(WorldInfo->Game->NumPlayers + GWorld->GetGameInfo()->NumBots) < (WorldInfo->Game->bAllowVehicles ? 500.f : 300.f) );
+			List.bPrioritySort = FALSE;
+			for (INT j = 0; j < List.NumViewers; j++)
 			{
-				bPrioritySort = bPrioritySort || ConnectionViewers(j).InViewer->bWasSaturated;
-				ConnectionViewers(j).InViewer->bWasSaturated = ConnectionViewers(j).InViewer->bWasSaturated && bLowNetBandwidth;
+				List.bPrioritySort = List.bPrioritySort || List.Viewers[j].InViewer->bWasSaturated;
+				List.Viewers[j].InViewer->bWasSaturated = List.Viewers[j].InViewer->bWasSaturated && List.bLowNetBandwidth;
 			}
+		}
+	}
+
+	// Build the prioritized list of actors to consider for each connection. The game thread helps out
+	// and returns once every list has been claimed, at which point it waits for the remaining ones.
+	const INT NumHelpers = (GThreadPool && NetDriver->bParallelPriorityLists) ? Min<INT>( GNumHardwareThreads, NumLists ) - 1 : 0;
+	FNetPriorityListBuilder* Builder = new FNetPriorityListBuilder( Lists, NumLists, ConsiderList, ConsiderListSize, NetRelevantActorCount, NetDriver, NetTag, NumHelpers + 1 );
+	for( INT HelperIndex=0; HelperIndex<NumHelpers; HelperIndex++ )
+	{
+		GThreadPool->AddQueuedWork( new FNetPriorityListWork( Builder ) );
+	}
+	Builder->BuildLists();
+	Builder->WaitForLists();
+	Builder->Release();
 
-			for( INT j=0; j<ConsiderListSize; j++ )
+	// Relevancy checks and replication modify actors and channels so connections are updated one at a time,
+	// in the same order as before.
+	for( INT ListIndex=0; ListIndex<NumLists; ListIndex++ )
+	{
+		FConnectionReplicationList& List = Lists[ListIndex];
+		UNetConnection* Connection = List.Connection;
+
+		// Replication conditions check the viewers of the connection being replicated to.
+		TArray<FNetViewer>& ConnectionViewers = WorldInfo->ReplicationViewers;
+		ConnectionViewers.Reset();
+		ConnectionViewers.Add(List.NumViewers);
+		appMemcpy(ConnectionViewers.GetData(), List.Viewers, List.NumViewers * sizeof(FNetViewer));
+
+		INT ConsiderCount = List.ConsiderCount;
+		FActorPriority** PriorityActors = List.PriorityActors;
+		FLOAT RelevantTime = 0.f;
+		clock(RelevantTime);
+
+		// Update all relevant actors in sorted order.
+		INT j;
+		UBOOL bNewSaturated = false;
+		//debugf(TEXT("START"));
+		for( j=0; j<ConsiderCount; j++ )
+		{
+			UActorChannel* Channel     = PriorityActors[j]->Channel;
+			//debugf(TEXT(" Maybe Replicate %s"),*PriorityActors[j]->Actor->GetName());
+			if ( !Channel || Channel->Actor ) //make sure didn't just close this channel
 			{
-				AActor* Actor = ConsiderList[j];
-				if( Actor->NetTag!=NetTag )
+				AActor*        Actor       = PriorityActors[j]->Actor;
+				UBOOL          CanSee      = 0;
+
+				// only check visibility on already visible actors every 1.0 + 0.5R seconds
+				// bTearOff actors should never be checked
+				if ( !Actor->bTearOff && (!Channel || NetDriver->Time-Channel->RelevantTime>1.f) && !IsBeyondNetCullDistance(Actor, List.Viewers, List.NumViewers, NetDriver) )
 				{
-					//debugf(TEXT("Consider %s alwaysrelevant %d frequency %f "),*Actor->GetName(), Actor->bAlwaysRelevant, Actor->NetUpdateFrequency);
-					UActorChannel* Channel = Connection->ActorChannels.FindRef(Actor);
-					if( Actor->bOnlyDirtyReplication 
-					&&	Channel 
-					&&	!Channel->ActorDirty 
-					&&	Channel->Recent.Num() 
-					&&	Channel->Dirty.Num() == 0 
-					)
+					for (INT k = 0; k < ConnectionViewers.Num(); k++)
 					{
-						Channel->RelevantTime = NetDriver->Time;
-					}
-					else
-					{
-						Actor->NetTag                 = NetTag;
-						PriorityList  [ConsiderCount] = FActorPriority(Connection, Channel, Actor, ConnectionViewers, bLowNetBandwidth);
-						PriorityActors[ConsiderCount] = PriorityList + ConsiderCount;
-						ConsiderCount++;
+						if (Actor->IsNetRelevantFor(ConnectionViewers(k).InViewer, ConnectionViewers(k).Viewer, ConnectionViewers(k).ViewLocation))
+						{
+							CanSee = TRUE;
+							break;
+						}
 					}
 				}
-			}
-
-			UNetConnection* NextConnection = Connection;
-			INT ChildIndex = 0;
-			while (NextConnection != NULL)
-			{
-				for (INT j = 0; j < NextConnection->OwnedConsiderListSize; j++)
-				{
-					AActor* Actor = NextConnection->OwnedConsiderList[j];
-					//debugf(TEXT("Consider owned %s always relevant %d frequency %f  "),Actor->GetName(), Actor->bAlwaysRelevant,Actor->NetUpdateFrequency);
-					if (Actor->NetTag != NetTag)
+				
+				if( CanSee || (Channel && NetDriver->Time-Channel->RelevantTime<NetDriver->RelevantTimeout) )
+				{	
+					// Find or create the channel for this actor.
+					// we can't create the channel if the client is in a different world than we are
+					// or the package map doesn't support the actor's class/archetype (or the actor itself in the case of serializable actors)
+					// or it's a static actor and the client hasn't initialized the level it's in
+					if ( Channel == NULL && Connection->PackageMap->SupportsObject(Actor->GetClass()) &&
+							Connection->PackageMap->SupportsObject((Actor->bStatic || Actor->bNoDelete) ? Actor : Actor->GetArchetype()) )
 					{
-						UActorChannel* Channel = Connection->ActorChannels.FindRef(Actor);
-						if( Actor->bOnlyDirtyReplication
-						&&	Channel
-						&&	!Channel->ActorDirty
-						&&	Channel->Recent.Num()
-						&&	Channel->Dirty.Num() == 0 )
+						if ( Connection->ClientWorldPackageName == GWorld->GetOutermost()->GetFName()
+							&& ((!Actor->bStatic && !Actor->bNoDelete) || Connection->ClientHasInitializedLevelFor(Actor)) )
 						{
-							Channel->RelevantTime = NetDriver->Time;
+							// Create a new channel for this actor.
+							Channel = (UActorChannel*)Connection->CreateChannel( CHTYPE_Actor, 1 );
+							if( Channel )
+							{
+								Channel->SetChannelActor( Actor );
+							}
 						}
-						else
+						// if we couldn't replicate it for a reason that should be temporary, and this Actor is updated very infrequently, make sure we update it again soon
+						else if (Actor->NetUpdateFrequency < 1.0f)
 						{
-							Actor->NetTag                 = NetTag;
-							PriorityList  [ConsiderCount] = FActorPriority(NextConnection, Channel, Actor, ConnectionViewers, bLowNetBandwidth);
-							PriorityActors[ConsiderCount] = PriorityList + ConsiderCount;
-							ConsiderCount++;
+							Actor->NetUpdateTime = WorldInfo->TimeSeconds + 0.2f * appFrand();
 						}
 					}
-				}
-				NextConnection->OwnedConsiderList = NULL;
-				NextConnection->OwnedConsiderListSize = 0;
-
-				NextConnection = (ChildIndex < Connection->Children.Num()) ? Connection->Children(ChildIndex++) : NULL;
-			}
-
-			FLOAT RelevantTime = 0.f;
-
-			// Sort by priority, if network connection is saturated
-			if ( bPrioritySort )
-			{
-				Sort<USE_COMPARE_POINTER(FActorPriority,UnLevTic)>( PriorityActors, ConsiderCount );
-			}
-
-			// Update all relevant actors in sorted order.
-			INT j;
-			UBOOL bNewSaturated = false;
-			//debugf(TEXT("START"));
-			for( j=0; j<ConsiderCount; j++ )
-			{
-				UActorChannel* Channel     = PriorityActors[j]->Channel;
-				//debugf(TEXT(" Maybe Replicate %s"),*PriorityActors[j]->Actor->GetName());
-				if ( !Channel || Channel->Actor ) //make sure didn't just close this channel
-				{
-					AActor*        Actor       = PriorityActors[j]->Actor;
-					UBOOL          CanSee      = 0;
 
-					// only check visibility on already visible actors every 1.0 + 0.5R seconds
-					// bTearOff actors should never be checked
-					if ( !Actor->bTearOff && (!Channel || NetDriver->Time-Channel->RelevantTime>1.f) )
+					if( Channel )
 					{
-						for (INT k = 0; k < ConnectionViewers.Num(); k++)
+						if (!Connection->IsNetReady(0))
 						{
-							if (Actor->IsNetRelevantFor(ConnectionViewers(k).InViewer, ConnectionViewers(k).Viewer, ConnectionViewers(k).ViewLocation))
-							{
-								CanSee = TRUE;
-								break;
-							}
+							bNewSaturated = true;
+							break;
 						}
-					}
-					
-					if( CanSee || (Channel && NetDriver->Time-Channel->RelevantTime<NetDriver->RelevantTimeout) )
-					{	
-						// Find or create the channel for this actor.
-						// we can't create the channel if the client is in a different world than we are
-						// or the package map doesn't support the actor's class/archetype (or the actor itself in the case of serializable actors)
-						// or it's a static actor and the client hasn't initialized the level it's in
-						if ( Channel == NULL && Connection->PackageMap->SupportsObject(Actor->GetClass()) &&
-								Connection->PackageMap->SupportsObject((Actor->bStatic || Actor->bNoDelete) ? Actor : Actor->GetArchetype()) )
+						if( CanSee )
 						{
-							if ( Connection->ClientWorldPackageName == GWorld->GetOutermost()->GetFName()
-								&& ((!Actor->bStatic && !Actor->bNoDelete) || Connection->ClientHasInitializedLevelFor(Actor)) )
-							{
-								// Create a new channel for this actor.
-								Channel = (UActorChannel*)Connection->CreateChannel( CHTYPE_Actor, 1 );
-								if( Channel )
-								{
-									Channel->SetChannelActor( Actor );
-								}
-							}
-							// if we couldn't replicate it for a reason that should be temporary, and this Actor is updated very infrequently, make sure we update it again soon
-							else if (Actor->NetUpdateFrequency < 1.0f)
-							{
-								Actor->NetUpdateTime = WorldInfo->TimeSeconds + 0.2f * appFrand();
-							}
+							Channel->RelevantTime = NetDriver->Time + 0.5f * appSRand();
 						}
-
-						if( Channel )
+						// The initial state of actors is sent on channels that haven't been opened yet, it's held back
+						// before updates of actors the client already knows about when pacing a saturated connection.
+						const ESendPriority Priority = Channel->OpenPacketId==INDEX_NONE ? SENDPRI_Bulk : SENDPRI_Movement;
+						if( Channel->IsNetReady(0,Priority) )
 						{
-							if (!Connection->IsNetReady(0))
-							{
-								bNewSaturated = true;
-								break;
-							}
-							if( CanSee )
-							{
-								Channel->RelevantTime = NetDriver->Time + 0.5f * appSRand();
-							}
-							if( Channel->IsNetReady(0) )
-							{
-								//debugf(TEXT("Replicate %s"),*Actor->GetName());
-								Channel->ReplicateActor();
-								Updated++;
-							}
-							else
-							{							
-								Actor->NetUpdateTime = WorldInfo->TimeSeconds - 1.f;
-							}
-							if (!Connection->IsNetReady(0))
-							{
-								bNewSaturated = true;
-								break;
-							}
+							//debugf(TEXT("Replicate %s"),*Actor->GetName());
+							Channel->ReplicateActor();
+							Updated++;
+						}
+						else
+						{							
+							Actor->NetUpdateTime = WorldInfo->TimeSeconds - 1.f;
+						}
+						if (!Connection->IsNetReady(0))
+						{
+							bNewSaturated = true;
+							break;
 						}
 					}
-					else if( Channel )
-					{
-						Channel->Close();
+				}
+				else if( Channel )
+				{
+					Channel->Close();
 
-						// streamingServer
-						///////////////////Actor->Attached can be null
-						// attachments may not be relevant anymore either
-						for ( INT k=0; k<Actor->Attached.Num(); k++ )
+					// streamingServer
+					///////////////////Actor->Attached can be null
+					// attachments may not be relevant anymore either
+					for ( INT k=0; k<Actor->Attached.Num(); k++ )
+					{
+						if ( Actor->Attached(k) && !Actor->Attached(k)->bAlwaysRelevant 
+							&& (Actor->Attached(k)->BaseSkelComponent || ((Actor == Actor->Attached(k)->Owner) && !Actor->Attached(k)->bOnlyOwnerSee)) )
 						{
-							if ( Actor->Attached(k) && !Actor->Attached(k)->bAlwaysRelevant 
-								&& (Actor->Attached(k)->BaseSkelComponent || ((Actor == Actor->Attached(k)->Owner) && !Actor->Attached(k)->bOnlyOwnerSee)) )
-							{
-								UChannel *AttachedChannel = Connection->ActorChannels.FindRef(Actor->Attached(k));
-								if ( AttachedChannel )
-									AttachedChannel->Close();
-							}
+							UChannel *AttachedChannel = Connection->ActorChannels.FindRef(Actor->Attached(k));
+							if ( AttachedChannel )
+								AttachedChannel->Close();
 						}
 					}
 				}
 			}
-			for (INT k = 0; k < ConnectionViewers.Num(); k++)
+		}
+		for (INT k = 0; k < ConnectionViewers.Num(); k++)
+		{
+			ConnectionViewers(k).InViewer->bWasSaturated = bNewSaturated;
+		}
+
+		// relevant actors that could not be processed this frame are marked to be considered for next frame
+		for ( INT k=j; k<ConsiderCount; k++ )
+		{
+			AActor* Actor = PriorityActors[k]->Actor;
+			UActorChannel* Channel = PriorityActors[k]->Channel;
+			
+			debugfSuppressed(NAME_DevNetTraffic, TEXT("Saturated. %s"), *Actor->GetName());
+			if (Channel != NULL && NetDriver->Time - Channel->RelevantTime <= 1.f)
 			{
-				ConnectionViewers(k).InViewer->bWasSaturated = bNewSaturated;
+				//debugfSuppressed(NAME_DevNetTraffic, TEXT(" Saturated. Mark %s NetUpdateTime to be checked for next tick"), *Actor->GetName());
+				Actor->NetUpdateTime = WorldInfo->TimeSeconds - 1.f;
 			}
-
-			// relevant actors that could not be processed this frame are marked to be considered for next frame
-			for ( INT k=j; k<ConsiderCount; k++ )
+			else if (!IsBeyondNetCullDistance(Actor, List.Viewers, List.NumViewers, NetDriver))
 			{
-				AActor* Actor = PriorityActors[k]->Actor;
-				UActorChannel* Channel = PriorityActors[k]->Channel;
-				
-				debugfSuppressed(NAME_DevNetTraffic, TEXT("Saturated. %s"), *Actor->GetName());
-				if (Channel != NULL && NetDriver->Time - Channel->RelevantTime <= 1.f)
-				{
-					//debugfSuppressed(NAME_DevNetTraffic, TEXT(" Saturated. Mark %s NetUpdateTime to be checked for next tick"), *Actor->GetName());
-					Actor->NetUpdateTime = WorldInfo->TimeSeconds - 1.f;
-				}
-				else
+				for (INT h = 0; h < ConnectionViewers.Num(); h++)
 				{
-					for (INT h = 0; h < ConnectionViewers.Num(); h++)
+					if (Actor->IsNetRelevantFor(ConnectionViewers(h).InViewer, ConnectionViewers(h).Viewer, ConnectionViewers(h).ViewLocation))
 					{
-						if (Actor->IsNetRelevantFor(ConnectionViewers(h).InViewer, ConnectionViewers(h).Viewer, ConnectionViewers(h).ViewLocation))
+						//debugfSuppressed(NAME_DevNetTraffic, TEXT(" Saturated. Mark %s NetUpdateTime to be checked for next tick"), *Actor->GetName());
+						Actor->NetUpdateTime = WorldInfo->TimeSeconds - 1.f;
+						if (Channel != NULL)
 						{
-							//debugfSuppressed(NAME_DevNetTraffic, TEXT(" Saturated. Mark %s NetUpdateTime to be checked for next tick"), *Actor->GetName());
-							Actor->NetUpdateTime = WorldInfo->TimeSeconds - 1.f;
-							if (Channel != NULL)
-							{
-								Channel->RelevantTime = NetDriver->Time + 0.5f * appSRand();
-							}
-							break;
+							Channel->RelevantTime = NetDriver->Time + 0.5f * appSRand();
 						}
+						break;
 					}
 				}
 			}
-			RelevantActorMark.Pop();
-			unclock(RelevantTime);
-			//debugf(TEXT("Potential %04i ConsiderList %03i ConsiderCount %03i Prune=%01.4f Relevance=%01.4f"),NetRelevantCount, 
-			//			ConsiderListSize, ConsiderCount, PruneActors * GSecondsPerCycle * 1000.f,RelevantTime * GSecondsPerCycle * 1000.f);
 		}
+		unclock(RelevantTime);
+		//debugf(TEXT("ConsiderList %03i ConsiderCount %03i Relevance=%01.4f"),
+		//			ConsiderListSize, ConsiderCount, RelevantTime * GSecondsPerCycle * 1000.f);
 	}
+	NetDriver->EndReplicationPass();
 	Mark.Pop();
 	return Updated;
 }
@@ -1559,13 +2131,16 @@ void UWorld::TickNetServer( FLOAT DeltaSeconds )
 Demo Recording tick.
 -----------------------------------------------------------------------------*/
 
+/** Max number of times an actor is replicated to the snapshot of a keyframe to send all of its properties */
+#define MAX_KEYFRAME_SNAPSHOT_PASSES	4
+
 static void DemoReplicateActor(AActor* Actor, UNetConnection* Connection, UBOOL IsNetClient)
 {
 	// All replicatable actors are assumed to be relevant for demo recording.
 	if
 		(	Actor
 		&&	( (IsNetClient && Actor->bTearOff) || Actor->RemoteRole!=ROLE_None || (IsNetClient && Actor->Role!=ROLE_None && Actor->Role != ROLE_Authority))
-		&&  (!Actor->bNetTemporary || Connection->SentTemporaries.FindItemIndex(Actor)==INDEX_NONE)
+		&&  (!Actor->bNetTemporary || !Connection->SentTemporaries.FindRef(Actor))
 		// @todo: WTF
 		&&  (Actor->bStatic || !Actor->GetClass()->GetDefaultActor()->bStatic)
 		//@todo: FIXME: UActorChannel::ReceivedBunch() currently doesn't handle receiving non-owned PCs (tries to hook them up to a splitscreen viewport). Do demos need those other PCs in them?
@@ -1603,7 +2178,15 @@ static void DemoReplicateActor(AActor* Actor, UNetConnection* Connection, UBOOL
 					else
 						Exchange(Actor->RemoteRole, Actor->Role);
 				}
+				// Bits flushed plus bits waiting to be flushed, the overhead of packets is attributed to the actor filling them up.
+				UDemoRecDriver* DemoRecDriver = (UDemoRecDriver*)Connection->Driver;
+				const QWORD StartBits = (QWORD)DemoRecDriver->OutBytes * 8 + Connection->Out.GetNumBits();
 				Channel->ReplicateActor();
+				if( DemoRecDriver->bMeasureBandwidth )
+				{
+					const QWORD EndBits = (QWORD)DemoRecDriver->OutBytes * 8 + Connection->Out.GetNumBits();
+					DemoRecDriver->RecordActorBandwidth( Actor, (INT)(EndBits - StartBits) );
+				}
 				if(IsNetClient)
 				{
 					if( TornOff )
@@ -1624,6 +2207,21 @@ INT UWorld::TickDemoRecord( FLOAT DeltaSeconds )
 {
 	UNetConnection* Connection = DemoRecDriver->ClientConnections(0);
 	UBOOL IsNetClient = (GetNetMode() == NM_Client);
+	if( DemoRecDriver->ShouldTakeKeyframe() )
+	{
+		// Replicate the actors with open channels in full to a connection of their own, properties that
+		// didn't fit into a bunch go out in further ones.
+		UNetConnection* SnapshotConnection = DemoRecDriver->BeginKeyframe();
+		for( INT ChannelIndex=0; ChannelIndex<SnapshotConnection->OpenChannels.Num(); ChannelIndex++ )
+		{
+			UActorChannel* Channel = (UActorChannel*)SnapshotConnection->OpenChannels(ChannelIndex);
+			for( INT Pass=0; Pass<MAX_KEYFRAME_SNAPSHOT_PASSES && (Pass == 0 || Channel->ActorDirty); Pass++ )
+			{
+				DemoReplicateActor(Channel->Actor, SnapshotConnection, IsNetClient);
+			}
+		}
+		DemoRecDriver->EndKeyframe(SnapshotConnection);
+	}
 	DemoReplicateActor(GetWorldInfo(), Connection, IsNetClient);
 	for (FNetRelevantActorIterator It; It; ++It)
 	{
@@ -1669,6 +2267,16 @@ UBOOL UWorld::IsPaused()
 template<typename ITER> void TickDeferredComponents(FLOAT DeltaSeconds,
 	FDeferredTickList& DeferredList)
 {
+	// Run the parallel part of the components that support it first
+	TArray<UActorComponent*> ParallelComponents;
+	for (ITER It(DeferredList); It; ++It)
+	{
+		if (It->IsPendingKill() == FALSE && It->CanTickInParallel())
+		{
+			ParallelComponents.AddItem(*It);
+		}
+	}
+	TickInParallel(TArray<AActor*>(),ParallelComponents,DeltaSeconds,LEVELTICK_All);
 	// Iterate through the list of components
 	for (ITER It(DeferredList); It; ++It)
 	{
@@ -1721,6 +2329,10 @@ void TickActorComponents(AActor* Actor,FLOAT DeltaSeconds,ELevelTick TickType,
 					INC_DWORD_STAT(Counter2);
 #endif
 					// Tick the component
+					if (ActorComp->CanTickInParallel())
+					{
+						ActorComp->ConditionalTickParallel(DeltaSeconds);
+					}
 					ActorComp->ConditionalTick(DeltaSeconds);
 					// Log it for debugging
 					debugfSlow(NAME_DevTick,TEXT("Ticked component (%s) in group (%d)"),
@@ -1751,6 +2363,11 @@ static void TickNewlySpawned(UWorld* World,FLOAT DeltaSeconds,
 		&&	!Actor->ActorIsPendingKill() )
 		{			
 			checkf(!Actor->HasAnyFlags(RF_Unreachable), TEXT("%s"), *Actor->GetFullName());
+			// Not worth going wide for the few actors spawned during a tick group
+			if (Actor->CanTickInParallel())
+			{
+				Actor->TickParallel(DeltaSeconds*Actor->CustomTimeDilation,TickType);
+			}
 			UBOOL bTicked = Actor->Tick(DeltaSeconds*Actor->CustomTimeDilation,TickType);
 			// If this actor actually ticked, ticks it's components
 			if (bTicked == TRUE)
@@ -1788,6 +2405,47 @@ void DeferNewlySpawned(UWorld* World,FDeferredTickList& DeferredList)
 	World->NewlySpawned.Empty();
 }
 
+/**
+ * Ticks the actors held back for parallel ticking. Their TickParallel is
+ * spread across threads, after which their regular ticks and components are
+ * ticked on the game thread in the order they were held back.
+ *
+ * @param World - The being ticked
+ * @param DeltaSeconds - time in seconds since last tick
+ * @param TickType - type of tick (viewports only, time only, etc)
+ * @param DeferredList - The list object that manages deferred ticking
+ */
+static void TickParallelActors(UWorld* World,FLOAT DeltaSeconds,
+	ELevelTick TickType,FDeferredTickList& DeferredList)
+{
+	TArray<AActor*>& Actors = DeferredList.GetParallelActors();
+	if (Actors.Num() == 0)
+	{
+		return;
+	}
+	TickInParallel(Actors,TArray<UActorComponent*>(),DeltaSeconds,TickType);
+	for (INT ActorIndex = 0; ActorIndex < Actors.Num(); ActorIndex++)
+	{
+		AActor* Actor = Actors(ActorIndex);
+		// An actor ticked earlier in this loop might have destroyed it
+		if (Actor->ActorIsPendingKill() == FALSE)
+		{
+			const UBOOL bTicked = Actor->Tick(DeltaSeconds*Actor->CustomTimeDilation,TickType);
+			if (bTicked == TRUE)
+			{
+				debugfSlow(NAME_DevTick,TEXT("Ticked parallel actor (%s) in group (%d)"),
+					*Actor->GetName(),(INT)GWorld->TickGroup);
+#if STATS
+				const DWORD Counter2 = (DWORD)STAT_PreAsyncActorsTicked - World->TickGroup;
+				INC_DWORD_STAT(Counter2);
+#endif
+				TickActorComponents(Actor,DeltaSeconds,TickType,&DeferredList);
+			}
+		}
+	}
+	Actors.Empty(Actors.Num());
+}
+
 /**
  * Ticks the world's dynamic actors based upon their tick group. This function
  * is called once for each ticking group
@@ -1812,7 +2470,8 @@ template<typename ITER> void TickActors(UWorld* World,FLOAT DeltaSeconds,
 		AActor* Actor = *It;
 		// Tick this actor if it isn't dead and it isn't being deferred
 		if (Actor->ActorIsPendingKill() == FALSE &&
-			DeferredList.ConditionalDefer(Actor) == FALSE)
+			DeferredList.ConditionalDefer(Actor) == FALSE &&
+			DeferredList.ConditionalDeferParallel(Actor) == FALSE)
 		{
 			checkf(!Actor->HasAnyFlags(RF_Unreachable), TEXT("%s"), *Actor->GetFullName());
 			const UBOOL bTicked = Actor->Tick(DeltaSeconds*Actor->CustomTimeDilation,TickType);
@@ -1830,6 +2489,9 @@ template<typename ITER> void TickActors(UWorld* World,FLOAT DeltaSeconds,
 		}
 	}
 
+	// Now tick the actors that were held back for parallel ticking
+	TickParallelActors(World,DeltaSeconds,TickType,DeferredList);
+
 	// If an actor was spawned during the async work, tick it in the post
 	// async work, so that it doesn't try to interact with the async threads
 	if (World->TickGroup == TG_DuringAsyncWork)
@@ -2272,6 +2934,8 @@ void UWorld::Tick( ELevelTick TickType, FLOAT DeltaSeconds )
 		}
 
 		SCOPE_CYCLE_COUNTER(STAT_TickTime);
+		// Advance the clock deciding which actors have timers to check
+		TimerWheel.BeginFrame(DeltaSeconds);
 		TickGroup = TG_PreAsyncWork;
 		// Clear out our old state and empty our arrays (without memory changes)
 		GDeferredList.Reset();
@@ -2304,6 +2968,7 @@ void UWorld::Tick( ELevelTick TickType, FLOAT DeltaSeconds )
 			DeltaSeconds,TickType,GDeferredList);
 		// And the final ticking of components
 		TickDeferredComponents<FDeferredTickList::FComponentPostAsyncWorkIterator>(DeltaSeconds,GDeferredList);
+		TimerWheel.EndFrame();
 
 		// Tick the decal manager
 		DecalManager->Tick(DeltaSeconds);
@@ -17,6 +17,10 @@ DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("In Bunches"),STAT_InBunches,STATGROUP_Net);
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Out Bunches"),STAT_OutBunches,STATGROUP_Net);
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Out Loss"),STAT_OutLoss,STATGROUP_Net);
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("In Loss"),STAT_InLoss,STATGROUP_Net);
+DECLARE_CYCLE_STAT(TEXT("Replicate Actor Time"),STAT_NetReplicateActorTime,STATGROUP_Net);
+DECLARE_CYCLE_STAT(TEXT("Property Compare Time"),STAT_NetPropertyCompareTime,STATGROUP_Net);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Send Queue (bytes)"),STAT_NetSendQueueBytes,STATGROUP_Net);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Held Back Sends"),STAT_NetHeldBackSends,STATGROUP_Net);
 
 /*-----------------------------------------------------------------------------
 	UPackageMapLevel implementation.
@@ -309,6 +313,8 @@ UNetDriver::UNetDriver()
 ,	OutPacketsLost(0)
 ,	InOutOfOrderPackets(0)
 ,	OutOutOfOrderPackets(0)
+,	ReplicationPass(INDEX_NONE)
+,	ReplicationPassCount(0)
 ,	StatUpdateTime(0.0)
 ,	StatPeriod(1.f)
 {
@@ -318,6 +324,8 @@ UNetDriver::UNetDriver()
 		RemoteRoleProperty = FindObjectChecked<UProperty>( AActor::StaticClass(), TEXT("RemoteRole") );
 		MasterMap          = new UPackageMap;
 		ProfileStats	   = ParseParam(appCmdLine(),TEXT("profilestats"));
+		bSharePropertyCompare = !ParseParam(appCmdLine(),TEXT("nosharedpropertycompare"));
+		bParallelPriorityLists = !ParseParam(appCmdLine(),TEXT("serialnetpriority"));
 	}
 }
 void UNetDriver::StaticConstructor()
@@ -328,12 +336,17 @@ void UNetDriver::StaticConstructor()
 	new(GetClass(),TEXT("KeepAliveTime"),        RF_Public)UFloatProperty(CPP_PROPERTY(KeepAliveTime        ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("RelevantTimeout"),      RF_Public)UFloatProperty(CPP_PROPERTY(RelevantTimeout      ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("SpawnPrioritySeconds"), RF_Public)UFloatProperty(CPP_PROPERTY(SpawnPrioritySeconds ), TEXT("Client"), CPF_Config );
+	new(GetClass(),TEXT("NetCullDistance"),      RF_Public)UFloatProperty(CPP_PROPERTY(NetCullDistance      ), TEXT("Client"), CPF_Config );
+	new(GetClass(),TEXT("NetRelevancyCellSize"), RF_Public)UFloatProperty(CPP_PROPERTY(NetRelevancyCellSize ), TEXT("Client"), CPF_Config );
+	new(GetClass(),TEXT("NetVisibilityCellSize"),RF_Public)UFloatProperty(CPP_PROPERTY(NetVisibilityCellSize), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("ServerTravelPause"),    RF_Public)UFloatProperty(CPP_PROPERTY(ServerTravelPause    ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("MaxClientRate"),		 RF_Public)UIntProperty  (CPP_PROPERTY(MaxClientRate        ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("MaxInternetClientRate"),RF_Public)UIntProperty  (CPP_PROPERTY(MaxInternetClientRate), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("NetServerMaxTickRate"), RF_Public)UIntProperty  (CPP_PROPERTY(NetServerMaxTickRate ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("bClampListenServerTickRate"),RF_Public)UBoolProperty(CPP_PROPERTY(bClampListenServerTickRate), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("AllowDownloads"),       RF_Public)UBoolProperty (CPP_PROPERTY(AllowDownloads       ), TEXT("Client"), CPF_Config );
+	new(GetClass(),TEXT("bDeltaCompressVectors"),RF_Public)UBoolProperty (CPP_PROPERTY(bDeltaCompressVectors), TEXT("Client"), CPF_Config );
+	new(GetClass(),TEXT("bPaceConnections"),     RF_Public)UBoolProperty (CPP_PROPERTY(bPaceConnections     ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("MaxDownloadSize"),	     RF_Public)UIntProperty  (CPP_PROPERTY(MaxDownloadSize      ), TEXT("Client"), CPF_Config );
 	new(GetClass(),TEXT("NetConnectionClassName"),RF_Public)UStrProperty(CPP_PROPERTY(NetConnectionClassName), TEXT("Client"), CPF_Config );
 
@@ -363,6 +376,7 @@ void UNetDriver::InitializeIntrinsicPropertyValues()
 	// Default values.
 	MaxClientRate = 15000;
 	MaxInternetClientRate = 10000;
+	NetRelevancyCellSize = 4096.f;
 }
 
 void UNetDriver::AssertValid()
@@ -394,13 +408,19 @@ void UNetDriver::TickFlush()
 			SET_DWORD_STAT(STAT_Ping, 0);
 		}
 		SET_DWORD_STAT(STAT_Channels, 0);
+		SET_DWORD_STAT(STAT_NetSendQueueBytes, 0);
+		SET_DWORD_STAT(STAT_NetHeldBackSends, 0);
 		if (ServerConnection != NULL)
 		{
 			INC_DWORD_STAT_BY(STAT_Channels, ServerConnection->OpenChannels.Num());
+			INC_DWORD_STAT_BY(STAT_NetSendQueueBytes, ServerConnection->SendQueueData.Num());
+			INC_DWORD_STAT_BY(STAT_NetHeldBackSends, ServerConnection->LastSendStats.HeldBack[SENDPRI_Movement] + ServerConnection->LastSendStats.HeldBack[SENDPRI_Bulk]);
 		}
 		for (INT i = 0; i < ClientConnections.Num(); i++)
 		{
 			INC_DWORD_STAT_BY(STAT_Channels, ClientConnections(i)->OpenChannels.Num());
+			INC_DWORD_STAT_BY(STAT_NetSendQueueBytes, ClientConnections(i)->SendQueueData.Num());
+			INC_DWORD_STAT_BY(STAT_NetHeldBackSends, ClientConnections(i)->LastSendStats.HeldBack[SENDPRI_Movement] + ClientConnections(i)->LastSendStats.HeldBack[SENDPRI_Bulk]);
 		}
 		SET_DWORD_STAT(STAT_OutLoss,OutPacketsLost);
 		SET_DWORD_STAT(STAT_InLoss,InPacketsLost);
@@ -515,6 +535,12 @@ void UNetDriver::FinishDestroy()
 
 		// Delete the master package map.
 		MasterMap = NULL;
+
+		for( TMap<AActor*,FPropertyChangeHistory*>::TIterator It(PropertyChangeHistories); It; ++It )
+		{
+			delete It.Value();
+		}
+		PropertyChangeHistories.Empty();
 	}
 	else
 	{
@@ -545,6 +571,20 @@ UBOOL UNetDriver::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
 		}
 		return TRUE;
 	}
+	else if( ParseCommand(&Cmd,TEXT("SENDSTATS")) )
+	{
+		// Print send statistics of open connections.
+		Ar.Logf( TEXT("Send stats (pacing %s):"), bPaceConnections ? TEXT("on") : TEXT("off") );
+		if( ServerConnection )
+		{
+			ServerConnection->LogSendStats( Ar );
+		}
+		for( INT i=0; i<ClientConnections.Num(); i++ )
+		{
+			ClientConnections(i)->LogSendStats( Ar );
+		}
+		return TRUE;
+	}
 	else if (ParseCommand(&Cmd, TEXT("PACKAGEMAP")))
 	{
 		// Print packagemap for open connections
@@ -590,11 +630,17 @@ UBOOL UNetDriver::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
 void UNetDriver::NotifyActorDestroyed( AActor* ThisActor )
 {
 	ForcedInitialReplicationMap.Remove(ThisActor);
+	FPropertyChangeHistory* History = NULL;
+	if( PropertyChangeHistories.RemoveAndCopyValue(ThisActor,History) )
+	{
+		delete History;
+	}
+	RelevancyGrid.RemoveActor(ThisActor);
 	for( INT i=ClientConnections.Num()-1; i>=0; i-- )
 	{
 		UNetConnection* Connection = ClientConnections(i);
 		if( ThisActor->bNetTemporary )
-			Connection->SentTemporaries.RemoveItem( ThisActor );
+			Connection->SentTemporaries.Remove( ThisActor );
 		UActorChannel* Channel = Connection->ActorChannels.FindRef(ThisActor);
 		if( Channel )
 		{
@@ -605,6 +651,324 @@ void UNetDriver::NotifyActorDestroyed( AActor* ThisActor )
 	}
 }
 
+/**
+ * Starts a replication pass, during which actors replicated to several connections are compared only once
+ * for property changes. Actors must not be modified till EndReplicationPass is called.
+ */
+void UNetDriver::BeginReplicationPass()
+{
+	check(ReplicationPass==INDEX_NONE);
+	ReplicationPass = ReplicationPassCount++;
+	RelevancyGrid.SetCellSizes(NetRelevancyCellSize, NetVisibilityCellSize);
+	RelevancyGrid.ResetLineChecks();
+}
+
+/** Ends the current replication pass. */
+void UNetDriver::EndReplicationPass()
+{
+	check(ReplicationPass!=INDEX_NONE);
+	ReplicationPass = INDEX_NONE;
+}
+
+/**
+ * Returns the property change history of an actor, updated for the current replication pass.
+ *
+ * @param	Actor	actor to return history for
+ * @return	the actor's history or NULL if not in a replication pass or sharing is disabled
+ */
+FPropertyChangeHistory* UNetDriver::GetPropertyChangeHistory( AActor* Actor )
+{
+	if( ReplicationPass==INDEX_NONE || !bSharePropertyCompare )
+	{
+		return NULL;
+	}
+
+	FPropertyChangeHistory* History = PropertyChangeHistories.FindRef(Actor);
+	if( History && History->GetActorClass()!=Actor->GetClass() )
+	{
+		// A new actor ended up at the address of one we weren't told about being destroyed.
+		delete History;
+		History = NULL;
+	}
+	if( !History )
+	{
+		History = new FPropertyChangeHistory(Actor->GetClass());
+		PropertyChangeHistories.Set( Actor, History );
+	}
+	if( History->GetLastReplicationPass()!=ReplicationPass )
+	{
+		History->Update( Actor, ReplicationPass );
+	}
+	return History;
+}
+
+/*-----------------------------------------------------------------------------
+	FPropertyChangeHistory implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, initializing the shadow copy to the class defaults.
+ *
+ * @param	InActorClass	class of the actor the history is for
+ */
+FPropertyChangeHistory::FPropertyChangeHistory( UClass* InActorClass )
+:	ActorClass( InActorClass )
+,	MaskSize( Max<INT>( (InActorClass->ClassReps.Num() + 31) / 32, 1 ) )
+,	HistoryIndex( 0 )
+,	LastReplicationPass( INDEX_NONE )
+{
+	AlwaysCompareMask.AddZeroed( MaskSize );
+	ChangedMasks.AddZeroed( MaskSize * HISTORY_SIZE );
+	for( INT RepIndex=0; RepIndex<ActorClass->ClassReps.Num(); RepIndex++ )
+	{
+		UProperty* Property = ActorClass->ClassReps(RepIndex).Property;
+		if( Cast<UObjectProperty>(Property,CLASS_IsAUObjectProperty) )
+		{
+			AlwaysCompareMask(RepIndex / 32) |= 1 << (RepIndex & 31);
+		}
+		else if( !(Property->GetOwnerClass()->ClassFlags & CLASS_NativeReplication) )
+		{
+			ComparedReps.AddItem( RepIndex );
+		}
+	}
+
+	const INT Size = ActorClass->GetDefaultsCount();
+	Shadow.Add( Size );
+	UObject::InitProperties( &Shadow(0), Size, ActorClass, NULL, 0 );
+}
+
+/** Destructor, destroying the shadow copy. */
+FPropertyChangeHistory::~FPropertyChangeHistory()
+{
+	UObject::ExitProperties( &Shadow(0), ActorClass );
+}
+
+/**
+ * Compares the actor against the shadow copy and records the changed properties as a new history entry.
+ *
+ * @param	Actor				actor to compare, needs to be of ActorClass
+ * @param	ReplicationPass		replication pass of the net driver the comparison is done for
+ */
+void FPropertyChangeHistory::Update( AActor* Actor, INT ReplicationPass )
+{
+	checkSlow(Actor->GetClass()==ActorClass);
+
+	DWORD* Changed = &ChangedMasks(0) + (HistoryIndex % HISTORY_SIZE) * MaskSize;
+	appMemzero( Changed, MaskSize * sizeof(DWORD) );
+	for( INT i=0; i<ComparedReps.Num(); i++ )
+	{
+		const INT	RepIndex	= ComparedReps(i);
+		FRepRecord&	Rep			= ActorClass->ClassReps(RepIndex);
+		const INT	Offset		= Rep.Property->Offset + Rep.Index * Rep.Property->ElementSize;
+		if( !Rep.Property->Identical( &Shadow(Offset), (BYTE*)Actor + Offset ) )
+		{
+			Rep.Property->CopySingleValue( &Shadow(Offset), (BYTE*)Actor + Offset );
+			Changed[RepIndex / 32] |= 1 << (RepIndex & 31);
+		}
+	}
+	HistoryIndex++;
+	LastReplicationPass = ReplicationPass;
+}
+
+/**
+ * Adds the properties that changed since the passed in history index to the mask.
+ *
+ * @param	InHistoryIndex	history index the caller is up to date with
+ * @param	Mask			mask of GetMaskSize() DWORDs to OR the changed properties into
+ * @return	FALSE if the index is too old to tell, in which case Mask is left untouched
+ */
+UBOOL FPropertyChangeHistory::GetChangedSince( INT InHistoryIndex, DWORD* Mask ) const
+{
+	if( InHistoryIndex < 0 || InHistoryIndex > HistoryIndex || HistoryIndex - InHistoryIndex > HISTORY_SIZE )
+	{
+		return FALSE;
+	}
+	for( INT Index=InHistoryIndex; Index<HistoryIndex; Index++ )
+	{
+		const DWORD* Changed = &ChangedMasks(0) + (Index % HISTORY_SIZE) * MaskSize;
+		for( INT i=0; i<MaskSize; i++ )
+		{
+			Mask[i] |= Changed[i];
+		}
+	}
+	return TRUE;
+}
+
+/*-----------------------------------------------------------------------------
+	FNetRelevancyGrid implementation.
+-----------------------------------------------------------------------------*/
+
+/** Constructor, initializing member variables. */
+FNetRelevancyGrid::FNetRelevancyGrid()
+:	CellSize( 0.f )
+,	VisibilityCellSize( 0.f )
+{}
+
+/**
+ * Sets the size of cells, emptying the grid if it changed.
+ *
+ * @param	InCellSize				size of a grid cell
+ * @param	InVisibilityCellSize	size of a visibility cell, 0 to only share line checks between identical view locations
+ */
+void FNetRelevancyGrid::SetCellSizes( FLOAT InCellSize, FLOAT InVisibilityCellSize )
+{
+	InCellSize = Max( InCellSize, 1.f );
+	if( InCellSize != CellSize )
+	{
+		CellSize = InCellSize;
+		Cells.Empty();
+		ActorCells.Empty();
+	}
+	if( InVisibilityCellSize != VisibilityCellSize )
+	{
+		VisibilityCellSize = InVisibilityCellSize;
+		LineChecks.Empty();
+	}
+}
+
+/**
+ * Adds an actor to the grid or moves it to the cell containing its current location.
+ *
+ * @param	Actor	actor to update
+ */
+void FNetRelevancyGrid::UpdateActor( AActor* Actor )
+{
+	const FIntPoint NewCell = GetCell( Actor->Location );
+	FIntPoint* OldCell = ActorCells.Find( Actor );
+	if( OldCell && *OldCell == NewCell )
+	{
+		return;
+	}
+	if( OldCell )
+	{
+		RemoveFromCell( *OldCell, Actor );
+		*OldCell = NewCell;
+	}
+	else
+	{
+		ActorCells.Set( Actor, NewCell );
+	}
+
+	TArray<AActor*>* NewCellActors = Cells.Find( NewCell );
+	if( !NewCellActors )
+	{
+		NewCellActors = &Cells.Set( NewCell, TArray<AActor*>() );
+	}
+	NewCellActors->AddItem( Actor );
+}
+
+/**
+ * Removes an actor from the grid if it is in it.
+ *
+ * @param	Actor	actor to remove
+ */
+void FNetRelevancyGrid::RemoveActor( AActor* Actor )
+{
+	FIntPoint Cell;
+	if( ActorCells.RemoveAndCopyValue( Actor, Cell ) )
+	{
+		RemoveFromCell( Cell, Actor );
+	}
+}
+
+/**
+ * Removes an actor from the actor list of a cell, removing the cell if it becomes empty.
+ *
+ * @param	Cell	cell the actor is in
+ * @param	Actor	actor to remove
+ */
+void FNetRelevancyGrid::RemoveFromCell( const FIntPoint& Cell, AActor* Actor )
+{
+	TArray<AActor*>& CellActors = *Cells.Find( Cell );
+	if( CellActors.Num() == 1 )
+	{
+		Cells.Remove( Cell );
+	}
+	else
+	{
+		// Order within a cell doesn't matter so swap the last actor into the hole.
+		const INT Index = CellActors.FindItemIndex( Actor );
+		CellActors(Index) = CellActors(CellActors.Num() - 1);
+		CellActors.Remove( CellActors.Num() - 1 );
+	}
+}
+
+/**
+ * Gathers the cells within a distance of a set of viewers, each cell only once.
+ *
+ * @param	Viewers		viewers to gather cells for
+ * @param	NumViewers	number of entries in Viewers
+ * @param	Distance	distance from viewers
+ * @param	OutCells	list to add actors of the cells to
+ */
+void FNetRelevancyGrid::GetCellsNear( const FNetViewer* Viewers, INT NumViewers, FLOAT Distance, TArray<const TArray<AActor*>*>& OutCells ) const
+{
+	const FVector Extent( Distance, Distance, 0.f );
+	for( INT ViewerIndex=0; ViewerIndex<NumViewers; ViewerIndex++ )
+	{
+		const FIntPoint Min = GetCell( Viewers[ViewerIndex].ViewLocation - Extent );
+		const FIntPoint Max = GetCell( Viewers[ViewerIndex].ViewLocation + Extent );
+		for( INT Y=Min.Y; Y<=Max.Y; Y++ )
+		{
+			for( INT X=Min.X; X<=Max.X; X++ )
+			{
+				// Skip cells that were already gathered for a previous viewer.
+				UBOOL bAlreadyGathered = FALSE;
+				for( INT OtherIndex=0; OtherIndex<ViewerIndex && !bAlreadyGathered; OtherIndex++ )
+				{
+					const FIntPoint OtherMin = GetCell( Viewers[OtherIndex].ViewLocation - Extent );
+					const FIntPoint OtherMax = GetCell( Viewers[OtherIndex].ViewLocation + Extent );
+					bAlreadyGathered = X >= OtherMin.X && X <= OtherMax.X && Y >= OtherMin.Y && Y <= OtherMax.Y;
+				}
+				const TArray<AActor*>* CellActors = bAlreadyGathered ? NULL : Cells.Find( FIntPoint( X, Y ) );
+				if( CellActors )
+				{
+					OutCells.AddItem( CellActors );
+				}
+			}
+		}
+	}
+}
+
+/** Forgets all cached line checks, needs to be called before actors move. */
+void FNetRelevancyGrid::ResetLineChecks()
+{
+	LineChecks.Reset();
+}
+
+/**
+ * Line check of a relevancy check, cached till the next call to ResetLineChecks.
+ *
+ * @param	Actor			actor whose relevancy is checked, ignored by the line check
+ * @param	End				end of the line check
+ * @param	Start			start of the line check
+ * @param	ViewLocation	location relevancy is checked for, either End or Start
+ * @return	TRUE if nothing blocks the line
+ */
+UBOOL FNetRelevancyGrid::LineCheck( AActor* Actor, const FVector& End, const FVector& Start, const FVector& ViewLocation )
+{
+	FLineCheckKey Key;
+	Key.Actor		= Actor;
+	Key.ActorPoint	= (End == ViewLocation) ? Start : End;
+	Key.ViewPoint	= ViewLocation;
+	if( VisibilityCellSize > 0.f )
+	{
+		Key.ViewPoint.X = appFloor( ViewLocation.X / VisibilityCellSize );
+		Key.ViewPoint.Y = appFloor( ViewLocation.Y / VisibilityCellSize );
+		Key.ViewPoint.Z = appFloor( ViewLocation.Z / VisibilityCellSize );
+	}
+
+	const UBOOL* CachedResult = LineChecks.Find( Key );
+	if( CachedResult )
+	{
+		return *CachedResult;
+	}
+	FCheckResult Hit(1.f);
+	const UBOOL bResult = GWorld->SingleLineCheck( Hit, Actor, End, Start, TRACE_World|TRACE_StopAtAnyHit, FVector(0.f,0.f,0.f) );
+	LineChecks.Set( Key, bResult );
+	return bResult;
+}
+
 /** creates a child connection and adds it to the given parent connection */
 UChildConnection* UNetDriver::CreateChild(UNetConnection* Parent)
 {
@@ -624,7 +988,7 @@ UChildConnection* UNetDriver::CreateChild(UNetConnection* Parent)
 /** notification when a package is added to the NetPackages list */
 void UNetDriver::NotifyNetPackageAdded(UPackage* Package)
 {
-	if (!GIsRequestingExit && GWorld != NULL && GWorld->IsServer())
+	if (!GIsRequestingExit && GWorld != NULL && GWorld->IsServer() && GHostedWorlds.IsNetPackageRelevant(GWorld, Package))
 	{
 		MasterMap->AddPackage(Package);
 		for (INT i = 0; i < ClientConnections.Num(); i++)
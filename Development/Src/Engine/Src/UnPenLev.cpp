@@ -225,6 +225,9 @@ void UNetPendingLevel::NotifyReceivedText( UNetConnection* Connection, const TCH
 		// Parse welcome message.
 		Parse( Text, TEXT("LEVEL="), URL.Map );
 		Parse( Text, TEXT("CHALLENGE="), Connection->Challenge );
+		INT DeltaCompressVectors = 0;
+		Parse( Text, TEXT("DELTAVECTORS="), DeltaCompressVectors );
+		Connection->bDeltaCompressVectors = DeltaCompressVectors != 0;
 
 		// Send first download request.
 		ReceiveNextFile( Connection );
@@ -2251,7 +2251,7 @@ void ARB_CylindricalForceActor::TickSpecial(FLOAT DeltaSeconds)
 
 		//Query octree for overlapping components
 
-		TArray<UPrimitiveComponent*> TouchingPrimitives;
+		TInlineArray<UPrimitiveComponent*,64> TouchingPrimitives;
 		GWorld->Hash->GetIntersectingPrimitives(BoxSphereBounds.GetBox(), TouchingPrimitives);
 		
 
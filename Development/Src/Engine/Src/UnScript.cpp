@@ -791,6 +791,13 @@ void AActor::SetTimer( FLOAT Rate,UBOOL bLoop,FName FuncName, UObject* inObj )
 	{
 		if( !inObj ) { inObj = this; }
 
+		// bring the counts up to date before one of them gets reset
+		FTimerWheel* TimerWheel = FTimerWheel::GetActorTimerWheel(this);
+		if (TimerWheel != NULL)
+		{
+			TimerWheel->SyncActor(this);
+		}
+
 		// search for an existing timer first
 		UBOOL bFoundEntry = 0;
 		for (INT Idx = 0; Idx < Timers.Num() && !bFoundEntry; Idx++)
@@ -830,6 +837,12 @@ void AActor::SetTimer( FLOAT Rate,UBOOL bLoop,FName FuncName, UObject* inObj )
 			Timers(Idx).Rate = Rate;
 			Timers(Idx).Count = 0.f;
 		}
+
+		// let the wheel know when the actor's timers need to be checked
+		if (TimerWheel != NULL)
+		{
+			TimerWheel->ScheduleActor(this);
+		}
 	}
 }
 
@@ -891,6 +904,13 @@ FLOAT AActor::GetTimerCount( FName FuncName, UObject* inObj )
 {
 	if( !inObj ) { inObj = this; }
 
+	// the wheel only adds the time the actor has been ticked by to the counts when needed
+	FTimerWheel* TimerWheel = FTimerWheel::GetActorTimerWheel(this);
+	if (TimerWheel != NULL)
+	{
+		TimerWheel->SyncActor(this);
+	}
+
 	FLOAT Result = -1.f;
 	for (INT Idx = 0; Idx < Timers.Num(); Idx++)
 	{
@@ -0,0 +1,359 @@
+/*=============================================================================
+	UnTimerWheel.cpp: Hierarchical timing wheel driving actor timers.
+	Copyright 1998-2007 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "EnginePrivate.h"
+
+/*-----------------------------------------------------------------------------
+	FTimerWheel implementation.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Constructor, initializing member variables.
+ */
+FTimerWheel::FTimerWheel()
+:	Time( 0.0 )
+,	FrameDeltaSeconds( 0.f )
+,	CurrentTick( 0 )
+,	bActorsTicking( FALSE )
+,	FirstFreeEntry( INDEX_NONE )
+{
+	for( INT List=0; List<NUM_LISTS; List++ )
+	{
+		ListHeads[List] = INDEX_NONE;
+	}
+}
+
+/**
+ * Returns the timer wheel of the world an actor is ticked by.
+ *
+ * @param	Owner	actor to look up the timer wheel for
+ * @return	timer wheel of the actor's world, NULL if the actor isn't part of one
+ */
+FTimerWheel* FTimerWheel::GetActorTimerWheel( AActor* Owner )
+{
+	ULevel* PersistentLevel	= Owner->WorldInfo ? Cast<ULevel>( Owner->WorldInfo->GetOuter() ) : NULL;
+	UWorld* World			= PersistentLevel ? Cast<UWorld>( PersistentLevel->GetOuter() ) : NULL;
+	return World ? &World->TimerWheel : NULL;
+}
+
+/**
+ * Advances the clock by the world's delta time, moving owners whose timers might expire into the due list.
+ *
+ * @param	DeltaSeconds	dilated time since the last frame
+ */
+void FTimerWheel::BeginFrame( FLOAT DeltaSeconds )
+{
+	Time				+= DeltaSeconds;
+	FrameDeltaSeconds	= DeltaSeconds;
+	bActorsTicking		= TRUE;
+
+	const QWORD NewTick = GetTick( Time );
+	if( EntryMap.Num() == 0 )
+	{
+		CurrentTick = NewTick;
+		return;
+	}
+
+	while( CurrentTick < NewTick )
+	{
+		CurrentTick++;
+
+		// Cascade wrapped levels from the top down so entries settle in the lowest level they belong to in one go.
+		if( (CurrentTick & ((((QWORD)1) << (SLOT_BITS * NUM_LEVELS)) - 1)) == 0 )
+		{
+			CascadeList( LIST_Overflow );
+		}
+		for( INT Level=NUM_LEVELS-1; Level>0; Level-- )
+		{
+			const INT Shift = SLOT_BITS * Level;
+			if( (CurrentTick & ((((QWORD)1) << Shift) - 1)) == 0 )
+			{
+				CascadeList( Level * SLOTS_PER_LEVEL + (INT)((CurrentTick >> Shift) & (SLOTS_PER_LEVEL - 1)) );
+			}
+		}
+
+		// The level 0 slot of the new tick holds exactly the entries expiring within it, they all end up due.
+		CascadeList( (INT)(CurrentTick & (SLOTS_PER_LEVEL - 1)) );
+	}
+}
+
+/**
+ * Adds the time an actor has been ticked by to the time pending for its timers.
+ *
+ * @param	Owner			actor being ticked
+ * @param	DeltaSeconds	time the actor is ticked by
+ * @return	TRUE if the Count of the actor's timers has been brought up to date and they need to be checked
+ */
+UBOOL FTimerWheel::UpdateActor( AActor* Owner, FLOAT DeltaSeconds )
+{
+	const INT* EntryIndex = EntryMap.Find( Owner );
+	if( !EntryIndex )
+	{
+		// Not scheduled yet, e.g. timers that were saved with the actor. They are checked right away and
+		// scheduled afterwards.
+		for( INT TimerIndex=0; TimerIndex<Owner->Timers.Num(); TimerIndex++ )
+		{
+			Owner->Timers(TimerIndex).Count += DeltaSeconds;
+		}
+		return TRUE;
+	}
+
+	Owner->TimerPendingSeconds += DeltaSeconds;
+
+	// The clock already advanced by the frame's time, make up for owners ticked by something else.
+	const FLOAT ClockDeltaSeconds = bActorsTicking ? FrameDeltaSeconds : 0.f;
+	if( DeltaSeconds != ClockDeltaSeconds )
+	{
+		Entries(*EntryIndex).ExpireTime += ClockDeltaSeconds - DeltaSeconds;
+		RelinkEntry( *EntryIndex );
+	}
+
+	if( Owner->bTimersIdle )
+	{
+		return FALSE;
+	}
+	SyncOwner( Owner );
+	return TRUE;
+}
+
+/**
+ * Adds the time pending for an actor's timers to their Count.
+ *
+ * @param	Owner	actor whose timers to bring up to date
+ */
+void FTimerWheel::SyncActor( AActor* Owner )
+{
+	// Owners without an entry have no time pending.
+	SyncOwner( Owner );
+}
+
+/**
+ * Brings an actor's timers up to date and (re)schedules its entry for the earliest of them to expire.
+ *
+ * @param	Owner			actor whose timers changed
+ * @param	bTickedThisFrame	whether the time of the current frame has been added to the actor's timers
+ */
+void FTimerWheel::ScheduleActor( AActor* Owner, UBOOL bTickedThisFrame )
+{
+	// Destroyed actors have been removed already and their timers don't fire anymore.
+	if( Owner->ActorIsPendingKill() )
+	{
+		return;
+	}
+
+	const INT* ExistingIndex = EntryMap.Find( Owner );
+	if( ExistingIndex )
+	{
+		SyncOwner( Owner );
+	}
+
+	UBOOL bHasActiveTimers = FALSE;
+	FLOAT MinRemainingSeconds = 0.f;
+	for( INT TimerIndex=0; TimerIndex<Owner->Timers.Num(); TimerIndex++ )
+	{
+		const FTimerData& Timer = Owner->Timers(TimerIndex);
+		if( Timer.Rate > 0.f )
+		{
+			const FLOAT RemainingSeconds = Timer.Rate - Timer.Count;
+			MinRemainingSeconds	= bHasActiveTimers ? Min( MinRemainingSeconds, RemainingSeconds ) : RemainingSeconds;
+			bHasActiveTimers	= TRUE;
+		}
+	}
+
+	if( !bHasActiveTimers )
+	{
+		// Cleared timers are removed by the next UpdateTimers that checks them, which happens right away.
+		if( ExistingIndex )
+		{
+			FreeEntry( *ExistingIndex );
+		}
+		return;
+	}
+
+	INT EntryIndex = ExistingIndex ? *ExistingIndex : INDEX_NONE;
+	if( EntryIndex == INDEX_NONE )
+	{
+		EntryIndex = FirstFreeEntry;
+		if( EntryIndex != INDEX_NONE )
+		{
+			FirstFreeEntry = Entries(EntryIndex).Next;
+		}
+		else
+		{
+			EntryIndex = Entries.Add();
+		}
+
+		FEntry& NewEntry		= Entries(EntryIndex);
+		NewEntry.Owner			= Owner;
+		NewEntry.List			= INDEX_NONE;
+		NewEntry.Next			= INDEX_NONE;
+		NewEntry.Prev			= INDEX_NONE;
+		EntryMap.Set( Owner, EntryIndex );
+	}
+
+	// Err on the early side, Count adds up the same time in single precision. An entry coming due early only
+	// costs UpdateTimers a look at the owner's timers.
+	const DOUBLE BaseTime = bTickedThisFrame ? Time : GetBaseTime();
+	Entries(EntryIndex).ExpireTime = BaseTime + MinRemainingSeconds - KINDA_SMALL_NUMBER;
+	RelinkEntry( EntryIndex );
+}
+
+/**
+ * Brings an actor's timers up to date and removes its entry.
+ *
+ * @param	Owner	actor to remove
+ */
+void FTimerWheel::RemoveActor( AActor* Owner )
+{
+	const INT* EntryIndex = EntryMap.Find( Owner );
+	if( EntryIndex )
+	{
+		const INT RemovedIndex = *EntryIndex;
+		SyncOwner( Owner );
+		FreeEntry( RemovedIndex );
+	}
+}
+
+/**
+ * Removes all entries.
+ */
+void FTimerWheel::Reset()
+{
+	for( INT EntryIndex=0; EntryIndex<Entries.Num(); EntryIndex++ )
+	{
+		AActor* Owner = Entries(EntryIndex).Owner;
+		if( Owner )
+		{
+			SyncOwner( Owner );
+			Owner->bTimersIdle = FALSE;
+		}
+	}
+	Entries.Empty();
+	FirstFreeEntry = INDEX_NONE;
+	for( INT List=0; List<NUM_LISTS; List++ )
+	{
+		ListHeads[List] = INDEX_NONE;
+	}
+	EntryMap.Empty();
+	bActorsTicking = FALSE;
+}
+
+/**
+ * Unlinks, unindexes and frees an entry.
+ */
+void FTimerWheel::FreeEntry( INT EntryIndex )
+{
+	UnlinkEntry( EntryIndex );
+
+	FEntry& Entry = Entries(EntryIndex);
+	EntryMap.Remove( Entry.Owner );
+
+	Entry.Owner->bTimersIdle = FALSE;
+	Entry.Owner		= NULL;
+	Entry.Next		= FirstFreeEntry;
+	FirstFreeEntry	= EntryIndex;
+}
+
+/**
+ * Links an unlinked entry into the list matching its expiration time.
+ */
+void FTimerWheel::LinkEntry( INT EntryIndex )
+{
+	FEntry& Entry = Entries(EntryIndex);
+	checkSlow(Entry.List == INDEX_NONE);
+
+	// Pick the lowest level that shares all higher bits with the current tick, the slot index within
+	// that level is then always ahead of the current one.
+	const QWORD ExpireTick = GetTick( Entry.ExpireTime );
+	INT List = LIST_Overflow;
+	if( ExpireTick <= CurrentTick )
+	{
+		List = LIST_Due;
+	}
+	else
+	{
+		for( INT Level=0; Level<NUM_LEVELS; Level++ )
+		{
+			const INT Shift = SLOT_BITS * (Level + 1);
+			if( (ExpireTick >> Shift) == (CurrentTick >> Shift) )
+			{
+				List = Level * SLOTS_PER_LEVEL + (INT)((ExpireTick >> (SLOT_BITS * Level)) & (SLOTS_PER_LEVEL - 1));
+				break;
+			}
+		}
+	}
+
+	Entry.List	= List;
+	Entry.Prev	= INDEX_NONE;
+	// Owners of entries that aren't due skip UpdateActor while they're ticked in step with the clock.
+	Entry.Owner->bTimersIdle = (List != LIST_Due);
+	Entry.Next	= ListHeads[List];
+	if( Entry.Next != INDEX_NONE )
+	{
+		Entries(Entry.Next).Prev = EntryIndex;
+	}
+	ListHeads[List] = EntryIndex;
+}
+
+/**
+ * Unlinks an entry from the list it is in.
+ */
+void FTimerWheel::UnlinkEntry( INT EntryIndex )
+{
+	FEntry& Entry = Entries(EntryIndex);
+	if( Entry.List == INDEX_NONE )
+	{
+		return;
+	}
+
+	if( Entry.Prev != INDEX_NONE )
+	{
+		Entries(Entry.Prev).Next = Entry.Next;
+	}
+	else
+	{
+		ListHeads[Entry.List] = Entry.Next;
+	}
+	if( Entry.Next != INDEX_NONE )
+	{
+		Entries(Entry.Next).Prev = Entry.Prev;
+	}
+	Entry.List = INDEX_NONE;
+}
+
+/**
+ * Relinks all entries of a list.
+ */
+void FTimerWheel::CascadeList( INT List )
+{
+	INT EntryIndex = ListHeads[List];
+	ListHeads[List] = INDEX_NONE;
+	while( EntryIndex != INDEX_NONE )
+	{
+		const INT NextIndex = Entries(EntryIndex).Next;
+		Entries(EntryIndex).List = INDEX_NONE;
+		LinkEntry( EntryIndex );
+		EntryIndex = NextIndex;
+	}
+}
+
+/**
+ * Adds the pending time of an owner to the Count of its timers.
+ */
+void FTimerWheel::SyncOwner( AActor* Owner )
+{
+	if( Owner->TimerPendingSeconds != 0.f )
+	{
+		for( INT TimerIndex=0; TimerIndex<Owner->Timers.Num(); TimerIndex++ )
+		{
+			Owner->Timers(TimerIndex).Count += Owner->TimerPendingSeconds;
+		}
+		Owner->TimerPendingSeconds = 0.f;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
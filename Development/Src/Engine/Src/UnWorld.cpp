@@ -1227,6 +1227,8 @@ void UWorld::RemoveFromWorld( ULevelStreaming* StreamingLevel )
 				{
 					Actor->TermRBPhys(NULL);
 					Actor->bScriptInitialized = FALSE;
+					// Keep timers where they are till the level is added again.
+					TimerWheel.RemoveActor(Actor);
 				}
 			}
 
@@ -2147,6 +2149,9 @@ void UWorld::CleanupWorld(UBOOL bSessionEnded)
 		NavigationOctree->RemoveAllObjects();
 	}
 
+	// Drop all timers, the actors owning them are about to go away.
+	TimerWheel.Reset();
+
 	// Clear standalone flag when switching maps in the Editor. This causes resources placed in the map
 	// package to be garbage collected together with the world.
 	if( GIsEditor && !IsTemplate() )
@@ -2781,11 +2786,20 @@ void UWorld::WelcomePlayer( UNetConnection* Connection, const TCHAR* Optional )
 	Connection->PackageMap->Copy( Connection->Driver->MasterMap );
 	Connection->SendPackageMap();
 
-	FString LevelName = CurrentLevel->GetOutermost()->GetName();
+	FString LevelName = CurrentLevel->GetOutermost()->GetNetPackageName().ToString();
 	Connection->ClientWorldPackageName = GetOutermost()->GetFName();
-	if( Optional[0] )
+
+	// Tell the client how actor properties are going to be sent.
+	FString Options = Optional;
+	Connection->bDeltaCompressVectors = Connection->Driver->bDeltaCompressVectors;
+	if( Connection->bDeltaCompressVectors )
+	{
+		Options += Options.Len() ? TEXT(" DELTAVECTORS=1") : TEXT("DELTAVECTORS=1");
+	}
+
+	if( Options.Len() )
 	{
-		Connection->Logf( TEXT("WELCOME LEVEL=%s %s"), *LevelName, Optional );
+		Connection->Logf( TEXT("WELCOME LEVEL=%s %s"), *LevelName, *Options );
 	}
 	else
 	{
@@ -3319,7 +3333,32 @@ void UWorld::BuildServerMasterMap(void)
 {
 	check(NetDriver);
 	NetDriver->MasterMap->AddNetPackages();
-	UPackage::NetObjectNotify = NetDriver;
+
+	// Leave out the map packages of other worlds hosted by this process.
+	UBOOL bRemovedPackages = FALSE;
+	const TArray<UPackage*>& NetPackages = UPackage::GetNetPackages();
+	for( INT PackageIndex=0; PackageIndex<NetPackages.Num(); PackageIndex++ )
+	{
+		if( !GHostedWorlds.IsNetPackageRelevant( this, NetPackages(PackageIndex) ) )
+		{
+			NetDriver->MasterMap->RemovePackage( NetPackages(PackageIndex), TRUE );
+			bRemovedPackages = TRUE;
+		}
+	}
+	if( bRemovedPackages )
+	{
+		NetDriver->MasterMap->Compute();
+	}
+
+	// The hosted world manager forwards notifications to the net drivers of all worlds.
+	if( GHostedWorlds.Num() > 0 )
+	{
+		UPackage::NetObjectNotify = &GHostedWorlds;
+	}
+	else
+	{
+		UPackage::NetObjectNotify = NetDriver;
+	}
 }
 
 /** asynchronously loads the given levels in preparation for a streaming map transition.
@@ -3555,6 +3594,8 @@ void FSeamlessTravelHandler::Tick()
 				if (It->GetLevel() == GWorld->PersistentLevel && !It->bStatic && !It->bNoDelete && (It->HasAnyFlags(RF_Marked) || It->Role < ROLE_Authority))
 				{
 					It->ClearFlags(RF_Marked);
+					// its timers are picked up by the new world's timer wheel once it ticks
+					GWorld->TimerWheel.RemoveActor(*It);
 					It->Rename(NULL, NewWorld->PersistentLevel);
 					It->WorldInfo = NewWorldInfo;
 					// if it's a Controller or a Pawn, add it to the appopriate list in the new world's WorldInfo
@@ -3712,6 +3753,15 @@ void FSeamlessTravelHandler::Tick()
  */
 void AWorldInfo::SeamlessTravel(const FString& URL)
 {
+	// The seamless travel handler replaces the main world, hosted worlds switch maps by being reloaded instead.
+	if (GHostedWorlds.IsHostedWorld(GWorld))
+	{
+		debugf(NAME_Warning, TEXT("Hosted world %s can't travel seamlessly, switching to %s instead"), *GWorld->GetOutermost()->GetName(), *URL);
+		NextURL = URL;
+		NextSwitchCountdown = 0.f;
+		return;
+	}
+
 	UGameEngine* GameEngine = Cast<UGameEngine>(GEngine);
 	if (GameEngine != NULL)
 	{
@@ -92,6 +92,7 @@
 	#include <sys/ioctl.h>
 	#include <sys/time.h>
 	#include <pthread.h>
+	#include <poll.h>
 #endif
 	// Handle glibc < 2.1.3
 	#ifndef MSG_NOSIGNAL
@@ -212,6 +212,46 @@ public:
 	 * @param BytesRead out param indicating how many bytes were read from the socket
 	 */
 	virtual UBOOL Recv(BYTE* Data,INT BufferSize,INT& BytesRead) = 0;
+	/**
+	 * Reads up to MaxCount datagrams from the socket, gathering their source addresses too. Stops at the
+	 * first read that fails, e.g. because no more data is pending on a non-blocking socket. Platforms that
+	 * can read several datagrams with one call override this, the default calls RecvFrom per datagram
+	 *
+	 * @param Data buffer of MaxCount * BufferSize bytes, datagram i is read to Data + i * BufferSize
+	 * @param BufferSize the max size of a single datagram
+	 * @param MaxCount the max number of datagrams to read
+	 * @param BytesRead out param of MaxCount elements receiving the size of each datagram read
+	 * @param Sources out param of MaxCount elements receiving the sender of each datagram read
+	 * @param Count out param receiving the number of datagrams read
+	 *
+	 * @return FALSE if a read failed, in which case Sources[Count] receives the address the error came from
+	 *		   unless the platform reports it through GetErrorOriginatingAddress
+	 */
+	virtual UBOOL RecvFromMulti(BYTE* Data,INT BufferSize,INT MaxCount,INT* BytesRead,FInternetIpAddr* Sources,INT& Count);
+	/**
+	 * Sends several buffers, each to its own network byte ordered address. Stops at the first send that
+	 * fails. Platforms that can send several datagrams with one call override this, the default calls
+	 * SendTo per buffer
+	 *
+	 * @param Data array of NumBuffers buffers to send
+	 * @param Count array of NumBuffers sizes of the data to send
+	 * @param Destinations array of NumBuffers network byte ordered addresses to send to
+	 * @param NumBuffers the number of buffers to send
+	 * @param NumSent out param indicating how many buffers were sent
+	 *
+	 * @return FALSE if a send failed, in which case buffer NumSent is the one that failed
+	 */
+	virtual UBOOL SendToMulti(const BYTE* const* Data,const INT* Count,const FInternetIpAddr* Destinations,INT NumBuffers,INT& NumSent);
+	/**
+	 * Blocks until the socket has data to read or the wait time has passed. Platforms that can't
+	 * wait on sockets don't override this, the default fails right away
+	 *
+	 * @param WaitSeconds the max time to wait
+	 * @param bHasData out param indicating whether data is pending
+	 *
+	 * @return TRUE if successful, FALSE if waiting failed or isn't supported
+	 */
+	virtual UBOOL WaitForRead(FLOAT WaitSeconds,UBOOL& bHasData);
 	/**
 	 * Determines the connection state of the socket
 	 */
@@ -623,6 +663,15 @@ public:
 			Addr.sin_port == Other.Addr.sin_port &&
 			Addr.sin_family == Other.Addr.sin_family;
 	}
+	/**
+	 * Hashes the ip address and port, so addresses can be used as map keys
+	 *
+	 * @param Address the address to hash
+	 */
+	friend inline DWORD GetTypeHash(const FInternetIpAddr& Address)
+	{
+		return Address.Addr.sin_addr.s_addr ^ ((DWORD)Address.Addr.sin_port * 0x9E3779B1);
+	}
 
 //jgtemp
 	operator SOCKADDR*(void)
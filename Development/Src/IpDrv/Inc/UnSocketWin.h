@@ -174,6 +174,44 @@ public:
 	 * @param BytesRead out param indicating how many bytes were read from the socket
 	 */
 	virtual UBOOL Recv(BYTE* Data,INT BufferSize,INT& BytesRead);
+#ifdef __linux__
+	/**
+	 * Reads up to MaxCount datagrams from the socket with a single recvmmsg call
+	 *
+	 * @param Data buffer of MaxCount * BufferSize bytes, datagram i is read to Data + i * BufferSize
+	 * @param BufferSize the max size of a single datagram
+	 * @param MaxCount the max number of datagrams to read
+	 * @param BytesRead out param of MaxCount elements receiving the size of each datagram read
+	 * @param Sources out param of MaxCount elements receiving the sender of each datagram read
+	 * @param Count out param receiving the number of datagrams read
+	 *
+	 * @return FALSE if reading failed, use GetErrorOriginatingAddress for the address the error came from
+	 */
+	virtual UBOOL RecvFromMulti(BYTE* Data,INT BufferSize,INT MaxCount,INT* BytesRead,FInternetIpAddr* Sources,INT& Count);
+	/**
+	 * Sends several buffers, each to its own network byte ordered address, with as few sendmmsg calls
+	 * as possible
+	 *
+	 * @param Data array of NumBuffers buffers to send
+	 * @param Count array of NumBuffers sizes of the data to send
+	 * @param Destinations array of NumBuffers network byte ordered addresses to send to
+	 * @param NumBuffers the number of buffers to send
+	 * @param NumSent out param indicating how many buffers were sent
+	 *
+	 * @return FALSE if a send failed, in which case buffer NumSent is the one that failed
+	 */
+	virtual UBOOL SendToMulti(const BYTE* const* Data,const INT* Count,const FInternetIpAddr* Destinations,INT NumBuffers,INT& NumSent);
+#endif
+	/**
+	 * Blocks until the socket has data to read or the wait time has passed. Uses ppoll on Linux
+	 * for its nanosecond timeout, select elsewhere
+	 *
+	 * @param WaitSeconds the max time to wait
+	 * @param bHasData out param indicating whether data is pending
+	 *
+	 * @return TRUE if successful, FALSE if waiting failed
+	 */
+	virtual UBOOL WaitForRead(FLOAT WaitSeconds,UBOOL& bHasData);
 	/**
 	 * Determines the connection state of the socket
 	 */
@@ -42,6 +42,11 @@ class UTcpipConnection : public UNetConnection
 	 */
 	virtual void LowLevelSend(void* Data,INT Count);
 
+	/**
+	 * Removes the connection from the driver's address lookup before cleaning it up.
+	 */
+	virtual void CleanUp();
+
 	FString LowLevelGetRemoteAddress();
 	FString LowLevelDescribe();
 };
@@ -64,6 +69,39 @@ class UTcpNetDriver : public UNetDriver
 	FInternetIpAddr LocalAddr;
 	FSocket* Socket;
 
+	/** Client connections by remote address, so incoming packets don't need to search ClientConnections */
+	TMap<FInternetIpAddr,UTcpipConnection*> ClientConnectionMap;
+
+	/** Packet queued by a connection during TickFlush */
+	struct FQueuedSend
+	{
+		/** Offset of the packet's data in QueuedSendData */
+		INT Offset;
+		/** Size of the packet */
+		INT Count;
+		/** Address to send the packet to */
+		FInternetIpAddr Destination;
+	};
+	/** Whether connections queue their packets instead of sending them right away */
+	UBOOL bQueueSends;
+	/** Packets queued during TickFlush */
+	TArray<FQueuedSend> QueuedSends;
+	/** Data of the queued packets */
+	TArray<BYTE> QueuedSendData;
+
+	/** Data of the packets read while waiting for incoming data, each packet is NETWORK_MAX_PACKET bytes apart */
+	TArray<BYTE> PendingPacketData;
+	/** Sizes of the packets read while waiting */
+	TArray<INT> PendingPacketSizes;
+	/** Senders of the packets read while waiting */
+	TArray<FInternetIpAddr> PendingPacketAddrs;
+	/** Whether reading while waiting failed, in which case TickDispatch handles the error */
+	UBOOL bHasPendingReceiveError;
+	/** The error reading while waiting failed with */
+	INT PendingReceiveError;
+	/** The address the pending error originated from */
+	FInternetIpAddr PendingReceiveErrorAddr;
+
 	// Constructor.
 	void StaticConstructor();
 	UTcpNetDriver()
@@ -73,12 +111,48 @@ class UTcpNetDriver : public UNetDriver
 	UBOOL InitConnect( FNetworkNotify* InNotify, const FURL& ConnectURL, FString& Error );
 	UBOOL InitListen( FNetworkNotify* InNotify, FURL& LocalURL, FString& Error );
 	void TickDispatch( FLOAT DeltaTime );
+	/**
+	 * Sends the packets connections queued during TickFlush.
+	 */
+	void TickFlush();
+	/**
+	 * Blocks until packets arrive or the wait time has passed. Packets that arrive are read right away
+	 * and held till the next TickDispatch.
+	 *
+	 * @param	WaitSeconds	max time to wait
+	 * @return	TRUE if the driver waited, FALSE if waiting failed or no more packets can be held
+	 */
+	UBOOL WaitForIncomingData( FLOAT WaitSeconds );
 	FString LowLevelGetNetworkNumber();
 	void LowLevelDestroy();
 
 	// UTcpNetDriver interface.
 	UBOOL InitBase( UBOOL Connect, FNetworkNotify* InNotify, const FURL& URL, FString& Error );
 	UTcpipConnection* GetServerConnection();
+	/**
+	 * Finds the connection packets from the passed in address belong to.
+	 *
+	 * @param Addr	address packets came from
+	 * @return	matching server or client connection, NULL if none
+	 */
+	UTcpipConnection* FindConnection( const FInternetIpAddr& Addr );
+	/**
+	 * Hands received packets to their connections, accepting new connections as needed.
+	 *
+	 * @param Data			packet data, packets are NETWORK_MAX_PACKET bytes apart
+	 * @param BytesRead		size of each packet
+	 * @param FromAddrs		sender of each packet
+	 * @param Count			number of packets
+	 */
+	void ProcessReceivedPackets( const BYTE* Data, const INT* BytesRead, const FInternetIpAddr* FromAddrs, INT Count );
+	/**
+	 * Handles a socket error reported when reading packets.
+	 *
+	 * @param Error		the socket error code
+	 * @param FromAddr	address the error originated from
+	 * @return	TRUE if reading can continue, FALSE if it should stop till the next tick
+	 */
+	UBOOL HandleReceiveError( INT Error, const FInternetIpAddr& FromAddr );
 	FSocketData GetSocketData();
 };
 
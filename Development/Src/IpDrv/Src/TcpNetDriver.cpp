@@ -25,6 +25,10 @@ Notes:
 #define SLIP_HEADER_SIZE   (UDP_HEADER_SIZE+4)
 #define WINSOCK_MAX_PACKET (512)
 #define NETWORK_MAX_PACKET (576)
+// Number of packets read at once.
+#define RECV_BATCH_SIZE    (32)
+// Max number of packets read while waiting for the next tick.
+#define MAX_PENDING_PACKETS (256)
 
 // Variables.
 #ifndef XBOX
@@ -119,6 +123,17 @@ void UTcpipConnection::LowLevelSend( void* Data, INT Count )
 			ResolveInfo = NULL;
 		}
 	}
+	// Queue for sending with the other connections' packets if the driver is flushing.
+	UTcpNetDriver* TcpDriver = Cast<UTcpNetDriver>(Driver);
+	if( TcpDriver && TcpDriver->bQueueSends && Socket == TcpDriver->Socket )
+	{
+		UTcpNetDriver::FQueuedSend& QueuedSend = TcpDriver->QueuedSends(TcpDriver->QueuedSends.Add());
+		QueuedSend.Offset		= TcpDriver->QueuedSendData.Add( Count );
+		QueuedSend.Count		= Count;
+		QueuedSend.Destination	= RemoteAddr;
+		appMemcpy( &TcpDriver->QueuedSendData(QueuedSend.Offset), Data, Count );
+		return;
+	}
 	// Send to remote.
 	INT BytesSent = 0;
 	clock(Driver->SendCycles);
@@ -126,6 +141,19 @@ void UTcpipConnection::LowLevelSend( void* Data, INT Count )
 	unclock(Driver->SendCycles);
 }
 
+/**
+ * Removes the connection from the driver's address lookup before cleaning it up.
+ */
+void UTcpipConnection::CleanUp()
+{
+	UTcpNetDriver* TcpDriver = Cast<UTcpNetDriver>(Driver);
+	if( TcpDriver && TcpDriver->ClientConnectionMap.FindRef(RemoteAddr) == this )
+	{
+		TcpDriver->ClientConnectionMap.Remove( RemoteAddr );
+	}
+	Super::CleanUp();
+}
+
 FString UTcpipConnection::LowLevelGetRemoteAddress()
 {
 	return RemoteAddr.ToString(TRUE);
@@ -204,117 +232,261 @@ void UTcpNetDriver::TickDispatch( FLOAT DeltaTime )
 {
 	Super::TickDispatch( DeltaTime );
 
-	// Process all incoming packets.
-	BYTE Data[NETWORK_MAX_PACKET];
-	FInternetIpAddr FromAddr;
+	// Handle what was read while the server was waiting for the tick first, it arrived before anything still in the socket.
+	if( PendingPacketSizes.Num() )
+	{
+		ProcessReceivedPackets( &PendingPacketData(0), &PendingPacketSizes(0), &PendingPacketAddrs(0), PendingPacketSizes.Num() );
+		PendingPacketSizes.Reset();
+		PendingPacketAddrs.Reset();
+	}
+	if( bHasPendingReceiveError )
+	{
+		bHasPendingReceiveError = FALSE;
+		if( !HandleReceiveError( PendingReceiveError, PendingReceiveErrorAddr ) )
+		{
+			return;
+		}
+	}
+
+	// Process all incoming packets, reading as many at once as the socket allows.
+	BYTE Data[RECV_BATCH_SIZE * NETWORK_MAX_PACKET];
+	INT BytesRead[RECV_BATCH_SIZE];
+	FInternetIpAddr FromAddrs[RECV_BATCH_SIZE];
 	for( ; ; )
 	{
-		INT BytesRead = 0;
+		INT Count = 0;
 		// Get data, if any.
 		clock(RecvCycles);
-		UBOOL bOk = Socket->RecvFrom(Data,sizeof(Data),BytesRead,FromAddr);
+		UBOOL bOk = Socket->RecvFromMulti(Data,NETWORK_MAX_PACKET,RECV_BATCH_SIZE,BytesRead,FromAddrs,Count);
 		unclock(RecvCycles);
+
+		// Handle the packets read before any error.
+		ProcessReceivedPackets( Data, BytesRead, FromAddrs, Count );
+		if( bOk )
+		{
+			continue;
+		}
+
 		// Handle result.
-		if( bOk == FALSE )
+		FInternetIpAddr& FromAddr = FromAddrs[Count];
+		INT Error = GSocketSubsystem->GetLastErrorCode();
+		if( Error == SE_EWOULDBLOCK )
 		{
-			INT Error = GSocketSubsystem->GetLastErrorCode();
-			if( Error == SE_EWOULDBLOCK )
-			{
-				// No data
-				break;
-			}
-			else
-			{
-                #ifdef __linux__
-                    // determine IP address where problem originated. --ryan.
-					GSocketSubsystem->GetErrorOriginatingAddress(&FromAddr);
-                #endif
-                
-				if( Error != SE_UDP_ERR_PORT_UNREACH )
-				{
-					static UBOOL FirstError=1;
-#if !CONSOLE//@todo joeg -- Remove/re-add this after verifying the problem on console
-					if( FirstError )
-#endif
-					{
-						debugf( TEXT("UDP recvfrom error: %i (%s) from %s"),
-							Error,
-							GSocketSubsystem->GetSocketError(Error),
-							*FromAddr.ToString(TRUE));
-					}
-					FirstError = 0;
-					break;
-				}
-			}
+			// No data
+			break;
+		}
+        #ifdef __linux__
+            // determine IP address where problem originated. --ryan.
+			Socket->GetErrorOriginatingAddress(FromAddr);
+        #endif
+		if( !HandleReceiveError( Error, FromAddr ) )
+		{
+			break;
 		}
+	}
+}
+
+/**
+ * Hands received packets to their connections, accepting new connections as needed.
+ *
+ * @param Data			packet data, packets are NETWORK_MAX_PACKET bytes apart
+ * @param BytesRead		size of each packet
+ * @param FromAddrs		sender of each packet
+ * @param Count			number of packets
+ */
+void UTcpNetDriver::ProcessReceivedPackets( const BYTE* Data, const INT* BytesRead, const FInternetIpAddr* FromAddrs, INT Count )
+{
+	for( INT PacketIndex=0; PacketIndex<Count; PacketIndex++ )
+	{
+		const FInternetIpAddr& FromAddr = FromAddrs[PacketIndex];
 		// Figure out which socket the received data came from.
-		UTcpipConnection* Connection = NULL;
-		if (GetServerConnection() && GetServerConnection()->RemoteAddr == FromAddr)
+		UTcpipConnection* Connection = FindConnection( FromAddr );
+
+		// If we didn't find a client connection, maybe create a new one.
+		if( !Connection && Notify->NotifyAcceptingConnection()==ACCEPTC_Accept )
 		{
-			Connection = GetServerConnection();
+			Connection = ConstructObject<UTcpipConnection>(NetConnectionClass);
+			Connection->InitConnection( this, Socket, FromAddr, USOCK_Open, FALSE, FURL() );
+			Notify->NotifyAcceptedConnection( Connection );
+			ClientConnections.AddItem( Connection );
+			ClientConnectionMap.Set( FromAddr, Connection );
 		}
-		for( INT i=0; i<ClientConnections.Num() && !Connection; i++ )
+
+		// Send the packet to the connection for processing.
+		if( Connection )
 		{
-			if(((UTcpipConnection*)ClientConnections(i))->RemoteAddr == FromAddr)
-			{
-				Connection = (UTcpipConnection*)ClientConnections(i);
-			}
+			Connection->ReceivedRawPacket( (BYTE*)Data + PacketIndex * NETWORK_MAX_PACKET, BytesRead[PacketIndex] );
 		}
+	}
+}
 
-		if( bOk == FALSE )
+/**
+ * Handles a socket error reported when reading packets.
+ *
+ * @param Error		the socket error code
+ * @param FromAddr	address the error originated from
+ * @return	TRUE if reading can continue, FALSE if it should stop till the next tick
+ */
+UBOOL UTcpNetDriver::HandleReceiveError( INT Error, const FInternetIpAddr& FromAddr )
+{
+	if( Error != SE_UDP_ERR_PORT_UNREACH )
+	{
+		static UBOOL FirstError=1;
+#if !CONSOLE//@todo joeg -- Remove/re-add this after verifying the problem on console
+		if( FirstError )
+#endif
 		{
-			if( Connection )
-			{
-				if( Connection != GetServerConnection() )
-				{
-					// We received an ICMP port unreachable from the client, meaning the client is no longer running the game
-					// (or someone is trying to perform a DoS attack on the client)
-
-					// rcg08182002 Some buggy firewalls get occasional ICMP port
-					// unreachable messages from legitimate players. Still, this code
-					// will drop them unceremoniously, so there's an option in the .INI
-					// file for servers with such flakey connections to let these
-					// players slide...which means if the client's game crashes, they
-					// might get flooded to some degree with packets until they timeout.
-					// Either way, this should close up the usual DoS attacks.
-					if ((Connection->State != USOCK_Open) || (!AllowPlayerPortUnreach))
-					{
-						if (LogPortUnreach)
-						{
-							debugf( TEXT("Received ICMP port unreachable from client %s.  Disconnecting."),
-								*FromAddr.ToString(TRUE));
-						}
-						Connection->CleanUp();
-					}
-				}
-			}
-			else
+			debugf( TEXT("UDP recvfrom error: %i (%s) from %s"),
+				Error,
+				GSocketSubsystem->GetSocketError(Error),
+				*FromAddr.ToString(TRUE));
+		}
+		FirstError = 0;
+		return FALSE;
+	}
+
+	UTcpipConnection* Connection = FindConnection( FromAddr );
+	if( Connection )
+	{
+		if( Connection != GetServerConnection() )
+		{
+			// We received an ICMP port unreachable from the client, meaning the client is no longer running the game
+			// (or someone is trying to perform a DoS attack on the client)
+
+			// rcg08182002 Some buggy firewalls get occasional ICMP port
+			// unreachable messages from legitimate players. Still, this code
+			// will drop them unceremoniously, so there's an option in the .INI
+			// file for servers with such flakey connections to let these
+			// players slide...which means if the client's game crashes, they
+			// might get flooded to some degree with packets until they timeout.
+			// Either way, this should close up the usual DoS attacks.
+			if ((Connection->State != USOCK_Open) || (!AllowPlayerPortUnreach))
 			{
 				if (LogPortUnreach)
 				{
-					debugf( TEXT("Received ICMP port unreachable from %s.  No matching connection found."),
+					debugf( TEXT("Received ICMP port unreachable from client %s.  Disconnecting."),
 						*FromAddr.ToString(TRUE));
 				}
+				Connection->CleanUp();
 			}
 		}
-		else
+	}
+	else
+	{
+		if (LogPortUnreach)
 		{
-			// If we didn't find a client connection, maybe create a new one.
-			if( !Connection && Notify->NotifyAcceptingConnection()==ACCEPTC_Accept )
-			{
-				Connection = ConstructObject<UTcpipConnection>(NetConnectionClass);
-				Connection->InitConnection( this, Socket, FromAddr, USOCK_Open, FALSE, FURL() );
-				Notify->NotifyAcceptedConnection( Connection );
-				ClientConnections.AddItem( Connection );
-			}
+			debugf( TEXT("Received ICMP port unreachable from %s.  No matching connection found."),
+				*FromAddr.ToString(TRUE));
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Blocks until packets arrive or the wait time has passed. Packets that arrive are read right away
+ * and held till the next TickDispatch.
+ *
+ * @param	WaitSeconds	max time to wait
+ * @return	TRUE if the driver waited, FALSE if waiting failed or no more packets can be held
+ */
+UBOOL UTcpNetDriver::WaitForIncomingData( FLOAT WaitSeconds )
+{
+	const INT NumPending = PendingPacketSizes.Num();
+	if( !Socket || bHasPendingReceiveError || NumPending + RECV_BATCH_SIZE > MAX_PENDING_PACKETS )
+	{
+		return FALSE;
+	}
+
+	UBOOL bHasData = FALSE;
+	if( !Socket->WaitForRead( WaitSeconds, bHasData ) )
+	{
+		return FALSE;
+	}
+	if( bHasData )
+	{
+		if( PendingPacketData.Num() == 0 )
+		{
+			PendingPacketData.Add( MAX_PENDING_PACKETS * NETWORK_MAX_PACKET );
+		}
+		PendingPacketSizes.Add( RECV_BATCH_SIZE );
+		PendingPacketAddrs.Add( RECV_BATCH_SIZE );
 
-			// Send the packet to the connection for processing.
-			if( Connection )
+		INT Count = 0;
+		clock(RecvCycles);
+		UBOOL bOk = Socket->RecvFromMulti( &PendingPacketData(NumPending * NETWORK_MAX_PACKET), NETWORK_MAX_PACKET, RECV_BATCH_SIZE,
+			&PendingPacketSizes(NumPending), &PendingPacketAddrs(NumPending), Count );
+		unclock(RecvCycles);
+
+		if( !bOk )
+		{
+			INT Error = GSocketSubsystem->GetLastErrorCode();
+			if( Error != SE_EWOULDBLOCK )
 			{
-				Connection->ReceivedRawPacket( Data, BytesRead );
+				// Leave the error to TickDispatch, which handles it once the packets read before it are processed.
+				PendingReceiveErrorAddr = PendingPacketAddrs(NumPending + Count);
+				#ifdef __linux__
+					Socket->GetErrorOriginatingAddress(PendingReceiveErrorAddr);
+				#endif
+				PendingReceiveError		= Error;
+				bHasPendingReceiveError	= TRUE;
 			}
 		}
+		PendingPacketSizes.Remove( NumPending + Count, RECV_BATCH_SIZE - Count );
+		PendingPacketAddrs.Remove( NumPending + Count, RECV_BATCH_SIZE - Count );
+	}
+	return TRUE;
+}
+
+/**
+ * Sends the packets connections queued during TickFlush.
+ */
+void UTcpNetDriver::TickFlush()
+{
+	// Queue the packets connections send while flushing so they go out with as few calls as possible.
+	bQueueSends = TRUE;
+	Super::TickFlush();
+	bQueueSends = FALSE;
+
+	if( QueuedSends.Num() )
+	{
+		const BYTE** SendData = (const BYTE**)appAlloca( QueuedSends.Num() * sizeof(BYTE*) );
+		INT* SendCounts = (INT*)appAlloca( QueuedSends.Num() * sizeof(INT) );
+		FInternetIpAddr* Destinations = (FInternetIpAddr*)appAlloca( QueuedSends.Num() * sizeof(FInternetIpAddr) );
+		for( INT i=0; i<QueuedSends.Num(); i++ )
+		{
+			SendData[i]		= &QueuedSendData(QueuedSends(i).Offset);
+			SendCounts[i]	= QueuedSends(i).Count;
+			Destinations[i]	= QueuedSends(i).Destination;
+		}
+
+		clock(SendCycles);
+		for( INT First=0; First<QueuedSends.Num(); )
+		{
+			INT NumSent = 0;
+			UBOOL bOk = Socket->SendToMulti( SendData + First, SendCounts + First, Destinations + First, QueuedSends.Num() - First, NumSent );
+			// Skip packets that failed to send, like LowLevelSend does.
+			First += bOk ? NumSent : NumSent + 1;
+		}
+		unclock(SendCycles);
+
+		QueuedSends.Reset();
+		QueuedSendData.Reset();
+	}
+}
+
+/**
+ * Finds the connection packets from the passed in address belong to.
+ *
+ * @param Addr	address packets came from
+ * @return	matching server or client connection, NULL if none
+ */
+UTcpipConnection* UTcpNetDriver::FindConnection( const FInternetIpAddr& Addr )
+{
+	if( GetServerConnection() && GetServerConnection()->RemoteAddr == Addr )
+	{
+		return GetServerConnection();
 	}
+	return ClientConnectionMap.FindRef( Addr );
 }
 
 FString UTcpNetDriver::LowLevelGetNetworkNumber()
@@ -92,6 +92,74 @@ void FSocketData::UpdateFromSocket(void)
 	}
 }
 
+/*----------------------------------------------------------------------------
+	FSocket.
+----------------------------------------------------------------------------*/
+
+/**
+ * Reads up to MaxCount datagrams from the socket, gathering their source addresses too. Stops at the
+ * first read that fails, e.g. because no more data is pending on a non-blocking socket
+ *
+ * @param Data buffer of MaxCount * BufferSize bytes, datagram i is read to Data + i * BufferSize
+ * @param BufferSize the max size of a single datagram
+ * @param MaxCount the max number of datagrams to read
+ * @param BytesRead out param of MaxCount elements receiving the size of each datagram read
+ * @param Sources out param of MaxCount elements receiving the sender of each datagram read
+ * @param Count out param receiving the number of datagrams read
+ *
+ * @return FALSE if a read failed, in which case Sources[Count] receives the address the error came from
+ */
+UBOOL FSocket::RecvFromMulti(BYTE* Data,INT BufferSize,INT MaxCount,INT* BytesRead,FInternetIpAddr* Sources,INT& Count)
+{
+	for (Count = 0; Count < MaxCount; Count++)
+	{
+		if (RecvFrom(Data + Count * BufferSize,BufferSize,BytesRead[Count],Sources[Count]) == FALSE)
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Sends several buffers, each to its own network byte ordered address. Stops at the first send that fails
+ *
+ * @param Data array of NumBuffers buffers to send
+ * @param Count array of NumBuffers sizes of the data to send
+ * @param Destinations array of NumBuffers network byte ordered addresses to send to
+ * @param NumBuffers the number of buffers to send
+ * @param NumSent out param indicating how many buffers were sent
+ *
+ * @return FALSE if a send failed, in which case buffer NumSent is the one that failed
+ */
+UBOOL FSocket::SendToMulti(const BYTE* const* Data,const INT* Count,const FInternetIpAddr* Destinations,INT NumBuffers,INT& NumSent)
+{
+	for (NumSent = 0; NumSent < NumBuffers; NumSent++)
+	{
+		INT BytesSent = 0;
+		if (SendTo(Data[NumSent],Count[NumSent],BytesSent,Destinations[NumSent]) == FALSE)
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Blocks until the socket has data to read or the wait time has passed. Platforms that can't
+ * wait on sockets don't override this, the default fails right away
+ *
+ * @param WaitSeconds the max time to wait
+ * @param bHasData out param indicating whether data is pending
+ *
+ * @return TRUE if successful, FALSE if waiting failed or isn't supported
+ */
+UBOOL FSocket::WaitForRead(FLOAT WaitSeconds,UBOOL& bHasData)
+{
+	bHasData = FALSE;
+	return FALSE;
+}
+
 //
 // FIpAddr functions
 //
@@ -179,6 +179,137 @@ UBOOL FSocketWin::Recv(BYTE* Data,INT BufferSize,INT& BytesRead)
 	return BytesRead >= 0;
 }
 
+#ifdef __linux__
+/**
+ * Reads up to MaxCount datagrams from the socket with a single recvmmsg call
+ *
+ * @param Data buffer of MaxCount * BufferSize bytes, datagram i is read to Data + i * BufferSize
+ * @param BufferSize the max size of a single datagram
+ * @param MaxCount the max number of datagrams to read
+ * @param BytesRead out param of MaxCount elements receiving the size of each datagram read
+ * @param Sources out param of MaxCount elements receiving the sender of each datagram read
+ * @param Count out param receiving the number of datagrams read
+ *
+ * @return FALSE if reading failed, use GetErrorOriginatingAddress for the address the error came from
+ */
+UBOOL FSocketWin::RecvFromMulti(BYTE* Data,INT BufferSize,INT MaxCount,INT* BytesRead,
+	FInternetIpAddr* Sources,INT& Count)
+{
+	mmsghdr* Messages = (mmsghdr*)appAlloca(MaxCount * sizeof(mmsghdr));
+	iovec* Buffers = (iovec*)appAlloca(MaxCount * sizeof(iovec));
+	appMemzero(Messages,MaxCount * sizeof(mmsghdr));
+	for (INT Index = 0; Index < MaxCount; Index++)
+	{
+		Buffers[Index].iov_base = Data + Index * BufferSize;
+		Buffers[Index].iov_len = BufferSize;
+		Messages[Index].msg_hdr.msg_name = (SOCKADDR*)Sources[Index];
+		Messages[Index].msg_hdr.msg_namelen = sizeof(SOCKADDR_IN);
+		Messages[Index].msg_hdr.msg_iov = &Buffers[Index];
+		Messages[Index].msg_hdr.msg_iovlen = 1;
+	}
+	// Read everything that is pending, the socket is non-blocking
+	INT Result = recvmmsg(Socket,Messages,MaxCount,0,NULL);
+	Count = Max(Result,0);
+	for (INT Index = 0; Index < Count; Index++)
+	{
+		BytesRead[Index] = Messages[Index].msg_len;
+	}
+	return Result >= 0;
+}
+
+/** The most buffers the kernel accepts in a single sendmmsg call */
+#ifndef UIO_MAXIOV
+#define UIO_MAXIOV 1024
+#endif
+
+/**
+ * Sends several buffers, each to its own network byte ordered address, with as few sendmmsg calls
+ * as possible. Buffers are passed to the kernel in chunks of at most UIO_MAXIOV
+ *
+ * @param Data array of NumBuffers buffers to send
+ * @param Count array of NumBuffers sizes of the data to send
+ * @param Destinations array of NumBuffers network byte ordered addresses to send to
+ * @param NumBuffers the number of buffers to send
+ * @param NumSent out param indicating how many buffers were sent
+ *
+ * @return FALSE if a send failed, in which case buffer NumSent is the one that failed
+ */
+UBOOL FSocketWin::SendToMulti(const BYTE* const* Data,const INT* Count,
+	const FInternetIpAddr* Destinations,INT NumBuffers,INT& NumSent)
+{
+	const INT MaxChunkSize = Min(NumBuffers,UIO_MAXIOV);
+	mmsghdr* Messages = (mmsghdr*)appAlloca(MaxChunkSize * sizeof(mmsghdr));
+	iovec* Buffers = (iovec*)appAlloca(MaxChunkSize * sizeof(iovec));
+	NumSent = 0;
+	while (NumSent < NumBuffers)
+	{
+		const INT ChunkSize = Min(NumBuffers - NumSent,MaxChunkSize);
+		appMemzero(Messages,ChunkSize * sizeof(mmsghdr));
+		for (INT Index = 0; Index < ChunkSize; Index++)
+		{
+			const INT BufferIndex = NumSent + Index;
+			Buffers[Index].iov_base = (void*)Data[BufferIndex];
+			Buffers[Index].iov_len = Count[BufferIndex];
+			Messages[Index].msg_hdr.msg_name = (void*)(const SOCKADDR*)Destinations[BufferIndex];
+			Messages[Index].msg_hdr.msg_namelen = sizeof(SOCKADDR_IN);
+			Messages[Index].msg_hdr.msg_iov = &Buffers[Index];
+			Messages[Index].msg_hdr.msg_iovlen = 1;
+		}
+		// sendmmsg stops early without an error (e.g. on ENOBUFS) if any buffer was sent, the next
+		// call then starts at the first unsent buffer and reports the error if it persists
+		const INT Result = sendmmsg(Socket,Messages,ChunkSize,MSG_NOSIGNAL);
+		if (Result <= 0)
+		{
+			return FALSE;
+		}
+		NumSent += Result;
+	}
+	return TRUE;
+}
+#endif
+
+/**
+ * Blocks until the socket has data to read or the wait time has passed. Uses ppoll on Linux
+ * for its nanosecond timeout, select elsewhere
+ *
+ * @param WaitSeconds the max time to wait
+ * @param bHasData out param indicating whether data is pending
+ *
+ * @return TRUE if successful, FALSE if waiting failed
+ */
+UBOOL FSocketWin::WaitForRead(FLOAT WaitSeconds,UBOOL& bHasData)
+{
+	bHasData = FALSE;
+	WaitSeconds = Max(WaitSeconds,0.f);
+#ifdef __linux__
+	pollfd PollSocket;
+	PollSocket.fd = Socket;
+	PollSocket.events = POLLIN;
+	PollSocket.revents = 0;
+	timespec Time;
+	Time.tv_sec = appTrunc(WaitSeconds);
+	Time.tv_nsec = appTrunc((WaitSeconds - Time.tv_sec) * 1000000000.f);
+	INT PollStatus = ppoll(&PollSocket,1,&Time,NULL);
+	// Being interrupted by a signal just means we should check again
+	if (PollStatus < 0 && errno == EINTR)
+	{
+		return TRUE;
+	}
+	bHasData = PollStatus > 0;
+	return PollStatus >= 0;
+#else
+	TIMEVAL Time;
+	Time.tv_sec = appTrunc(WaitSeconds);
+	Time.tv_usec = appTrunc((WaitSeconds - Time.tv_sec) * 1000000.f);
+	fd_set SocketSet;
+	FD_ZERO(&SocketSet);
+	FD_SET(Socket,&SocketSet);
+	INT SelectStatus = select(Socket + 1,&SocketSet,NULL,NULL,&Time);
+	bHasData = SelectStatus > 0;
+	return SelectStatus >= 0;
+#endif
+}
+
 /**
  * Determines the connection state of the socket
  */
@@ -89,6 +89,7 @@
 #include "FMallocProfiler.h"
 #include "FMallocProxySimpleTrack.h"
 #include "FMallocThreadSafeProxy.h"
+#include "FMallocThreadCache.h"
 #include "FFeedbackContextAnsi.h"
 #include "FFeedbackContextWindows.h"
 #include "FFileManagerWindows.h"
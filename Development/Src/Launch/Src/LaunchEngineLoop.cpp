@@ -164,6 +164,16 @@ void GCreateMalloc()
 	GMalloc = new FMallocXenon();
 #elif _DEBUG
 	GMalloc = new FMallocDebug();
+#elif __LINUX__
+	// Allows comparing the thread caching allocator against the default one.
+	if( FMallocThreadCache::IsRequestedOnCommandLine() )
+	{
+		GMalloc = new FMallocThreadCache();
+	}
+	else
+	{
+		GMalloc = new FMallocAnsi();
+	}
 #elif __GNUC__
 	GMalloc = new FMallocAnsi();
 #else
@@ -209,6 +219,8 @@ static FOutputDeviceFile					Log;
 static FOutputDeviceAnsiError				Error;
 static FFeedbackContextAnsi					GameWarn;
 static FFileManagerLinux					FileManager;
+static FQueuedThreadPoolLinux				ThreadPool;
+static FQueuedThreadPoolTaskGraph			TaskGraphThreadPool;
 #else
 #include "FFeedbackContextEditor.h"
 #include "ALAudio.h"
@@ -224,6 +236,7 @@ static FOutputDeviceConsoleWindowsInherited InheritedLogConsole(LogConsole);
 static FSynchronizeFactoryWin				SynchronizeFactory;
 static FThreadFactoryWin					ThreadFactory;
 static FQueuedThreadPoolWin					ThreadPool;
+static FQueuedThreadPoolTaskGraph			TaskGraphThreadPool;
 #endif
 
 static FCallbackEventObserver				GameEventCallback;
@@ -966,6 +979,64 @@ void CheckForQABuildCandidateStatus()
 	}
 }
 
+/**
+ * Whether the dedicated server waits for the next tick by blocking on its net driver, which wakes up as soon
+ * as packets arrive so they are read right away, instead of sleeping and spinning. Enabled by
+ * bEventDrivenServerPacing in the [Engine.GameEngine] section or -EVENTPACING.
+ */
+static UBOOL appUseEventDrivenServerPacing()
+{
+	static UBOOL bInitialized = FALSE;
+	static UBOOL bUseEventDrivenPacing = FALSE;
+	if( !bInitialized )
+	{
+		GConfig->GetBool( TEXT("Engine.GameEngine"), TEXT("bEventDrivenServerPacing"), bUseEventDrivenPacing, GEngineIni );
+		bUseEventDrivenPacing	= bUseEventDrivenPacing || ParseParam( appCmdLine(), TEXT("EVENTPACING") );
+		bInitialized			= TRUE;
+	}
+	return bUseEventDrivenPacing && !GIsClient;
+}
+
+/**
+ * Waits for the passed in time by blocking on the net driver, reading packets as they arrive. Falls back
+ * to sleeping if the driver can't wait and gives up the timeslice for the last bit of the wait as the
+ * driver's wait is no more precise than the scheduler. Also sleeps while worlds are hosted next to GWorld,
+ * as blocking on GWorld's driver alone would leave packets for the hosted worlds waiting out the frame.
+ *
+ * @param	WaitStartTime	time the wait started at
+ * @param	WaitTime		time to wait for, in seconds
+ * @return	time at the end of the wait
+ */
+static DOUBLE appWaitForServerTickDeadline( DOUBLE WaitStartTime, FLOAT WaitTime )
+{
+#if _MSC_VER
+	// The scheduler granularity is set to 1 ms on PC.
+	const FLOAT SpinTime = 2 / 1000.f;
+#else
+	const FLOAT SpinTime = 0.2f / 1000.f;
+#endif
+	const DOUBLE Deadline = WaitStartTime + WaitTime;
+	UNetDriver* NetDriver = GWorld && GHostedWorlds.Num() == 0 ? GWorld->NetDriver : NULL;
+	DOUBLE CurrentTime = WaitStartTime;
+	while( Deadline - CurrentTime > SpinTime )
+	{
+		const FLOAT BlockTime = Deadline - CurrentTime - SpinTime;
+		if( !NetDriver || !NetDriver->WaitForIncomingData( BlockTime ) )
+		{
+			appSleep( BlockTime );
+			CurrentTime = appSeconds();
+			break;
+		}
+		CurrentTime = appSeconds();
+	}
+	while( CurrentTime < Deadline )
+	{
+		appSleep( 0 );
+		CurrentTime = appSeconds();
+	}
+	return CurrentTime;
+}
+
 /**
  * Update GCurrentTime/ GDeltaTime while taking into account max tick rate.
  */
@@ -1008,20 +1079,27 @@ void appUpdateTimaAndHandleMaxTickRate()
 			STAT(FScopeSecondsCounter ActualWaitTimeTimer(ActualWaitTime));
 			SCOPE_CYCLE_COUNTER(STAT_GameTickWaitTime);
 
-			// Sleep if we're waiting more than 5 ms. We set the scheduler granularity to 1 ms
-			// at startup on PC. We reserve 2 ms of slack time which we will wait for by giving
-			// up our timeslice.
-			if( WaitTime > 5 / 1000.f )
+			if( appUseEventDrivenServerPacing() )
 			{
-				appSleep( WaitTime - 3 / 1000.f );
+				GCurrentTime = appWaitForServerTickDeadline( GCurrentTime, WaitTime );
 			}
-
-			// Give up timeslice for remainder of wait time.
-			DOUBLE WaitStartTime = GCurrentTime;
-			while( GCurrentTime - WaitStartTime < WaitTime )
+			else
 			{
-				GCurrentTime = appSeconds();
-				appSleep( 0 );
+				// Sleep if we're waiting more than 5 ms. We set the scheduler granularity to 1 ms
+				// at startup on PC. We reserve 2 ms of slack time which we will wait for by giving
+				// up our timeslice.
+				if( WaitTime > 5 / 1000.f )
+				{
+					appSleep( WaitTime - 3 / 1000.f );
+				}
+
+				// Give up timeslice for remainder of wait time.
+				DOUBLE WaitStartTime = GCurrentTime;
+				while( GCurrentTime - WaitStartTime < WaitTime )
+				{
+					GCurrentTime = appSeconds();
+					appSleep( 0 );
+				}
 			}
 		}
 
@@ -1062,14 +1140,40 @@ INT FEngineLoop::PreInit( const TCHAR* CmdLine )
 	GThreadFactory		= &ThreadFactory;
 #ifdef __GNUC__
 #if PS3
-	//@todo joeg -- Get this working for linux
 	GThreadPool = &ThreadPool;
 	verify(GThreadPool->Create(1));
+#else
+	if( ParseParam( CmdLine, TEXT("SINGLEQUEUEPOOL") ) )
+	{
+		// Old single queue, single thread pool. Kept around for comparison.
+		GThreadPool = &ThreadPool;
+		verify(GThreadPool->Create(1));
+	}
+	else
+	{
+		// Work stealing pool, one worker per hardware thread minus the game thread unless overridden.
+		INT NumPoolThreads = 0;
+		Parse( CmdLine, TEXT("POOLTHREADS="), NumPoolThreads );
+		GThreadPool = &TaskGraphThreadPool;
+		verify(GThreadPool->Create(Max(NumPoolThreads,0)));
+	}
 #endif
 	appInit( CmdLine, &Log, NULL, &Error, &GameWarn, &FileManager, &GameEventCallback, &GameQueryCallback, FConfigCacheIni::Factory );
 #else	// __GNUC__
-	GThreadPool = &ThreadPool;
-	verify(GThreadPool->Create(1));
+	if( ParseParam( CmdLine, TEXT("SINGLEQUEUEPOOL") ) )
+	{
+		// Old single queue, single thread pool. Kept around for comparison.
+		GThreadPool = &ThreadPool;
+		verify(GThreadPool->Create(1));
+	}
+	else
+	{
+		// Work stealing pool, one worker per hardware thread minus the game thread unless overridden.
+		INT NumPoolThreads = 0;
+		Parse( CmdLine, TEXT("POOLTHREADS="), NumPoolThreads );
+		GThreadPool = &TaskGraphThreadPool;
+		verify(GThreadPool->Create(Max(NumPoolThreads,0)));
+	}
 	// see if we were launched from our .com command line launcher
 	InheritedLogConsole.Connect();
 
@@ -1265,6 +1369,8 @@ INT FEngineLoop::PreInit( const TCHAR* CmdLine )
 	FAsyncIOSystemPS3*		AsyncIOSystem = new FAsyncIOSystemPS3();
 #elif _MSC_VER
 	FAsyncIOSystemWindows*	AsyncIOSystem = new FAsyncIOSystemWindows();
+#elif __LINUX__
+	FAsyncIOSystemLinux*	AsyncIOSystem = new FAsyncIOSystemLinux();
 #else
 	#error implement async io manager for platform
 #endif
@@ -2000,6 +2106,8 @@ void FEngineLoop::Exit()
 	// Stop the rendering thread.
 	StopRenderingThread();
 
+	GFrameArena.Exit();
+
 	delete GStreamingManager;
 	GStreamingManager	= NULL;
 
@@ -2073,6 +2181,9 @@ void FEngineLoop::Tick()
 		FDeferredUpdateResource::ResetNeedsUpdate();
 	});
 
+	// Release the frame arena memory of the frame before the last one.
+	GFrameArena.BeginFrame();
+
 	// Update.
 	GEngine->Tick( GDeltaTime );
 
@@ -19,7 +19,8 @@ var LightEnvironmentComponent MyLightEnvironment;
 
 cpptext
 {
-	virtual void TickSpecial( FLOAT DeltaSeconds );
+	virtual UBOOL CanTickInParallel() const;
+	virtual void TickParallel( FLOAT DeltaSeconds, enum ELevelTick TickType );
 }
 
 event PreBeginPlay()
@@ -1412,7 +1412,8 @@ public:
     //## END PROPS UTDroppedPickup
 
     DECLARE_CLASS(AUTDroppedPickup,ADroppedPickup,0,UTGame)
-	virtual void TickSpecial( FLOAT DeltaSeconds );
+	virtual UBOOL CanTickInParallel() const;
+	virtual void TickParallel( FLOAT DeltaSeconds, enum ELevelTick TickType );
 };
 
 struct UTKActor_eventOnEncroach_Parms
@@ -139,9 +139,24 @@ IMPLEMENT_CLASS(AUTEmitterPool);
 IMPLEMENT_CLASS(AUTVoteCollector);
 IMPLEMENT_CLASS(AUTVoteReplicationInfo);
 
-void AUTDroppedPickup::TickSpecial(FLOAT DeltaSeconds)
+/**
+ * Spinning and fading the pickup mesh only touches the pickup's own mesh, so it is done in parallel with the other
+ * dropped pickups. There is nothing to do on dedicated servers.
+ */
+UBOOL AUTDroppedPickup::CanTickInParallel() const
 {
-	Super::TickSpecial(DeltaSeconds);
+	return PickupMesh != NULL && WorldInfo->NetMode != NM_DedicatedServer;
+}
+
+void AUTDroppedPickup::TickParallel(FLOAT DeltaSeconds, ELevelTick TickType)
+{
+	// Same checks as AActor::Tick uses to decide whether to call TickSpecial, which used to spin the mesh.
+	if (TickType == LEVELTICK_ViewportsOnly || bDeleteMe || (bStasis && InStasis()))
+	{
+		return;
+	}
+	// Deferred transform updates of components of dynamic actors only flag the component.
+	checkSlow(!bStatic);
 	if(PickupMesh && WorldInfo->NetMode != NM_DedicatedServer )
 	{
 		if ( (bFadeOut || bRotatingPickup) && (WorldInfo->TimeSeconds - LastRenderTime < 0.2f) )
@@ -0,0 +1,49 @@
+/**
+ * Call targets for UnrealScriptTest.ScriptCallBenchmarkCommandlet, which measures how many virtual and global
+ * script function calls per second the script VM executes with and without call site caches.
+ *
+ * Copyright  1998-2007 Epic Games, Inc. All Rights Reserved
+ */
+class Test0024_CallBenchmarkBase extends Object;
+
+var int CallCount;
+
+function CallTarget()
+{
+	CallCount++;
+}
+
+/** Makes Count virtual calls, resolved through the object's state if it is in one. */
+event RunVirtualCalls( int Count )
+{
+	local int i;
+
+	for( i = 0; i < Count; i++ )
+	{
+		CallTarget();
+	}
+}
+
+/** Makes Count global calls, which ignore the object's state. */
+event RunGlobalCalls( int Count )
+{
+	local int i;
+
+	for( i = 0; i < Count; i++ )
+	{
+		global.CallTarget();
+	}
+}
+
+state BenchmarkBaseState
+{
+	function CallTarget()
+	{
+		CallCount += 2;
+	}
+}
+
+DefaultProperties
+{
+
+}
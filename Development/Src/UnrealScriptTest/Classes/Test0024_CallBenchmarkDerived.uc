@@ -0,0 +1,16 @@
+/**
+ * Derived call target for UnrealScriptTest.ScriptCallBenchmarkCommandlet. Nothing is overridden here, so
+ * uncached lookups have to search past this class or state to find the call target.
+ *
+ * Copyright  1998-2007 Epic Games, Inc. All Rights Reserved
+ */
+class Test0024_CallBenchmarkDerived extends Test0024_CallBenchmarkBase;
+
+state BenchmarkState extends BenchmarkBaseState
+{
+}
+
+DefaultProperties
+{
+
+}
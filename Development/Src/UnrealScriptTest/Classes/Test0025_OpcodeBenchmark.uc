@@ -0,0 +1,81 @@
+/**
+ * Loops for UnrealScriptTest.ScriptOpcodeBenchmarkCommandlet, which measures how fast the script VM runs common
+ * arithmetic, comparison and struct member expressions with and without superinstructions.
+ *
+ * Copyright  1998-2007 Epic Games, Inc. All Rights Reserved
+ */
+class Test0025_OpcodeBenchmark extends Object;
+
+struct BenchmarkInner
+{
+	var int		A;
+	var float	B;
+};
+
+struct BenchmarkOuter
+{
+	var BenchmarkInner	Inner;
+	var vector			Offset;
+};
+
+var BenchmarkOuter	Nested;
+var float			Scale;
+var int				Bias;
+
+/** Int arithmetic, increments and compare-and-jump on locals and member variables. */
+event int RunIntLoop( int Count )
+{
+	local int i, Sum, Step;
+
+	Step = 3;
+	for( i = 0; i < Count; i++ )
+	{
+		Sum = Sum + Step;
+		Sum = Sum - Bias;
+		if( Sum > 100000 )
+		{
+			Sum = Sum / 2;
+		}
+		Step = i * 7;
+	}
+	return Sum;
+}
+
+/** Float arithmetic on locals, member variables and constants. */
+event float RunFloatLoop( int Count )
+{
+	local int i;
+	local float X, Y;
+
+	X = 1.0;
+	for( i = 0; i < Count; i++ )
+	{
+		X = X * 1.0001;
+		Y = Y + X;
+		Y = Y - Scale;
+		X = X / 1.00005;
+	}
+	return Y;
+}
+
+/** Member access of nested structs held in locals and member variables. */
+event int RunStructLoop( int Count )
+{
+	local int i;
+	local BenchmarkOuter LocalNested;
+
+	for( i = 0; i < Count; i++ )
+	{
+		LocalNested.Inner.A = LocalNested.Inner.A + i;
+		Nested.Inner.A = LocalNested.Inner.A;
+		Nested.Offset.X = Nested.Offset.X + Nested.Inner.B;
+	}
+	return Nested.Inner.A;
+}
+
+DefaultProperties
+{
+	Scale=0.5
+	Bias=2
+	Nested=(Inner=(B=0.25))
+}
@@ -6,6 +6,35 @@
 #include "Engine.h"
 #include "UnrealScriptTestClasses.h"
 
+/*-----------------------------------------------------------------------------
+	Commandlets.
+-----------------------------------------------------------------------------*/
+
+BEGIN_COMMANDLET(ScriptCallBenchmark,UnrealScriptTest)
+	/**
+	 * Runs one of the call loops of Test0024_CallBenchmarkBase.
+	 *
+	 * @param	Object			object to run the loop on
+	 * @param	LoopName		name of the event running the loop
+	 * @param	NumCalls		number of calls to make
+	 * @return	calls per second, including the loop overhead
+	 */
+	DOUBLE RunCallLoop( UObject* Object, FName LoopName, INT NumCalls );
+END_COMMANDLET
+
+BEGIN_COMMANDLET(ScriptOpcodeBenchmark,UnrealScriptTest)
+	/**
+	 * Runs one of the loops of Test0025_OpcodeBenchmark.
+	 *
+	 * @param	Object			object to run the loop on
+	 * @param	LoopName		name of the event running the loop
+	 * @param	NumIterations	number of iterations to run
+	 * @param	OutResult		[out] bits of the values the loop returned, combined over all events it was run by
+	 * @return	iterations per second
+	 */
+	DOUBLE RunLoop( UObject* Object, FName LoopName, INT NumIterations, DWORD& OutResult );
+END_COMMANDLET
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
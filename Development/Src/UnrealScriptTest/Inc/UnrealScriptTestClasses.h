@@ -552,6 +552,8 @@ DECLARE_NATIVE_TYPE(UnrealScriptTest,UTestComponentsBase);
 	UCTSimpleNestObject::StaticClass(); \
 	UCTSimpleNestParent::StaticClass(); \
 	ACTSimpleNestRoot::StaticClass(); \
+	UScriptCallBenchmarkCommandlet::StaticClass(); \
+	UScriptOpcodeBenchmarkCommandlet::StaticClass(); \
 	UTest0002_InterfaceNative::StaticClass(); \
 	UTest0010_NativeObject::StaticClass(); \
 	GNativeLookupFuncs[Lookup++] = &FindUnrealScriptTestUTest0010_NativeObjectNative; \
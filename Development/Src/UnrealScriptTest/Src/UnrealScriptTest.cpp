@@ -218,6 +218,228 @@ UBOOL UTest0011_NativeObjectBoolOrder::NativeTestBoolOrderFunction(UBOOL BoolPar
 }
 
 
+/*-----------------------------------------------------------------------------
+	UScriptCallBenchmarkCommandlet.
+-----------------------------------------------------------------------------*/
+
+/**
+ * Maximum number of iterations a benchmark loop is run for by a single event. Every iteration takes a few
+ * jumps, each counting towards the runaway loop limit of a million, so longer runs are split into several events.
+ */
+static const INT MaxIterationsPerEvent = 100000;
+
+/**
+ * Runs one of the call loops of Test0024_CallBenchmarkBase.
+ *
+ * @param	Object			object to run the loop on
+ * @param	LoopName		name of the event running the loop
+ * @param	NumCalls		number of calls to make
+ * @return	calls per second, including the loop overhead
+ */
+DOUBLE UScriptCallBenchmarkCommandlet::RunCallLoop( UObject* Object, FName LoopName, INT NumCalls )
+{
+	struct FRunCallsParms
+	{
+		INT Count;
+	};
+	FRunCallsParms Parms;
+
+	UFunction* Function = Object->FindFunctionChecked( LoopName );
+	DOUBLE Duration = 0.0;
+	for( INT RemainingCalls=NumCalls; RemainingCalls>0; RemainingCalls-=MaxIterationsPerEvent )
+	{
+		Parms.Count = Min( RemainingCalls, MaxIterationsPerEvent );
+		GInitRunaway();
+		const DOUBLE StartTime = appSeconds();
+		Object->ProcessEvent( Function, &Parms );
+		Duration += appSeconds() - StartTime;
+	}
+	return NumCalls / Max( Duration, 0.000001 );
+}
+
+/**
+ * Measures virtual and global script calls per second with and without call site caches, outside of
+ * any state and in a state whose function overrides the class's. Also measures how much the script
+ * profiler slows down back to back calls, both when instrumenting every call and when sampling.
+ *
+ * Usage: UnrealScriptTest.ScriptCallBenchmark [calls=N] [profilesample=N]
+ */
+INT UScriptCallBenchmarkCommandlet::Main( const FString& Params )
+{
+	INT NumCalls = 5000000;
+	Parse( *Params, TEXT("CALLS="), NumCalls );
+	INT ProfileSampleRate = 16;
+	Parse( *Params, TEXT("PROFILESAMPLE="), ProfileSampleRate );
+
+	UClass* BenchmarkClass = LoadClass<UObject>( NULL, TEXT("UnrealScriptTest.Test0024_CallBenchmarkDerived"), NULL, LOAD_None, NULL );
+	if( !BenchmarkClass )
+	{
+		warnf( NAME_Error, TEXT("Couldn't load Test0024_CallBenchmarkDerived") );
+		return 1;
+	}
+	UObject* Object = ConstructObject<UObject>( BenchmarkClass );
+	const FName VirtualLoopName( TEXT("RunVirtualCalls") );
+	const FName GlobalLoopName( TEXT("RunGlobalCalls") );
+
+	warnf( TEXT("Script call benchmark: %i calls per loop"), NumCalls );
+	warnf( TEXT("%-10s %-10s %16s %16s"), TEXT("State"), TEXT("Caches"), TEXT("Virtual calls/s"), TEXT("Global calls/s") );
+
+	const UBOOL bSavedUseCaches = GUseScriptCallCaches;
+	for( INT StateIndex=0; StateIndex<2; StateIndex++ )
+	{
+		const FName StateName = StateIndex ? FName(TEXT("BenchmarkState")) : NAME_None;
+		Object->GotoState( StateName );
+		for( INT CacheIndex=0; CacheIndex<2; CacheIndex++ )
+		{
+			GUseScriptCallCaches = CacheIndex;
+
+			// Warm up so both runs start out with the code and caches in the same state.
+			RunCallLoop( Object, VirtualLoopName, NumCalls / 10 );
+			const DOUBLE VirtualCallsPerSecond	= RunCallLoop( Object, VirtualLoopName, NumCalls );
+			const DOUBLE GlobalCallsPerSecond	= RunCallLoop( Object, GlobalLoopName, NumCalls );
+			warnf( TEXT("%-10s %-10s %16.0f %16.0f"), *StateName.ToString(), CacheIndex ? TEXT("On") : TEXT("Off"), VirtualCallsPerSecond, GlobalCallsPerSecond );
+		}
+	}
+	GUseScriptCallCaches = bSavedUseCaches;
+
+	// Script profiler overhead. Calls that do next to nothing are the worst case, as the profiler's cost is per call.
+	Object->GotoState( NAME_None );
+	RunCallLoop( Object, VirtualLoopName, NumCalls / 10 );
+	const DOUBLE UnprofiledCallsPerSecond = RunCallLoop( Object, VirtualLoopName, NumCalls );
+	GScriptProfiler.Start( 1 );
+	const DOUBLE InstrumentedCallsPerSecond = RunCallLoop( Object, VirtualLoopName, NumCalls );
+	GScriptProfiler.Start( ProfileSampleRate );
+	const DOUBLE SampledCallsPerSecond = RunCallLoop( Object, VirtualLoopName, NumCalls );
+	GScriptProfiler.Stop();
+	GScriptProfiler.Reset();
+
+	const DOUBLE InstrumentedOverhead	= 100.0 * (UnprofiledCallsPerSecond / InstrumentedCallsPerSecond - 1.0);
+	const DOUBLE SampledOverhead		= 100.0 * (UnprofiledCallsPerSecond / SampledCallsPerSecond - 1.0);
+	warnf( TEXT("Script profiler overhead: %.1f%% instrumenting every call, %.1f%% sampling every %i call trees"), InstrumentedOverhead, SampledOverhead, Max( ProfileSampleRate, 1 ) );
+	if( SampledOverhead > 5.0 )
+	{
+		warnf( NAME_Warning, TEXT("Sampled script profiler overhead is above 5%%") );
+	}
+
+	return 0;
+}
+IMPLEMENT_CLASS(UScriptCallBenchmarkCommandlet);
+
+/**
+ * Runs one of the loops of Test0025_OpcodeBenchmark.
+ *
+ * @param	Object			object to run the loop on
+ * @param	LoopName		name of the event running the loop
+ * @param	NumIterations	number of iterations to run
+ * @param	OutResult		[out] bits of the values the loop returned, combined over all events it was run by
+ * @return	iterations per second
+ */
+DOUBLE UScriptOpcodeBenchmarkCommandlet::RunLoop( UObject* Object, FName LoopName, INT NumIterations, DWORD& OutResult )
+{
+	struct FRunLoopParms
+	{
+		INT Count;
+		DWORD ReturnValue;
+	};
+	FRunLoopParms Parms;
+
+	UFunction* Function = Object->FindFunctionChecked( LoopName );
+	DOUBLE Duration = 0.0;
+	OutResult = 0;
+	for( INT RemainingIterations=NumIterations; RemainingIterations>0; RemainingIterations-=MaxIterationsPerEvent )
+	{
+		Parms.Count			= Min( RemainingIterations, MaxIterationsPerEvent );
+		Parms.ReturnValue	= 0;
+		GInitRunaway();
+		const DOUBLE StartTime = appSeconds();
+		Object->ProcessEvent( Function, &Parms );
+		Duration += appSeconds() - StartTime;
+		OutResult = OutResult * 31 + Parms.ReturnValue;
+	}
+	return NumIterations / Max( Duration, 0.000001 );
+}
+
+/**
+ * Measures loop iterations per second of int, float and struct member heavy script with and without
+ * superinstructions, and checks that both produce the same results and that translating the script
+ * back restores the original bytecode.
+ *
+ * Usage: UnrealScriptTest.ScriptOpcodeBenchmark [iterations=N]
+ */
+INT UScriptOpcodeBenchmarkCommandlet::Main( const FString& Params )
+{
+	INT NumIterations = 2000000;
+	Parse( *Params, TEXT("ITERATIONS="), NumIterations );
+
+	UClass* BenchmarkClass = LoadClass<UObject>( NULL, TEXT("UnrealScriptTest.Test0025_OpcodeBenchmark"), NULL, LOAD_None, NULL );
+	if( !BenchmarkClass )
+	{
+		warnf( NAME_Error, TEXT("Couldn't load Test0025_OpcodeBenchmark") );
+		return 1;
+	}
+	const FName LoopNames[] = { FName(TEXT("RunIntLoop")), FName(TEXT("RunFloatLoop")), FName(TEXT("RunStructLoop")) };
+	const INT NumLoops = ARRAY_COUNT(LoopNames);
+
+	// Script is loaded in its original form by commandlets, remember it to check the round trip at the end.
+	TMap<UFunction*,TArray<BYTE> > OriginalScripts;
+	for( TFieldIterator<UFunction,CLASS_None,0> It(BenchmarkClass); It; ++It )
+	{
+		OriginalScripts.Set( *It, It->Script );
+	}
+
+	// Run each loop before and after translating it.
+	DOUBLE IterationsPerSecond[2][ARRAY_COUNT(LoopNames)];
+	DWORD Results[2][ARRAY_COUNT(LoopNames)];
+	for( INT FusedIndex=0; FusedIndex<2; FusedIndex++ )
+	{
+		INT NumFusedExprs = 0;
+		for( TFieldIterator<UFunction,CLASS_None,0> It(BenchmarkClass); It; ++It )
+		{
+			NumFusedExprs += It->TranslateSuperinstructions( FusedIndex );
+		}
+		if( FusedIndex )
+		{
+			warnf( TEXT("Fused %i expressions into superinstructions"), NumFusedExprs );
+		}
+
+		for( INT LoopIndex=0; LoopIndex<NumLoops; LoopIndex++ )
+		{
+			// Each run starts out with fresh member variables so results can be compared.
+			UObject* Object = ConstructObject<UObject>( BenchmarkClass );
+			IterationsPerSecond[FusedIndex][LoopIndex] = RunLoop( Object, LoopNames[LoopIndex], NumIterations, Results[FusedIndex][LoopIndex] );
+		}
+	}
+
+	// Leave the class the way it was loaded.
+	INT NumMismatches = 0;
+	for( TFieldIterator<UFunction,CLASS_None,0> It(BenchmarkClass); It; ++It )
+	{
+		It->TranslateSuperinstructions( FALSE );
+		const TArray<BYTE>* OriginalScript = OriginalScripts.Find( *It );
+		if( !OriginalScript || *OriginalScript != It->Script )
+		{
+			warnf( NAME_Error, TEXT("%s wasn't restored to its original bytecode"), *It->GetName() );
+			NumMismatches++;
+		}
+	}
+
+	warnf( TEXT("Script opcode benchmark: %i iterations per loop"), NumIterations );
+	warnf( TEXT("%-14s %16s %16s %8s"), TEXT("Loop"), TEXT("Plain it/s"), TEXT("Fused it/s"), TEXT("Speedup") );
+	for( INT LoopIndex=0; LoopIndex<NumLoops; LoopIndex++ )
+	{
+		warnf( TEXT("%-14s %16.0f %16.0f %7.2fx"), *LoopNames[LoopIndex].ToString(), IterationsPerSecond[0][LoopIndex], IterationsPerSecond[1][LoopIndex], IterationsPerSecond[1][LoopIndex] / IterationsPerSecond[0][LoopIndex] );
+		if( Results[0][LoopIndex] != Results[1][LoopIndex] )
+		{
+			warnf( NAME_Error, TEXT("%s returned %08X with superinstructions instead of %08X"), *LoopNames[LoopIndex].ToString(), Results[1][LoopIndex], Results[0][LoopIndex] );
+			NumMismatches++;
+		}
+	}
+
+	return NumMismatches ? 1 : 0;
+}
+IMPLEMENT_CLASS(UScriptOpcodeBenchmarkCommandlet);
+
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/